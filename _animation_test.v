@@ -0,0 +1,221 @@
+module gui
+
+import time
+
+fn test_animation_frame_period_follows_display() {
+	assert animation_frame_period(0) == animation_cycle
+	assert animation_frame_period(1.0 / 120.0) == time.Duration(i64(f64(time.second) / 120.0))
+	// Clamped to sane display rates.
+	assert animation_frame_period(1.0 / 1000.0) == animation_min_period
+	assert animation_frame_period(1.0) == animation_max_period
+}
+
+fn test_animation_next_wait_parks_until_delay() {
+	mut animations := map[string]Animation{}
+	mut ids := map[string]bool{}
+	assert animation_next_wait(animations, ids) == time.Duration(max_i64)
+
+	animations['blink'] = BlinkCursorAnimation{
+		start: time.now()
+	}
+	ids['blink'] = true
+	wait := animation_next_wait(animations, ids)
+	assert wait > 0
+	assert wait <= blink_cursor_animation_delay
+
+	animations['now'] = Animate{
+		id:       'now'
+		callback: fn (mut _ Animate, mut _ Window) {}
+		start:    time.now()
+		delay:    0
+	}
+	// Only the listed ids count.
+	assert animation_next_wait(animations, ids) > 0
+	ids['now'] = true
+	assert animation_next_wait(animations, ids) == 0
+}
+
+fn test_animation_tick_dt_uses_elapsed_time() {
+	dt := animation_tick_dt(i64(8 * time.millisecond))
+	assert f32_abs(dt - 0.008) < 0.0001
+	assert animation_tick_dt(i64(time.second)) == animation_max_dt
+	assert animation_tick_dt(0) > 0
+}
+
+fn animation_batch_test_spring(id string, to f32) SpringAnimation {
+	mut sp := SpringAnimation{
+		id:       id
+		config:   spring_bouncy
+		on_value: fn (_ f32, mut _ Window) {}
+	}
+	sp.spring_to(0, to)
+	return sp
+}
+
+fn test_animation_batch_spring_is_rate_independent() {
+	mut fast := AnimationBatch{}
+	mut slow := AnimationBatch{}
+	fast.add_spring(animation_batch_test_spring('s', 100), 0)
+	slow.add_spring(animation_batch_test_spring('s', 100), 0)
+	mut out := AnimationBatchOutput{}
+	for i in 1 .. 73 {
+		out.reset()
+		fast.tick(i64(i) * i64(time.second) / 144, f32(1.0 / 144.0), mut out)
+	}
+	for i in 1 .. 16 {
+		out.reset()
+		slow.tick(i64(i) * i64(time.second) / 30, f32(1.0 / 30.0), mut out)
+	}
+	assert f32_abs(fast.springs.position[0] - slow.springs.position[0]) < 1.0
+}
+
+fn test_animation_batch_tween_values_and_completion() {
+	mut b := AnimationBatch{}
+	b.add_tween(TweenAnimation{
+		id:       'a'
+		from:     0
+		to:       10
+		duration: 100 * time.millisecond
+		easing:   ease_linear
+		on_value: fn (_ f32, mut _ Window) {}
+	}, 0)
+	b.add_tween(TweenAnimation{
+		id:       'b'
+		from:     0
+		to:       1
+		duration: 100 * time.millisecond
+		easing:   ease_linear
+		delay:    time.second
+		on_value: fn (_ f32, mut _ Window) {}
+	}, 0)
+	mut out := AnimationBatchOutput{}
+	b.tick(i64(50 * time.millisecond), 0, mut out)
+	// 'b' is still in its delay and reports nothing.
+	assert out.values.len == 1
+	assert f32_abs(out.values[0] - 5) < 0.001
+	assert out.stopped.len == 0
+
+	out.reset()
+	b.tick(i64(100 * time.millisecond), 0, mut out)
+	assert out.values == [f32(10)]
+	assert out.stopped == ['a']
+	assert b.len() == 1
+	assert b.next_wait(i64(100 * time.millisecond)) == 900 * time.millisecond
+}
+
+fn test_animation_batch_swap_remove_keeps_slots() {
+	mut b := AnimationBatch{}
+	for id in ['a', 'b', 'c'] {
+		b.add_keyframe(KeyframeAnimation{
+			id:        id
+			keyframes: [Keyframe{
+				at:    0
+				value: 0
+			}, Keyframe{
+				at:    1
+				value: 1
+			}]
+			on_value:  fn (_ f32, mut _ Window) {}
+		}, 0)
+	}
+	b.remove('a')
+	assert b.len() == 2
+	slot := b.slots['c'] or { panic('missing c') }
+	assert b.keyframes.ids[slot.index] == 'c'
+	animations := {
+		'b': Animation(KeyframeAnimation{
+			id:       'b'
+			on_value: fn (_ f32, mut _ Window) {}
+		})
+		'c': Animation(Animate{
+			id:       'c'
+			callback: fn (mut _ Animate, mut _ Window) {}
+		})
+	}
+	// 'c' was replaced by another kind under the same id.
+	b.sync(animations)
+	assert b.len() == 2
+	b.dirty = true
+	b.sync(animations)
+	assert b.len() == 1
+	assert 'b' in b.slots
+	assert b.unbatched == {
+		'c': true
+	}
+}
+
+fn test_animation_batch_spring_retarget_keeps_live_state() {
+	mut w := Window{}
+	sp := animation_batch_test_spring('s', 100)
+	w.animations['s'] = sp
+	w.animation_batch.add_spring(sp, 0)
+	mut out := AnimationBatchOutput{}
+	w.animation_batch.tick(i64(time.second) / 60, f32(1.0 / 60.0), mut out)
+	moved := w.animation_batch.springs.position[0]
+	assert moved > 0
+	assert w.retarget_spring('s', -100)
+	mut entry := w.animations['s'] or { panic('missing spring') }
+	if mut entry is SpringAnimation {
+		// The retarget copies the live state into the map entry.
+		assert entry.state.position == moved
+		assert entry.state.target == -100
+	}
+	assert w.animation_batch.springs.target[0] == -100
+	assert w.animation_batch.springs.position[0] == moved
+
+	// A sync after another add must not reload springs from the map.
+	w.animation_batch.tick(i64(time.second) / 30, f32(1.0 / 60.0), mut out)
+	moved_again := w.animation_batch.springs.position[0]
+	other := animation_batch_test_spring('t', 50)
+	w.animations['t'] = other
+	w.animation_batch.add_spring(other, 0)
+	w.animation_batch.dirty = true
+	w.animation_batch.sync(w.animations)
+	slot := w.animation_batch.slots['s'] or { panic('missing spring slot') }
+	assert w.animation_batch.springs.position[slot.index] == moved_again
+	assert w.animation_batch.springs.target[slot.index] == -100
+}
+
+fn test_layout_transition_reapplies_without_layout() {
+	mut w := Window{}
+	w.animations['__layout_transition__'] = LayoutTransition{
+		snapshots: {
+			'box': LayoutSnapshot{
+				x:      0
+				y:      0
+				width:  10
+				height: 10
+			}
+		}
+		progress:  0.5
+	}
+	assert w.animations['__layout_transition__'].refresh_kind() == .layout
+	mut layer := Layout{
+		shape:    &Shape{}
+		children: [
+			Layout{
+				shape: &Shape{
+					id:     'box'
+					x:      100
+					y:      50
+					width:  30
+					height: 10
+				}
+			},
+		]
+	}
+	apply_layout_transition(mut layer, &w)
+	assert layer.children[0].shape.x == 50
+	assert w.animations['__layout_transition__'].refresh_kind() == .render_only
+
+	w.layout = Layout{
+		children: [layer]
+	}
+	mut transition := w.get_layout_transition() or { panic('missing transition') }
+	transition.progress = 1
+	w.reapply_transitions()
+	box := w.layout.children[0].children[0].shape
+	assert box.x == 100
+	assert box.y == 50
+	assert box.width == 30
+}
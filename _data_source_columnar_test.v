@@ -0,0 +1,326 @@
+module gui
+
+fn columnar_test_store() &GridColumnStore {
+	mut age := grid_int_column('age', [i64(30), 9, 100, 42])
+	age.set_null(3)
+	return new_grid_column_store(['a', 'b', 'c', 'd'], [
+		grid_text_column('name', ['Zoe', 'adam', 'Bob', 'bob']),
+		age,
+		grid_float_column('score', [2.5, 10.0, -1.0, 2.5]),
+		grid_bool_column('active', [true, false, true, false]),
+	]) or { panic(err) }
+}
+
+fn columnar_test_fetch(source InMemoryDataSource, query GridQueryState) GridDataResult {
+	return source.fetch_data(GridDataRequest{
+		grid_id: 'grid'
+		query:   query
+		page:    GridPageRequest(GridOffsetPageReq{
+			start_index: 0
+			end_index:   100
+		})
+	}) or { panic(err) }
+}
+
+fn columnar_test_ids(rows []GridRow) []string {
+	return rows.map(it.id)
+}
+
+fn test_new_grid_column_store_rejects_ragged_columns() {
+	if _ := new_grid_column_store([]string{}, [grid_int_column('a', [i64(1), 2]),
+		grid_int_column('b', [i64(1)])])
+	{
+		assert false
+	}
+	if _ := new_grid_column_store(['x'], [grid_int_column('a', [i64(1), 2])]) {
+		assert false
+	}
+}
+
+fn test_grid_column_store_materializes_rows() {
+	store := columnar_test_store()
+	row := store.row(0)
+	assert row.id == 'a'
+	assert row.cells['name'] == 'Zoe'
+	assert row.cells['age'] == '30'
+	assert row.cells['score'] == '2.5'
+	assert row.cells['active'] == 'true'
+	// Null cells are omitted.
+	assert 'age' !in store.row(3).cells
+	assert store.cell(3, 'age') == ''
+	assert store.cell(0, 'missing') == ''
+}
+
+fn test_columnar_source_sorts_by_type() {
+	source := InMemoryDataSource{
+		columns: columnar_test_store()
+	}
+	// Numeric, not lexicographic ('100' < '30' < '9' as strings);
+	// the null sorts first.
+	by_age := columnar_test_fetch(source, GridQueryState{
+		sorts: [GridSort{
+			col_id: 'age'
+		}]
+	})
+	assert columnar_test_ids(by_age.rows) == ['d', 'b', 'a', 'c']
+	by_score := columnar_test_fetch(source, GridQueryState{
+		sorts: [GridSort{
+			col_id: 'score'
+			dir:    .desc
+		}, GridSort{
+			col_id: 'name'
+		}]
+	})
+	assert columnar_test_ids(by_score.rows) == ['b', 'a', 'd', 'c']
+}
+
+fn test_columnar_source_filters_match_rows_mode() {
+	store := columnar_test_store()
+	columnar := InMemoryDataSource{
+		columns: store
+	}
+	rows := InMemoryDataSource{
+		rows: store.rows_at([0, 1, 2, 3])
+	}
+	queries := [
+		GridQueryState{
+			quick_filter: 'bob'
+		},
+		GridQueryState{
+			quick_filter: '2.5'
+		},
+		GridQueryState{
+			filters: [GridFilter{
+				col_id: 'active'
+				op:     'equals'
+				value:  'TRUE'
+			}]
+		},
+		GridQueryState{
+			filters: [GridFilter{
+				col_id: 'age'
+				op:     'starts_with'
+				value:  '1'
+			}]
+		},
+		GridQueryState{
+			filters: [GridFilter{
+				col_id: 'age'
+				value:  'x'
+			}]
+		},
+		GridQueryState{
+			filters: [GridFilter{
+				col_id: 'missing'
+				op:     'equals'
+				value:  ''
+			}]
+		},
+	]
+	for query in queries {
+		want := columnar_test_fetch(rows, query)
+		got := columnar_test_fetch(columnar, query)
+		assert columnar_test_ids(got.rows) == columnar_test_ids(want.rows)
+	}
+}
+
+fn test_columnar_source_mutations_copy_on_write() {
+	original := columnar_test_store()
+	mut source := InMemoryDataSource{
+		columns: original
+	}
+	created := source.mutate_data(GridMutationRequest{
+		kind: .create
+		rows: [GridRow{
+			id:    'e'
+			cells: {
+				'name': 'Eve'
+				'age':  '7'
+			}
+		}]
+	}) or { panic(err) }
+	assert created.created[0].id == 'e'
+	assert source.columns.len == 5
+	assert original.len == 4
+
+	source.mutate_data(GridMutationRequest{
+		kind:  .update
+		edits: [GridCellEdit{
+			row_id: 'e'
+			col_id: 'age'
+			value:  '8'
+		}]
+	}) or { panic(err) }
+	assert source.columns.cell(4, 'age') == '8'
+
+	if _ := source.mutate_data(GridMutationRequest{
+		kind:  .update
+		edits: [GridCellEdit{
+			row_id: 'e'
+			col_id: 'age'
+			value:  'eight'
+		}]
+	})
+	{
+		assert false
+	}
+
+	deleted := source.mutate_data(GridMutationRequest{
+		kind:    .delete
+		row_ids: ['b', 'e']
+	}) or { panic(err) }
+	assert deleted.deleted_ids == ['b', 'e']
+	assert source.columns.len == 3
+	assert source.columns.row(1).id == 'c'
+	assert source.columns.cell(1, 'age') == '100'
+	assert source.columns.cell(2, 'age') == ''
+}
+
+fn test_columnar_edit_copies_only_edited_columns() {
+	base := columnar_test_store()
+	mut source := InMemoryDataSource{
+		columns: base
+	}
+	source.mutate_data(GridMutationRequest{
+		kind:  .update
+		edits: [GridCellEdit{
+			row_id: 'c'
+			col_id: 'name'
+			value:  'Cy'
+		}]
+	}) or { panic(err) }
+	edited := source.columns
+	assert edited.cell(2, 'name') == 'Cy'
+	assert base.cell(2, 'name') == 'Bob'
+	assert edited.columns[0].codes.data != base.columns[0].codes.data
+	assert edited.columns[1].nums.data == base.columns[1].nums.data
+
+	// A failed create writes only to its own fork.
+	if _ := source.mutate_data(GridMutationRequest{
+		kind: .create
+		rows: [GridRow{
+			id:    'x'
+			cells: {
+				'name': 'Xena'
+				'age':  'old'
+			}
+		}]
+	})
+	{
+		assert false
+	}
+	source.mutate_data(GridMutationRequest{
+		kind: .create
+		rows: [GridRow{
+			id:    'y'
+			cells: {
+				'name': 'Xena'
+			}
+		}]
+	}) or { panic(err) }
+	assert source.columns.cell(4, 'name') == 'Xena'
+	assert edited.len == 4
+
+	// Row 'y' exists only in the newer version.
+	mut older := InMemoryDataSource{
+		columns: edited
+	}
+	if _ := older.mutate_data(GridMutationRequest{
+		kind:  .update
+		edits: [GridCellEdit{
+			row_id: 'y'
+			col_id: 'age'
+			value:  '1'
+		}]
+	})
+	{
+		assert false
+	}
+}
+
+fn test_columnar_sibling_forks_do_not_share_appends() {
+	// One create first, so the base's buffers have spare capacity.
+	mut seed := InMemoryDataSource{
+		columns: columnar_test_store()
+	}
+	seed.mutate_data(GridMutationRequest{
+		kind: .create
+		rows: [GridRow{
+			id:    'w'
+			cells: {
+				'name': 'Wes'
+			}
+		}]
+	}) or { panic(err) }
+	base := seed.columns
+	mut first := InMemoryDataSource{
+		columns: base
+	}
+	mut second := InMemoryDataSource{
+		columns: base
+	}
+	first.mutate_data(GridMutationRequest{
+		kind: .create
+		rows: [GridRow{
+			id:    'x'
+			cells: {
+				'name': 'Xena'
+				'age':  '7'
+			}
+		}]
+	}) or { panic(err) }
+	second.mutate_data(GridMutationRequest{
+		kind: .create
+		rows: [GridRow{
+			id:    'y'
+			cells: {
+				'name': 'Yuri'
+			}
+		}]
+	}) or { panic(err) }
+	assert first.columns.row_id(5) == 'x'
+	assert first.columns.cell(5, 'name') == 'Xena'
+	assert first.columns.cell(5, 'age') == '7'
+	assert second.columns.row_id(5) == 'y'
+	assert second.columns.cell(5, 'name') == 'Yuri'
+	assert second.columns.cell(5, 'age') == ''
+	assert base.len == 5
+	if _ := first.mutate_data(GridMutationRequest{
+		kind:  .update
+		edits: [GridCellEdit{
+			row_id: 'y'
+			col_id: 'age'
+			value:  '1'
+		}]
+	})
+	{
+		assert false
+	}
+}
+
+fn test_grid_column_store_from_rows_and_memory_report() {
+	mut rows := []GridRow{cap: 2000}
+	for i in 0 .. 2000 {
+		rows << GridRow{
+			id:    'r${i}'
+			cells: {
+				'qty':    '${i}'
+				'status': if i % 2 == 0 { 'open' } else { 'closed' }
+				'bad':    if i == 0 { 'n/a' } else { '${i}' }
+			}
+		}
+	}
+	store := grid_column_store_from_rows(rows, {
+		'qty': GridColumnKind.integer
+		'bad': .integer
+	})
+	assert store.len == 2000
+	assert store.row_id(1) == 'r1'
+	assert store.cell(1, 'qty') == '1'
+	assert store.cell(0, 'bad') == ''
+	report := store.memory_report()
+	assert report.rows == 2000
+	assert report.columns == 3
+	assert report.columnar_bytes < report.map_bytes
+	assert report.columnar_bytes_per_million == report.columnar_bytes * 500
+}
@@ -0,0 +1,123 @@
+module gui
+
+fn filter_test_rows(n int) []GridRow {
+	mut rows := []GridRow{cap: n}
+	for i in 0 .. n {
+		rows << GridRow{
+			id:    '${i}'
+			cells: {
+				'name': 'User ${i}'
+				'team': if i % 3 == 0 { 'Core' } else { 'Data' }
+			}
+		}
+	}
+	return rows
+}
+
+fn test_grid_bytes_contain_matches_scalar_search() {
+	hay := 'the quick brown fox jumps over the lazy dog'.bytes()
+	for needle in ['t', 'the', 'dog', 'g', 'fox j', 'lazy dog', 'cat', 'dogs', ''] {
+		assert grid_bytes_contain(hay, 0, hay.len, needle) == hay.bytestr().contains(needle)
+	}
+	// Bounds are respected: 'quick' starts at 4.
+	assert !grid_bytes_contain(hay, 5, hay.len, 'quick')
+	assert !grid_bytes_contain(hay, 0, 8, 'quick')
+	assert grid_bytes_contain(hay, 4, 9, 'quick')
+}
+
+fn test_grid_filter_cache_refines_previous_result() {
+	rows := filter_test_rows(100)
+	mut cache := &GridFilterCache{}
+	first := cache.filter(rows, 0, 'user 1', []GridFilterLowered{}, unsafe { nil })
+	assert first.len == 11 // 1 and 10..19
+	second := cache.filter(rows, 0, 'user 12', []GridFilterLowered{}, unsafe { nil })
+	assert second == [12]
+	assert cache.refined == 1
+	// Broadening scans everything again.
+	third := cache.filter(rows, 0, 'user', []GridFilterLowered{}, unsafe { nil })
+	assert third.len == 100
+	assert cache.refined == 1
+}
+
+fn test_grid_filter_cache_matches_uncached_query() {
+	rows := filter_test_rows(300)
+	mut source := InMemoryDataSource{
+		rows: rows
+	}
+	queries := [
+		GridQueryState{
+			quick_filter: 'CORE'
+		},
+		GridQueryState{
+			quick_filter: 'core'
+			filters:      [GridFilter{
+				col_id: 'name'
+				op:     'ends_with'
+				value:  '5'
+			}]
+		},
+		GridQueryState{
+			quick_filter: 'core 2'
+		},
+		GridQueryState{
+			quick_filter: '2'
+		},
+	]
+	for query in queries {
+		want := data_grid_source_apply_query(rows, query)
+		got := data_grid_source_apply_query_typed(rows, 0, query, map[string]GridSortKind{},
+			source.filter_cache, unsafe { nil })
+		assert got.map(it.id) == want.map(it.id)
+	}
+	// Replacing rows invalidates the cache.
+	source.rows = filter_test_rows(3)
+	res := source.fetch_data(GridDataRequest{
+		grid_id: 'grid'
+		query:   GridQueryState{
+			quick_filter: '2'
+		}
+		page:    GridPageRequest(GridCursorPageReq{
+			limit: 10
+		})
+	}) or { panic(err) }
+	assert res.rows.map(it.id) == ['2']
+}
+
+fn test_grid_filter_cache_rebuilds_on_version_bump() {
+	mut source := InMemoryDataSource{
+		rows:    filter_test_rows(10)
+		version: 1
+	}
+	query := GridQueryState{
+		quick_filter: 'zed'
+	}
+	kinds := map[string]GridSortKind{}
+	before := data_grid_source_apply_query_typed(source.rows, source.version, query, kinds,
+		source.filter_cache, unsafe { nil })
+	assert before.len == 0
+	// An in-place edit keeps the array; the version bump is what tells.
+	source.rows[4] = GridRow{
+		id:    '4'
+		cells: {
+			'name': 'Zed'
+		}
+	}
+	source.version++
+	got := data_grid_source_apply_query_typed(source.rows, source.version, query, kinds,
+		source.filter_cache, unsafe { nil })
+	assert got.map(it.id) == ['4']
+}
+
+fn test_grid_filter_scan_parallel_keeps_order() {
+	rows := filter_test_rows(1000)
+	mut cache := &GridFilterCache{}
+	cache.build_text(rows)
+	candidates := []int{len: rows.len, init: index}
+	filters := []GridFilterLowered{}
+	serial := grid_filter_scan_parallel(rows, cache.text, cache.offsets, []string{}, candidates,
+		'7', filters, 1)
+	parallel := grid_filter_scan_parallel(rows, cache.text, cache.offsets, []string{},
+		candidates, '7', filters, 4)
+	assert parallel == serial
+	assert serial.len > 0
+}
@@ -1,5 +1,7 @@
 module gui
 
+import time
+
 fn test_grid_orm_data_source_capabilities() {
 	source := GridOrmDataSource{
 		columns:         orm_test_columns()
@@ -984,6 +986,307 @@ fn test_build_sql_like_wildcards_escaped() {
 	assert b4.params[0] == '%y\\_'
 }
 
+fn test_grid_orm_keyset_cursor_round_trip() {
+	values := ['Data', 'a:b', ' padded ', '', '42']
+	cursor := grid_orm_keyset_cursor(300, true, values)
+	parsed := grid_orm_parse_keyset_cursor(cursor) or { panic('expected keyset cursor') }
+	assert parsed.offset == 300
+	assert parsed.backward
+	assert parsed.values == values
+	// The grid reads the logical offset for row numbering.
+	assert data_grid_source_cursor_to_index(cursor) == 300
+	for bad in ['i:3', 'k:', 'k:x:f:', 'k:1:z:', 'k:1:f:9:abc', 'k:1:f:ab'] {
+		if _ := grid_orm_parse_keyset_cursor(bad) {
+			assert false, bad
+		}
+	}
+}
+
+fn test_build_sql_keyset_seek() {
+	columns := [
+		GridOrmColumnSpec{
+			id:       'team'
+			db_field: 'm.team'
+		},
+		GridOrmColumnSpec{
+			id:       'score'
+			db_field: 'm.score'
+		},
+	]
+	source := new_grid_orm_data_source(GridOrmDataSource{
+		columns:  columns
+		fetch_fn: orm_test_fetch_ok
+	}) or { panic(err) }
+	asc_sorts := [GridSort{
+		col_id: 'team'
+	}, GridSort{
+		col_id: 'score'
+	}]
+	uniform := source.build_sql(GridOrmQuerySpec{
+		sorts:      asc_sorts
+		limit:      50
+		offset:     5000
+		seek:       ['Data', '7', '901']
+		seek_field: 'm.id'
+	}) or { panic(err) }
+	assert uniform.where_sql == '(m.team, m.score, m.id) > (?, ?, ?)'
+	assert uniform.order_sql == 'm.team asc, m.score asc, m.id asc'
+	// Seeking does not skip rows.
+	assert uniform.params == ['Data', '7', '901', '50', '0']
+
+	mixed := source.build_sql(GridOrmQuerySpec{
+		sorts:         [GridSort{
+			col_id: 'team'
+			dir:    .desc
+		}, GridSort{
+			col_id: 'score'
+		}]
+		limit:         50
+		seek:          ['Data', '7', '901']
+		seek_field:    'm.id'
+		seek_backward: true
+	}) or { panic(err) }
+	assert mixed.where_sql == '((m.team > ?) or (m.team = ? and m.score < ?) or (m.team = ? and m.score = ? and m.id < ?))'
+	assert mixed.order_sql == 'm.team asc, m.score desc, m.id desc'
+	assert mixed.params == ['Data', 'Data', '7', 'Data', '7', '901', '50', '0']
+
+	first := source.build_sql(GridOrmQuerySpec{
+		seek_field: 'm.id'
+	}) or { panic(err) }
+	assert first.where_sql == ''
+	assert first.order_sql == 'm.id asc'
+
+	if _ := source.build_sql(GridOrmQuerySpec{
+		sorts:      asc_sorts
+		seek:       ['Data', '901']
+		seek_field: 'm.id'
+	})
+	{
+		assert false, 'seek must match the sorts'
+	}
+	if _ := source.build_sql(GridOrmQuerySpec{
+		seek:       ['1']
+		seek_field: 'id; drop table m'
+	})
+	{
+		assert false, 'seek_field must be validated'
+	} else {
+		assert err.msg().contains('invalid seek_field')
+	}
+}
+
+fn test_build_sql_reuses_text_per_shape() {
+	source := new_grid_orm_data_source(GridOrmDataSource{
+		columns:  orm_test_columns()
+		fetch_fn: orm_test_fetch_ok
+	}) or { panic(err) }
+	spec := GridOrmQuerySpec{
+		quick_filter: 'ada'
+		filters:      [GridFilter{
+			col_id: 'team'
+			op:     'equals'
+			value:  'Data'
+		}]
+		limit:        10
+	}
+	a := source.build_sql(spec) or { panic(err) }
+	b := source.build_sql(GridOrmQuerySpec{
+		...spec
+		quick_filter: 'grace'
+		filters:      [GridFilter{
+			col_id: 'team'
+			op:     'equals'
+			value:  'Core'
+		}]
+		offset:       20
+	}) or { panic(err) }
+	assert a.shape == b.shape
+	assert a.where_sql == b.where_sql
+	assert b.params.contains('core')
+	assert b.params.last() == '20'
+	assert source.cache.sql_hits == 1
+	c := source.build_sql(GridOrmQuerySpec{
+		...spec
+		quick_filter: ''
+	}) or { panic(err) }
+	assert c.shape != a.shape
+	assert source.cache.sql_hits == 1
+	// Without a factory-built source nothing is cached.
+	d := grid_orm_build_sql(spec, source.column_map) or { panic(err) }
+	assert d.where_sql == a.where_sql
+	assert d.shape == a.shape
+}
+
+fn test_grid_orm_data_source_fetch_data_keyset_cursors() {
+	source := new_grid_orm_data_source(GridOrmDataSource{
+		columns:      orm_test_columns()
+		keyset_field: 'users.id'
+		fetch_fn:     fn (spec GridOrmQuerySpec, _ &GridAbortSignal) !GridOrmPage {
+			assert spec.seek_field == 'users.id'
+			if spec.seek.len == 0 {
+				assert spec.offset == 0
+				return GridOrmPage{
+					rows:     orm_test_rows(['1', '2'])
+					has_more: true
+				}
+			}
+			assert spec.seek == ['User 2', '2']
+			assert spec.offset == 2
+			if spec.seek_backward {
+				return GridOrmPage{
+					rows:     orm_test_rows(['1', '0'])
+					has_more: true
+				}
+			}
+			return GridOrmPage{
+				rows: orm_test_rows(['3', '4'])
+			}
+		}
+	}) or { panic(err) }
+	sorts := [GridSort{
+		col_id: 'name'
+	}]
+	fetch := fn [source, sorts] (cursor string) GridDataResult {
+		return source.fetch_data(GridDataRequest{
+			grid_id: 'orm-grid'
+			query:   GridQueryState{
+				sorts: sorts
+			}
+			page:    GridPageRequest(GridCursorPageReq{
+				cursor: cursor
+				limit:  2
+			})
+		}) or { panic(err) }
+	}
+	first := fetch('')
+	assert first.next_cursor == grid_orm_keyset_cursor(2, false, ['User 2', '2'])
+	assert first.prev_cursor == ''
+	second := fetch(first.next_cursor)
+	assert second.rows.map(it.id) == ['3', '4']
+	assert second.next_cursor == ''
+	assert second.prev_cursor == 'i:0'
+	// Backward pages come back reversed and always have a next page.
+	back := fetch(grid_orm_keyset_cursor(2, true, ['User 2', '2']))
+	assert back.rows.map(it.id) == ['0', '1']
+	assert back.next_cursor == grid_orm_keyset_cursor(4, false, ['User 1', '1'])
+}
+
+fn test_grid_orm_data_source_keyset_falls_back_to_offset() {
+	columns := [
+		GridOrmColumnSpec{
+			id:       'name'
+			db_field: 'users.name'
+		},
+	]
+	source := new_grid_orm_data_source(GridOrmDataSource{
+		columns:      columns
+		keyset_field: 'users.id'
+		fetch_fn:     fn (spec GridOrmQuerySpec, _ &GridAbortSignal) !GridOrmPage {
+			assert spec.seek_field == ''
+			assert spec.seek.len == 0
+			assert spec.offset == 4
+			return GridOrmPage{
+				rows:     orm_test_rows(['5', '6'])
+				has_more: true
+			}
+		}
+	}) or { panic(err) }
+	res := source.fetch_data(GridDataRequest{
+		grid_id: 'orm-grid'
+		query:   GridQueryState{
+			sorts: [GridSort{
+				col_id: 'name'
+			}]
+		}
+		page:    GridPageRequest(GridCursorPageReq{
+			cursor: grid_orm_keyset_cursor(4, false, ['User 4', '4'])
+			limit:  2
+		})
+	}) or { panic(err) }
+	assert res.next_cursor == 'i:6'
+	if _ := new_grid_orm_data_source(GridOrmDataSource{
+		columns:      columns
+		keyset_field: 'id)'
+		fetch_fn:     orm_test_fetch_ok
+	})
+	{
+		assert false, 'keyset_field must be validated'
+	} else {
+		assert err.msg().contains('keyset_field')
+	}
+}
+
+@[heap]
+struct OrmTestCountLog {
+mut:
+	counts int
+}
+
+fn test_grid_orm_data_source_caches_row_counts() {
+	mut log := &OrmTestCountLog{}
+	mut source := new_grid_orm_data_source(GridOrmDataSource{
+		columns:        orm_test_columns()
+		row_count_ttl:  time.hour
+		fetch_fn:       fn [mut log] (spec GridOrmQuerySpec, _ &GridAbortSignal) !GridOrmPage {
+			if !spec.need_count {
+				return GridOrmPage{
+					rows: orm_test_rows(['1'])
+				}
+			}
+			log.counts++
+			return GridOrmPage{
+				rows:      orm_test_rows(['1'])
+				row_count: ?int(40)
+			}
+		}
+		delete_many_fn: fn (row_ids []string, _ &GridAbortSignal) ![]string {
+			return row_ids
+		}
+	}) or { panic(err) }
+	fetch := fn [source] (quick_filter string, dir GridSortDir) ?int {
+		res := source.fetch_data(GridDataRequest{
+			grid_id: 'orm-grid'
+			query:   GridQueryState{
+				quick_filter: quick_filter
+				sorts:        [GridSort{
+					col_id: 'name'
+					dir:    dir
+				}]
+			}
+			page:    GridPageRequest(GridOffsetPageReq{
+				start_index: 0
+				end_index:   1
+			})
+		}) or { panic(err) }
+		return res.row_count
+	}
+	assert (fetch('a', .asc) or { 0 }) == 40
+	// Sorting does not change the count.
+	assert (fetch('a', .desc) or { 0 }) == 40
+	assert log.counts == 1
+	assert (fetch('b', .asc) or { 0 }) == 40
+	assert log.counts == 2
+	source.mutate_data(GridMutationRequest{
+		kind:    .delete
+		row_ids: ['1']
+	}) or { panic(err) }
+	assert (fetch('a', .asc) or { 0 }) == 40
+	assert log.counts == 3
+}
+
+fn test_grid_orm_cache_drops_counts_taken_before_a_mutation() {
+	mut cache := &GridOrmCache{}
+	generation := cache.count_generation()
+	// A mutation lands while the fetch is counting.
+	cache.clear_row_counts()
+	cache.put_row_count(7, 40, generation)
+	if _ := cache.row_count(7, time.hour) {
+		assert false, 'stale count must be dropped'
+	}
+	cache.put_row_count(7, 39, cache.count_generation())
+	assert (cache.row_count(7, time.hour) or { 0 }) == 39
+}
+
 fn orm_test_fetch_ok(_ GridOrmQuerySpec, _ &GridAbortSignal) !GridOrmPage {
 	return GridOrmPage{}
 }
@@ -997,6 +1300,7 @@ fn orm_test_columns() []GridOrmColumnSpec {
 			filterable:       true
 			sortable:         true
 			case_insensitive: true
+			keyset:           true
 		},
 		GridOrmColumnSpec{
 			id:               'team'
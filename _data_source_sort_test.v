@@ -0,0 +1,95 @@
+module gui
+
+fn sort_test_rows(col_id string, values []string) []GridRow {
+	mut rows := []GridRow{cap: values.len}
+	for i, value in values {
+		rows << GridRow{
+			id:    '${i}'
+			cells: {
+				col_id: value
+			}
+		}
+	}
+	return rows
+}
+
+fn sort_test_ids(rows []GridRow, kind GridSortKind, dir GridSortDir) []string {
+	sorted := data_grid_source_apply_query_typed(rows, 0, GridQueryState{
+		sorts: [GridSort{
+			col_id: 'v'
+			dir:    dir
+		}]
+	}, {
+		'v': kind
+	}, unsafe { nil }, unsafe { nil })
+	return sorted.map(it.id)
+}
+
+fn test_grid_sort_number_kind_is_numeric() {
+	rows := sort_test_rows('v', ['10', '9', '-2.5', '', '1,000', 'x', '100'])
+	// Empty and unparseable cells first, then by value.
+	assert sort_test_ids(rows, .number, .asc) == ['3', '5', '2', '1', '0', '6', '4']
+	assert sort_test_ids(rows, .number, .desc) == ['4', '6', '0', '1', '2', '3', '5']
+	// Default text kind stays lexicographic.
+	assert sort_test_ids(rows, .text, .asc) == ['3', '2', '4', '0', '6', '1', '5']
+}
+
+fn test_grid_sort_number_kind_uses_locale_separators() {
+	old := gui_locale
+	gui_locale = Locale{
+		number: NumberFormat{
+			decimal_sep: `,`
+			group_sep:   `.`
+		}
+	}
+	defer {
+		gui_locale = old
+	}
+	rows := sort_test_rows('v', ['1.000', '2,5', '30'])
+	assert sort_test_ids(rows, .number, .asc) == ['1', '2', '0']
+}
+
+fn test_grid_sort_date_kind() {
+	rows := sort_test_rows('v', ['2024-03-01', '12/25/2023', '2024-01-15 08:00:00', 'soon'])
+	assert sort_test_ids(rows, .date, .asc) == ['3', '1', '2', '0']
+}
+
+fn test_grid_sort_text_fold_and_natural() {
+	rows := sort_test_rows('v', ['b', 'A', 'a', 'file10', 'File2', 'file02'])
+	assert sort_test_ids(rows, .text, .asc) == ['1', '4', '2', '0', '5', '3']
+	assert sort_test_ids(rows, .text_fold, .asc) == ['1', '2', '0', '5', '3', '4']
+	assert sort_test_ids(rows, .natural, .asc) == ['1', '2', '0', '4', '5', '3']
+}
+
+fn test_grid_natural_compare() {
+	assert grid_natural_compare('a2', 'a10') < 0
+	assert grid_natural_compare('a10', 'a2') > 0
+	assert grid_natural_compare('a2', 'a02') < 0
+	assert grid_natural_compare('a2b', 'a2b') == 0
+	assert grid_natural_compare('a', 'a1') < 0
+}
+
+fn test_grid_sort_f64_key_preserves_order() {
+	values := [-1e300, -2.5, -0.0, 0.0, 1e-9, 3.0, 1e300]
+	for i in 1 .. values.len {
+		assert grid_sort_f64_key(values[i - 1]) <= grid_sort_f64_key(values[i])
+	}
+	assert grid_sort_f64_key(-1e300) > 0
+}
+
+fn test_grid_sort_parallel_matches_serial() {
+	n := 5000
+	mut values := []string{cap: n}
+	for i in 0 .. n {
+		values << '${(i * 7919) % 611}'
+	}
+	rows := sort_test_rows('v', values)
+	keys := [grid_sort_keys(rows, 'v', .number)]
+	idxs := []int{len: n, init: index}
+	serial := grid_sort_by_keys(idxs, keys, [true], 1)
+	assert grid_sort_by_keys(idxs, keys, [true], 3) == serial
+	assert grid_sort_by_keys(idxs, keys, [true], 8) == serial
+	for i in 1 .. n {
+		assert values[serial[i - 1]].int() >= values[serial[i]].int()
+	}
+}
@@ -1,5 +1,7 @@
 module gui
 
+import time
+
 fn test_in_memory_cursor_data_source_pages_with_cursor() {
 	source := InMemoryDataSource{
 		rows:          data_source_rows(10)
@@ -308,6 +310,39 @@ fn test_in_memory_offset_data_source_mutate_batch_delete() {
 	assert page.rows[2].id == '5'
 }
 
+fn test_in_memory_data_source_version_is_opt_in() {
+	req := GridDataRequest{
+		grid_id: 'grid'
+		query:   GridQueryState{}
+		page:    GridPageRequest(GridCursorPageReq{
+			limit: 10
+		})
+	}
+	mut plain := InMemoryDataSource{
+		rows: data_source_rows(3)
+	}
+	plain.mutate_data(GridMutationRequest{
+		grid_id: 'grid'
+		kind:    .delete
+		row_ids: ['1']
+	}) or { panic(err) }
+	assert plain.version == 0
+	assert (plain.fetch_data(req) or { panic(err) }).version == 0
+
+	mut source := InMemoryDataSource{
+		rows:    data_source_rows(3)
+		version: 5
+	}
+	assert (source.fetch_data(req) or { panic(err) }).version == 5
+	source.mutate_data(GridMutationRequest{
+		grid_id: 'grid'
+		kind:    .delete
+		row_ids: ['1']
+	}) or { panic(err) }
+	assert source.version == 6
+	assert (source.fetch_data(req) or { panic(err) }).version == 6
+}
+
 fn test_in_memory_cursor_data_source_empty_fetch() {
 	source := InMemoryDataSource{
 		rows: []GridRow{}
@@ -524,7 +559,7 @@ fn test_next_mutation_row_id_falls_back_to_random() {
 		existing[data_grid_row_id(row, i)] = true
 		rows << row
 	}
-	id := data_grid_source_next_create_row_id(rows, existing, '') or {
+	id := data_grid_source_next_create_row_id(rows.len, existing, '') or {
 		assert false
 		return
 	}
@@ -1077,6 +1112,433 @@ fn test_is_decimal_negative_cases() {
 	assert data_grid_source_is_decimal('12345')
 }
 
+fn test_data_grid_page_cache_evicts_least_recently_used() {
+	page := GridDataResult{
+		rows: data_source_rows(10)
+	}
+	bytes := data_grid_source_result_bytes(page)
+	mut cache := &DataGridPageCache{
+		budget: 2 * bytes
+	}
+	cache.put('a', page)
+	cache.put('b', page)
+	cache.get('a') or { panic('missing a') }
+	cache.put('c', page)
+	assert cache.pages.len == 2
+	assert 'a' in cache.pages
+	assert 'b' !in cache.pages
+	assert cache.bytes == 2 * bytes
+	// Pages over budget are not kept.
+	cache.put('big', GridDataResult{
+		rows: data_source_rows(100)
+	})
+	assert 'big' !in cache.pages
+}
+
+fn test_data_grid_page_cache_drops_older_versions() {
+	mut cache := &DataGridPageCache{
+		budget: 1 << 20
+	}
+	cache.put('p1', GridDataResult{
+		rows:    data_source_rows(2)
+		version: 3
+	})
+	cache.put('p2', GridDataResult{
+		rows:    data_source_rows(2)
+		version: 4
+	})
+	assert cache.pages.len == 1
+	assert 'p2' in cache.pages
+	// A late result of an older version is ignored.
+	cache.put('p1', GridDataResult{
+		rows:    data_source_rows(2)
+		version: 3
+	})
+	assert 'p1' !in cache.pages
+}
+
+fn test_data_grid_source_cache_hit_shows_cached_page() {
+	mut state := DataGridSourceState{
+		page_cache: &DataGridPageCache{
+			budget: 1 << 20
+		}
+	}
+	assert !data_grid_source_cache_hit('k', GridDataCapabilities{}, mut state)
+	state.page_cache.put('k', GridDataResult{
+		rows:        data_source_rows(3)
+		next_cursor: 'i:3'
+	})
+	assert data_grid_source_cache_hit('k', GridDataCapabilities{}, mut state)
+	assert state.request_key == 'k'
+	assert state.rows.len == 3
+	assert state.next_cursor == 'i:3'
+	assert !state.loading
+	assert state.page_cache.hits == 1
+	assert state.page_cache.misses == 0
+}
+
+fn test_data_grid_source_prefetch_depth_follows_paging_pace() {
+	assert data_grid_source_prefetch_depth(0, 100) == 0
+	assert data_grid_source_prefetch_depth(4, -1) == 1
+	assert data_grid_source_prefetch_depth(4, 2000) == 1
+	assert data_grid_source_prefetch_depth(4, 500) == 3
+	assert data_grid_source_prefetch_depth(4, 0) == 4
+}
+
+fn test_data_grid_source_navigation_joins_running_prefetch() {
+	mut w := Window{}
+	mut cache := &DataGridPageCache{
+		budget: 1 << 20
+	}
+	controller := new_grid_abort_controller()
+	cache.inflight['p2'] = controller
+	mut state := DataGridSourceState{
+		has_loaded:  true
+		request_key: 'p1'
+		page_cache:  cache
+	}
+	assert data_grid_source_join_prefetch('p2', mut state)
+	assert state.loading
+	assert state.request_key == 'p2'
+	assert isnil(state.active_abort)
+	assert !data_grid_source_join_prefetch('p3', mut state)
+	mut dg_src := state_map[string, DataGridSourceState](mut w, ns_dg_source, cap_moderate)
+	dg_src.set('grid', state)
+
+	data_grid_source_store_prefetch('grid', 'p2', cache.generation, GridDataResult{
+		rows: data_source_rows(3)
+	}, mut w)
+	state = dg_src.get('grid') or { panic('missing state') }
+	assert !state.loading
+	assert state.rows.len == 3
+	assert 'p2' in cache.pages
+	assert cache.inflight.len == 0
+	assert w.data_grid_source_stats('grid').prefetch_joins == 1
+}
+
+fn test_data_grid_page_cache_clear_aborts_prefetches() {
+	mut cache := &DataGridPageCache{}
+	controller := new_grid_abort_controller()
+	cache.inflight['p2'] = controller
+	mut state := DataGridSourceState{
+		page_cache: cache
+	}
+	assert data_grid_source_join_prefetch('p2', mut state)
+	data_grid_source_clear_page_cache(mut state)
+	assert controller.signal.is_aborted()
+	assert cache.inflight.len == 0
+	// The joined page is fetched again instead of waiting forever.
+	assert !state.loading
+	assert state.request_key == ''
+}
+
+fn test_grid_request_pacer_debounces_query_changes() {
+	policy := GridRequestPolicy{
+		debounce: 200 * time.millisecond
+	}
+	mut pacer := GridRequestPacer{}
+	assert pacer.wait_ms(policy, 'a', 1000, true) == 200
+	assert pacer.wait_ms(policy, 'a', 1150, true) == 50
+	// A new key restarts the wait.
+	assert pacer.wait_ms(policy, 'ab', 1150, true) == 200
+	assert pacer.wait_ms(policy, 'ab', 1400, true) == 0
+	// Paging does not wait.
+	assert pacer.wait_ms(policy, 'p2', 1400, false) == 0
+	assert pacer.deferred == 2
+}
+
+fn test_grid_request_pacer_throttles_and_adapts() {
+	throttled := GridRequestPolicy{
+		throttle: 100 * time.millisecond
+	}
+	mut pacer := GridRequestPacer{}
+	assert pacer.wait_ms(throttled, 'a', 1000, false) == 0
+	pacer.note_start('q', 1000)
+	assert pacer.wait_ms(throttled, 'b', 1040, false) == 60
+	assert pacer.wait_ms(throttled, 'b', 1100, false) == 0
+
+	adaptive := GridRequestPolicy{
+		debounce:     50 * time.millisecond
+		adaptive:     true
+		max_debounce: 300 * time.millisecond
+	}
+	pacer.observe(1400) // 400ms fetch
+	assert pacer.latency_ms == 400
+	assert pacer.debounce_ms(adaptive) == 200
+	pacer.note_start('q', 2000)
+	pacer.observe(3000)
+	assert pacer.latency_ms == 580
+	assert pacer.debounce_ms(adaptive) == 290
+	pacer.observe(5000)
+	assert pacer.debounce_ms(adaptive) == 300
+}
+
+fn test_grid_shared_request_delivers_to_every_subscriber() {
+	mut w := Window{}
+	policy := GridRequestPolicy{
+		share_key: 'users'
+	}
+	key := grid_request_share_key(policy, 'q:1')
+	assert grid_request_share_key(GridRequestPolicy{}, 'q:1') == ''
+	a := GridRequestSubscriber{
+		id:         'a'
+		request_id: 1
+	}
+	b := GridRequestSubscriber{
+		id:         'b'
+		request_id: 4
+	}
+	if _ := grid_shared_request_join(ns_dg_shared_request, key, a, mut w) {
+		assert false, 'nothing to join yet'
+	}
+	mut lead := grid_shared_request_lead(ns_dg_shared_request, key, a, mut w)
+	mut joined := grid_shared_request_join(ns_dg_shared_request, key, b, mut w) or {
+		panic('expected to join')
+	}
+	assert voidptr(joined.signal) == voidptr(lead.signal)
+	// The fetch survives until every subscriber aborts.
+	lead.abort()
+	lead.abort()
+	assert !lead.signal.is_aborted()
+	subs := grid_shared_request_take(ns_dg_shared_request, key, lead.signal, a, mut w)
+	assert subs.map(it.id) == ['a', 'b']
+	assert subs[1].request_id == 4
+	// Once taken, the entry is gone.
+	again := grid_shared_request_take(ns_dg_shared_request, key, lead.signal, a, mut w)
+	assert again.map(it.id) == ['a']
+	joined.abort()
+	assert lead.signal.is_aborted()
+	// An aborted fetch is not joined.
+	if _ := grid_shared_request_join(ns_dg_shared_request, key, b, mut w) {
+		assert false, 'aborted fetch must not be joined'
+	}
+}
+
+fn test_grid_live_inbox_coalesces_patches_by_row() {
+	mut feed := new_grid_live_feed()
+	inbox := &GridLiveInbox{
+		feed: feed
+	}
+	feed.subscribe(inbox)
+	feed.upsert('1', {
+		'score': '10'
+	})
+	feed.upsert('2', {
+		'name': 'Bo'
+	})
+	feed.upsert('1', {
+		'name':  'Al'
+		'score': '11'
+	})
+	feed.upsert('3', {
+		'score': '5'
+	})
+	feed.delete('3')
+	mut target := unsafe { inbox }
+	patches := target.take()
+	assert patches.map(it.id) == ['1', '2', '3']
+	assert patches[0].cells == {
+		'score': '11'
+		'name':  'Al'
+	}
+	assert patches[2].kind == .delete
+	assert target.received == 5
+	assert target.coalesced == 2
+	assert target.take().len == 0
+	feed.unsubscribe(inbox)
+	feed.delete('1')
+	assert target.take().len == 0
+}
+
+// data_source_live_grid subscribes a loaded grid of five rows to a new
+// feed, as if rows 0 and 1 were generated.
+fn data_source_live_grid(mut w Window, query GridQueryState) (&GridLiveFeed, DataGridCfg) {
+	feed := new_grid_live_feed()
+	cfg := DataGridCfg{
+		id:        'live'
+		columns:   []
+		query:     query
+		live_feed: feed
+	}
+	mut state := DataGridSourceState{
+		rows:        data_source_rows(5)
+		has_loaded:  true
+		row_count:   5
+		rows_dirty:  false
+		request_key: 'page'
+	}
+	data_grid_live_sync(cfg, mut state, mut w)
+	data_grid_live_note_view(state, DataGridPresentation{
+		rows: [DataGridDisplayRow{
+			data_row_idx: 0
+		}, DataGridDisplayRow{
+			data_row_idx: 1
+		}]
+	}, 0, 1, map[string]bool{})
+	mut dg_src := state_map[string, DataGridSourceState](mut w, ns_dg_source, cap_moderate)
+	dg_src.set(cfg.id, state)
+	return feed, cfg
+}
+
+fn test_data_grid_live_drain_patches_rows_in_place() {
+	mut w := Window{}
+	mut feed, cfg := data_source_live_grid(mut w, GridQueryState{})
+	assert w.live_inboxes.len == 1
+	mut dg_src := state_map[string, DataGridSourceState](mut w, ns_dg_source, cap_moderate)
+	signature := (dg_src.get(cfg.id) or { panic('missing state') }).rows_signature
+
+	// Off-screen rows are patched without a relayout.
+	feed.upsert('4', {
+		'score': '1'
+	})
+	feed.upsert('4', {
+		'score': '2'
+	})
+	w.flush_commands()
+	mut got := dg_src.get(cfg.id) or { panic('missing state') }
+	assert got.rows[3].cells['score'] == '2'
+	assert got.rows[3].cells['name'] == 'User 4'
+	assert got.rows_dirty
+	assert got.rows_signature != signature
+	assert !w.refresh_layout
+
+	// A patch that changes nothing is dropped.
+	feed.upsert('1', {
+		'name': 'User 1'
+	})
+	w.flush_commands()
+	assert !w.refresh_layout
+
+	feed.upsert('2', {
+		'score': '99'
+	})
+	w.flush_commands()
+	assert w.refresh_layout
+
+	// Deletes and appends to the last page change the row count.
+	w.refresh_layout = false
+	feed.publish([GridRowPatch{
+		kind: .delete
+		id:   '3'
+	}, GridRowPatch{
+		kind:  .upsert
+		id:    '9'
+		cells: {
+			'name': 'User 9'
+		}
+	}])
+	w.flush_commands()
+	got = dg_src.get(cfg.id) or { panic('missing state') }
+	assert got.rows.map(it.id) == ['1', '2', '4', '5', '9']
+	assert (got.row_count or { 0 }) == 5
+	assert got.request_key == 'page'
+	assert w.refresh_layout
+
+	stats := w.data_grid_source_stats(cfg.id)
+	assert stats.live_received == 6
+	assert stats.live_coalesced == 1
+	assert stats.live_applied == 4
+	assert stats.live_relayouts == 2
+	assert stats.live_refetches == 0
+
+	// Closing the window ends the subscription.
+	w.close_live_inboxes()
+	assert w.live_inboxes.len == 0
+	feed.upsert('1', {
+		'score': '0'
+	})
+	assert w.command_queue_stats().depth == 0
+}
+
+fn test_data_grid_live_refetches_when_rows_may_move() {
+	mut w := Window{}
+	mut feed, cfg := data_source_live_grid(mut w, GridQueryState{
+		sorts: [GridSort{
+			col_id: 'score'
+		}]
+	})
+	mut dg_src := state_map[string, DataGridSourceState](mut w, ns_dg_source, cap_moderate)
+	// A new row of a sorted query is left to the server.
+	feed.upsert('9', {
+		'score': '1'
+	})
+	w.flush_commands()
+	mut got := dg_src.get(cfg.id) or { panic('missing state') }
+	assert got.rows.len == 5
+	assert got.request_key == ''
+	assert w.refresh_layout
+
+	// A changed sort key is shown at once and refetched.
+	got.request_key = 'page'
+	dg_src.set(cfg.id, got)
+	feed.upsert('5', {
+		'score': '0'
+	})
+	w.flush_commands()
+	got = dg_src.get(cfg.id) or { panic('missing state') }
+	assert got.rows[4].cells['score'] == '0'
+	assert got.request_key == ''
+	// Other columns patch in place.
+	got.request_key = 'page'
+	dg_src.set(cfg.id, got)
+	feed.upsert('5', {
+		'name': 'Eve'
+	})
+	w.flush_commands()
+	got = dg_src.get(cfg.id) or { panic('missing state') }
+	assert got.request_key == 'page'
+	assert w.data_grid_source_stats(cfg.id).live_refetches == 2
+}
+
+fn test_data_grid_live_replays_patches_over_in_flight_fetch() {
+	mut w := Window{}
+	mut feed, cfg := data_source_live_grid(mut w, GridQueryState{})
+	mut dg_src := state_map[string, DataGridSourceState](mut w, ns_dg_source, cap_moderate)
+	mut state := dg_src.get(cfg.id) or { panic('missing state') }
+	state.loading = true
+	state.request_id = 7
+	dg_src.set(cfg.id, state)
+	feed.upsert('2', {
+		'score': '42'
+	})
+	w.flush_commands()
+	// The response was computed before the patch.
+	data_grid_source_apply_success(cfg.id, 7, GridDataResult{
+		rows: data_source_rows(5)
+	}, GridDataCapabilities{}, mut w)
+	state = dg_src.get(cfg.id) or { panic('missing state') }
+	assert !state.loading
+	assert state.rows[1].cells['score'] == '42'
+	// Replayed once only.
+	mut inbox := unsafe { state.live }
+	assert inbox.take_replay().len == 0
+}
+
+fn test_data_grid_live_drops_subscriptions_of_gone_grids() {
+	mut w := Window{}
+	mut feed, cfg := data_source_live_grid(mut w, GridQueryState{})
+	mut dg_src := state_map[string, DataGridSourceState](mut w, ns_dg_source, cap_moderate)
+	// The grid state is evicted while a drain is queued.
+	feed.upsert('1', {
+		'score': '0'
+	})
+	dg_src.delete(cfg.id)
+	w.flush_commands()
+	assert w.live_inboxes.len == 0
+	feed.upsert('1', {
+		'score': '1'
+	})
+	assert w.command_queue_stats().depth == 0
+
+	// A grid the last view did not generate is swept.
+	data_source_live_grid(mut w, GridQueryState{})
+	assert w.live_inboxes.len == 1
+	w.sweep_live_inboxes()
+	assert w.live_inboxes.len == 1
+	w.sweep_live_inboxes()
+	assert w.live_inboxes.len == 0
+}
+
 fn data_source_rows(count int) []GridRow {
 	mut rows := []GridRow{cap: count}
 	for i in 0 .. count {
@@ -0,0 +1,144 @@
+module gui
+
+import net.http
+import os
+import time
+
+fn diagram_disk_test_dir(name string) string {
+	return os.join_path(os.temp_dir(), 'gui_diagram_disk_${name}_${time.now().unix_micro()}')
+}
+
+fn test_diagram_disk_key_depends_on_every_part() {
+	a := diagram_disk_key(['mermaid', 'http://a', 'graph TD', '500', '1,2,3'])
+	assert a == diagram_disk_key(['mermaid', 'http://a', 'graph TD', '500', '1,2,3'])
+	assert a != diagram_disk_key(['mermaid', 'http://b', 'graph TD', '500', '1,2,3'])
+	assert a != diagram_disk_key(['mermaid', 'http://a', 'graph TD', '400', '1,2,3'])
+	assert a != diagram_disk_key(['mermaid', 'http://a', 'graph TD', '500', '1,2,4'])
+	// Part boundaries are significant.
+	assert diagram_disk_key(['ab', 'c']) != diagram_disk_key(['a', 'bc'])
+}
+
+fn test_diagram_disk_cache_round_trip() {
+	dir := diagram_disk_test_dir('rt')
+	defer {
+		os.rmdir_all(dir) or {}
+	}
+	disk := DiagramDiskCache{
+		dir: dir
+	}
+	if _ := disk.read('k') {
+		assert false
+	}
+	disk.write('k', [u8(1), 2, 3])
+	bytes := disk.read('k') or { panic('expected cache hit') }
+	assert bytes == [u8(1), 2, 3]
+}
+
+fn test_diagram_disk_cache_disabled() {
+	dir := diagram_disk_test_dir('off')
+	defer {
+		os.rmdir_all(dir) or {}
+	}
+	disk := DiagramDiskCache{
+		dir:       dir
+		max_bytes: 0
+	}
+	disk.write('k', [u8(1)])
+	assert !os.exists(dir)
+	if _ := disk.read('k') {
+		assert false
+	}
+}
+
+fn test_diagram_disk_cache_trims_least_recently_used() {
+	dir := diagram_disk_test_dir('trim')
+	defer {
+		os.rmdir_all(dir) or {}
+	}
+	disk := DiagramDiskCache{
+		dir:       dir
+		max_bytes: 20
+	}
+	disk.write('old', []u8{len: 8})
+	disk.write('mid', []u8{len: 8})
+	now := int(time.now().unix())
+	os.utime(disk.path('old'), now - 100, now - 100) or { panic(err) }
+	os.utime(disk.path('mid'), now - 50, now - 50) or { panic(err) }
+	disk.write('new', []u8{len: 8})
+	assert !os.exists(disk.path('old'))
+	assert os.exists(disk.path('mid'))
+	assert os.exists(disk.path('new'))
+}
+
+const diagram_test_png = [u8(0x89), 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00,
+	0x0d, 0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x08, 0x06, 0x00,
+	0x00, 0x00, 0x1f, 0x15, 0xc4, 0x89, 0x00, 0x00, 0x00, 0x0a, 0x49, 0x44, 0x41, 0x54, 0x78, 0x9c,
+	0x63, 0x00, 0x01, 0x00, 0x00, 0x05, 0x00, 0x01, 0x0d, 0x0a, 0x2d, 0xb4, 0x00, 0x00, 0x00, 0x00,
+	0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82]
+
+fn diagram_test_fetch(body string) fn () !http.Response {
+	return fn [body] () !http.Response {
+		return http.Response{
+			status_code: 200
+			body:        body
+		}
+	}
+}
+
+fn test_diagram_fetch_png_caches_only_decodable_bodies() {
+	dir := diagram_disk_test_dir('fetch')
+	defer {
+		os.rmdir_all(dir) or {}
+	}
+	disk := DiagramDiskCache{
+		dir: dir
+	}
+	// A captive portal answers 200 with an HTML page.
+	portal := diagram_test_fetch('<html>Sign in to continue</html>')
+	if _ := diagram_fetch_png_body(disk, 'portal', portal) {
+		assert false
+	}
+	assert !os.exists(disk.path('portal'))
+
+	body := diagram_fetch_png_body(disk, 'ok', diagram_test_fetch(diagram_test_png.bytestr())) or {
+		panic(err)
+	}
+	assert !body.cached
+	// Written only once the pool has decoded it.
+	assert !os.exists(disk.path('ok'))
+	img := diagram_png_decode(disk, 'ok', body) or { panic(err) }
+	assert img.width == 1
+	img.free()
+	assert os.exists(disk.path('ok'))
+	cached := diagram_fetch_png_body(disk, 'ok', diagram_test_fetch('')) or { panic(err) }
+	assert cached.cached
+}
+
+fn test_diagram_fetch_png_evicts_undecodable_cache_entry() {
+	dir := diagram_disk_test_dir('evict')
+	defer {
+		os.rmdir_all(dir) or {}
+	}
+	disk := DiagramDiskCache{
+		dir: dir
+	}
+	disk.write('k', '<html>stale</html>'.bytes())
+	body := diagram_fetch_png_body(disk, 'k', diagram_test_fetch(diagram_test_png.bytestr())) or {
+		panic(err)
+	}
+	assert !body.cached
+	img := diagram_png_decode(disk, 'k', body) or { panic(err) }
+	img.free()
+	cached := disk.read('k') or { panic('expected refetched entry') }
+	assert cached == diagram_test_png
+
+	// A cached file with the signature but a corrupt body is deleted
+	// when the decode fails, so the retry fetches it afresh.
+	disk.write('k', diagram_png_signature)
+	corrupt := diagram_fetch_png_body(disk, 'k', diagram_test_fetch('')) or { panic(err) }
+	assert corrupt.cached
+	if _ := diagram_png_decode(disk, 'k', corrupt) {
+		assert false
+	}
+	assert !os.exists(disk.path('k'))
+}
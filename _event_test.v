@@ -1,5 +1,7 @@
 module gui
 
+import gg
+
 fn test_modifier_has() {
 	// none
 	assert Modifier.none.has(.none)
@@ -29,3 +31,67 @@ fn test_modifier_has_any() {
 		assert Modifier(u32(Modifier.shift) | u32(Modifier.ctrl)).has_any(.shift, .alt)
 	}
 }
+
+fn test_input_coalescer_merges_moves_and_sums_deltas() {
+	mut c := InputCoalescer{}
+	c.add(&gg.Event{
+		typ:      .mouse_move
+		mouse_x:  10
+		mouse_dx: 2
+	})
+	c.add(&gg.Event{
+		typ:      .mouse_move
+		mouse_x:  15
+		mouse_dx: 5
+	})
+	c.add(&gg.Event{
+		typ:      .mouse_scroll
+		scroll_y: 1
+	})
+	c.add(&gg.Event{
+		typ:      .mouse_scroll
+		scroll_y: 2
+	})
+	events := c.take()
+	assert events.len == 2
+	assert events[0].typ == .mouse_move
+	assert events[0].mouse_x == 15
+	assert events[0].mouse_dx == 7
+	assert events[1].typ == .mouse_scroll
+	assert events[1].scroll_y == 3
+	assert c.merged == 2
+	assert c.take().len == 0
+}
+
+fn test_input_coalescer_keeps_interleaved_order() {
+	mut c := InputCoalescer{}
+	c.add(&gg.Event{
+		typ:     .mouse_move
+		mouse_x: 10
+	})
+	c.add(&gg.Event{
+		typ:      .mouse_scroll
+		scroll_y: 1
+	})
+	c.add(&gg.Event{
+		typ:     .mouse_move
+		mouse_x: 15
+	})
+	events := c.take()
+	assert events.len == 3
+	assert events[0].typ == .mouse_move
+	assert events[1].typ == .mouse_scroll
+	assert events[2].typ == .mouse_move
+	assert events[0].mouse_x == 10
+	assert events[2].mouse_x == 15
+	assert c.merged == 0
+}
+
+fn test_is_coalescable_excludes_buttons_and_keys() {
+	assert is_coalescable(.mouse_move)
+	assert is_coalescable(.mouse_scroll)
+	assert !is_coalescable(.mouse_down)
+	assert !is_coalescable(.mouse_up)
+	assert !is_coalescable(.key_down)
+	assert !is_coalescable(.char)
+}
@@ -0,0 +1,69 @@
+module gui
+
+fn test_image_atlas_packs_same_height_on_one_shelf() {
+	mut atlas := ImageAtlas{}
+	a := atlas.insert(1, 32, 32, 1) or { panic('expected entry a') }
+	b := atlas.insert(2, 32, 30, 1) or { panic('expected entry b') }
+	assert a.page == 0
+	assert b.page == 0
+	assert a.shelf == b.shelf
+	assert b.x == 32 + image_atlas_padding
+	assert atlas.len() == 2
+}
+
+fn test_image_atlas_rejects_large_images() {
+	mut atlas := ImageAtlas{}
+	assert atlas.insert(3, image_atlas_max_dim + 1, 16, 1) == none
+	assert atlas.len() == 0
+}
+
+fn test_image_atlas_uvs_are_inset_half_texel() {
+	mut atlas := ImageAtlas{}
+	e := atlas.insert(1, 16, 16, 1) or { panic('expected entry') }
+	size := f32(image_atlas_page_size)
+	assert f32_are_close(e.u0, 0.5 / size)
+	assert f32_are_close(e.v0, 0.5 / size)
+	assert f32_are_close(e.u1, 15.5 / size)
+	assert f32_are_close(e.v1, 15.5 / size)
+}
+
+fn test_image_atlas_lookup_hit_refreshes_shelf() {
+	mut atlas := ImageAtlas{}
+	e := atlas.insert(1, 16, 16, 1) or { panic('expected entry') }
+	hit := atlas.lookup(1, unsafe { nil }, 7) or { panic('expected hit') }
+	assert hit.x == e.x
+	assert atlas.pages[e.page].shelves[e.shelf].last_used == 7
+}
+
+fn test_image_atlas_evicts_lru_shelf_when_full() {
+	mut atlas := ImageAtlas{}
+	dim := image_atlas_max_dim
+	mut n := 0
+	for {
+		atlas.insert(100 + n, dim, dim, 5) or { break }
+		n++
+	}
+	assert n > 0
+	assert atlas.pages.len == image_atlas_max_pages
+	// Shelves used in the current frame are never evicted.
+	assert atlas.insert(99, dim, dim, 5) == none
+	assert atlas.evictions == 0
+	// Nor are shelves the presented renderers still draw.
+	atlas.begin_renderers(5)
+	assert atlas.insert(99, dim, dim, 6) == none
+	assert atlas.evictions == 0
+	// A new renderer build may reclaim the least recently used shelf.
+	atlas.begin_renderers(6)
+	e := atlas.insert(99, dim, dim, 6) or { panic('expected eviction') }
+	assert atlas.evictions == 1
+	assert 100 !in atlas.entries
+	assert e.page == 0
+	assert e.shelf == 0
+}
+
+fn test_image_atlas_remove_forgets_entry() {
+	mut atlas := ImageAtlas{}
+	atlas.insert(1, 8, 8, 1) or { panic('expected entry') }
+	atlas.remove(1)
+	assert atlas.len() == 0
+}
@@ -0,0 +1,100 @@
+module gui
+
+import os
+
+fn test_image_header_size_png() {
+	mut b := []u8{len: 24}
+	b[0] = 0x89
+	b[1] = `P`
+	b[2] = `N`
+	b[3] = `G`
+	b[18] = 0x01
+	b[19] = 0x2c // width 300
+	b[22] = 0x00
+	b[23] = 0xc8 // height 200
+	w, h := image_header_size(b) or { panic('expected size') }
+	assert w == 300
+	assert h == 200
+}
+
+fn test_image_header_size_gif() {
+	b := [u8(`G`), `I`, `F`, `8`, `9`, `a`, 0x40, 0x01, 0xf0, 0x00]
+	w, h := image_header_size(b) or { panic('expected size') }
+	assert w == 320
+	assert h == 240
+}
+
+fn test_image_header_size_bmp_top_down() {
+	mut b := []u8{len: 26}
+	b[0] = `B`
+	b[1] = `M`
+	b[18] = 0x10 // width 16
+	// height -8 (top-down)
+	b[22] = 0xf8
+	b[23] = 0xff
+	b[24] = 0xff
+	b[25] = 0xff
+	w, h := image_header_size(b) or { panic('expected size') }
+	assert w == 16
+	assert h == 8
+}
+
+fn test_image_header_size_jpeg_skips_app_segments() {
+	mut b := [u8(0xff), 0xd8]
+	// APP0 segment, length 16.
+	b << [u8(0xff), 0xe0, 0x00, 0x10]
+	b << []u8{len: 14}
+	// SOF0: length, precision, height 480, width 640.
+	b << [u8(0xff), 0xc0, 0x00, 0x11, 0x08, 0x01, 0xe0, 0x02, 0x80]
+	b << []u8{len: 8}
+	w, h := image_header_size(b) or { panic('expected size') }
+	assert w == 640
+	assert h == 480
+}
+
+fn test_image_header_size_unknown() {
+	if _, _ := image_header_size([u8(1), 2, 3, 4, 5, 6, 7, 8, 9, 10]) {
+		assert false
+	}
+	if _, _ := image_header_size([]u8{}) {
+		assert false
+	}
+}
+
+fn test_image_source_size_missing_file_errors_unsniffable_uses_placeholder() {
+	mut w := Window{}
+	dir := os.join_path(os.temp_dir(), 'gui_image_source_size_test')
+	os.mkdir_all(dir) or { panic(err) }
+	missing := os.join_path(dir, 'missing.webp')
+	if _, _ := w.image_source_size(missing) {
+		assert false, 'missing file must be an error'
+	}
+	unknown := os.join_path(dir, 'unknown.webp')
+	os.write_file(unknown, 'RIFF????WEBP') or { panic(err) }
+	defer {
+		os.rmdir_all(dir) or {}
+	}
+	iw, ih := w.image_source_size(unknown) or { panic(err) }
+	assert iw == image_placeholder_size
+	assert ih == image_placeholder_size
+	// The size is not cached, so the decode can still supply it.
+	assert os.real_path(unknown) !in w.view_state.image_dims
+}
+
+fn test_image_decoder_failure_backs_off() {
+	path := os.join_path(os.temp_dir(), 'gui_image_decode_failure.png')
+	os.write_file(path, 'not a png') or { panic(err) }
+	defer {
+		os.rm(path) or {}
+	}
+	mut decoder := &ImageDecoder{}
+	decoder.record_failure('k', path, 'decode failed')
+	first := decoder.failed['k'] or { panic('expected failure') }
+	assert first.attempts == 1
+	assert first.mtime == os.file_last_mod_unix(path)
+	decoder.record_failure('k', path, 'decode failed')
+	second := decoder.failed['k'] or { panic('expected failure') }
+	assert second.attempts == 2
+	// The wait doubles: 1s, then 2s.
+	assert second.retry_at - first.retry_at >= image_retry_base_ms
+}
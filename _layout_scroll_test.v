@@ -0,0 +1,76 @@
+module gui
+
+fn scroll_test_window() &Window {
+	mut w := &Window{}
+	w.layout = Layout{
+		shape:    &Shape{}
+		children: [
+			Layout{
+				shape:    &Shape{
+					id_scroll:  1
+					height:     100
+					width:      100
+					shape_clip: DrawClip{
+						width:  100
+						height: 100
+					}
+				}
+				children: [
+					Layout{
+						shape: &Shape{
+							y:      10
+							width:  100
+							height: 400
+						}
+					},
+				]
+			},
+		]
+	}
+	w.scroll_applied[1] = ScrollOffset{}
+	return w
+}
+
+fn test_scroll_fast_path_translates_content() {
+	mut w := scroll_test_window()
+	mut sy := state_map[u32, f32](mut w, ns_scroll_y, cap_scroll)
+	sy.set(1, -30)
+	assert w.scroll_fast_path()
+	child := w.layout.children[0].children[0]
+	assert child.shape.y == -20
+	assert child.shape.shape_clip.y == 0
+	assert child.shape.shape_clip.height == 100
+	assert w.scroll_applied[1] or { ScrollOffset{} } == ScrollOffset{
+		y: -30
+	}
+}
+
+fn test_scroll_fast_path_falls_back_when_range_changes() {
+	mut w := scroll_test_window()
+	first, last := list_core_visible_range(40, 20, 100, 0)
+	w.scroll_dep(ScrollDep{
+		id_scroll:  1
+		kind:       .list_core
+		first:      first
+		last:       last
+		row_count:  40
+		row_height: 20
+		viewport:   100
+	})
+	mut sy := state_map[u32, f32](mut w, ns_scroll_y, cap_scroll)
+	sy.set(1, -10) // still inside the first row
+	assert w.scroll_fast_path()
+	sy.set(1, -200)
+	assert !w.scroll_fast_path()
+	assert w.layout.children[0].children[0].shape.y == 0
+}
+
+fn test_scroll_dep_offset_x_holds_only_at_offset() {
+	dep := ScrollDep{
+		id_scroll: 1
+		kind:      .offset_x
+		offset:    -5
+	}
+	assert dep.holds(ScrollOffset{ x: -5, y: -100 })
+	assert !dep.holds(ScrollOffset{ x: -6 })
+}
@@ -1,8 +1,5 @@
 module gui
 
-import os
-import time
-
 // test_markdown_mermaid checks if mermaid blocks are correctly identified.
 fn test_markdown_mermaid() {
 	source := '```mermaid
@@ -50,33 +47,61 @@ fn test_diagram_cache_should_apply_result_guard() {
 	assert !diagram_cache_should_apply_result(&cache, 42, 7)
 }
 
-fn test_diagram_cache_replaces_old_temp_file() {
-	path_a := os.join_path(os.temp_dir(), 'gui_mermaid_a_${time.now().unix_micro()}.png')
-	path_b := os.join_path(os.temp_dir(), 'gui_mermaid_b_${time.now().unix_micro()}.png')
-	os.write_file(path_a, 'a') or { panic(err) }
-	os.write_file(path_b, 'b') or { panic(err) }
-	defer {
-		if os.exists(path_a) {
-			os.rm(path_a) or {}
-		}
-		if os.exists(path_b) {
-			os.rm(path_b) or {}
-		}
-	}
-
+fn test_diagram_cache_releases_replaced_image() {
 	mut cache := BoundedDiagramCache{}
 	cache.set(1, DiagramCacheEntry{
-		state:    .ready
-		png_path: path_a
+		state:     .ready
+		image_key: 'mem:mermaid/1/1'
 	})
 	cache.set(1, DiagramCacheEntry{
-		state:    .ready
-		png_path: path_b
+		state:     .ready
+		image_key: 'mem:mermaid/1/2'
 	})
-	assert !os.exists(path_a)
-	assert os.exists(path_b)
+	assert cache.released == ['mem:mermaid/1/1']
 	cache.clear()
-	assert !os.exists(path_b)
+	assert cache.released == ['mem:mermaid/1/1', 'mem:mermaid/1/2']
+}
+
+fn test_diagram_cache_releases_evicted_image() {
+	mut cache := BoundedDiagramCache{
+		max_size: 1
+	}
+	cache.set(1, DiagramCacheEntry{
+		state:     .ready
+		image_key: 'mem:math/1/1'
+	})
+	cache.set(2, DiagramCacheEntry{
+		state: .loading
+	})
+	assert cache.released == ['mem:math/1/1']
+	cache.delete(2)
+	assert cache.len() == 0
+}
+
+fn test_release_diagram_images_defers_textures() {
+	mut w := Window{}
+	w.view_state.image_map.set_sized('mem:mermaid/1/1', 5, 0, 4)
+	w.view_state.image_map.set_sized('mem:mermaid/1/2', 6, 0, 4)
+	w.view_state.diagram_cache.set(1, DiagramCacheEntry{
+		state:     .ready
+		image_key: 'mem:mermaid/1/1'
+	})
+	w.view_state.diagram_cache.set(1, DiagramCacheEntry{
+		state:     .ready
+		image_key: 'mem:mermaid/1/2'
+	})
+	w.release_diagram_images()
+	assert !w.view_state.image_map.contains('mem:mermaid/1/1')
+	assert w.view_state.image_map.contains('mem:mermaid/1/2')
+	assert w.view_state.image_map.release == [5]
+	assert w.stats.textures_released == 0
+	w.release_evicted_textures()
+	assert w.stats.textures_released == 1
+}
+
+fn test_diagram_image_name_is_unique_per_request() {
+	assert diagram_image_name('math', 5, 1) != diagram_image_name('math', 5, 2)
+	assert diagram_image_name('math', 5, 1) != diagram_image_name('mermaid', 5, 1)
 }
 
 fn test_markdown_external_api_warning_flag_sets_once() {
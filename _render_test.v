@@ -921,3 +921,34 @@ fn test_clip_group_over_budget_rejected_atomically() {
 	assert w.frame_triangle_vertices == 0
 	assert w.render_guard_warned['triangle_vertex_budget']
 }
+
+fn test_overlay_drops_caret_under_later_layer() {
+	mut w := make_window()
+	w.layer_rects = [make_clip(0, 0, 400, 300), make_clip(50, 50, 100, 100)]
+	caret := DrawRect{
+		x: 60
+		y: 60
+		w: 1.5
+		h: 14
+	}
+	visible := DrawRect{
+		x: 200
+		y: 60
+		w: 1.5
+		h: 14
+	}
+	// Anchor in the main layer: the popup covers the first caret only.
+	w.renderers = [Renderer(make_clip(0, 0, 400, 300)), caret, visible]
+	w.drop_covered_overlay(1, 0)
+	assert w.renderers.len == 2
+	last := w.renderers[1]
+	if last is DrawRect {
+		assert last.x == 200
+	} else {
+		assert false
+	}
+	// Anchor inside the popup: nothing is drawn over it.
+	w.renderers = [Renderer(make_clip(50, 50, 100, 100)), caret]
+	w.drop_covered_overlay(1, 1)
+	assert w.renderers.len == 2
+}
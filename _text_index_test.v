@@ -0,0 +1,194 @@
+module gui
+
+import time
+
+fn text_index_test_rows(n int) []GridRow {
+	mut rows := []GridRow{cap: n}
+	for i in 0 .. n {
+		rows << GridRow{
+			id:    'r${i}'
+			cells: {
+				'name': 'Person ${i}'
+				'city': ['Oslo', 'Lima', 'Quito', 'Perth'][i % 4]
+			}
+		}
+	}
+	return rows
+}
+
+fn text_index_test_wait(mut index GridTextIndex, rows []GridRow) {
+	for _ in 0 .. 1000 {
+		if index.rows_current(rows, 0) {
+			return
+		}
+		time.sleep(2 * time.millisecond)
+	}
+	assert false, 'index build timed out'
+}
+
+fn test_text_index_grams_are_lowered_and_distinct() {
+	grams := text_index_grams(['AbAb', 'ab'])
+	// 'aba', 'bab'; 'ab' is too short and trigrams do not span texts.
+	assert grams.len == 2
+	assert grams[0] == (u32(`a`) << 16) | (u32(`b`) << 8) | u32(`a`)
+	assert text_index_grams(['xy']).len == 0
+}
+
+fn test_text_index_candidates_are_superset_of_matches() {
+	rows := text_index_test_rows(200)
+	mut index := new_grid_text_index([]string{})
+	text_index_test_wait(mut index, rows)
+	for needle in ['person 1', 'quito', 'lima', 'son 19', 'zzz'] {
+		hits := index.candidates(needle, rows.data, rows.len, 0) or { panic('index not current') }
+		for i, row in rows {
+			if grid_row_contains_lower(row, []string{}, needle) {
+				assert i in hits
+			}
+		}
+	}
+	assert (index.candidates('zzz', rows.data, rows.len, 0) or { [0] }).len == 0
+	// An index for another array answers none.
+	other := text_index_test_rows(200)
+	if _ := index.candidates('quito', other.data, other.len, 0) {
+		assert false
+	}
+	stats := index.stats()
+	assert stats.ready
+	assert stats.docs == 200
+	assert stats.queries == 6
+}
+
+fn test_text_index_restricts_columns() {
+	rows := text_index_test_rows(40)
+	source := InMemoryDataSource{
+		rows:       rows
+		text_index: new_grid_text_index(['city'])
+	}
+	mut index := unsafe { source.text_index }
+	text_index_test_wait(mut index, rows)
+	res := source.fetch_data(GridDataRequest{
+		grid_id: 'grid'
+		query:   GridQueryState{
+			quick_filter: 'person'
+		}
+		page:    GridPageRequest(GridCursorPageReq{
+			limit: 100
+		})
+	}) or { panic(err) }
+	assert res.rows.len == 0
+}
+
+fn test_text_index_fetch_matches_scan_and_follows_mutations() {
+	rows := text_index_test_rows(120)
+	mut source := InMemoryDataSource{
+		rows:       rows
+		text_index: new_grid_text_index([]string{})
+	}
+	mut index := unsafe { source.text_index }
+	text_index_test_wait(mut index, rows)
+	fetch := fn (source InMemoryDataSource, needle string) []string {
+		res := source.fetch_data(GridDataRequest{
+			grid_id: 'grid'
+			query:   GridQueryState{
+				quick_filter: needle
+			}
+			page:    GridPageRequest(GridCursorPageReq{
+				limit: 1000
+			})
+		}) or { panic(err) }
+		return res.rows.map(it.id)
+	}
+	scan := fn (rows []GridRow, needle string) []string {
+		return data_grid_source_apply_query(rows, GridQueryState{
+			quick_filter: needle
+		}).map(it.id)
+	}
+	assert fetch(source, 'perth') == scan(source.rows, 'perth')
+
+	source.mutate_data(GridMutationRequest{
+		kind: .create
+		rows: [GridRow{
+			id:    'new'
+			cells: {
+				'name': 'Zelda'
+				'city': 'Perth'
+			}
+		}]
+	}) or { panic(err) }
+	source.mutate_data(GridMutationRequest{
+		kind:  .update
+		edits: [GridCellEdit{
+			row_id: 'r3'
+			col_id: 'city'
+			value:  'Lisbon'
+		}]
+	}) or { panic(err) }
+	source.mutate_data(GridMutationRequest{
+		kind:    .delete
+		row_ids: ['r7', 'r11']
+	}) or { panic(err) }
+
+	assert index.stats().updates == 3
+	assert index.rows_current(source.rows, source.version)
+	for needle in ['perth', 'lisbon', 'zelda', 'person 1'] {
+		assert fetch(source, needle) == scan(source.rows, needle)
+	}
+	assert 'new' in fetch(source, 'perth')
+	assert 'r3' !in fetch(source, 'perth')
+	assert 'r7' !in fetch(source, 'perth')
+}
+
+fn test_text_index_rebuilds_on_version_bump() {
+	mut source := InMemoryDataSource{
+		rows:       text_index_test_rows(20)
+		version:    1
+		text_index: new_grid_text_index([]string{})
+	}
+	mut index := unsafe { source.text_index }
+	assert index.rows_current(source.rows, source.version)
+	source.rows[5] = GridRow{
+		id:    'r5'
+		cells: {
+			'name': 'Zelda'
+		}
+	}
+	if _ := index.candidates('zelda', source.rows.data, source.rows.len, source.version + 1) {
+		assert false
+	}
+	source.version++
+	res := source.fetch_data(GridDataRequest{
+		grid_id: 'grid'
+		query:   GridQueryState{
+			quick_filter: 'zelda'
+		}
+		page:    GridPageRequest(GridCursorPageReq{
+			limit: 100
+		})
+	}) or { panic(err) }
+	assert res.rows.map(it.id) == ['r5']
+}
+
+fn test_list_box_source_uses_text_index() {
+	mut options := []ListBoxOption{}
+	for i in 0 .. 50 {
+		options << list_box_option('id${i}', 'Option ${i}', if i % 2 == 0 { 'even' } else { 'odd' })
+	}
+	mut index := new_grid_text_index([]string{})
+	source := InMemoryListBoxDataSource{
+		data:       options
+		text_index: index
+	}
+	for _ in 0 .. 1000 {
+		if index.options_current(options) {
+			break
+		}
+		time.sleep(2 * time.millisecond)
+	}
+	for query in ['even', 'ption 4', 'ID1', 'xyz'] {
+		res := source.fetch_data(ListBoxDataRequest{
+			query: query
+		}) or { panic(err) }
+		assert res.data.map(it.id) == list_box_source_apply_query(options, query).map(it.id)
+	}
+	assert index.stats().queries == 4
+}
@@ -886,6 +886,120 @@ fn test_data_grid_aggregate_value_numeric_ops() {
 	assert max == '25'
 }
 
+fn data_grid_aggregate_test_rows(n int) []GridRow {
+	mut rows := []GridRow{cap: n}
+	for i in 0 .. n {
+		rows << GridRow{
+			id:    '${i}'
+			cells: {
+				'score': if i % 5 == 0 { 'n/a' } else { '${(i * 37) % 101 - 40}.5' }
+			}
+		}
+	}
+	return rows
+}
+
+fn test_data_grid_aggregate_index_matches_scan() {
+	rows := data_grid_aggregate_test_rows(37)
+	mut index := DataGridAggregateIndex{}
+	index.sync(rows, ['score'], 0)
+	for op in [GridAggregateOp.sum, .avg, .min, .max] {
+		agg := GridAggregateCfg{
+			op:     op
+			col_id: 'score'
+		}
+		assert index.covers(agg)
+		for start in [0, 1, 5, 17, 36] {
+			for end in [start, start + 3, 36] {
+				if end >= rows.len {
+					continue
+				}
+				want := data_grid_aggregate_value(rows, start, end, agg) or { 'none' }
+				got := index.aggregate_value(start, end, agg) or { 'none' }
+				assert got == want
+			}
+		}
+	}
+	assert !index.covers(GridAggregateCfg{
+		op: .count
+	})
+}
+
+fn test_data_grid_aggregate_index_reparses_changed_cells() {
+	mut rows := data_grid_aggregate_test_rows(20)
+	mut index := DataGridAggregateIndex{}
+	index.sync(rows, ['score'], 0)
+	assert index.rebuilds == 1
+	rows[3] = GridRow{
+		id:    '3'
+		cells: {
+			'score': '1000'
+		}
+	}
+	index.sync(rows, ['score'], 0)
+	assert index.rebuilds == 1
+	assert index.reparsed == 1
+	max := GridAggregateCfg{
+		op:     .max
+		col_id: 'score'
+	}
+	assert index.aggregate_value(0, 19, max) or { '' } == '1000'
+	assert index.aggregate_value(4, 19, max) or { '' } == data_grid_aggregate_value(rows, 4, 19, max) or {
+		''
+	}
+	// Deleting the tail keeps the leading rows without parsing them.
+	index.sync(rows[..10], ['score'], 0)
+	assert index.rebuilds == 1
+	assert index.splices == 1
+	assert index.reparsed == 1
+	// Rows with no ids in common rebuild.
+	index.sync(data_grid_aggregate_test_rows(8).map(GridRow{
+		id:    'new-${it.id}'
+		cells: it.cells
+	}), ['score'], 0)
+	assert index.rebuilds == 2
+}
+
+fn test_data_grid_aggregate_index_splices_inserts() {
+	mut rows := data_grid_aggregate_test_rows(30)
+	mut index := DataGridAggregateIndex{}
+	index.sync(rows, ['score'], 1)
+	rows.insert(12, GridRow{
+		id:    'inserted'
+		cells: {
+			'score': '500'
+		}
+	})
+	rows.delete(25)
+	rows.delete(2)
+	index.sync(rows, ['score'], 2)
+	assert index.rebuilds == 1
+	assert index.splices == 1
+	// Only rows between the first and last change are parsed.
+	assert index.reparsed == 22
+	for op in [GridAggregateOp.sum, .min, .max] {
+		agg := GridAggregateCfg{
+			op:     op
+			col_id: 'score'
+		}
+		for start in [0, 2, 11, 12, 20] {
+			want := data_grid_aggregate_value(rows, start, rows.len - 1, agg) or { 'none' }
+			assert index.aggregate_value(start, rows.len - 1, agg) or { 'none' } == want
+		}
+	}
+	// The same version skips the sync, even for edited rows.
+	rows[0] = GridRow{
+		id:    '0'
+		cells: {
+			'score': '9999'
+		}
+	}
+	index.sync(rows, ['score'], 2)
+	assert index.reparsed == 22
+	index.sync(rows, ['score'], 3)
+	assert index.reparsed == 23
+}
+
 fn test_data_grid_next_detail_expanded_map_toggle() {
 	base := {
 		'2': true
@@ -1405,6 +1519,124 @@ fn test_data_grid_cached_presentation_invalidates_on_group_value_change() {
 	assert second_cache.signature != first_cache.signature
 }
 
+fn test_data_grid_cached_presentation_uses_rows_version() {
+	mut w := Window{}
+	cfg := DataGridCfg{
+		id:           'cache-version'
+		group_by:     ['team']
+		columns:      [
+			GridColumnCfg{
+				id:    'team'
+				title: 'Team'
+			},
+		]
+		rows:         [
+			GridRow{
+				id:    '1'
+				cells: {
+					'team': 'A'
+				}
+			},
+			GridRow{
+				id:    '2'
+				cells: {
+					'team': 'B'
+				}
+			},
+		]
+		rows_version: 1
+	}
+	first := data_grid_presentation_signature(cfg, cfg.columns, [0, 1], ['team'], ['team'])
+	// Same version: cell values are not hashed.
+	edited := DataGridCfg{
+		...cfg
+		rows: [
+			GridRow{
+				id:    '1'
+				cells: {
+					'team': 'A'
+				}
+			},
+			GridRow{
+				id:    '2'
+				cells: {
+					'team': 'A'
+				}
+			},
+		]
+	}
+	assert data_grid_presentation_signature(edited, cfg.columns, [0, 1], ['team'], ['team']) == first
+	bumped := DataGridCfg{
+		...edited
+		rows_version: 2
+	}
+	assert data_grid_presentation_signature(bumped, cfg.columns, [0, 1], ['team'], ['team']) != first
+	p := data_grid_cached_presentation(bumped, cfg.columns, []int{}, mut w)
+	assert p.rows.len == 3
+}
+
+fn test_data_grid_fnv64_indices_matches_for_same_run() {
+	run := data_grid_fnv64_indices(data_grid_fnv64_offset, [3, 4, 5])
+	assert data_grid_fnv64_indices(data_grid_fnv64_offset, [3, 4, 5]) == run
+	assert data_grid_fnv64_indices(data_grid_fnv64_offset, [4, 5, 6]) != run
+	assert data_grid_fnv64_indices(data_grid_fnv64_offset, [3, 5, 4]) != run
+	assert data_grid_fnv64_indices(data_grid_fnv64_offset, [3, 4]) != run
+}
+
+fn test_data_grid_crud_resolve_cfg_follows_rows_version() {
+	mut w := Window{}
+	cfg := DataGridCfg{
+		id:                'crud-version'
+		show_crud_toolbar: true
+		columns:           [
+			GridColumnCfg{
+				id:    'name'
+				title: 'Name'
+			},
+		]
+		rows:              [
+			GridRow{
+				id:    '1'
+				cells: {
+					'name': 'A'
+				}
+			},
+		]
+		rows_version:      1
+	}
+	first, _ := data_grid_crud_resolve_cfg(cfg, mut w)
+	assert first.rows[0].cells['name'] == 'A'
+	assert first.rows_version == 1
+	changed := DataGridCfg{
+		...cfg
+		rows: [
+			GridRow{
+				id:    '1'
+				cells: {
+					'name': 'B'
+				}
+			},
+		]
+	}
+	// Unchanged version: the working copy is kept.
+	kept, _ := data_grid_crud_resolve_cfg(changed, mut w)
+	assert kept.rows[0].cells['name'] == 'A'
+	synced, state := data_grid_crud_resolve_cfg(DataGridCfg{
+		...changed
+		rows_version: 2
+	}, mut w)
+	assert synced.rows[0].cells['name'] == 'B'
+	assert state.rows_versioned
+}
+
+fn test_data_grid_source_rows_version() {
+	assert data_grid_source_rows_version(0, 'k') == 0
+	v := data_grid_source_rows_version(7, 'k')
+	assert v != 0
+	assert data_grid_source_rows_version(7, 'other') != v
+	assert data_grid_source_rows_version(8, 'k') != v
+}
+
 fn test_data_grid_next_page_index_for_key_ctrl_page() {
 	mut e := Event{
 		modifiers: .ctrl
@@ -1,44 +1,70 @@
 module gui
 
-import os
-import time
-
-fn test_clear_view_state_clears_diagram_cache_temp_files() {
-	tmp_path := os.join_path(os.temp_dir(), 'gui_diagram_test_${time.now().unix_micro()}.png')
-	os.write_file(tmp_path, 'x') or { panic(err) }
-	defer {
-		if os.exists(tmp_path) {
-			os.rm(tmp_path) or {}
-		}
-	}
+import gg
 
+fn test_clear_view_state_clears_diagram_cache() {
 	mut w := Window{}
+	key := 'mem:math/1/1'
+	w.view_state.image_map.set_sized(key, 7, 0, 4)
+	w.view_state.image_dims[key] = [1, 1]!
 	w.view_state.diagram_cache.set(1, DiagramCacheEntry{
-		state:    .ready
-		png_path: tmp_path
+		state:     .ready
+		image_key: key
 	})
-	assert os.exists(tmp_path)
+	assert w.view_state.diagram_cache.len() == 1
 
 	w.clear_view_state()
 
-	assert !os.exists(tmp_path)
 	assert w.view_state.diagram_cache.len() == 0
+	// The diagram's texture is queued, and released by the next build.
+	assert w.view_state.image_map.release == [7]
+	w.release_evicted_textures()
+	assert w.stats.textures_released == 1
+	assert !w.view_state.image_map.contains(key)
+	assert key !in w.view_state.image_dims
+	if _ := w.load_memory_image(key) {
+		assert false, 'diagram image must be gone'
+	}
+}
+
+fn test_clear_view_state_keeps_textures_the_front_renderers_draw() {
+	mut w := Window{
+		pipeline: &LayoutPipeline{}
+	}
+	key := '/tmp/front.png'
+	w.view_state.image_map.set_sized(key, 9, 0, 4)
+	w.renderers << DrawImage{
+		img: &gg.Image{
+			id: 9
+		}
+		w:   10
+		h:   10
+	}
+
+	// update_view while the back layout is still building: the front
+	// renderers keep drawing image 9 until it is presented.
+	w.clear_view_state()
+	assert w.stats.textures_released == 0
+	assert w.view_state.image_map.release == [9]
+	assert !w.view_state.image_map.contains(key)
+
+	w.release_evicted_textures()
+	assert w.stats.textures_released == 1
+	assert w.view_state.image_map.release.len == 0
 }
 
 fn test_bounded_image_map_fifo_eviction() {
-	mut w := Window{}
-	mut ctx := w.context()
 	mut m := BoundedImageMap{
 		max_size: 2
 	}
 
-	m.set('a', 1, mut ctx)
-	m.set('b', 2, mut ctx)
+	m.set('a', 1)
+	m.set('b', 2)
 	assert m.len() == 2
 	assert m.keys() == ['a', 'b']
 
 	// Adding 'c' should evict 'a' (FIFO)
-	m.set('c', 3, mut ctx)
+	m.set('c', 3)
 	assert m.len() == 2
 	assert m.get('a') == none
 	assert m.get('b') or { -1 } == 2
@@ -48,11 +74,62 @@ fn test_bounded_image_map_fifo_eviction() {
 	// Deleting 'b' and adding 'd'
 	m.delete('b')
 	assert m.len() == 1
-	m.set('d', 4, mut ctx)
+	m.set('d', 4)
 	assert m.len() == 2
 	assert m.keys() == ['c', 'd']
 }
 
+fn test_bounded_image_map_byte_budget_evicts_lru() {
+	mut m := BoundedImageMap{
+		max_size:      10
+		max_gpu_bytes: 300
+	}
+
+	m.set_sized('a', 1, 0, 100)
+	m.set_sized('b', 2, 0, 100)
+	m.set_sized('c', 3, 0, 100)
+	assert m.gpu_bytes == 300
+	// Touching 'a' makes 'b' the least recently used entry.
+	m.touch('a')
+	m.set_sized('d', 4, 0, 100)
+	assert m.get('b') == none
+	assert m.get('a') or { -1 } == 1
+	assert m.gpu_bytes == 300
+	assert m.evicted == [2]
+	// The texture outlives the eviction until renderers are rebuilt.
+	assert m.release == [2]
+	assert m.evictions == 1
+	assert m.hits == 1
+}
+
+fn test_bounded_image_map_cpu_budget_tracked_separately() {
+	mut m := BoundedImageMap{
+		max_cpu_bytes: 150
+	}
+
+	m.set_sized('a', 1, 100, 100)
+	m.set_sized('b', 2, 0, 100)
+	assert m.len() == 2
+	m.set_sized('c', 3, 100, 100)
+	assert m.get('a') == none
+	assert m.cpu_bytes == 100
+	assert m.gpu_bytes == 200
+	m.delete('c')
+	assert m.cpu_bytes == 0
+	assert m.gpu_bytes == 100
+}
+
+fn test_image_mip_level_covers_target() {
+	assert image_mip_level(4000, 3000, 64, 64) == 5
+	assert image_mip_level(4000, 3000, 4000, 3000) == 0
+	assert image_mip_level(4000, 3000, 0, 64) == 0
+	assert image_mip_level(1024, 1024, 500, 500) == 1
+	assert image_mip_level(1 << 20, 1 << 20, 1, 1) == image_max_mip_levels
+	w, h := image_mip_size(4000, 3000, 5)
+	assert w == 125
+	assert h == 93
+}
+
 fn test_state_registry_clear_drops_maps() {
 	mut w := Window{}
 	_ = state_map[string, int](mut w, 'test.a', 10)
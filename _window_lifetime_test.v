@@ -896,7 +896,8 @@ fn start_lifetime_math_oversized_fetch(mut w Window) {
 		request_id: request_id
 	})
 	w.layout_callback_lifetime.lifetime.frame(fn [mut w, latex, request_id] () {
-		fetch_math_async(mut w, latex, lifetime_math_hash, request_id, 120, rgba(0, 0, 0, 255))
+		fetch_math_async(mut w, latex, lifetime_math_hash, request_id, 120, rgba(0, 0, 0, 255),
+			markdown_default_math_endpoint)
 	}) or { panic(err) }
 }
 
@@ -908,7 +909,8 @@ fn start_lifetime_mermaid_oversized_fetch(mut w Window) {
 		request_id: request_id
 	})
 	w.layout_callback_lifetime.lifetime.frame(fn [mut w, source, request_id] () {
-		fetch_mermaid_async(mut w, source, lifetime_mermaid_hash, request_id, 100, 255, 255, 255)
+		fetch_mermaid_async(mut w, source, lifetime_mermaid_hash, request_id, 100, 255, 255, 255,
+			markdown_default_mermaid_endpoint)
 	}) or { panic(err) }
 }
 
@@ -1,8 +1,11 @@
 module gui
 
+import time
+
 struct QueueTestState {
 mut:
 	count int
+	log   []string
 }
 
 fn test_flush_commands_runs_all_and_clears() {
@@ -10,25 +13,116 @@ fn test_flush_commands_runs_all_and_clears() {
 	mut w := Window{
 		state: state
 	}
-	w.commands_mutex.lock()
-	w.commands << fn (mut win Window) {
+	w.commands.push(fn (mut win Window) {
 		mut s := win.state[QueueTestState]()
 		s.count++
-	}
-	w.commands << fn (mut win Window) {
+	}, '')
+	w.commands.push(fn (mut win Window) {
 		mut s := win.state[QueueTestState]()
 		s.count++
-	}
-	w.commands_mutex.unlock()
+	}, '')
 
 	w.flush_commands()
 
 	assert state.count == 2
-	assert w.commands.len == 0
+	assert w.commands.depth() == 0
+	assert w.command_queue_stats().executed == 2
 }
 
 fn test_flush_commands_empty_queue_is_noop() {
 	mut w := Window{}
 	w.flush_commands()
-	assert w.commands.len == 0
+	assert w.commands.depth() == 0
+}
+
+fn queue_test_log(msg string) WindowCommand {
+	return fn [msg] (mut win Window) {
+		mut s := win.state[QueueTestState]()
+		s.log << msg
+	}
+}
+
+fn test_command_queue_overflow_keeps_order() {
+	mut state := &QueueTestState{}
+	mut w := Window{
+		state:    state
+		commands: new_command_queue(4)
+	}
+	for i in 0 .. 10 {
+		w.commands.push(queue_test_log('${i}'), '')
+	}
+	assert w.commands.depth() == 10
+	w.flush_commands()
+	assert state.log == ['0', '1', '2', '3', '4', '5', '6', '7', '8', '9']
+	assert w.command_queue_stats().overflowed == 6
+
+	// The ring is usable again once overflow drains.
+	w.commands.push(queue_test_log('a'), '')
+	w.flush_commands()
+	assert state.log.last() == 'a'
+}
+
+fn test_command_queue_overflow_waits_for_earlier_claims() {
+	mut state := &QueueTestState{}
+	mut w := Window{
+		state:    state
+		commands: new_command_queue(4)
+	}
+	// Q claims a slot and has not filled it yet.
+	q_pos := w.commands.claim() or { panic('ring full') }
+	// P fills the rest of the ring, then overflows.
+	w.commands.push(queue_test_log('p1'), '')
+	w.commands.push(queue_test_log('p2'), '')
+	w.commands.push(queue_test_log('p3'), '')
+	w.commands.push(queue_test_log('p4'), '')
+	assert w.command_queue_stats().overflowed == 1
+	// Nothing runs ahead of Q's slot, and p4 does not pass p1..p3.
+	w.flush_commands()
+	assert state.log.len == 0
+	w.commands.publish(q_pos, queue_test_log('q'), '', time.sys_mono_now())
+	w.flush_commands()
+	assert state.log == ['q', 'p1', 'p2', 'p3', 'p4']
+	assert w.commands.depth() == 0
+}
+
+fn test_command_queue_coalesces_keyed_commands() {
+	mut state := &QueueTestState{}
+	mut w := Window{
+		state: state
+	}
+	w.commands.push(queue_test_log('grid 1'), 'grid')
+	w.commands.push(queue_test_log('plain'), '')
+	w.commands.push(queue_test_log('grid 2'), 'grid')
+	w.commands.push(queue_test_log('list 1'), 'list')
+	w.flush_commands()
+	assert state.log == ['plain', 'grid 2', 'list 1']
+	stats := w.command_queue_stats()
+	assert stats.coalesced == 1
+	assert stats.executed == 3
+	assert stats.max_depth == 4
+}
+
+fn test_command_queue_concurrent_producers() {
+	mut state := &QueueTestState{}
+	mut w := &Window{
+		state:    state
+		commands: new_command_queue(64)
+	}
+	mut threads := []thread{}
+	for _ in 0 .. 4 {
+		threads << spawn fn (mut q CommandQueue) {
+			for _ in 0 .. 500 {
+				q.push(fn (mut win Window) {
+					mut s := win.state[QueueTestState]()
+					s.count++
+				}, '')
+			}
+		}(mut w.commands)
+	}
+	for _ in 0 .. 50 {
+		w.flush_commands()
+	}
+	threads.wait()
+	w.flush_commands()
+	assert state.count == 2000
 }
@@ -1,5 +1,7 @@
 module gui
 
+import gg
+
 fn test_mark_layout_refresh_clears_render_only() {
 	mut w := Window{
 		refresh_render_only: true
@@ -35,9 +37,25 @@ fn test_max_animation_refresh_kind_prefers_render_only_over_none() {
 	assert kind == .render_only
 }
 
-fn test_blink_cursor_animation_refresh_kind_is_render_only() {
+fn test_max_animation_refresh_kind_prefers_render_only_over_overlay() {
+	assert max_animation_refresh_kind(.overlay, .render_only) == .render_only
+	assert max_animation_refresh_kind(.none, .overlay) == .overlay
+}
+
+fn test_mark_overlay_refresh_skips_when_renderers_pending() {
+	mut w := Window{}
+	w.mark_overlay_refresh()
+	assert w.refresh_overlay
+	w.mark_render_only_refresh()
+	assert w.refresh_render_only
+	assert !w.refresh_overlay
+	w.mark_overlay_refresh()
+	assert !w.refresh_overlay
+}
+
+fn test_blink_cursor_animation_refresh_kind_is_overlay() {
 	a := BlinkCursorAnimation{}
-	assert a.refresh_kind() == .render_only
+	assert a.refresh_kind() == .overlay
 }
 
 fn test_animate_refresh_kind_is_layout() {
@@ -47,3 +65,105 @@ fn test_animate_refresh_kind_is_layout() {
 	}
 	assert a.refresh_kind() == .layout
 }
+
+fn test_layout_pipeline_request_coalesces() {
+	mut p := &LayoutPipeline{}
+	p.request()
+	p.request()
+	assert p.wake.len == 1
+}
+
+fn test_pipelined_event_defers_while_gate_held() {
+	mut w := Window{
+		pipeline: &LayoutPipeline{}
+	}
+	w.pipeline.gate.lock()
+	w.pipelined_event(&gg.Event{
+		typ: .mouse_move
+	})
+	w.pipeline.gate.unlock()
+	assert w.pipeline.deferred_events.len == 1
+}
+
+fn test_set_event_refresh_keeps_strongest() {
+	mut w := Window{}
+	w.set_event_refresh(.render_only)
+	w.set_event_refresh(.none)
+	assert w.event_refresh == .render_only
+	w.set_event_refresh(.layout)
+	assert w.event_refresh == .layout
+}
+
+fn test_layout_hover_signature_tracks_hover_shapes() {
+	layout := Layout{
+		shape:    &Shape{}
+		children: [
+			Layout{
+				shape: &Shape{
+					shape_clip: DrawClip{
+						x:      0
+						y:      0
+						width:  10
+						height: 10
+					}
+					events:     &EventHandlers{
+						on_hover: fn (mut _ Layout, mut _ Event, mut _ Window) {}
+					}
+				}
+			},
+			Layout{
+				shape: &Shape{
+					shape_clip: DrawClip{
+						x:      10
+						y:      0
+						width:  10
+						height: 10
+					}
+				}
+			},
+		]
+	}
+	outside := layout_hover_signature(&layout, 30, 5)
+	// Shapes without hover handlers do not count.
+	assert layout_hover_signature(&layout, 15, 5) == outside
+	assert layout_hover_signature(&layout, 5, 5) != outside
+	assert layout_hover_signature(&layout, 5, 5) == layout_hover_signature(&layout, 2, 8)
+}
+
+fn test_layout_hover_signature_tracks_markdown_copy_button() {
+	mut w := Window{}
+	mut view := render_md_code(MarkdownBlock{
+		content: RichText{
+			runs: [RichTextRun{
+				text: 'println(1)'
+			}]
+		}
+	}, 0, MarkdownCfg{}, &w)
+	// Container layouts only; the code text needs a text system.
+	mut block := view.generate_layout(mut w)
+	block.shape.shape_clip = DrawClip{
+		x:      0
+		y:      0
+		width:  200
+		height: 60
+	}
+	// The copy button floats at the top right and styles itself from
+	// amend_layout when the pointer is anywhere over the code block.
+	mut button := view.content[1].generate_layout(mut w)
+	assert button.shape.has_events()
+	assert button.shape.events.amend_layout != unsafe { nil }
+	button.shape.shape_clip = DrawClip{
+		x:      170
+		y:      6
+		width:  24
+		height: 24
+	}
+	button.parent = &block
+	root := Layout{
+		shape:    &Shape{}
+		children: [block, button]
+	}
+	outside := layout_hover_signature(&root, 300, 100)
+	assert layout_hover_signature(&root, 20, 40) != outside
+	assert layout_hover_signature(&root, 20, 40) == layout_hover_signature(&root, 100, 50)
+}
@@ -0,0 +1,144 @@
+module gui
+
+import time
+
+@[heap]
+struct WorkerPoolTestLog {
+mut:
+	lines []string
+}
+
+fn worker_pool_test_item(priority WorkPriority, msg string, mut out WorkerPoolTestLog) WorkItem {
+	return WorkItem{
+		priority: priority
+		run:      fn [msg, mut out] (mut _ Window) {
+			out.lines << msg
+		}
+	}
+}
+
+fn test_worker_pool_take_orders_by_priority() {
+	mut out := &WorkerPoolTestLog{}
+	mut pool := &WorkerPool{
+		queues: [][]WorkItem{len: 3}
+	}
+	pool.submit(worker_pool_test_item(.background, 'decode', mut out))
+	pool.submit(worker_pool_test_item(.prefetch, 'prefetch', mut out))
+	pool.submit(worker_pool_test_item(.interactive, 'fetch 1', mut out))
+	pool.submit(worker_pool_test_item(.interactive, 'fetch 2', mut out))
+	mut w := Window{}
+	for {
+		item := pool.take() or { break }
+		item.run(mut w)
+	}
+	assert out.lines == ['fetch 1', 'fetch 2', 'prefetch', 'decode']
+}
+
+fn test_worker_pool_skips_aborted_work() {
+	mut w := &Window{}
+	mut pool := new_worker_pool(mut w, 1)
+	mut controller := new_grid_abort_controller()
+	controller.abort()
+	ran := chan string{cap: 2}
+	pool.submit(WorkItem{
+		signal:    controller.signal
+		on_cancel: fn [ran] (mut _ Window) {
+			ran <- 'cancelled'
+		}
+		run:       fn [ran] (mut _ Window) {
+			ran <- 'ran'
+		}
+	})
+	pool.submit(WorkItem{
+		run: fn [ran] (mut _ Window) {
+			ran <- 'ran'
+		}
+	})
+	mut got := []string{}
+	for _ in 0 .. 2 {
+		select {
+			msg := <-ran {
+				got << msg
+			}
+			time.second {}
+		}
+	}
+	pool.close()
+	assert got == ['cancelled', 'ran']
+	assert pool.stats().cancelled == 1
+	assert pool.stats().submitted == 2
+}
+
+fn test_worker_pool_reserves_a_worker_for_interactive_work() {
+	mut out := &WorkerPoolTestLog{}
+	mut pool := &WorkerPool{
+		queues:  [][]WorkItem{len: 3}
+		threads: 2
+		low:     1 // one prefetch already running
+	}
+	pool.submit(worker_pool_test_item(.prefetch, 'prefetch', mut out))
+	assert pool.take() == none
+	pool.submit(worker_pool_test_item(.interactive, 'fetch', mut out))
+	mut w := Window{}
+	item := pool.take() or { panic('interactive item held back') }
+	item.run(mut w)
+	assert out.lines == ['fetch']
+	pool.low = 0
+	next := pool.take() or { panic('prefetch not released') }
+	next.run(mut w)
+	assert out.lines == ['fetch', 'prefetch']
+}
+
+fn test_worker_pool_close_cancels_queued_work() {
+	mut w := &Window{}
+	mut pool := &WorkerPool{
+		window: w
+		queues: [][]WorkItem{len: 3}
+	}
+	mut out := &WorkerPoolTestLog{}
+	pool.submit(WorkItem{
+		priority:  .background
+		on_cancel: fn [mut out] (mut _ Window) {
+			out.lines << 'released'
+		}
+		run:       fn [mut out] (mut _ Window) {
+			out.lines << 'ran'
+		}
+	})
+	pool.close()
+	assert out.lines == ['released']
+	assert pool.stats().cancelled == 1
+}
+
+fn test_fetch_queue_caps_running_jobs_across_clear_view_state() {
+	mut w := &Window{
+		image_downloads: &FetchQueue{
+			max_running: 2
+		}
+	}
+	q := w.image_downloads
+	gate := chan bool{cap: 3}
+	ran := chan int{cap: 3}
+	for i in 0 .. 3 {
+		fetch_queue_push(q, fn [gate, ran, i] (mut _ Window) {
+			_ := <-gate
+			ran <- i
+		}, mut w)
+	}
+	assert q.running == 2
+	assert q.queued.len == 1
+	w.clear_view_state()
+	for _ in 0 .. 3 {
+		gate <- true
+	}
+	for _ in 0 .. 100 {
+		if q.running == 0 && q.queued.len == 0 {
+			break
+		}
+		time.sleep(10 * time.millisecond)
+		w.flush_commands()
+	}
+	assert q.running == 0
+	assert q.queued.len == 0
+	assert ran.len == 3
+}
@@ -252,6 +252,15 @@ fn window_cleanup(user_data voidptr) {
 		layout_clear(mut w.layout)
 		array_clear(mut w.renderers)
 		w.release_all_file_access()
+		w.close_layout_pipeline()
+		w.close_image_decoder()
+		w.close_live_inboxes()
+		if w.workers != unsafe { nil } {
+			w.workers.close()
+		}
+		// Dropped work queues its pin releases; run them before dispose.
+		w.flush_commands()
+		w.animation_wake.close()
 		w.dispose_layout_callbacks()
 	}
 	nativebridge.a11y_destroy()
@@ -4,16 +4,31 @@ module gui
 // (one-shot or repeating callback) and BlinkCursorAnimation (cursor blink).
 // The animation loop runs in a goroutine and fires refresh_layout or
 // refresh_render_only depending on each animation's refresh_kind(). The
-// blink cursor uses render_only; Animate (which changes app state) uses layout.
+// blink cursor uses overlay (caret renderers only); Animate (which changes
+// app state) uses layout.
+//
+// The loop is event driven. With no animations it parks on
+// animation_wake until animation_add signals it. Otherwise it sleeps
+// until the earliest animation is due (a pending delay, or the next
+// display frame for running animations), on monotonic deadlines spaced
+// by the measured display frame period, so 120/144 Hz displays tick at
+// their native rate and ticks do not drift. Springs integrate the real
+// elapsed time since the previous tick.
+import math
+import sokol.sapp
 import time
 
-const animation_cycle = 16 * time.millisecond
+const animation_cycle = 16 * time.millisecond // fallback frame period
+const animation_min_period = time.second / 240
+const animation_max_period = time.second / 30
+const animation_max_dt = f32(0.05) // clamps dt after stalls so springs don't jump
 const animation_delay = 500 * time.millisecond
 const blink_cursor_animation_id = '___blinky_cursor_animation___'
 const blink_cursor_animation_delay = 600 * time.millisecond
 
 enum AnimationRefreshKind as u8 {
 	none
+	overlay
 	render_only
 	layout
 }
@@ -56,7 +71,7 @@ mut:
 }
 
 fn (_ BlinkCursorAnimation) refresh_kind() AnimationRefreshKind {
-	return .render_only
+	return .overlay
 }
 
 // animation_add registers a new animation to the window's animation queue.
@@ -69,6 +84,40 @@ pub fn (mut window Window) animation_add(mut animation Animation) {
 	}
 	animation.start = time.now()
 	window.animations[animation.id] = animation
+	window.animation_batch.dirty = true
+	// Tweens, springs and keyframes also go into the batched store,
+	// which is what animation_loop advances (see animation_batch.v).
+	now := i64(time.sys_mono_now())
+	match mut animation {
+		TweenAnimation {
+			window.animation_batch.add_tween(animation, now)
+		}
+		SpringAnimation {
+			if !window.animation_batch.add_spring(animation, now) {
+				window.animations.delete(animation.id)
+				return
+			}
+		}
+		KeyframeAnimation {
+			window.animation_batch.add_keyframe(animation, now)
+		}
+		else {
+			window.animation_batch.remove(animation.id)
+		}
+	}
+	window.animation_wake_up()
+}
+
+// animation_wake_up unparks the animation loop. Never blocks; a wakeup
+// already pending is enough.
+fn (mut window Window) animation_wake_up() {
+	if window.animation_wake.closed {
+		return
+	}
+	select {
+		window.animation_wake <- true {}
+		else {}
+	}
 }
 
 // animation_add_from_layout runs animation construction outside transient layout
@@ -83,28 +132,94 @@ pub fn (window &Window) has_animation(id string) bool {
 	return id in window.animations
 }
 
+// retarget_spring redirects the running spring animation id toward
+// `to`, keeping its position and velocity. Returns false when no spring
+// with that id is running.
+pub fn (mut window Window) retarget_spring(id string, to f32) bool {
+	window.lock()
+	defer { window.unlock() }
+	mut entry := window.animations[id] or { return false }
+	if mut entry is SpringAnimation {
+		window.animation_batch.retarget_spring(id, mut entry, to)
+		return true
+	}
+	return false
+}
+
 // remove_animation stops and removes an animation by id.
 pub fn (mut window Window) remove_animation(id string) {
 	window.lock()
 	defer { window.unlock() }
 	window.animations.delete(id)
+	window.animation_batch.remove(id)
+	window.animation_batch.dirty = true
 }
 
 fn (mut window Window) animation_loop() {
-	// dt in seconds for spring physics
-	dt := f32(animation_cycle) / f32(time.second)
 	// Pre-allocate and reuse across ticks to avoid per-tick allocs.
 	mut deferred := []AnimationCallback{cap: 4}
 	mut stopped_ids := []string{cap: 4}
+	mut batch_out := AnimationBatchOutput{}
+	mut last_tick := i64(time.sys_mono_now())
 
 	for {
-		time.sleep(animation_cycle)
+		if window.animation_wake.closed {
+			return
+		}
+		period := animation_frame_period(sapp.frame_duration())
+		window.lock()
+		count := window.animations.len
+		window.animation_batch.sync(window.animations)
+		unbatched_wait := animation_next_wait(window.animations, window.animation_batch.unbatched)
+		batched_wait := window.animation_batch.next_wait(i64(time.sys_mono_now()))
+		wait := time.Duration(math.min(i64(unbatched_wait), i64(batched_wait)))
+		window.unlock()
+		if count == 0 {
+			// Park until animation_add; a closed channel ends the loop.
+			_ := <-window.animation_wake or { return }
+			last_tick = i64(time.sys_mono_now()) - i64(period)
+			continue
+		}
+		now := i64(time.sys_mono_now())
+		// Next frame boundary on the tick grid; resync after a stall.
+		mut deadline := last_tick + i64(period)
+		if deadline < now - i64(period) {
+			deadline = now
+		}
+		deadline = math.max(deadline, now + i64(wait))
+		if deadline > now {
+			mut woken := false
+			select {
+				_ := <-window.animation_wake {
+					woken = true
+				}
+				time.Duration(deadline - now) {}
+			}
+			if woken {
+				// New animation (or shutdown): re-evaluate what is due.
+				continue
+			}
+		}
+		tick := i64(time.sys_mono_now())
+		dt := animation_tick_dt(tick - last_tick)
+		last_tick = math.max(deadline, tick - i64(period))
+
 		mut refresh_kind := AnimationRefreshKind.none
 		array_clear(mut deferred)
 		array_clear(mut stopped_ids)
+		batch_out.reset()
 		//--------------------------------------------
 		window.lock()
-		for _, mut animation in window.animations {
+		window.animation_batch.sync(window.animations)
+		window.animation_batch.tick(tick, dt, mut batch_out)
+		if !batch_out.is_empty() {
+			refresh_kind = .layout
+		}
+		for id in batch_out.stopped {
+			window.animations.delete(id)
+		}
+		for id, _ in window.animation_batch.unbatched {
+			mut animation := window.animations[id] or { continue }
 			match mut animation {
 				Animate {
 					if update_animate(mut animation, mut window, mut deferred) {
@@ -118,17 +233,9 @@ fn (mut window Window) animation_loop() {
 							animation.refresh_kind())
 					}
 				}
-				TweenAnimation {
-					if update_tween(mut animation, mut window, mut deferred) {
-						refresh_kind = max_animation_refresh_kind(refresh_kind,
-							animation.refresh_kind())
-					}
-				}
-				SpringAnimation {
-					if update_spring(mut animation, mut window, dt, mut deferred) {
-						refresh_kind = max_animation_refresh_kind(refresh_kind,
-							animation.refresh_kind())
-					}
+				TweenAnimation, SpringAnimation, KeyframeAnimation {
+					// Advanced by animation_batch.tick above.
+					continue
 				}
 				LayoutTransition {
 					if update_layout_transition(mut animation, mut window, mut deferred) {
@@ -142,12 +249,6 @@ fn (mut window Window) animation_loop() {
 							animation.refresh_kind())
 					}
 				}
-				KeyframeAnimation {
-					if update_keyframe(mut animation, mut window, mut deferred) {
-						refresh_kind = max_animation_refresh_kind(refresh_kind,
-							animation.refresh_kind())
-					}
-				}
 				else {}
 			}
 
@@ -157,14 +258,21 @@ fn (mut window Window) animation_loop() {
 		}
 		for id in stopped_ids {
 			window.animations.delete(id)
+			window.animation_batch.unbatched.delete(id)
 		}
 		window.unlock()
 		//--------------------------------------------
 		// Queue deferred callbacks to be executed on the main thread
+		if !batch_out.is_empty() {
+			window.queue_command(batch_out.command())
+		}
 		for cb in deferred {
 			window.queue_command(cb)
 		}
 		match refresh_kind {
+			.overlay {
+				window.request_overlay_only()
+			}
 			.render_only {
 				window.request_render_only()
 			}
@@ -176,6 +284,55 @@ fn (mut window Window) animation_loop() {
 	}
 }
 
+// animation_frame_period converts sapp's smoothed frame duration
+// (seconds) into the tick period, clamped to sane display rates.
+fn animation_frame_period(frame_duration f64) time.Duration {
+	if frame_duration <= 0 {
+		return animation_cycle
+	}
+	period := time.Duration(i64(frame_duration * f64(time.second)))
+	if period < animation_min_period {
+		return animation_min_period
+	}
+	if period > animation_max_period {
+		return animation_max_period
+	}
+	return period
+}
+
+// animation_next_wait returns how long until the earliest of the ids in
+// animations is due. Running animations are due now; delayed ones
+// (Animate, cursor blink) when their delay elapses. The loop passes
+// only unbatched ids; AnimationBatch.next_wait covers the rest.
+fn animation_next_wait(animations map[string]Animation, ids map[string]bool) time.Duration {
+	mut wait := time.Duration(max_i64)
+	now := time.now()
+	for id, _ in ids {
+		animation := animations[id] or { continue }
+		if animation.stopped {
+			return 0
+		}
+		remaining := animation.delay - (now - animation.start)
+		if remaining <= 0 {
+			return 0
+		}
+		if remaining < wait {
+			wait = remaining
+		}
+	}
+	return wait
+}
+
+// animation_tick_dt converts elapsed nanoseconds between ticks into
+// seconds for physics integration.
+fn animation_tick_dt(elapsed_ns i64) f32 {
+	dt := f32(f64(elapsed_ns) / f64(time.second))
+	if dt <= 0 {
+		return f32(animation_cycle) / f32(time.second)
+	}
+	return f32_min(dt, animation_max_dt)
+}
+
 fn max_animation_refresh_kind(current AnimationRefreshKind, incoming AnimationRefreshKind) AnimationRefreshKind {
 	if current == .layout || incoming == .layout {
 		return .layout
@@ -183,6 +340,9 @@ fn max_animation_refresh_kind(current AnimationRefreshKind, incoming AnimationRe
 	if current == .render_only || incoming == .render_only {
 		return .render_only
 	}
+	if current == .overlay || incoming == .overlay {
+		return .overlay
+	}
 	return .none
 }
 
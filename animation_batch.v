@@ -0,0 +1,502 @@
+module gui
+
+// animation_batch.v integrates tweens, springs and keyframes in
+// struct-of-arrays form. window.animations stays the source of truth
+// (ids, has_animation, lookups); these three kinds are also copied into
+// the window's AnimationBatch, and animation_loop advances them here
+// instead of through the per-animation interface match. animation_add
+// and remove_animation mark the batch dirty, and only then does the
+// next tick sync it with the map: ids that left it, or now hold another
+// kind, are dropped, and the entries the batch does not hold are listed
+// in unbatched, which is all the loop walks. Spring motion lives in the
+// batch; map entries are not written back each tick, so
+// retarget_spring copies the live state into the entry as it changes
+// the target. Timing, interpolation and spring physics loop over
+// contiguous f32 arrays, but easing functions and keyframe lookup are
+// still called per animation; the saving is the interface dispatch and
+// the per-animation closures. Each tick delivers every on_value result
+// in one queued command. Removal is swap-remove, so order is not
+// preserved.
+import math
+import time
+
+// AnimationBatchSlot locates an id inside one of the batches.
+struct AnimationBatchSlot {
+	kind  AnimationBatchKind
+	index int
+}
+
+enum AnimationBatchKind as u8 {
+	tween
+	spring
+	keyframe
+}
+
+// AnimationBatchOutput collects one tick's results. on_value[i] is
+// called with values[i]; on_done callbacks run after all values.
+struct AnimationBatchOutput {
+mut:
+	on_value []fn (f32, mut Window)
+	values   []f32
+	on_done  []fn (mut Window)
+	stopped  []string
+}
+
+fn (mut out AnimationBatchOutput) reset() {
+	array_clear(mut out.on_value)
+	array_clear(mut out.values)
+	array_clear(mut out.on_done)
+	array_clear(mut out.stopped)
+}
+
+fn (out &AnimationBatchOutput) is_empty() bool {
+	return out.values.len == 0 && out.on_done.len == 0
+}
+
+// command packages the results for the main thread. Arrays are cloned
+// because the output buffers are reused on the next tick.
+fn (out &AnimationBatchOutput) command() AnimationCallback {
+	on_value := out.on_value.clone()
+	values := out.values.clone()
+	on_done := out.on_done.clone()
+	return fn [on_value, values, on_done] (mut w Window) {
+		for i, cb in on_value {
+			cb(values[i], mut w)
+		}
+		for cb in on_done {
+			cb(mut w)
+		}
+	}
+}
+
+struct TweenBatch {
+mut:
+	ids          []string
+	from         []f32
+	to           []f32
+	start        []i64 // monotonic ns when motion begins (delay included)
+	inv_duration []f32 // 1 / duration in ns
+	easing       []EasingFn
+	on_value     []fn (f32, mut Window)
+	on_done      []fn (mut Window)
+	t            []f32 // scratch: normalized time
+	eased        []f32 // scratch: eased progress
+	values       []f32 // scratch: interpolated values
+}
+
+struct SpringBatch {
+mut:
+	ids       []string
+	position  []f32
+	velocity  []f32
+	target    []f32
+	stiffness []f32
+	damping   []f32
+	inv_mass  []f32
+	threshold []f32
+	start     []i64 // monotonic ns when motion begins (delay included)
+	on_value  []fn (f32, mut Window)
+	on_done   []fn (mut Window)
+	active    []f32 // scratch: 1 once started, else 0
+}
+
+struct KeyframeBatch {
+mut:
+	ids          []string
+	keyframes    [][]Keyframe
+	start        []i64 // monotonic ns when motion begins (delay included)
+	inv_duration []f32
+	repeat       []bool
+	on_value     []fn (f32, mut Window)
+	on_done      []fn (mut Window)
+	t            []f32 // scratch: normalized time
+}
+
+// AnimationBatch owns the batched animations of one window. Guarded by
+// the window lock like window.animations.
+struct AnimationBatch {
+mut:
+	slots     map[string]AnimationBatchSlot
+	unbatched map[string]bool // ids of map entries the batch does not hold
+	dirty     bool            // map changed since the last sync
+	tweens    TweenBatch
+	springs   SpringBatch
+	keyframes KeyframeBatch
+}
+
+// len returns the number of batched animations.
+fn (b &AnimationBatch) len() int {
+	return b.slots.len
+}
+
+@[inline]
+fn animation_batch_start(now i64, delay time.Duration) i64 {
+	return now + i64(delay)
+}
+
+@[inline]
+fn animation_batch_inv_duration(duration time.Duration) f32 {
+	return if duration > 0 { f32(1.0 / f64(duration)) } else { f32(max_f32) }
+}
+
+// add_tween inserts or replaces a tween. now is time.sys_mono_now().
+fn (mut b AnimationBatch) add_tween(tw TweenAnimation, now i64) {
+	b.remove(tw.id)
+	b.slots[tw.id] = AnimationBatchSlot{
+		kind:  .tween
+		index: b.tweens.ids.len
+	}
+	b.tweens.ids << tw.id
+	b.tweens.from << tw.from
+	b.tweens.to << tw.to
+	b.tweens.start << animation_batch_start(now, tw.delay)
+	b.tweens.inv_duration << animation_batch_inv_duration(tw.duration)
+	b.tweens.easing << tw.easing
+	b.tweens.on_value << tw.on_value
+	b.tweens.on_done << tw.on_done
+	b.tweens.t << 0
+	b.tweens.eased << 0
+	b.tweens.values << 0
+}
+
+// add_spring inserts or replaces a spring, starting from its current
+// state. Returns false for a spring already at rest, which has nothing
+// to animate.
+fn (mut b AnimationBatch) add_spring(sp SpringAnimation, now i64) bool {
+	b.remove(sp.id)
+	if sp.stopped || sp.state.at_rest {
+		return false
+	}
+	b.slots[sp.id] = AnimationBatchSlot{
+		kind:  .spring
+		index: b.springs.ids.len
+	}
+	b.springs.ids << sp.id
+	b.springs.position << sp.state.position
+	b.springs.velocity << sp.state.velocity
+	b.springs.target << sp.state.target
+	b.springs.stiffness << sp.config.stiffness
+	b.springs.damping << sp.config.damping
+	b.springs.inv_mass << if sp.config.mass > 0 { 1 / sp.config.mass } else { f32(1) }
+	b.springs.threshold << sp.config.threshold
+	b.springs.start << animation_batch_start(now, sp.delay)
+	b.springs.on_value << sp.on_value
+	b.springs.on_done << sp.on_done
+	b.springs.active << 0
+	return true
+}
+
+// add_keyframe inserts or replaces a keyframe animation.
+fn (mut b AnimationBatch) add_keyframe(kf KeyframeAnimation, now i64) {
+	b.remove(kf.id)
+	b.slots[kf.id] = AnimationBatchSlot{
+		kind:  .keyframe
+		index: b.keyframes.ids.len
+	}
+	b.keyframes.ids << kf.id
+	b.keyframes.keyframes << kf.keyframes
+	b.keyframes.start << animation_batch_start(now, kf.delay)
+	b.keyframes.inv_duration << animation_batch_inv_duration(kf.duration)
+	b.keyframes.repeat << kf.repeat
+	b.keyframes.on_value << kf.on_value
+	b.keyframes.on_done << kf.on_done
+	b.keyframes.t << 0
+}
+
+// remove drops id from whichever batch holds it.
+fn (mut b AnimationBatch) remove(id string) {
+	slot := b.slots[id] or { return }
+	b.slots.delete(id)
+	moved := match slot.kind {
+		.tween { b.tweens.swap_remove(slot.index) }
+		.spring { b.springs.swap_remove(slot.index) }
+		.keyframe { b.keyframes.swap_remove(slot.index) }
+	}
+	if moved.len > 0 {
+		b.slots[moved] = slot
+	}
+}
+
+// sync reconciles the batch with animations once animation_add or
+// remove_animation marked it dirty; otherwise it does nothing. Batched
+// ids that are no longer in the map, or whose entry is now another
+// kind or a stopped spring, are dropped, and unbatched is rebuilt from
+// the remaining entries.
+fn (mut b AnimationBatch) sync(animations map[string]Animation) {
+	if !b.dirty {
+		return
+	}
+	b.dirty = false
+	mut gone := []string{}
+	for id, slot in b.slots {
+		entry := animations[id] or {
+			gone << id
+			continue
+		}
+		kept := match entry {
+			TweenAnimation { slot.kind == .tween }
+			KeyframeAnimation { slot.kind == .keyframe }
+			SpringAnimation { slot.kind == .spring && !entry.stopped }
+			else { false }
+		}
+		if !kept {
+			gone << id
+		}
+	}
+	for id in gone {
+		b.remove(id)
+	}
+	b.unbatched.clear()
+	for id, _ in animations {
+		if id !in b.slots {
+			b.unbatched[id] = true
+		}
+	}
+}
+
+// retarget_spring points the batched spring id at to, keeping its
+// motion, and writes its live position and velocity into sp, the map
+// entry, which the tick does not keep current.
+fn (mut b AnimationBatch) retarget_spring(id string, mut sp SpringAnimation, to f32) {
+	slot := b.slots[id] or {
+		sp.retarget(to)
+		return
+	}
+	if slot.kind == .spring {
+		sp.state.position = b.springs.position[slot.index]
+		sp.state.velocity = b.springs.velocity[slot.index]
+		b.springs.target[slot.index] = to
+	}
+	sp.retarget(to)
+}
+
+// clear drops every batched animation.
+fn (mut b AnimationBatch) clear() {
+	b.slots.clear()
+	b.unbatched.clear()
+	b.dirty = true
+	b.tweens = TweenBatch{}
+	b.springs = SpringBatch{}
+	b.keyframes = KeyframeBatch{}
+}
+
+// next_wait returns how long until the earliest batched animation
+// starts moving; 0 when one already is.
+fn (b &AnimationBatch) next_wait(now i64) time.Duration {
+	mut earliest := i64(max_i64)
+	for start in b.tweens.start {
+		earliest = math.min(earliest, start)
+	}
+	for start in b.springs.start {
+		earliest = math.min(earliest, start)
+	}
+	for start in b.keyframes.start {
+		earliest = math.min(earliest, start)
+	}
+	if earliest == max_i64 {
+		return time.Duration(max_i64)
+	}
+	return time.Duration(math.max(i64(0), earliest - now))
+}
+
+// tick advances every batched animation to now (monotonic ns); dt is
+// seconds since the previous tick for spring physics. Finished ids are
+// removed from the batch and listed in out.stopped.
+fn (mut b AnimationBatch) tick(now i64, dt f32, mut out AnimationBatchOutput) {
+	b.tick_tweens(now, mut out)
+	b.tick_springs(now, dt, mut out)
+	b.tick_keyframes(now, mut out)
+	for id in out.stopped {
+		b.remove(id)
+	}
+}
+
+fn (mut b AnimationBatch) tick_tweens(now i64, mut out AnimationBatchOutput) {
+	mut tw := &b.tweens
+	n := tw.ids.len
+	for i in 0 .. n {
+		tw.t[i] = f32(now - tw.start[i]) * tw.inv_duration[i]
+	}
+	for i in 0 .. n {
+		t := tw.t[i]
+		tw.eased[i] = if t <= 0 || t >= 1 { f32(0) } else { tw.easing[i](t) }
+	}
+	for i in 0 .. n {
+		tw.values[i] = tw.from[i] + (tw.to[i] - tw.from[i]) * tw.eased[i]
+	}
+	for i in 0 .. n {
+		if tw.t[i] < 0 {
+			continue
+		}
+		if tw.t[i] >= 1 {
+			out.on_value << tw.on_value[i]
+			out.values << tw.to[i]
+			if tw.on_done[i] != unsafe { nil } {
+				out.on_done << tw.on_done[i]
+			}
+			out.stopped << tw.ids[i]
+			continue
+		}
+		out.on_value << tw.on_value[i]
+		out.values << tw.values[i]
+	}
+}
+
+fn (mut b AnimationBatch) tick_springs(now i64, dt f32, mut out AnimationBatchOutput) {
+	mut sp := &b.springs
+	n := sp.ids.len
+	if n == 0 {
+		return
+	}
+	for i in 0 .. n {
+		sp.active[i] = if now >= sp.start[i] { f32(1) } else { f32(0) }
+	}
+	// Fixed substeps keep Euler integration stable for stiff springs
+	// when dt is large (30 Hz displays, late ticks).
+	steps := int_max(1, int(math.ceil(f64(dt) / spring_max_step)))
+	step := dt / f32(steps)
+	for _ in 0 .. steps {
+		// Spring physics: F = -kx - cv, integrated for all springs.
+		// Springs still in their delay have active = 0 and hold still.
+		for i in 0 .. n {
+			h := step * sp.active[i]
+			spring_force := -sp.stiffness[i] * (sp.position[i] - sp.target[i])
+			damping_force := -sp.damping[i] * sp.velocity[i]
+			accel := (spring_force + damping_force) * sp.inv_mass[i]
+			sp.velocity[i] += accel * h
+			sp.position[i] += sp.velocity[i] * h
+		}
+	}
+	for i in 0 .. n {
+		if sp.active[i] == 0 {
+			continue
+		}
+		out.on_value << sp.on_value[i]
+		if f32_abs(sp.velocity[i]) < sp.threshold[i]
+			&& f32_abs(sp.position[i] - sp.target[i]) < sp.threshold[i] {
+			sp.position[i] = sp.target[i]
+			sp.velocity[i] = 0
+			out.values << sp.target[i]
+			if sp.on_done[i] != unsafe { nil } {
+				out.on_done << sp.on_done[i]
+			}
+			out.stopped << sp.ids[i]
+			continue
+		}
+		out.values << sp.position[i]
+	}
+}
+
+fn (mut b AnimationBatch) tick_keyframes(now i64, mut out AnimationBatchOutput) {
+	mut kf := &b.keyframes
+	n := kf.ids.len
+	for i in 0 .. n {
+		kf.t[i] = f32(now - kf.start[i]) * kf.inv_duration[i]
+	}
+	for i in 0 .. n {
+		t := kf.t[i]
+		if t < 0 {
+			continue
+		}
+		if t >= 1 {
+			if kf.keyframes[i].len > 0 {
+				out.on_value << kf.on_value[i]
+				out.values << kf.keyframes[i].last().value
+			}
+			if kf.repeat[i] {
+				kf.start[i] = now
+				continue
+			}
+			if kf.on_done[i] != unsafe { nil } {
+				out.on_done << kf.on_done[i]
+			}
+			out.stopped << kf.ids[i]
+			continue
+		}
+		out.on_value << kf.on_value[i]
+		out.values << interpolate_keyframes(kf.keyframes[i], t)
+	}
+}
+
+// swap_remove deletes index i by moving the last item into it.
+// Returns the id of the moved item, or '' when i was last.
+fn (mut tw TweenBatch) swap_remove(i int) string {
+	last := tw.ids.len - 1
+	moved := if i < last { tw.ids[last] } else { '' }
+	if i < last {
+		tw.ids[i] = tw.ids[last]
+		tw.from[i] = tw.from[last]
+		tw.to[i] = tw.to[last]
+		tw.start[i] = tw.start[last]
+		tw.inv_duration[i] = tw.inv_duration[last]
+		tw.easing[i] = tw.easing[last]
+		tw.on_value[i] = tw.on_value[last]
+		tw.on_done[i] = tw.on_done[last]
+	}
+	tw.ids.delete_last()
+	tw.from.delete_last()
+	tw.to.delete_last()
+	tw.start.delete_last()
+	tw.inv_duration.delete_last()
+	tw.easing.delete_last()
+	tw.on_value.delete_last()
+	tw.on_done.delete_last()
+	tw.t.delete_last()
+	tw.eased.delete_last()
+	tw.values.delete_last()
+	return moved
+}
+
+fn (mut sp SpringBatch) swap_remove(i int) string {
+	last := sp.ids.len - 1
+	moved := if i < last { sp.ids[last] } else { '' }
+	if i < last {
+		sp.ids[i] = sp.ids[last]
+		sp.position[i] = sp.position[last]
+		sp.velocity[i] = sp.velocity[last]
+		sp.target[i] = sp.target[last]
+		sp.stiffness[i] = sp.stiffness[last]
+		sp.damping[i] = sp.damping[last]
+		sp.inv_mass[i] = sp.inv_mass[last]
+		sp.threshold[i] = sp.threshold[last]
+		sp.start[i] = sp.start[last]
+		sp.on_value[i] = sp.on_value[last]
+		sp.on_done[i] = sp.on_done[last]
+	}
+	sp.ids.delete_last()
+	sp.position.delete_last()
+	sp.velocity.delete_last()
+	sp.target.delete_last()
+	sp.stiffness.delete_last()
+	sp.damping.delete_last()
+	sp.inv_mass.delete_last()
+	sp.threshold.delete_last()
+	sp.start.delete_last()
+	sp.on_value.delete_last()
+	sp.on_done.delete_last()
+	sp.active.delete_last()
+	return moved
+}
+
+fn (mut kf KeyframeBatch) swap_remove(i int) string {
+	last := kf.ids.len - 1
+	moved := if i < last { kf.ids[last] } else { '' }
+	if i < last {
+		kf.ids[i] = kf.ids[last]
+		kf.keyframes[i] = kf.keyframes[last]
+		kf.start[i] = kf.start[last]
+		kf.inv_duration[i] = kf.inv_duration[last]
+		kf.repeat[i] = kf.repeat[last]
+		kf.on_value[i] = kf.on_value[last]
+		kf.on_done[i] = kf.on_done[last]
+	}
+	kf.ids.delete_last()
+	kf.keyframes.delete_last()
+	kf.start.delete_last()
+	kf.inv_duration.delete_last()
+	kf.repeat.delete_last()
+	kf.on_value.delete_last()
+	kf.on_done.delete_last()
+	kf.t.delete_last()
+	return moved
+}
@@ -26,16 +26,20 @@ pub:
 	easing   EasingFn        = ease_out_cubic
 	on_done  fn (mut Window) = unsafe { nil }
 mut:
-	delay    time.Duration
-	start    time.Time
-	stopped  bool
-	outgoing map[string]HeroSnapshot // hero id -> snapshot
-	incoming map[string]HeroSnapshot // captured after view switch
-	progress f32
+	delay       time.Duration
+	start       time.Time
+	stopped     bool
+	outgoing    map[string]HeroSnapshot // hero id -> snapshot
+	incoming    map[string]HeroSnapshot // captured after view switch
+	targets     map[string]HeroSnapshot // matched heroes as placed by the last layout
+	has_targets bool
+	progress    f32
 }
 
-fn (_ HeroTransition) refresh_kind() AnimationRefreshKind {
-	return .layout
+// refresh_kind is .layout until a layout pass has recorded targets, then
+// .render_only (see reapply_transitions). The final tick relayouts once.
+fn (ht HeroTransition) refresh_kind() AnimationRefreshKind {
+	return if ht.has_targets && !ht.stopped { .render_only } else { .layout }
 }
 
 // transition_to_view switches to a new view with animated hero element transitions.
@@ -183,15 +187,31 @@ fn update_hero_transition(mut ht HeroTransition, mut _ Window, mut deferred []An
 	return true
 }
 
+// get_hero_transition returns active hero transition if any
+fn (w &Window) get_hero_transition() ?&HeroTransition {
+	animation := w.animations['__hero_transition__'] or { return none }
+	if animation is HeroTransition {
+		return animation
+	}
+	return none
+}
+
 // apply_hero_transition modifies layout during render for hero effect
+// and records matched hero geometry for render-only ticks.
 fn apply_hero_transition(mut layout Layout, w &Window) {
-	animation := w.animations['__hero_transition__'] or { return }
-	if animation is HeroTransition {
-		if animation.stopped {
-			return
-		}
-		apply_hero_recursive(mut layout, animation.progress, animation.outgoing, animation.incoming)
+	mut transition := w.get_hero_transition() or { return }
+	if transition.stopped {
+		return
 	}
+	transition.has_targets = true
+	apply_hero_recursive(mut layout, mut transition, true)
+}
+
+// reapply_hero_recursive advances an already interpolated layout to the
+// current progress, using the recorded targets.
+fn reapply_hero_recursive(mut layout Layout, transition &HeroTransition) {
+	mut t := unsafe { transition }
+	apply_hero_recursive(mut layout, mut t, false)
 }
 
 // propagate_opacity sets opacity on element and all descendants
@@ -202,21 +222,35 @@ fn propagate_opacity(mut layout Layout, opacity f32) {
 	}
 }
 
-fn apply_hero_recursive(mut layout Layout, progress f32, outgoing map[string]HeroSnapshot, incoming map[string]HeroSnapshot) {
+// apply_hero_recursive interpolates hero elements. With record set,
+// shape geometry is the freshly computed target and is saved; otherwise
+// shapes are already interpolated and the saved target is used.
+fn apply_hero_recursive(mut layout Layout, mut transition HeroTransition, record bool) {
 	if layout.shape.hero && layout.shape.id != '' {
 		id := layout.shape.id
+		progress := transition.progress
 
 		// Split animation: first half for morph, second half for text fade
 		morph_progress := f32_min(1, progress * 2) // 0-0.5 -> 0-1
 		fade_progress := f32_max(0, (progress - 0.5) * 2) // 0.5-1 -> 0-1
 
-		if out := outgoing[id] {
-			if _ := incoming[id] {
+		if out := transition.outgoing[id] {
+			if _ := transition.incoming[id] {
 				// Matched hero: interpolate from outgoing to current (incoming) position
-				layout.shape.x = lerp(out.x, layout.shape.x, morph_progress)
-				layout.shape.y = lerp(out.y, layout.shape.y, morph_progress)
-				layout.shape.width = lerp(out.width, layout.shape.width, morph_progress)
-				layout.shape.height = lerp(out.height, layout.shape.height, morph_progress)
+				if record {
+					transition.targets[id] = HeroSnapshot{
+						x:      layout.shape.x
+						y:      layout.shape.y
+						width:  layout.shape.width
+						height: layout.shape.height
+					}
+				}
+				if target := transition.targets[id] {
+					layout.shape.x = lerp(out.x, target.x, morph_progress)
+					layout.shape.y = lerp(out.y, target.y, morph_progress)
+					layout.shape.width = lerp(out.width, target.width, morph_progress)
+					layout.shape.height = lerp(out.height, target.height, morph_progress)
+				}
 			}
 			// Outgoing only (no match in incoming): element is leaving, don't render
 		} else {
@@ -225,6 +259,6 @@ fn apply_hero_recursive(mut layout Layout, progress f32, outgoing map[string]Her
 		}
 	}
 	for mut child in layout.children {
-		apply_hero_recursive(mut child, progress, outgoing, incoming)
+		apply_hero_recursive(mut child, mut transition, record)
 	}
 }
@@ -107,45 +107,6 @@ fn (_ KeyframeAnimation) refresh_kind() AnimationRefreshKind {
 	return .layout
 }
 
-fn update_keyframe(mut kf KeyframeAnimation, mut _ Window, mut deferred []AnimationCallback) bool {
-	if kf.stopped {
-		return false
-	}
-
-	elapsed := time.since(kf.start)
-	if elapsed < kf.delay {
-		return false
-	}
-
-	anim_elapsed := elapsed - kf.delay
-	if anim_elapsed >= kf.duration {
-		if kf.keyframes.len > 0 {
-			on_value := kf.on_value
-			val := kf.keyframes.last().value
-			deferred << fn [on_value, val] (mut w Window) {
-				on_value(val, mut w)
-			}
-		}
-		if kf.repeat {
-			kf.start = time.now()
-			return true
-		}
-		if kf.on_done != unsafe { nil } {
-			deferred << kf.on_done
-		}
-		kf.stopped = true
-		return true
-	}
-
-	progress := f32(anim_elapsed) / f32(kf.duration)
-	value := interpolate_keyframes(kf.keyframes, progress)
-	on_value := kf.on_value
-	deferred << fn [on_value, value] (mut w Window) {
-		on_value(value, mut w)
-	}
-	return true
-}
-
 fn interpolate_keyframes(keyframes []Keyframe, progress f32) f32 {
 	if keyframes.len < 2 {
 		return if keyframes.len == 1 { keyframes[0].value } else { 0 }
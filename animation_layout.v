@@ -49,8 +49,16 @@ pub:
 // - `easing`: Easing function (default ease_out_cubic). Applied to overall progress.
 // - `on_done`: Optional callback when animation completes.
 // - `snapshots`: Internal map of element ID → captured position/size before change.
+// - `targets`: Internal map of element ID → position/size computed by the new layout.
 // - `progress`: Current animation progress (0.0 to 1.0), easing-adjusted.
 //
+// # Refresh Cost
+//
+// Only the first frame after `animate_layout()` runs view generation and layout; it
+// records each element's target geometry. Later ticks are render-only: the existing
+// layout tree is re-interpolated from `snapshots` to `targets` and renderers rebuilt,
+// with no view generation or layout until the final tick.
+//
 // # Interpolated Properties
 //
 // For each matched element, the following properties are interpolated:
@@ -117,15 +125,19 @@ pub:
 	easing   EasingFn        = ease_out_cubic
 	on_done  fn (mut Window) = unsafe { nil }
 mut:
-	delay     time.Duration
-	start     time.Time
-	stopped   bool
-	snapshots map[string]LayoutSnapshot
-	progress  f32
+	delay       time.Duration
+	start       time.Time
+	stopped     bool
+	snapshots   map[string]LayoutSnapshot
+	targets     map[string]LayoutSnapshot
+	has_targets bool // a layout pass has filled targets
+	progress    f32
 }
 
-fn (_ LayoutTransition) refresh_kind() AnimationRefreshKind {
-	return .layout
+// refresh_kind is .layout until a layout pass has recorded targets, then
+// .render_only (see reapply_transitions). The final tick relayouts once.
+fn (lt LayoutTransition) refresh_kind() AnimationRefreshKind {
+	return if lt.has_targets && !lt.stopped { .render_only } else { .layout }
 }
 
 // animate_layout triggers layout transition animation
@@ -196,27 +208,84 @@ fn (w &Window) get_layout_transition() ?&LayoutTransition {
 	return none
 }
 
-// apply_layout_transition interpolates positions during amend phase
+// apply_layout_transition interpolates positions during amend phase and
+// records the new (target) geometry for render-only ticks.
 fn apply_layout_transition(mut layout Layout, w &Window) {
-	transition := w.get_layout_transition() or { return }
+	mut transition := w.get_layout_transition() or { return }
 	if transition.stopped {
 		return
 	}
-	apply_transition_recursive(mut layout, transition)
+	transition.has_targets = true
+	apply_transition_recursive(mut layout, mut transition)
+}
+
+fn apply_transition_recursive(mut layout Layout, mut transition LayoutTransition) {
+	if layout.shape.id != '' {
+		if old := transition.snapshots[layout.shape.id] {
+			target := LayoutSnapshot{
+				x:      layout.shape.x
+				y:      layout.shape.y
+				width:  layout.shape.width
+				height: layout.shape.height
+			}
+			transition.targets[layout.shape.id] = target
+			lerp_layout_shape(mut layout.shape, old, target, transition.progress)
+		}
+	}
+	for mut child in layout.children {
+		apply_transition_recursive(mut child, mut transition)
+	}
 }
 
-fn apply_transition_recursive(mut layout Layout, transition &LayoutTransition) {
+// reapply_layout_transition moves shapes of an already interpolated
+// layout to the current progress, using the recorded targets.
+fn reapply_layout_transition(mut layout Layout, transition &LayoutTransition) {
 	if layout.shape.id != '' {
 		if old := transition.snapshots[layout.shape.id] {
-			t := transition.progress
-			// Interpolate from old to new position
-			layout.shape.x = lerp(old.x, layout.shape.x, t)
-			layout.shape.y = lerp(old.y, layout.shape.y, t)
-			layout.shape.width = lerp(old.width, layout.shape.width, t)
-			layout.shape.height = lerp(old.height, layout.shape.height, t)
+			if target := transition.targets[layout.shape.id] {
+				lerp_layout_shape(mut layout.shape, old, target, transition.progress)
+			}
 		}
 	}
 	for mut child in layout.children {
-		apply_transition_recursive(mut child, transition)
+		reapply_layout_transition(mut child, transition)
+	}
+}
+
+// Interpolate from old to new position
+@[inline]
+fn lerp_layout_shape(mut shape Shape, old LayoutSnapshot, target LayoutSnapshot, t f32) {
+	shape.x = lerp(old.x, target.x, t)
+	shape.y = lerp(old.y, target.y, t)
+	shape.width = lerp(old.width, target.width, t)
+	shape.height = lerp(old.height, target.height, t)
+}
+
+// reapply_transitions advances active layout and hero transitions on
+// the current layout tree without regenerating it. Called on
+// render-only refreshes; a no-op until a layout pass recorded targets.
+fn (mut window Window) reapply_transitions() {
+	mut applied := false
+	if transition := window.get_layout_transition() {
+		if transition.has_targets && !transition.stopped {
+			for mut layer in window.layout.children {
+				reapply_layout_transition(mut layer, transition)
+			}
+			applied = true
+		}
+	}
+	if transition := window.get_hero_transition() {
+		if transition.has_targets && !transition.stopped {
+			for mut layer in window.layout.children {
+				reapply_hero_recursive(mut layer, transition)
+			}
+			applied = true
+		}
+	}
+	if applied {
+		clip := window.window_rect()
+		for mut layer in window.layout.children {
+			layout_set_shape_clips(mut layer, clip)
+		}
 	}
 }
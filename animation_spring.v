@@ -2,6 +2,8 @@ module gui
 
 import time
 
+const spring_max_step = 1.0 / 240.0 // seconds per integration substep
+
 // SpringCfg controls spring physics behavior
 pub struct SpringCfg {
 pub:
@@ -59,8 +61,9 @@ mut:
 // - x (displacement): Distance from target position.
 // - v (velocity): Current rate of change.
 //
-// Each frame, acceleration is computed from forces, then integrated to update velocity
-// and position using Euler integration.
+// Each frame, acceleration is computed from forces, then integrated over the real
+// time since the previous frame to update velocity and position using Euler
+// integration (in small fixed substeps, so high and low refresh rates settle alike).
 //
 // # Spring Configuration
 //
@@ -145,10 +148,8 @@ mut:
 //     // Spring back to nearest snap point
 //     snap_x := f32(int((release_x + 50) / 100) * 100)
 //
-//     if existing := w.animation_get[gui.SpringAnimation]('drag_spring') {
-//         // Smoothly redirect existing spring (preserves momentum)
-//         existing.retarget(snap_x)
-//     } else {
+//     // Smoothly redirect a running spring (preserves momentum)
+//     if !w.retarget_spring('drag_spring', snap_x) {
 //         mut spring := gui.SpringAnimation{
 //             id:       'drag_spring'
 //             config:   gui.spring_bouncy
@@ -205,50 +206,3 @@ pub fn (mut s SpringAnimation) retarget(to f32) {
 	s.state.at_rest = false
 	s.stopped = false
 }
-
-fn update_spring(mut sp SpringAnimation, mut _ Window, dt f32, mut deferred []AnimationCallback) bool {
-	if sp.stopped || sp.state.at_rest {
-		return false
-	}
-
-	elapsed := time.since(sp.start)
-	if elapsed < sp.delay {
-		return false
-	}
-
-	// Spring physics: F = -kx - cv
-	// k = stiffness, c = damping, x = displacement, v = velocity
-	cfg := sp.config
-	displacement := sp.state.position - sp.state.target
-	spring_force := -cfg.stiffness * displacement
-	damping_force := -cfg.damping * sp.state.velocity
-	acceleration := (spring_force + damping_force) / cfg.mass
-
-	// Euler integration
-	sp.state.velocity += acceleration * dt
-	sp.state.position += sp.state.velocity * dt
-
-	// Check if at rest
-	if f32_abs(sp.state.velocity) < cfg.threshold && f32_abs(displacement) < cfg.threshold {
-		sp.state.position = sp.state.target
-		sp.state.velocity = 0
-		sp.state.at_rest = true
-		on_value := sp.on_value
-		target := sp.state.target
-		deferred << fn [on_value, target] (mut w Window) {
-			on_value(target, mut w)
-		}
-		if sp.on_done != unsafe { nil } {
-			deferred << sp.on_done
-		}
-		sp.stopped = true
-		return true
-	}
-
-	on_value := sp.on_value
-	pos := sp.state.position
-	deferred << fn [on_value, pos] (mut w Window) {
-		on_value(pos, mut w)
-	}
-	return true
-}
@@ -163,38 +163,3 @@ mut:
 fn (_ TweenAnimation) refresh_kind() AnimationRefreshKind {
 	return .layout
 }
-
-fn update_tween(mut tw TweenAnimation, mut _ Window, mut deferred []AnimationCallback) bool {
-	if tw.stopped {
-		return false
-	}
-
-	elapsed := time.since(tw.start)
-	if elapsed < tw.delay {
-		return false
-	}
-
-	anim_elapsed := elapsed - tw.delay
-	if anim_elapsed >= tw.duration {
-		on_value := tw.on_value
-		to_val := tw.to
-		deferred << fn [on_value, to_val] (mut w Window) {
-			on_value(to_val, mut w)
-		}
-		if tw.on_done != unsafe { nil } {
-			deferred << tw.on_done
-		}
-		tw.stopped = true
-		return true
-	}
-
-	// Calculate progress 0.0 to 1.0
-	progress := f32(anim_elapsed) / f32(tw.duration)
-	eased := tw.easing(progress)
-	value := lerp(tw.from, tw.to, eased)
-	on_value := tw.on_value
-	deferred << fn [on_value, value] (mut w Window) {
-		on_value(value, mut w)
-	}
-	return true
-}
@@ -0,0 +1,240 @@
+module gui
+
+// command_queue.v is the multi-producer, single-consumer queue behind
+// queue_command. Producers (any thread) claim a slot in a fixed ring
+// with one compare-and-swap and publish it by bumping the slot's
+// sequence number (Vyukov's bounded queue); the main thread drains it
+// in flush_commands without taking a lock. When the ring is full,
+// producers fall back to a mutex-guarded overflow list and keep using
+// it until the consumer empties it. Overflowed commands run only after
+// every ring slot claimed before them, so each producer's commands
+// still run in the order they were queued.
+//
+// Keyed commands (queue_command_keyed) coalesce: when several commands
+// with the same key are pending, only the newest runs. Use a key per
+// target (e.g. a data source id) for updates that fully replace the
+// previous one.
+import math
+import sync
+import sync.stdatomic
+import time
+
+const command_queue_capacity = 1024 // ring slots; power of two
+
+struct CommandSlot {
+mut:
+	seq         stdatomic.AtomicVal[u64]
+	cmd         WindowCommand = unsafe { nil }
+	key         string
+	enqueued_ns u64
+}
+
+struct PendingCommand {
+	cmd         WindowCommand = unsafe { nil }
+	key         string
+	enqueued_ns u64
+	after       u64 // overflow: ring tickets claimed before this command
+}
+
+// CommandQueueStats reports queue depth and latency. Latency is the
+// time from queue_command to the start of the command's execution.
+pub struct CommandQueueStats {
+pub:
+	depth           int // commands currently waiting
+	max_depth       int // largest batch seen by flush_commands
+	executed        u64
+	coalesced       u64 // keyed commands dropped in favour of a newer one
+	overflowed      u64 // commands that found the ring full
+	max_latency_ns  u64
+	last_latency_ns u64 // oldest command of the last flush
+}
+
+// CommandQueue is shared by reference; never copy it.
+@[heap]
+struct CommandQueue {
+mut:
+	slots           []CommandSlot
+	mask            u64
+	head            stdatomic.AtomicVal[u64] // next ticket for producers
+	tail            u64                      // consumer only
+	overflow_mutex  &sync.Mutex = sync.new_mutex()
+	overflow        []PendingCommand
+	overflow_active stdatomic.AtomicVal[u64] // 1 while overflow is non-empty
+	overflowed      stdatomic.AtomicVal[u64]
+	max_depth       int // consumer only from here down
+	executed        u64
+	coalesced       u64
+	max_latency_ns  u64
+	last_latency_ns u64
+	batch           []PendingCommand // reused between flushes
+}
+
+fn new_command_queue(capacity int) &CommandQueue {
+	mut size := 2
+	for size < capacity {
+		size *= 2
+	}
+	mut q := &CommandQueue{
+		slots: []CommandSlot{len: size}
+		mask:  u64(size - 1)
+	}
+	for i in 0 .. size {
+		q.slots[i].seq.store(u64(i))
+	}
+	return q
+}
+
+// push enqueues cmd. Safe from any thread.
+fn (mut q CommandQueue) push(cmd WindowCommand, key string) {
+	now := time.sys_mono_now()
+	if q.overflow_active.load() == 0 {
+		if pos := q.claim() {
+			q.publish(pos, cmd, key, now)
+			return
+		}
+	}
+	q.overflow_mutex.lock()
+	q.overflow << PendingCommand{
+		cmd:         cmd
+		key:         key
+		enqueued_ns: now
+		after:       q.head.load()
+	}
+	q.overflow_active.store(1)
+	q.overflow_mutex.unlock()
+	q.overflowed.add(1)
+}
+
+// claim reserves the next ring slot, returning its ticket, or none when
+// the ring is full.
+fn (mut q CommandQueue) claim() ?u64 {
+	mut pos := q.head.load()
+	for {
+		slot := &q.slots[pos & q.mask]
+		diff := i64(slot.seq.load() - pos)
+		if diff == 0 {
+			if q.head.compare_and_swap(pos, pos + 1) {
+				return pos
+			}
+			pos = q.head.load()
+		} else if diff < 0 {
+			return none
+		} else {
+			pos = q.head.load()
+		}
+	}
+	return none
+}
+
+// publish fills the slot claimed with ticket pos and hands it to the
+// consumer.
+fn (mut q CommandQueue) publish(pos u64, cmd WindowCommand, key string, now u64) {
+	mut slot := &q.slots[pos & q.mask]
+	slot.cmd = cmd
+	slot.key = key
+	slot.enqueued_ns = now
+	slot.seq.store(pos + 1)
+}
+
+// drain moves every published command into q.batch in queue order.
+// Overflowed commands are taken only once the ring has been drained
+// past every slot claimed before them: a producer may have published a
+// later slot and then overflowed while an earlier slot is still being
+// filled, and its overflowed command must not run ahead of that slot.
+// Consumer (main thread) only.
+fn (mut q CommandQueue) drain() {
+	array_clear(mut q.batch)
+	for {
+		mut slot := &q.slots[q.tail & q.mask]
+		if slot.seq.load() != q.tail + 1 {
+			break
+		}
+		q.batch << PendingCommand{
+			cmd:         slot.cmd
+			key:         slot.key
+			enqueued_ns: slot.enqueued_ns
+		}
+		// Drop references so the GC can collect closure captures.
+		slot.cmd = unsafe { nil }
+		slot.key = ''
+		slot.seq.store(q.tail + q.mask + 1) // hand the slot back to producers
+		q.tail++
+	}
+	if q.overflow_active.load() != 0 {
+		q.overflow_mutex.lock()
+		mut take := 0
+		for take < q.overflow.len && q.overflow[take].after <= q.tail {
+			take++
+		}
+		if take > 0 {
+			q.batch << q.overflow[..take]
+			q.overflow = q.overflow[take..].clone()
+		}
+		if q.overflow.len == 0 {
+			q.overflow_active.store(0)
+		}
+		q.overflow_mutex.unlock()
+	}
+}
+
+// depth approximates the number of waiting commands.
+fn (mut q CommandQueue) depth() int {
+	n := int(q.head.load() - q.tail)
+	if q.overflow_active.load() != 0 {
+		q.overflow_mutex.lock()
+		total := n + q.overflow.len
+		q.overflow_mutex.unlock()
+		return total
+	}
+	return n
+}
+
+// flush drains the queue and runs each command, skipping keyed
+// commands superseded by a newer one with the same key.
+fn (mut q CommandQueue) flush(mut window Window) {
+	q.drain()
+	if q.batch.len == 0 {
+		return
+	}
+	// Commands queued while these run land in the ring and run next frame.
+	if q.batch.len > q.max_depth {
+		q.max_depth = q.batch.len
+	}
+	now := time.sys_mono_now()
+	mut oldest := u64(0)
+	mut keyed := false
+	for pc in q.batch {
+		oldest = math.max(oldest, now - pc.enqueued_ns)
+		keyed = keyed || pc.key.len > 0
+	}
+	q.last_latency_ns = oldest
+	q.max_latency_ns = math.max(q.max_latency_ns, oldest)
+	mut newest := map[string]int{}
+	if keyed {
+		for i, pc in q.batch {
+			if pc.key.len > 0 {
+				newest[pc.key] = i
+			}
+		}
+	}
+	for i, pc in q.batch {
+		if keyed && pc.key.len > 0 && newest[pc.key] != i {
+			q.coalesced++
+			continue
+		}
+		q.executed++
+		pc.cmd(mut window)
+	}
+}
+
+fn (mut q CommandQueue) stats() CommandQueueStats {
+	return CommandQueueStats{
+		depth:           q.depth()
+		max_depth:       q.max_depth
+		executed:        q.executed
+		coalesced:       q.coalesced
+		overflowed:      q.overflowed.load()
+		max_latency_ns:  q.max_latency_ns
+		last_latency_ns: q.last_latency_ns
+	}
+}
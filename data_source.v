@@ -1,6 +1,7 @@
 module gui
 
 import rand
+import sync
 import time
 
 pub enum GridPaginationKind as u8 {
@@ -57,6 +58,9 @@ fn (mut signal GridAbortSignal) set_aborted(value bool) {
 pub struct GridAbortController {
 pub mut:
 	signal &GridAbortSignal = unsafe { nil }
+mut:
+	group    &GridAbortGroup = unsafe { nil } // set for shared fetches
+	released bool
 }
 
 // new_grid_abort_controller allocates a fresh abort controller.
@@ -67,8 +71,16 @@ pub fn new_grid_abort_controller() &GridAbortController {
 	}
 }
 
-// abort marks request as cancelled.
+// abort marks request as cancelled. A shared fetch is only cancelled
+// once every subscriber aborted.
 pub fn (mut controller GridAbortController) abort() {
+	if !isnil(controller.group) {
+		if !controller.released {
+			controller.released = true
+			controller.group.release()
+		}
+		return
+	}
 	if isnil(controller.signal) {
 		return
 	}
@@ -83,6 +95,8 @@ pub:
 	page       GridPageRequest
 	signal     &GridAbortSignal = unsafe { nil }
 	request_id u64
+mut:
+	window &Window = unsafe { nil } // set by grids; runs text index builds
 }
 
 @[minify]
@@ -94,6 +108,10 @@ pub:
 	row_count      ?int
 	has_more       bool
 	received_count int
+	// version is the revision of the source data. When non-zero, the
+	// grid detects changed pages by comparing it (with the request)
+	// instead of hashing every row. Bump it whenever the data changes.
+	version u64
 }
 
 @[minify]
@@ -146,16 +164,29 @@ mut:
 	mutate_data(req GridMutationRequest) !GridMutationResult
 }
 
+// InMemoryDataSource serves rows held in memory. Set `columns` to serve
+// a GridColumnStore instead of `rows`; only fetched pages are then
+// materialized as GridRow.
 @[heap; minify]
 pub struct InMemoryDataSource {
 pub mut:
-	rows []GridRow
+	rows    []GridRow
+	columns &GridColumnStore = unsafe { nil }
+	// version is reported in GridDataResult.version. Zero leaves change
+	// detection to hashing. Once set, bump it whenever you replace rows;
+	// mutate_data bumps it.
+	version u64
 pub:
 	default_limit   int = 100
 	latency_ms      int
 	row_count_known bool = true
 	supports_cursor bool = true
 	supports_offset bool = true
+	sort_kinds      map[string]GridSortKind // per column; default .text
+	text_index      &GridTextIndex = unsafe { nil } // optional trigram index for the quick filter
+mut:
+	filter_cache &GridFilterCache = &GridFilterCache{}
+	mutate_mutex &sync.Mutex      = sync.new_mutex() // one mutation at a time
 }
 
 pub fn (source InMemoryDataSource) capabilities() GridDataCapabilities {
@@ -172,39 +203,92 @@ pub fn (source InMemoryDataSource) capabilities() GridDataCapabilities {
 }
 
 pub fn (source InMemoryDataSource) fetch_data(req GridDataRequest) !GridDataResult {
-	return data_grid_source_inmemory_fetch(source.rows, source.default_limit, source.latency_ms,
-		source.row_count_known, req)
+	result := if source.columns != unsafe { nil } {
+		data_grid_source_columnar_fetch(source.columns, source.default_limit, source.latency_ms,
+			source.row_count_known, req)!
+	} else {
+		if source.text_index != unsafe { nil } {
+			mut index := unsafe { source.text_index }
+			index.use_window(req.window)
+		}
+		data_grid_source_inmemory_fetch(source.rows, source.version, source.sort_kinds,
+			source.filter_cache, source.text_index, source.default_limit, source.latency_ms,
+			source.row_count_known, req)!
+	}
+	if source.version == 0 {
+		return result
+	}
+	return GridDataResult{
+		...result
+		version: source.version
+	}
 }
 
 pub fn (mut source InMemoryDataSource) mutate_data(req GridMutationRequest) !GridMutationResult {
-	return data_grid_source_inmemory_mutate(mut source.rows, source.latency_ms,
-		source.row_count_known, req)
+	source.mutate_mutex.lock()
+	defer {
+		source.mutate_mutex.unlock()
+	}
+	if source.columns != unsafe { nil } {
+		store, result := data_grid_source_columnar_mutate(source.columns, source.latency_ms,
+			source.row_count_known, req)!
+		source.columns = store
+		if source.version != 0 {
+			source.version++
+		}
+		return result
+	}
+	old_rows := source.rows
+	old_version := source.version
+	result := data_grid_source_inmemory_mutate(mut source.rows, source.latency_ms,
+		source.row_count_known, req)!
+	if source.version != 0 {
+		source.version++
+	}
+	if source.text_index != unsafe { nil } {
+		mut index := unsafe { source.text_index }
+		index.apply_rows_mutation(old_rows, old_version, source.rows, source.version, req.kind,
+			result)
+	}
+	return result
 }
 
-fn data_grid_source_inmemory_fetch(rows []GridRow, default_limit int, latency_ms int, row_count_known bool, req GridDataRequest) !GridDataResult {
+fn data_grid_source_inmemory_fetch(rows []GridRow, version u64, sort_kinds map[string]GridSortKind, cache &GridFilterCache, text_index &GridTextIndex, default_limit int, latency_ms int, row_count_known bool, req GridDataRequest) !GridDataResult {
 	data_grid_source_sleep_with_abort(req.signal, latency_ms)!
-	filtered := data_grid_source_apply_query(rows, req.query)
+	filtered := data_grid_source_apply_query_typed(rows, version, req.query, sort_kinds,
+		cache, text_index)
+	start, end := data_grid_source_page_bounds(req.page, filtered.len, default_limit)
+	page := filtered[start..end].clone()
+	grid_abort_check(req.signal)!
+	return data_grid_source_page_result(page, req, start, end, filtered.len, row_count_known)
+}
+
+// data_grid_source_page_bounds resolves a page request to a
+// [start,end) range over `total` query results.
+fn data_grid_source_page_bounds(page GridPageRequest, total int, default_limit int) (int, int) {
 	limit := int_clamp(if default_limit > 0 { default_limit } else { 100 }, 1,
 		data_grid_source_max_page_limit)
-	start, end := match req.page {
+	start, end := match page {
 		GridCursorPageReq {
-			s := int_clamp(data_grid_source_cursor_to_index(req.page.cursor), 0, filtered.len)
-			chunk := int_clamp(if req.page.limit > 0 { req.page.limit } else { limit }, 1,
+			s := int_clamp(data_grid_source_cursor_to_index(page.cursor), 0, total)
+			chunk := int_clamp(if page.limit > 0 { page.limit } else { limit }, 1,
 				data_grid_source_max_page_limit)
-			s, int_min(filtered.len, s + chunk)
+			s, int_min(total, s + chunk)
 		}
 		GridOffsetPageReq {
-			data_grid_source_offset_bounds(req.page.start_index, req.page.end_index, filtered.len,
-				limit)
+			data_grid_source_offset_bounds(page.start_index, page.end_index, total, limit)
 		}
 	}
+	return start, end
+}
 
-	page := filtered[start..end].clone()
-	grid_abort_check(req.signal)!
+// data_grid_source_page_result wraps the rows of [start,end) with
+// cursors and counts for an in-memory fetch.
+fn data_grid_source_page_result(page []GridRow, req GridDataRequest, start int, end int, total int, row_count_known bool) GridDataResult {
 	is_cursor := req.page is GridCursorPageReq
 	return GridDataResult{
 		rows:           page
-		next_cursor:    if is_cursor && end < filtered.len {
+		next_cursor:    if is_cursor && end < total {
 			data_grid_source_cursor_from_index(end)
 		} else {
 			''
@@ -214,8 +298,8 @@ fn data_grid_source_inmemory_fetch(rows []GridRow, default_limit int, latency_ms
 		} else {
 			''
 		}
-		row_count:      if row_count_known { ?int(filtered.len) } else { none }
-		has_more:       end < filtered.len
+		row_count:      if row_count_known { ?int(total) } else { none }
+		has_more:       end < total
 		received_count: page.len
 	}
 }
@@ -286,6 +370,11 @@ fn data_grid_source_cursor_to_index(cursor string) int {
 }
 
 fn data_grid_source_cursor_to_index_opt(cursor string) ?int {
+	// Keyset values may end in spaces; parse before trimming.
+	if cursor.starts_with('k:') {
+		keyset := grid_orm_parse_keyset_cursor(cursor) or { return none }
+		return ?int(keyset.offset)
+	}
 	trimmed := cursor.trim_space()
 	if trimmed.len == 0 {
 		return ?int(0)
@@ -315,11 +404,22 @@ fn data_grid_source_is_decimal(input string) bool {
 	return true
 }
 
-// data_grid_source_apply_query filters and sorts rows in memory.
+// data_grid_source_apply_query filters and sorts rows in memory,
+// comparing cells as text.
 // NOTE: returns `rows` directly (slice alias, not clone) when
 // no filters/sorts apply. Callers must clone if mutation is
 // intended.
 fn data_grid_source_apply_query(rows []GridRow, query GridQueryState) []GridRow {
+	return data_grid_source_apply_query_typed(rows, 0, query, map[string]GridSortKind{},
+		unsafe { nil }, unsafe { nil })
+}
+
+// data_grid_source_apply_query_typed is data_grid_source_apply_query
+// with a GridSortKind per column; unlisted columns sort as text. A
+// non-nil cache makes repeated filtering incremental, and a non-nil
+// index narrows the quick filter (see data_source_filter.v). version is
+// the rows' data version, zero when unknown.
+fn data_grid_source_apply_query_typed(rows []GridRow, version u64, query GridQueryState, sort_kinds map[string]GridSortKind, cache &GridFilterCache, text_index &GridTextIndex) []GridRow {
 	if query.quick_filter.len == 0 && query.filters.len == 0 && query.sorts.len == 0 {
 		return rows
 	}
@@ -334,59 +434,24 @@ fn data_grid_source_apply_query(rows []GridRow, query GridQueryState) []GridRow
 				value:  filter.value.to_lower()
 			}
 		}
-		rows.filter(data_grid_source_row_matches_query(it, needle, lowered_filters))
+		if cache != unsafe { nil } && !needle.contains_u8(grid_filter_cell_sep) {
+			mut c := unsafe { cache }
+			idxs := c.filter(rows, version, needle, lowered_filters, text_index)
+			[]GridRow{len: idxs.len, init: rows[idxs[index]]}
+		} else {
+			rows.filter(data_grid_source_row_matches_query(it, needle, lowered_filters))
+		}
 	} else {
 		rows
 	}
 	if query.sorts.len == 0 {
 		return filtered
 	}
-	// Sorting is lexicographic (string comparison). Numeric-aware
-	// sorting is the caller's responsibility via custom data sources.
 	n := filtered.len
 	if n <= 1 {
 		return filtered
 	}
-	mut idxs := []int{len: n, init: index}
-	if query.sorts.len == 1 {
-		// Single-sort fast path: one key array, no inner loop.
-		sort0 := query.sorts[0]
-		keys := []string{len: n, init: filtered[index].cells[sort0.col_id] or { '' }}
-		dir := if sort0.dir == .asc { 1 } else { -1 }
-		idxs.sort_with_compare(fn [keys, dir] (ia &int, ib &int) int {
-			ka := keys[*ia]
-			kb := keys[*ib]
-			if ka == kb {
-				return 0
-			}
-			return if ka < kb { -dir } else { dir }
-		})
-	} else {
-		// Multi-sort: pre-extract key columns.
-		sorts := query.sorts
-		mut key_cols := [][]string{len: sorts.len}
-		for si, sort in sorts {
-			mut col := []string{len: n}
-			for i, row in filtered {
-				col[i] = row.cells[sort.col_id] or { '' }
-			}
-			key_cols[si] = col
-		}
-		idxs.sort_with_compare(fn [sorts, key_cols] (ia &int, ib &int) int {
-			a := *ia
-			b := *ib
-			for si, sort in sorts {
-				ka := key_cols[si][a]
-				kb := key_cols[si][b]
-				if ka == kb {
-					continue
-				}
-				cmp := if ka < kb { -1 } else { 1 }
-				return if sort.dir == .asc { cmp } else { -cmp }
-			}
-			return 0
-		})
-	}
+	idxs := grid_sort_row_indices(filtered, query.sorts, sort_kinds)
 	mut result := []GridRow{len: n}
 	for i, idx in idxs {
 		result[i] = filtered[idx]
@@ -416,20 +481,24 @@ fn data_grid_source_row_matches_query(row GridRow, needle string, filters []Grid
 	}
 	for filter in filters {
 		cell := row.cells[filter.col_id] or { '' }
-		matched := match filter.op {
-			'equals' { grid_equals_lower(cell, filter.value) }
-			'starts_with' { grid_starts_with_lower(cell, filter.value) }
-			'ends_with' { grid_ends_with_lower(cell, filter.value) }
-			else { grid_contains_lower(cell, filter.value) }
-		}
-
-		if !matched {
+		if !grid_filter_matches_lower(cell, filter.op, filter.value) {
 			return false
 		}
 	}
 	return true
 }
 
+// grid_filter_matches_lower applies a filter op to a cell.
+// `value` must already be lowered.
+fn grid_filter_matches_lower(cell string, op string, value string) bool {
+	return match op {
+		'equals' { grid_equals_lower(cell, value) }
+		'starts_with' { grid_starts_with_lower(cell, value) }
+		'ends_with' { grid_ends_with_lower(cell, value) }
+		else { grid_contains_lower(cell, value) }
+	}
+}
+
 // ASCII lowercase byte (a-z, A-Z only).
 @[inline]
 fn grid_lower_byte(c u8) u8 {
@@ -634,7 +703,7 @@ fn data_grid_source_apply_create(mut rows []GridRow, req_rows []GridRow) !GridMu
 	}
 	mut created := []GridRow{cap: req_rows.len}
 	for row in req_rows {
-		next_id := data_grid_source_next_create_row_id(rows, existing, row.id)!
+		next_id := data_grid_source_next_create_row_id(rows.len, existing, row.id)!
 		next_row := GridRow{
 			...row
 			id:    next_id
@@ -756,16 +825,24 @@ fn grid_deduplicate_row_ids(rows []GridRow, row_ids []string) map[string]bool {
 	return seen
 }
 
-fn data_grid_source_next_create_row_id(rows []GridRow, existing map[string]bool, preferred_id string) !string {
+fn data_grid_source_next_create_row_id(row_count int, existing map[string]bool, preferred_id string) !string {
+	return data_grid_source_next_row_id(row_count, preferred_id, fn [existing] (id string) bool {
+		return existing[id]
+	})
+}
+
+// data_grid_source_next_row_id picks an ID for a created row: the
+// preferred one when free, else the first free number past row_count.
+fn data_grid_source_next_row_id(row_count int, preferred_id string, taken fn (string) bool) !string {
 	id := preferred_id.trim_space()
-	if id.len > 0 && !existing[id] {
+	if id.len > 0 && !taken(id) {
 		return id
 	}
-	cap := rows.len + 1000
-	mut next := rows.len + 1
+	cap := row_count + 1000
+	mut next := row_count + 1
 	for next <= cap {
 		candidate := '${next}'
-		if !existing[candidate] {
+		if !taken(candidate) {
 			return candidate
 		}
 		next++
@@ -773,7 +850,7 @@ fn data_grid_source_next_create_row_id(rows []GridRow, existing map[string]bool,
 	// Numeric range exhausted; try random hex IDs.
 	for _ in 0 .. 10 {
 		candidate := '__gen_${rand.u64():016x}'
-		if !existing[candidate] {
+		if !taken(candidate) {
 			return candidate
 		}
 	}
@@ -0,0 +1,346 @@
+module gui
+
+// data_source_cache.v keeps recently fetched data-source pages so that
+// paging back, or forward into a prefetched page, shows rows at once
+// instead of a loading state.
+// - DataGridCfg.page_cache_bytes enables the cache with a memory
+//   budget. Pages are keyed by request key, which already combines the
+//   page position, page size and query signature. The least recently
+//   used pages are evicted past the budget.
+// - DataGridCfg.prefetch_pages bounds speculative fetches. After a page
+//   loads, neighbouring pages in the paging direction are fetched in
+//   the background: one when paging slowly, up to prefetch_pages when
+//   pages turn faster than a second apart. Cursor pagination can only
+//   look one page ahead, since later cursors are not known yet.
+// - Navigating to a page whose prefetch is still running waits for that
+//   prefetch instead of fetching the page a second time.
+// - Refetches and local mutations clear the cache and abort running
+//   prefetches. A result carrying a newer GridDataResult.version drops
+//   pages of older versions.
+import time
+
+const data_grid_source_fast_paging_ms = 1000
+
+// DataGridCachedPage is one cached fetch result.
+struct DataGridCachedPage {
+	result GridDataResult
+	bytes  int
+	used   u64 // cache tick of the last hit
+}
+
+// DataGridPageCache is a grid's LRU page cache. It is only touched on
+// the main thread: prefetch results arrive through queue_command.
+@[heap]
+struct DataGridPageCache {
+mut:
+	pages          map[string]DataGridCachedPage
+	bytes          int
+	budget         int
+	tick           u64
+	version        u64 // newest GridDataResult.version seen
+	generation     u64 // bumped by clear; drops late prefetches
+	inflight       map[string]&GridAbortController
+	joined         map[string]u64 // request key -> request_id waiting on its prefetch
+	prefetched_key string         // request key prefetch last ran for
+	hits           int
+	misses         int
+	prefetches     int
+	joins          int // navigations served by a running prefetch
+}
+
+fn (mut cache DataGridPageCache) get(key string) ?GridDataResult {
+	page := cache.pages[key] or { return none }
+	cache.tick++
+	cache.pages[key] = DataGridCachedPage{
+		...page
+		used: cache.tick
+	}
+	return page.result
+}
+
+fn (mut cache DataGridPageCache) put(key string, result GridDataResult) {
+	if result.version != cache.version && result.version != 0 {
+		if result.version < cache.version {
+			return
+		}
+		cache.drop_pages()
+		cache.version = result.version
+	}
+	bytes := data_grid_source_result_bytes(result)
+	if bytes > cache.budget {
+		return
+	}
+	if old := cache.pages[key] {
+		cache.bytes -= old.bytes
+	}
+	cache.tick++
+	cache.pages[key] = DataGridCachedPage{
+		result: result
+		bytes:  bytes
+		used:   cache.tick
+	}
+	cache.bytes += bytes
+	cache.evict()
+}
+
+// evict drops least recently used pages until within budget.
+fn (mut cache DataGridPageCache) evict() {
+	for cache.bytes > cache.budget && cache.pages.len > 0 {
+		mut oldest_key := ''
+		mut oldest := u64(0)
+		for key, page in cache.pages {
+			if oldest_key.len == 0 || page.used < oldest {
+				oldest_key = key
+				oldest = page.used
+			}
+		}
+		cache.bytes -= cache.pages[oldest_key].bytes
+		cache.pages.delete(oldest_key)
+	}
+}
+
+fn (mut cache DataGridPageCache) drop_pages() {
+	cache.pages = map[string]DataGridCachedPage{}
+	cache.bytes = 0
+}
+
+// clear drops every page and aborts in-flight prefetches.
+fn (mut cache DataGridPageCache) clear() {
+	cache.drop_pages()
+	for _, controller in cache.inflight {
+		mut c := unsafe { controller }
+		c.abort()
+	}
+	cache.inflight = map[string]&GridAbortController{}
+	cache.joined = map[string]u64{}
+	cache.prefetched_key = ''
+	cache.generation++
+}
+
+// data_grid_source_result_bytes estimates the memory held by result.
+fn data_grid_source_result_bytes(result GridDataResult) int {
+	mut bytes := int(sizeof(GridDataResult))
+	for row in result.rows {
+		bytes += int(sizeof(GridRow)) + row.id.len
+		for key, value in row.cells {
+			bytes += key.len + value.len + 2 * int(sizeof(string))
+		}
+	}
+	return bytes
+}
+
+// data_grid_source_sync_page_cache creates, resizes or drops the
+// grid's page cache to match cfg.page_cache_bytes.
+fn data_grid_source_sync_page_cache(cfg DataGridCfg, mut state DataGridSourceState) {
+	if cfg.page_cache_bytes <= 0 {
+		data_grid_source_clear_page_cache(mut state)
+		state.page_cache = unsafe { nil }
+		return
+	}
+	if state.page_cache == unsafe { nil } {
+		state.page_cache = &DataGridPageCache{}
+	}
+	state.page_cache.budget = cfg.page_cache_bytes
+	state.page_cache.evict()
+}
+
+// data_grid_source_clear_page_cache clears the cache. A page waiting
+// on an aborted prefetch is fetched again on the next view generation.
+fn data_grid_source_clear_page_cache(mut state DataGridSourceState) {
+	if state.page_cache == unsafe { nil } {
+		return
+	}
+	if state.loading && state.request_key in state.page_cache.joined {
+		state.loading = false
+		state.request_key = ''
+	}
+	state.page_cache.clear()
+}
+
+// data_grid_source_cache_hit shows the cached page for request_key, if
+// any, in place of a fetch. Misses are counted when the fetch starts,
+// since a paced request key is looked up on every frame it waits.
+fn data_grid_source_cache_hit(request_key string, caps GridDataCapabilities, mut state DataGridSourceState) bool {
+	if state.page_cache == unsafe { nil } {
+		return false
+	}
+	result := state.page_cache.get(request_key) or { return false }
+	state.page_cache.hits++
+	data_grid_source_cancel_active(mut state)
+	state.request_id++
+	state.request_key = request_key
+	data_grid_source_store_result(mut state, result, caps)
+	return true
+}
+
+// data_grid_source_join_prefetch makes request_key wait for its running
+// prefetch instead of fetching the page again. The prefetch is not
+// made the active request: navigating on does not abort it, so its
+// page still lands in the cache.
+fn data_grid_source_join_prefetch(request_key string, mut state DataGridSourceState) bool {
+	if state.page_cache == unsafe { nil } || request_key !in state.page_cache.inflight {
+		return false
+	}
+	data_grid_source_cancel_active(mut state)
+	state.request_id++
+	state.request_key = request_key
+	state.loading = true
+	state.load_error = ''
+	state.active_abort = unsafe { nil }
+	state.page_cache.joined[request_key] = state.request_id
+	state.page_cache.joins++
+	return true
+}
+
+// data_grid_source_note_paging records the direction and pace of
+// paging for prefetch.
+fn data_grid_source_note_paging(mut state DataGridSourceState, dir int) {
+	if dir == 0 {
+		return
+	}
+	now := time.ticks()
+	state.nav_gap_ms = if state.nav_ticks > 0 { now - state.nav_ticks } else { -1 }
+	state.nav_ticks = now
+	state.nav_dir = if dir > 0 { 1 } else { -1 }
+}
+
+// data_grid_source_prefetch_depth returns how many pages to fetch
+// ahead: one when paging slowly, more as pages turn faster.
+fn data_grid_source_prefetch_depth(max_pages int, gap_ms i64) int {
+	if max_pages <= 1 || gap_ms < 0 || gap_ms >= data_grid_source_fast_paging_ms {
+		return int_min(max_pages, 1)
+	}
+	scaled := i64(max_pages) * (data_grid_source_fast_paging_ms - gap_ms) / data_grid_source_fast_paging_ms
+	return int_clamp(int(scaled) + 1, 1, max_pages)
+}
+
+// data_grid_source_prefetch fetches the pages after the current one, in
+// the paging direction, once per loaded page.
+fn data_grid_source_prefetch(cfg DataGridCfg, kind GridPaginationKind, query_sig u64, mut state DataGridSourceState, mut window Window) {
+	if state.page_cache == unsafe { nil } || cfg.prefetch_pages <= 0 || state.loading
+		|| !state.has_loaded || state.load_error.len > 0
+		|| state.page_cache.prefetched_key == state.request_key {
+		return
+	}
+	state.page_cache.prefetched_key = state.request_key
+	limit := data_grid_page_limit(cfg)
+	match kind {
+		.offset {
+			depth := data_grid_source_prefetch_depth(cfg.prefetch_pages, state.nav_gap_ms)
+			for k in 1 .. depth + 1 {
+				start := state.offset_start + state.nav_dir * k * limit
+				if start < 0 {
+					break
+				}
+				if total := state.row_count {
+					if start >= total {
+						break
+					}
+				} else if state.nav_dir > 0 && !state.has_more && state.received_count < limit {
+					break
+				}
+				key := data_grid_source_request_key(cfg, DataGridSourceState{
+					...state
+					offset_start: start
+				}, kind, query_sig)
+				data_grid_source_start_prefetch(cfg, key, GridPageRequest(GridOffsetPageReq{
+					start_index: start
+					end_index:   start + limit
+				}), mut state.page_cache, mut window)
+			}
+		}
+		.cursor {
+			cursor := if state.nav_dir < 0 { state.prev_cursor } else { state.next_cursor }
+			if cursor.len == 0 {
+				return
+			}
+			key := data_grid_source_request_key(cfg, DataGridSourceState{
+				...state
+				current_cursor: cursor
+			}, kind, query_sig)
+			data_grid_source_start_prefetch(cfg, key, GridPageRequest(GridCursorPageReq{
+				cursor: cursor
+				limit:  limit
+			}), mut state.page_cache, mut window)
+		}
+	}
+}
+
+fn data_grid_source_start_prefetch(cfg DataGridCfg, key string, page GridPageRequest, mut cache DataGridPageCache, mut window Window) {
+	source := cfg.data_source or { return }
+	if key in cache.pages || key in cache.inflight {
+		return
+	}
+	controller := new_grid_abort_controller()
+	cache.inflight[key] = controller
+	cache.prefetches++
+	req := GridDataRequest{
+		grid_id: cfg.id
+		query:   cfg.query
+		page:    page
+		signal:  controller.signal
+		window:  window
+	}
+	grid_id := cfg.id
+	generation := cache.generation
+	window.pin_layout_callback_reclaim() or { panic(err) }
+	window.suspend_layout_callback_tracking(fn [source, req, grid_id, key, generation, mut window] () {
+		window.submit_work(WorkItem{
+			signal:    req.signal
+			on_cancel: fn (mut w Window) {
+				w.data_grid_source_queue_reclaim_pin_release()
+			}
+			run:       fn [source, req, grid_id, key, generation] (mut w Window) {
+				result := source.fetch_data(req) or {
+					w.queue_command(fn [grid_id, key, generation] (mut w Window) {
+						data_grid_source_store_prefetch(grid_id, key, generation, none, mut
+							w)
+						w.release_layout_callback_reclaim_pin()
+					})
+					return
+				}
+				w.queue_command(fn [grid_id, key, generation, result] (mut w Window) {
+					data_grid_source_store_prefetch(grid_id, key, generation, result, mut
+						w)
+					w.release_layout_callback_reclaim_pin()
+				})
+			}
+		})
+	}) or {
+		window.release_layout_callback_reclaim_pin()
+		panic(err)
+	}
+}
+
+// data_grid_source_store_prefetch caches a prefetched page unless the
+// cache was cleared since the prefetch started, and shows it when the
+// grid navigated to it meanwhile. Failed prefetches are dropped; the
+// page is fetched normally when visited, or at once if it was joined.
+fn data_grid_source_store_prefetch(grid_id string, key string, generation u64, result ?GridDataResult, mut window Window) {
+	mut dg_src := state_map[string, DataGridSourceState](mut window, ns_dg_source, cap_moderate)
+	mut state := dg_src.get(grid_id) or { return }
+	if state.page_cache == unsafe { nil } {
+		return
+	}
+	mut cache := unsafe { state.page_cache }
+	if cache.generation != generation {
+		return
+	}
+	cache.inflight.delete(key)
+	request_id := cache.joined[key] or { 0 }
+	cache.joined.delete(key)
+	if r := result {
+		cache.put(key, r)
+		if request_id != 0 {
+			data_grid_source_apply_success(grid_id, request_id, r, state.cached_caps, mut
+				window)
+		}
+		return
+	}
+	if request_id != 0 && state.loading && state.request_id == request_id {
+		state.loading = false
+		state.request_key = ''
+		dg_src.set(grid_id, state)
+		window.update_window()
+	}
+}
@@ -0,0 +1,950 @@
+module gui
+
+// data_source_columnar.v is a typed, column-oriented backing store for
+// data grids. GridRow keeps every row as map[string]string, so a
+// 1M-row × 20-column grid costs 1M hash maps and 20M heap strings, and
+// every sort and filter does map lookups and string compares. A
+// GridColumnStore keeps one typed array per column instead:
+// - integer and date columns as i64 (dates in unix seconds)
+// - float columns as f64, boolean columns as a bitmap
+// - text columns dictionary-encoded: a u32 code per row into a table
+//   of distinct values
+// - a null bitmap per column (null cells read as '')
+// Queries run on row indices: text predicates are evaluated once per
+// distinct value, sorts compare typed values or dictionary ranks, and
+// GridRow is materialized only for the page the grid fetches.
+// A mutation never changes a store a fetch may be reading. It forks a
+// new version that shares column buffers with the old one and copies a
+// column before writing to it: an edit copies the columns it touches,
+// and a create copies every column, the row IDs and the row index.
+import strconv
+import time
+
+// GridColumnKind is the storage type of a GridColumnStore column.
+pub enum GridColumnKind as u8 {
+	text    // dictionary-encoded string
+	integer // i64
+	float   // f64
+	boolean // bitmap
+	date    // unix seconds; shown as YYYY-MM-DD or YYYY-MM-DD HH:mm:ss
+}
+
+// GridColumnData is one typed column. Build it with grid_text_column,
+// grid_int_column, grid_float_column, grid_bool_column or
+// grid_date_column; mark missing values with set_null.
+pub struct GridColumnData {
+pub:
+	id   string
+	kind GridColumnKind
+mut:
+	len    int
+	nums   []i64          // integer, date
+	floats []f64          // float
+	bits   []u64          // boolean values, one bit per row
+	codes  []u32          // text: index into dict
+	dict   []string       // text: distinct values
+	lookup map[string]u32 // text: value -> code
+	nulls  []u64          // one bit per row; set means null
+}
+
+// GridColumnStore holds a data grid's rows column by column. Pass it as
+// DataGridCfg.column_store or InMemoryDataSource.columns.
+@[heap]
+pub struct GridColumnStore {
+pub:
+	len int
+mut:
+	ids     []string // row IDs; empty means the row index is the ID
+	columns []GridColumnData
+	by_id   map[string]int // column id -> index in columns
+	rows    &GridRowIndex = unsafe { nil } // built by the first mutation that needs it
+}
+
+// GridRowIndex maps row IDs to row indices. Versions of a store share
+// it read-only; a version that adds rows writes to its own copy.
+@[heap]
+struct GridRowIndex {
+mut:
+	by_id map[string]int
+}
+
+// GridColumnStoreMemory compares the store's footprint with the same
+// rows held as []GridRow. Map figures are estimates from a sample of
+// materialized rows.
+pub struct GridColumnStoreMemory {
+pub:
+	rows                       int
+	columns                    int
+	columnar_bytes             i64
+	map_bytes                  i64
+	columnar_bytes_per_million i64
+	map_bytes_per_million      i64
+}
+
+const grid_column_memory_sample = 1000
+// Per-entry cost of a map[string]string beyond the key and value
+// strings: hash, metadata and load-factor slack.
+const grid_map_entry_overhead = 24
+
+pub fn grid_text_column(id string, values []string) GridColumnData {
+	mut col := GridColumnData{
+		id:    id
+		kind:  .text
+		codes: []u32{cap: values.len}
+	}
+	for value in values {
+		col.codes << col.intern(value)
+	}
+	col.len = values.len
+	col.nulls = []u64{len: grid_bitmap_words(values.len)}
+	return col
+}
+
+pub fn grid_int_column(id string, values []i64) GridColumnData {
+	return GridColumnData{
+		id:    id
+		kind:  .integer
+		len:   values.len
+		nums:  values.clone()
+		nulls: []u64{len: grid_bitmap_words(values.len)}
+	}
+}
+
+pub fn grid_float_column(id string, values []f64) GridColumnData {
+	return GridColumnData{
+		id:     id
+		kind:   .float
+		len:    values.len
+		floats: values.clone()
+		nulls:  []u64{len: grid_bitmap_words(values.len)}
+	}
+}
+
+pub fn grid_bool_column(id string, values []bool) GridColumnData {
+	mut bits := []u64{len: grid_bitmap_words(values.len)}
+	for i, value in values {
+		grid_bit_set(mut bits, i, value)
+	}
+	return GridColumnData{
+		id:    id
+		kind:  .boolean
+		len:   values.len
+		bits:  bits
+		nulls: []u64{len: grid_bitmap_words(values.len)}
+	}
+}
+
+pub fn grid_date_column(id string, values []time.Time) GridColumnData {
+	return GridColumnData{
+		id:    id
+		kind:  .date
+		len:   values.len
+		nums:  []i64{len: values.len, init: values[index].unix()}
+		nulls: []u64{len: grid_bitmap_words(values.len)}
+	}
+}
+
+// set_null marks a cell as having no value.
+pub fn (mut col GridColumnData) set_null(row int) {
+	if row >= 0 && row < col.len {
+		grid_bit_set(mut col.nulls, row, true)
+	}
+}
+
+// new_grid_column_store builds a store from columns of equal length.
+// ids may be empty, in which case row indices serve as row IDs.
+pub fn new_grid_column_store(ids []string, columns []GridColumnData) !&GridColumnStore {
+	len := if columns.len > 0 { columns[0].len } else { ids.len }
+	if ids.len > 0 && ids.len != len {
+		return error('grid: column store has ${ids.len} ids for ${len} rows')
+	}
+	mut by_id := map[string]int{}
+	for i, col in columns {
+		if col.len != len {
+			return error('grid: column ${col.id} has ${col.len} rows, expected ${len}')
+		}
+		if col.id in by_id {
+			return error('grid: duplicate column id: ${col.id}')
+		}
+		by_id[col.id] = i
+	}
+	return &GridColumnStore{
+		len:     len
+		ids:     ids.clone()
+		columns: columns.clone()
+		by_id:   by_id
+	}
+}
+
+// grid_column_store_from_rows converts rows to a store. kinds gives the
+// type of each column; columns not listed are stored as text. Cells
+// that are missing, empty or do not parse as their kind become null.
+pub fn grid_column_store_from_rows(rows []GridRow, kinds map[string]GridColumnKind) &GridColumnStore {
+	mut store := &GridColumnStore{}
+	for col_id, kind in kinds {
+		store.add_column(col_id, kind)
+	}
+	for row in rows {
+		for col_id, _ in row.cells {
+			if col_id !in store.by_id {
+				store.add_column(col_id, .text)
+			}
+		}
+	}
+	store.ids = []string{cap: rows.len}
+	for idx, row in rows {
+		store.ids << data_grid_row_id(row, idx)
+		for mut col in store.columns {
+			col.push_text(row.cells[col.id] or { '' }) or { col.push_null() }
+		}
+	}
+	store.set_len(rows.len)
+	return store
+}
+
+// row_id returns the ID of row i.
+pub fn (store &GridColumnStore) row_id(i int) string {
+	if store.ids.len > 0 {
+		return store.ids[i]
+	}
+	return i.str()
+}
+
+// cell returns the display text of a cell, '' for null or unknown
+// columns.
+pub fn (store &GridColumnStore) cell(row int, col_id string) string {
+	idx := store.by_id[col_id] or { return '' }
+	return store.columns[idx].text(row)
+}
+
+// row materializes row i as a GridRow. Null cells are omitted.
+pub fn (store &GridColumnStore) row(i int) GridRow {
+	mut cells := map[string]string{}
+	for col in store.columns {
+		if !col.is_null(i) {
+			cells[col.id] = col.text(i)
+		}
+	}
+	return GridRow{
+		id:    store.row_id(i)
+		cells: cells
+	}
+}
+
+// rows_at materializes the given row indices, in order.
+pub fn (store &GridColumnStore) rows_at(idxs []int) []GridRow {
+	mut rows := []GridRow{cap: idxs.len}
+	for i in idxs {
+		rows << store.row(i)
+	}
+	return rows
+}
+
+// memory_bytes estimates the store's heap footprint.
+pub fn (store &GridColumnStore) memory_bytes() i64 {
+	mut total := i64(sizeof(GridColumnStore))
+	for id in store.ids {
+		total += i64(sizeof(string)) + id.len
+	}
+	for col in store.columns {
+		total += i64(sizeof(GridColumnData))
+		total += i64(col.nums.len) * 8 + i64(col.floats.len) * 8
+		total += i64(col.bits.len) * 8 + i64(col.nulls.len) * 8
+		total += i64(col.codes.len) * 4
+		for value in col.dict {
+			// dict entry plus lookup key
+			total += 2 * (i64(sizeof(string)) + value.len) + 4 + grid_map_entry_overhead
+		}
+	}
+	return total
+}
+
+// grid_rows_memory_bytes estimates the heap footprint of rows held as
+// []GridRow: row structs, IDs, and one map per row.
+pub fn grid_rows_memory_bytes(rows []GridRow) i64 {
+	mut total := i64(0)
+	for row in rows {
+		total += i64(sizeof(GridRow)) + row.id.len
+		for key, value in row.cells {
+			total += 2 * i64(sizeof(string)) + key.len + value.len + grid_map_entry_overhead
+		}
+	}
+	return total
+}
+
+// memory_report compares the store with the []GridRow it replaces,
+// including the per-million-row cost of each.
+pub fn (store &GridColumnStore) memory_report() GridColumnStoreMemory {
+	columnar := store.memory_bytes()
+	sample := int_min(store.len, grid_column_memory_sample)
+	mut map_bytes := i64(0)
+	if sample > 0 {
+		step := store.len / sample
+		mut sampled := []GridRow{cap: sample}
+		for i in 0 .. sample {
+			sampled << store.row(i * step)
+		}
+		map_bytes = grid_rows_memory_bytes(sampled) * store.len / sample
+	}
+	return GridColumnStoreMemory{
+		rows:                       store.len
+		columns:                    store.columns.len
+		columnar_bytes:             columnar
+		map_bytes:                  map_bytes
+		columnar_bytes_per_million: grid_per_million(columnar, store.len)
+		map_bytes_per_million:      grid_per_million(map_bytes, store.len)
+	}
+}
+
+fn grid_per_million(bytes i64, rows int) i64 {
+	if rows <= 0 {
+		return 0
+	}
+	return bytes * 1_000_000 / rows
+}
+
+// --- column internals ---
+
+@[inline]
+fn grid_bitmap_words(n int) int {
+	return (n + 63) / 64
+}
+
+@[inline]
+fn grid_bit_get(bits []u64, i int) bool {
+	return bits[i >> 6] & (u64(1) << (i & 63)) != 0
+}
+
+@[inline]
+fn grid_bit_set(mut bits []u64, i int, value bool) {
+	for bits.len <= i >> 6 {
+		bits << 0
+	}
+	if value {
+		bits[i >> 6] |= u64(1) << (i & 63)
+	} else {
+		bits[i >> 6] &= ~(u64(1) << (i & 63))
+	}
+}
+
+@[inline]
+fn (col &GridColumnData) is_null(row int) bool {
+	return grid_bit_get(col.nulls, row)
+}
+
+// intern returns the dictionary code of value, adding it if new. The
+// column must be owned by the caller's version.
+fn (mut col GridColumnData) intern(value string) u32 {
+	if code := col.lookup[value] {
+		return code
+	}
+	code := u32(col.dict.len)
+	col.dict << value
+	col.lookup[value] = code
+	return code
+}
+
+// text formats a cell for display and text filtering.
+fn (col &GridColumnData) text(row int) string {
+	if row < 0 || row >= col.len || col.is_null(row) {
+		return ''
+	}
+	return match col.kind {
+		.text { col.dict[col.codes[row]] }
+		.integer { col.nums[row].str() }
+		.float { col.floats[row].str() }
+		.boolean { if grid_bit_get(col.bits, row) { 'true' } else { 'false' } }
+		.date { grid_format_date(col.nums[row]) }
+	}
+}
+
+fn grid_format_date(unix i64) string {
+	t := time.unix(unix)
+	if unix % 86400 == 0 {
+		return t.ymmdd()
+	}
+	return t.format_ss()
+}
+
+// store_text converts display text to the column's storage type and
+// writes it at row. Empty text, or blank text in a typed column, stores
+// null.
+fn (mut col GridColumnData) store_text(row int, text string) ! {
+	value := if col.kind == .text { text } else { text.trim_space() }
+	if value.len == 0 {
+		grid_bit_set(mut col.nulls, row, true)
+		return
+	}
+	match col.kind {
+		.text {
+			col.codes[row] = col.intern(text)
+		}
+		.integer {
+			col.nums[row] = strconv.parse_int(value, 10, 64) or {
+				return error('grid: ${col.id}: not an integer: ${text}')
+			}
+		}
+		.float {
+			col.floats[row] = strconv.atof64(value) or {
+				return error('grid: ${col.id}: not a number: ${text}')
+			}
+		}
+		.boolean {
+			lowered := value.to_lower()
+			if lowered !in ['true', 'false', '1', '0'] {
+				return error('grid: ${col.id}: not a boolean: ${text}')
+			}
+			grid_bit_set(mut col.bits, row, lowered == 'true' || lowered == '1')
+		}
+		.date {
+			t := time.parse(value) or {
+				time.parse_iso8601(value) or {
+					return error('grid: ${col.id}: not a date: ${text}')
+				}
+			}
+			col.nums[row] = t.unix()
+		}
+	}
+	grid_bit_set(mut col.nulls, row, false)
+}
+
+// push_null appends a null cell.
+fn (mut col GridColumnData) push_null() {
+	match col.kind {
+		.text { col.codes << 0 }
+		.integer, .date { col.nums << 0 }
+		.float { col.floats << 0 }
+		.boolean { grid_bit_set(mut col.bits, col.len, false) }
+	}
+	if col.kind == .text && col.dict.len == 0 {
+		col.intern('')
+	}
+	grid_bit_set(mut col.nulls, col.len, true)
+	col.len++
+}
+
+// push_text appends a cell parsed from text. On a parse error the
+// column is left unchanged.
+fn (mut col GridColumnData) push_text(text string) ! {
+	col.push_null()
+	col.store_text(col.len - 1, text) or {
+		col.truncate(col.len - 1)
+		return err
+	}
+}
+
+// truncate drops rows from n on.
+fn (mut col GridColumnData) truncate(n int) {
+	match col.kind {
+		.text { col.codes.trim(n) }
+		.integer, .date { col.nums.trim(n) }
+		.float { col.floats.trim(n) }
+		.boolean {}
+	}
+	for i in n .. col.len {
+		grid_bit_set(mut col.nulls, i, false)
+		if col.kind == .boolean {
+			grid_bit_set(mut col.bits, i, false)
+		}
+	}
+	col.len = n
+}
+
+// clone deep-copies the column, so an edit never touches a store that
+// a fetch may be reading.
+fn (col &GridColumnData) clone() GridColumnData {
+	return GridColumnData{
+		id:     col.id
+		kind:   col.kind
+		len:    col.len
+		nums:   col.nums.clone()
+		floats: col.floats.clone()
+		bits:   col.bits.clone()
+		codes:  col.codes.clone()
+		dict:   col.dict.clone()
+		lookup: col.lookup.clone()
+		nulls:  col.nulls.clone()
+	}
+}
+
+// keep returns the column with only the rows whose keep flag is set.
+fn (col &GridColumnData) keep(flags []bool, kept int) GridColumnData {
+	mut out := GridColumnData{
+		id:     col.id
+		kind:   col.kind
+		len:    kept
+		dict:   col.dict.clone()
+		lookup: col.lookup.clone()
+		nulls:  []u64{len: grid_bitmap_words(kept)}
+	}
+	match col.kind {
+		.text { out.codes = []u32{cap: kept} }
+		.integer, .date { out.nums = []i64{cap: kept} }
+		.float { out.floats = []f64{cap: kept} }
+		.boolean { out.bits = []u64{len: grid_bitmap_words(kept)} }
+	}
+	mut j := 0
+	for i in 0 .. col.len {
+		if !flags[i] {
+			continue
+		}
+		match col.kind {
+			.text { out.codes << col.codes[i] }
+			.integer, .date { out.nums << col.nums[i] }
+			.float { out.floats << col.floats[i] }
+			.boolean { grid_bit_set(mut out.bits, j, grid_bit_get(col.bits, i)) }
+		}
+		if col.is_null(i) {
+			grid_bit_set(mut out.nulls, j, true)
+		}
+		j++
+	}
+	return out
+}
+
+// add_column appends an all-null column. Caller ensures id is new.
+fn (mut store GridColumnStore) add_column(id string, kind GridColumnKind) int {
+	mut col := GridColumnData{
+		id:   id
+		kind: kind
+	}
+	for _ in 0 .. store.len {
+		col.push_null()
+	}
+	store.by_id[id] = store.columns.len
+	store.columns << col
+	return store.columns.len - 1
+}
+
+// fork returns a new version of the store for a mutation. Column
+// buffers, row IDs and the row index are shared with store; callers
+// own a column before writing to it and own_rows before adding rows.
+fn (store &GridColumnStore) fork() &GridColumnStore {
+	return &GridColumnStore{
+		len:     store.len
+		ids:     store.ids
+		columns: store.columns.clone()
+		by_id:   store.by_id.clone()
+		rows:    store.rows
+	}
+}
+
+// set_len sets the row count. len is read-only, so this rebuilds the
+// header around the same buffers.
+fn (mut store GridColumnStore) set_len(n int) {
+	store = GridColumnStore{
+		...store
+		len: n
+	}
+}
+
+// own gives the fork a private copy of column col, once per mutation.
+fn (mut store GridColumnStore) own(col int, mut owned map[int]bool) {
+	if !owned[col] {
+		store.columns[col] = store.columns[col].clone()
+		owned[col] = true
+	}
+}
+
+// own_rows gives the fork private copies of every column, the row IDs
+// and the row index, so appending rows never writes into buffers that
+// store's base or a sibling fork still reads.
+fn (mut store GridColumnStore) own_rows(mut owned map[int]bool) {
+	for col in 0 .. store.columns.len {
+		store.own(col, mut owned)
+	}
+	store.ids = store.ids.clone()
+	if store.rows != unsafe { nil } {
+		store.rows = &GridRowIndex{
+			by_id: store.rows.by_id.clone()
+		}
+	}
+}
+
+// row_index returns the index of the row with ID id, building the row
+// index on first use.
+fn (mut store GridColumnStore) row_index(id string) ?int {
+	if store.rows == unsafe { nil } {
+		mut rows := &GridRowIndex{}
+		for i in 0 .. store.len {
+			rows.by_id[store.row_id(i)] = i
+		}
+		store.rows = rows
+	}
+	return store.rows.by_id[id] or { return none }
+}
+
+// --- query ---
+
+// GridColumnMatcher is one text predicate (quick filter or column
+// filter) prepared against a store. Text columns are evaluated once per
+// dictionary entry and booleans once per value; numeric and date
+// columns format each row unless the needle holds a byte their display
+// text never contains.
+struct GridColumnMatcher {
+	col      int // -1: column not in store, every cell is ''
+	op       string
+	value    string
+	on_empty bool   // result for null cells
+	dict     []bool // text: result per dictionary code
+	on_true  bool
+	on_false bool
+	miss     bool // numeric/date: no formatted value can match
+}
+
+fn (store &GridColumnStore) matcher(col int, op string, value string) GridColumnMatcher {
+	on_empty := grid_filter_matches_lower('', op, value)
+	if col < 0 {
+		return GridColumnMatcher{
+			col:      -1
+			on_empty: on_empty
+		}
+	}
+	c := &store.columns[col]
+	allowed := match c.kind {
+		.integer { '0123456789-' }
+		.float { '0123456789-+.einfa' }
+		else { '0123456789-: ' }
+	}
+	return match c.kind {
+		.text {
+			GridColumnMatcher{
+				col:      col
+				on_empty: on_empty
+				dict:     []bool{len: c.dict.len, init: grid_filter_matches_lower(c.dict[index],
+					op, value)}
+			}
+		}
+		.boolean {
+			GridColumnMatcher{
+				col:      col
+				on_empty: on_empty
+				on_true:  grid_filter_matches_lower('true', op, value)
+				on_false: grid_filter_matches_lower('false', op, value)
+			}
+		}
+		else {
+			GridColumnMatcher{
+				col:      col
+				op:       op
+				value:    value
+				on_empty: on_empty
+				miss:     !grid_chars_within(value, allowed)
+			}
+		}
+	}
+}
+
+fn (m &GridColumnMatcher) matches(store &GridColumnStore, row int) bool {
+	if m.col < 0 {
+		return m.on_empty
+	}
+	col := &store.columns[m.col]
+	if col.is_null(row) {
+		return m.on_empty
+	}
+	return match col.kind {
+		.text { m.dict[col.codes[row]] }
+		.boolean { if grid_bit_get(col.bits, row) { m.on_true } else { m.on_false } }
+		else { !m.miss && grid_filter_matches_lower(col.text(row), m.op, m.value) }
+	}
+}
+
+// grid_chars_within reports whether every byte of s is in allowed.
+fn grid_chars_within(s string, allowed string) bool {
+	for ch in s {
+		if !allowed.contains_u8(ch) {
+			return false
+		}
+	}
+	return true
+}
+
+// query returns the indices of the rows matching query, in sort order.
+fn (store &GridColumnStore) query(query GridQueryState) []int {
+	mut idxs := []int{cap: store.len}
+	if query.quick_filter.len == 0 && query.filters.len == 0 {
+		for i in 0 .. store.len {
+			idxs << i
+		}
+	} else {
+		needle := query.quick_filter.to_lower()
+		mut quick := []GridColumnMatcher{}
+		if needle.len > 0 {
+			for col in 0 .. store.columns.len {
+				quick << store.matcher(col, 'contains', needle)
+			}
+		}
+		mut filters := []GridColumnMatcher{cap: query.filters.len}
+		for filter in query.filters {
+			filters << store.matcher(store.by_id[filter.col_id] or { -1 }, filter.op,
+				filter.value.to_lower())
+		}
+		for i in 0 .. store.len {
+			if needle.len > 0 && !quick.any(it.matches(store, i)) {
+				continue
+			}
+			if filters.all(it.matches(store, i)) {
+				idxs << i
+			}
+		}
+	}
+	if query.sorts.len > 0 && idxs.len > 1 {
+		store.sort_indices(mut idxs, query.sorts)
+	}
+	return idxs
+}
+
+// GridColumnSortKey is a sort key resolved against a store. ranks
+// orders a text column's dictionary codes.
+struct GridColumnSortKey {
+	col   int
+	dir   int
+	ranks []u32
+}
+
+// sort_indices orders row indices by typed value: numbers and dates
+// numerically, booleans false before true, text by string. Nulls sort
+// first ascending, as '' does in rows mode.
+fn (store &GridColumnStore) sort_indices(mut idxs []int, sorts []GridSort) {
+	mut keys := []GridColumnSortKey{cap: sorts.len}
+	for sort in sorts {
+		col := store.by_id[sort.col_id] or { continue }
+		mut ranks := []u32{}
+		c := &store.columns[col]
+		if c.kind == .text {
+			dict := c.dict
+			mut order := []int{len: dict.len, init: index}
+			order.sort_with_compare(fn [dict] (a &int, b &int) int {
+				return if dict[*a] < dict[*b] {
+					-1
+				} else if dict[*a] > dict[*b] {
+					1
+				} else {
+					0
+				}
+			})
+			ranks = []u32{len: dict.len}
+			for rank, code in order {
+				ranks[code] = u32(rank)
+			}
+		}
+		keys << GridColumnSortKey{
+			col:   col
+			dir:   if sort.dir == .asc { 1 } else { -1 }
+			ranks: ranks
+		}
+	}
+	if keys.len == 0 {
+		return
+	}
+	columns := store.columns
+	idxs.sort_with_compare(fn [columns, keys] (ia &int, ib &int) int {
+		a := *ia
+		b := *ib
+		for key in keys {
+			cmp := grid_column_compare(&columns[key.col], key.ranks, a, b)
+			if cmp != 0 {
+				return cmp * key.dir
+			}
+		}
+		return 0
+	})
+}
+
+fn grid_column_compare(col &GridColumnData, ranks []u32, a int, b int) int {
+	an := col.is_null(a)
+	bn := col.is_null(b)
+	if an || bn {
+		return if an && bn {
+			0
+		} else if an {
+			-1
+		} else {
+			1
+		}
+	}
+	match col.kind {
+		.text {
+			ra := ranks[col.codes[a]]
+			rb := ranks[col.codes[b]]
+			return if ra < rb { -1 } else if ra > rb { 1 } else { 0 }
+		}
+		.integer, .date {
+			return if col.nums[a] < col.nums[b] {
+				-1
+			} else if col.nums[a] > col.nums[b] {
+				1
+			} else {
+				0
+			}
+		}
+		.float {
+			return if col.floats[a] < col.floats[b] {
+				-1
+			} else if col.floats[a] > col.floats[b] {
+				1
+			} else {
+				0
+			}
+		}
+		.boolean {
+			va := grid_bit_get(col.bits, a)
+			vb := grid_bit_get(col.bits, b)
+			return if va == vb { 0 } else if vb { -1 } else { 1 }
+		}
+	}
+}
+
+// --- InMemoryDataSource over a store ---
+
+fn data_grid_source_columnar_fetch(store &GridColumnStore, default_limit int, latency_ms int, row_count_known bool, req GridDataRequest) !GridDataResult {
+	data_grid_source_sleep_with_abort(req.signal, latency_ms)!
+	idxs := store.query(req.query)
+	grid_abort_check(req.signal)!
+	start, end := data_grid_source_page_bounds(req.page, idxs.len, default_limit)
+	return data_grid_source_page_result(store.rows_at(idxs[start..end]), req, start, end,
+		idxs.len, row_count_known)
+}
+
+// data_grid_source_columnar_mutate applies a mutation to a fork of the
+// store and returns the fork, leaving `store` intact for any fetch
+// still reading it. A cell edit copies only the edited columns.
+fn data_grid_source_columnar_mutate(store &GridColumnStore, latency_ms int, row_count_known bool, req GridMutationRequest) !(&GridColumnStore, GridMutationResult) {
+	data_grid_source_sleep_with_abort(req.signal, latency_ms)!
+	mut work := store.fork()
+	result := match req.kind {
+		.create { work.apply_create(req.rows)! }
+		.update { work.apply_update(req.rows, req.edits)! }
+		.delete { work.apply_delete(req.rows, req.row_ids) }
+	}
+	grid_abort_check(req.signal)!
+	return work, GridMutationResult{
+		created:     result.created
+		updated:     result.updated
+		deleted_ids: result.deleted_ids
+		row_count:   if row_count_known { ?int(work.len) } else { none }
+	}
+}
+
+// ensure_ids gives every row an explicit ID, so IDs survive deletes.
+fn (mut store GridColumnStore) ensure_ids() {
+	if store.ids.len == 0 {
+		store.ids = []string{len: store.len, init: index.str()}
+	}
+}
+
+// column_for returns the index of column col_id, adding an owned text
+// column when it is new.
+fn (mut store GridColumnStore) column_for(col_id string, mut owned map[int]bool) int {
+	if col := store.by_id[col_id] {
+		return col
+	}
+	col := store.add_column(col_id, .text)
+	owned[col] = true
+	return col
+}
+
+fn (mut store GridColumnStore) apply_create(req_rows []GridRow) !GridMutationApplyResult {
+	if req_rows.len == 0 {
+		return GridMutationApplyResult{}
+	}
+	mut owned := map[int]bool{}
+	store.own_rows(mut owned)
+	store.ensure_ids()
+	for row in req_rows {
+		for col_id, _ in row.cells {
+			store.column_for(col_id, mut owned)
+		}
+	}
+	mut created := []GridRow{cap: req_rows.len}
+	for row in req_rows {
+		next_id := data_grid_source_next_row_id(store.len, row.id, fn [mut store] (id string) bool {
+			return store.row_index(id) != none
+		})!
+		for mut col in store.columns {
+			col.push_text(row.cells[col.id] or { '' })!
+		}
+		store.ids << next_id
+		store.set_len(store.len + 1)
+		store.rows.by_id[next_id] = store.len - 1
+		created << store.row(store.len - 1)
+	}
+	return GridMutationApplyResult{
+		created: created
+	}
+}
+
+fn (mut store GridColumnStore) apply_update(req_rows []GridRow, edits []GridCellEdit) !GridMutationApplyResult {
+	mut owned := map[int]bool{}
+	mut touched := []int{}
+	mut seen := map[int]bool{}
+	for req_row in req_rows {
+		if req_row.id.len == 0 {
+			return error('grid: row id is required')
+		}
+		idx := store.row_index(req_row.id) or {
+			return error('grid: update row not found: ${req_row.id}')
+		}
+		for col_id, value in req_row.cells {
+			col := store.column_for(col_id, mut owned)
+			store.own(col, mut owned)
+			store.columns[col].store_text(idx, value)!
+		}
+		if !seen[idx] {
+			seen[idx] = true
+			touched << idx
+		}
+	}
+	for edit in edits {
+		if edit.row_id.len == 0 {
+			return error('grid: row id is required')
+		}
+		if edit.col_id.len == 0 {
+			return error('grid: edit has empty col id')
+		}
+		idx := store.row_index(edit.row_id) or {
+			return error('grid: edit row not found: ${edit.row_id}')
+		}
+		col := store.column_for(edit.col_id, mut owned)
+		store.own(col, mut owned)
+		store.columns[col].store_text(idx, edit.value)!
+		if !seen[idx] {
+			seen[idx] = true
+			touched << idx
+		}
+	}
+	return GridMutationApplyResult{
+		updated: store.rows_at(touched)
+	}
+}
+
+fn (mut store GridColumnStore) apply_delete(req_rows []GridRow, req_row_ids []string) GridMutationApplyResult {
+	id_set := grid_deduplicate_row_ids(req_rows, req_row_ids)
+	if id_set.len == 0 {
+		return GridMutationApplyResult{}
+	}
+	store.ensure_ids()
+	mut flags := []bool{len: store.len, init: true}
+	mut deleted_ids := []string{cap: id_set.len}
+	mut ids := []string{cap: store.len}
+	for i, id in store.ids {
+		if id_set[id] {
+			flags[i] = false
+			deleted_ids << id
+		} else {
+			ids << id
+		}
+	}
+	if deleted_ids.len == 0 {
+		return GridMutationApplyResult{}
+	}
+	store.columns = []GridColumnData{len: store.columns.len, init: store.columns[index].keep(flags,
+		ids.len)}
+	store.ids = ids
+	store.set_len(ids.len)
+	store.rows = unsafe { nil } // indices shifted; rebuilt on next use
+	return GridMutationApplyResult{
+		deleted_ids: deleted_ids
+	}
+}
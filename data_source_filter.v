@@ -0,0 +1,233 @@
+module gui
+
+// data_source_filter.v speeds up the quick filter of InMemoryDataSource
+// while the user types. Filtering used to lower the text of every cell
+// of every row on each keystroke. The source now keeps a
+// GridFilterCache:
+// - each row's cells are lowered once per data version into one byte
+//   buffer, separated by 0x1f, so "any cell contains" is one search
+// - the last result is kept; when the new needle contains the previous
+//   one and the column filters are unchanged, only the previous matches
+//   are scanned
+// - the search skips ahead 8 bytes at a time to candidate first bytes
+// - large scans are split across threads
+// - an optional GridTextIndex (text_index.v) narrows the rows scanned
+// The cache is keyed on InMemoryDataSource.version together with the
+// rows array, so replacing `rows` (as every mutation does) or bumping
+// the version rebuilds it. With version zero, edit rows in place only
+// by replacing the array; an in-place cell edit is not seen.
+import math.bits
+import runtime
+import sync
+
+const grid_filter_parallel_min = 65536
+const grid_filter_max_threads = 8
+const grid_filter_cell_sep = u8(0x1f)
+
+// GridFilterCache is InMemoryDataSource's quick-filter state. Fetches
+// may overlap on worker threads, so all access holds mutex.
+@[heap]
+struct GridFilterCache {
+mut:
+	mutex   &sync.Mutex = sync.new_mutex()
+	data    voidptr // rows.data the cache was built from
+	len     int
+	version u64 // InMemoryDataSource.version the cache was built for
+	text    []u8  // lowered cells; row i is text[offsets[i]..offsets[i + 1]]
+	offsets []int // rows.len + 1 entries once built
+	valid   bool  // needle/filters/matches hold a result
+	needle  string
+	filters []GridFilterLowered
+	matches []int
+	refined u64 // filters answered from the previous result
+}
+
+// filter returns the indices of rows matching needle and filters. With
+// a text index, the needle is only verified on the rows the index
+// returns, against the index's columns: an index over some columns
+// narrows the quick filter to them.
+fn (mut cache GridFilterCache) filter(rows []GridRow, version u64, needle string, filters []GridFilterLowered, text_index &GridTextIndex) []int {
+	cache.mutex.lock()
+	defer {
+		cache.mutex.unlock()
+	}
+	if cache.data != rows.data || cache.len != rows.len || cache.version != version {
+		cache.reset(rows, version)
+	}
+	refine := cache.valid && filters == cache.filters && needle.contains(cache.needle)
+	if refine && needle == cache.needle {
+		return cache.matches
+	}
+	mut columns := []string{}
+	mut candidates := if refine {
+		cache.refined++
+		cache.matches
+	} else {
+		[]int{len: rows.len, init: index}
+	}
+	if text_index != unsafe { nil } {
+		mut idx := unsafe { text_index }
+		columns = idx.columns
+		if needle.len >= text_index_gram_len && idx.rows_current(rows, version) {
+			if hits := idx.candidates(needle, rows.data, rows.len, version) {
+				candidates = if refine { text_index_intersect(candidates, hits) } else { hits }
+			}
+		}
+	} else if needle.len > 0 && cache.offsets.len == 0 {
+		cache.build_text(rows)
+	}
+	threads := if candidates.len >= grid_filter_parallel_min {
+		int_min(grid_filter_max_threads, runtime.nr_cpus())
+	} else {
+		1
+	}
+	matches := grid_filter_scan_parallel(rows, cache.text, cache.offsets, columns, candidates,
+		needle, filters, threads)
+	cache.valid = true
+	cache.needle = needle
+	cache.filters = filters.clone()
+	cache.matches = matches
+	return matches
+}
+
+fn (mut cache GridFilterCache) reset(rows []GridRow, version u64) {
+	cache.data = rows.data
+	cache.len = rows.len
+	cache.version = version
+	cache.text = []u8{}
+	cache.offsets = []int{}
+	cache.valid = false
+	cache.needle = ''
+	cache.filters = []GridFilterLowered{}
+	cache.matches = []int{}
+}
+
+// build_text lowers every row's cells into one buffer.
+fn (mut cache GridFilterCache) build_text(rows []GridRow) {
+	mut size := 0
+	for row in rows {
+		for _, value in row.cells {
+			size += value.len + 1
+		}
+	}
+	mut text := []u8{cap: size}
+	mut offsets := []int{cap: rows.len + 1}
+	for row in rows {
+		offsets << text.len
+		for _, value in row.cells {
+			for i in 0 .. value.len {
+				text << grid_lower_byte(value[i])
+			}
+			text << grid_filter_cell_sep
+		}
+	}
+	offsets << text.len
+	cache.text = text
+	cache.offsets = offsets
+}
+
+// grid_filter_scan_parallel filters candidates on `threads` threads,
+// keeping candidate order. Without a text buffer (offsets empty) the
+// needle is checked cell by cell, in `columns` when given.
+fn grid_filter_scan_parallel(rows []GridRow, text []u8, offsets []int, columns []string, candidates []int, needle string, filters []GridFilterLowered, threads int) []int {
+	if threads <= 1 || candidates.len < 2 * threads {
+		return grid_filter_scan(rows, text, offsets, columns, candidates, needle, filters)
+	}
+	chunk := (candidates.len + threads - 1) / threads
+	mut scans := []thread []int{cap: threads}
+	for start := 0; start < candidates.len; start += chunk {
+		scans << spawn grid_filter_scan(rows, text, offsets, columns, candidates[start..int_min(candidates.len,
+			start + chunk)], needle, filters)
+	}
+	parts := scans.wait()
+	mut total := 0
+	for part in parts {
+		total += part.len
+	}
+	mut matches := []int{cap: total}
+	for part in parts {
+		matches << part
+	}
+	return matches
+}
+
+fn grid_filter_scan(rows []GridRow, text []u8, offsets []int, columns []string, candidates []int, needle string, filters []GridFilterLowered) []int {
+	mut matches := []int{}
+	for i in candidates {
+		if needle.len > 0 {
+			found := if offsets.len > 0 {
+				grid_bytes_contain(text, offsets[i], offsets[i + 1], needle)
+			} else {
+				grid_row_contains_lower(rows[i], columns, needle)
+			}
+			if !found {
+				continue
+			}
+		}
+		if filters.len > 0 && !data_grid_source_row_matches_query(rows[i], '', filters) {
+			continue
+		}
+		matches << i
+	}
+	return matches
+}
+
+// grid_row_contains_lower reports whether any of the row's cells in
+// columns (all cells when empty) contains needle.
+fn grid_row_contains_lower(row GridRow, columns []string, needle string) bool {
+	if columns.len == 0 {
+		for _, value in row.cells {
+			if grid_contains_lower(value, needle) {
+				return true
+			}
+		}
+		return false
+	}
+	for col_id in columns {
+		if grid_contains_lower(row.cells[col_id] or { '' }, needle) {
+			return true
+		}
+	}
+	return false
+}
+
+// grid_bytes_contain reports whether needle occurs in
+// hay[start..end]. Eight bytes at a time are tested for the needle's
+// first byte (SWAR); only candidate positions are compared in full.
+@[direct_array_access]
+fn grid_bytes_contain(hay []u8, start int, end int, needle string) bool {
+	n := needle.len
+	if n == 0 {
+		return true
+	}
+	last := end - n // last possible match position
+	if last < start {
+		return false
+	}
+	first := needle[0]
+	mut i := start
+	$if little_endian {
+		ones := u64(0x0101010101010101)
+		highs := u64(0x8080808080808080)
+		pattern := u64(first) * ones
+		for i + 7 <= last {
+			x := unsafe { *(&u64(&hay[i])) } ^ pattern
+			mut found := (x - ones) & ~x & highs
+			for found != 0 {
+				pos := i + bits.trailing_zeros_64(found) / 8
+				if unsafe { vmemcmp(&hay[pos], needle.str, n) } == 0 {
+					return true
+				}
+				found &= found - 1
+			}
+			i += 8
+		}
+	}
+	for i <= last {
+		if hay[i] == first && unsafe { vmemcmp(&hay[i], needle.str, n) } == 0 {
+			return true
+		}
+		i++
+	}
+	return false
+}
@@ -1,6 +1,7 @@
 module gui
 
 import hash.fnv1a
+import time
 
 const data_grid_default_page_limit = 100
 const data_grid_jump_input_width = 68
@@ -15,6 +16,21 @@ pub:
 	has_more         bool
 	received_count   int
 	row_count        ?int
+	cache_hits       int // pages shown from the page cache
+	cache_misses     int // pages fetched while the cache was enabled
+	cache_hit_rate   f64 // hits / (hits + misses), 0 when unused
+	cache_pages      int
+	cache_bytes      int
+	prefetch_count   int
+	prefetch_joins   int // pages shown from a prefetch still running when visited
+	deduped_count    int // requests served by another view's identical fetch
+	deferred_count   int // request keys held back by debounce or throttle
+	latency_ms       f64 // moving average of fetch latency
+	live_received    u64 // row patches pushed by DataGridCfg.live_feed
+	live_coalesced   u64 // patches merged into one already pending
+	live_applied     u64 // rows changed, added or removed by patches
+	live_relayouts   u64 // patch batches that changed generated rows
+	live_refetches   u64 // pages refetched because a patch may move rows
 }
 
 // data_grid_source_stats returns runtime async stats for a data-source grid.
@@ -23,7 +39,7 @@ pub fn (window &Window) data_grid_source_stats(grid_id string) DataGridSourceSta
 		return DataGridSourceStats{}
 	}
 	if state := dg_src.get(grid_id) {
-		return DataGridSourceStats{
+		mut stats := DataGridSourceStats{
 			loading:          state.loading
 			load_error:       state.load_error
 			request_count:    state.request_count
@@ -32,7 +48,38 @@ pub fn (window &Window) data_grid_source_stats(grid_id string) DataGridSourceSta
 			has_more:         state.has_more
 			received_count:   state.received_count
 			row_count:        state.row_count
+			deduped_count:    state.deduped_count
+			deferred_count:   state.pacer.deferred
+			latency_ms:       state.pacer.latency_ms
 		}
+		if state.page_cache != unsafe { nil } {
+			cache := state.page_cache
+			lookups := cache.hits + cache.misses
+			stats = DataGridSourceStats{
+				...stats
+				cache_hits:     cache.hits
+				cache_misses:   cache.misses
+				cache_hit_rate: if lookups > 0 { f64(cache.hits) / f64(lookups) } else { 0 }
+				cache_pages:    cache.pages.len
+				cache_bytes:    cache.bytes
+				prefetch_count: cache.prefetches
+				prefetch_joins: cache.joins
+			}
+		}
+		if !isnil(state.live) {
+			mut live := unsafe { state.live }
+			live.mutex.lock()
+			stats = DataGridSourceStats{
+				...stats
+				live_received:  live.received
+				live_coalesced: live.coalesced
+				live_applied:   live.applied
+				live_relayouts: live.relayouts
+				live_refetches: live.refetches
+			}
+			live.mutex.unlock()
+		}
+		return stats
 	}
 	return DataGridSourceStats{}
 }
@@ -41,6 +88,7 @@ fn data_grid_source_apply_local_mutation(grid_id string, rows []GridRow, row_cou
 	mut dg_src := state_map[string, DataGridSourceState](mut window, ns_dg_source, cap_moderate)
 	mut state := dg_src.get(grid_id) or { DataGridSourceState{} }
 	data_grid_source_cancel_active(mut state)
+	data_grid_source_clear_page_cache(mut state)
 	state.request_id++
 	state.rows = rows
 	state.received_count = rows.len
@@ -48,7 +96,13 @@ fn data_grid_source_apply_local_mutation(grid_id string, rows []GridRow, row_cou
 	state.loading = false
 	state.load_error = ''
 	state.rows_dirty = true
-	state.rows_signature = data_grid_rows_signature(rows, []string{})
+	if state.rows_version != 0 {
+		// Versioned source: a local mutation is a new revision.
+		state.rows_version = data_grid_fnv64_u64(state.rows_version, state.request_id)
+		state.rows_signature = state.rows_version
+	} else {
+		state.rows_signature = data_grid_rows_signature(rows, []string{})
+	}
 	state.active_abort = unsafe { nil }
 	if count := row_count {
 		state.row_count = ?int(count)
@@ -77,6 +131,7 @@ fn data_grid_source_force_refetch(grid_id string, mut window Window) {
 	mut dg_src := state_map[string, DataGridSourceState](mut window, ns_dg_source, cap_moderate)
 	mut state := dg_src.get(grid_id) or { return }
 	data_grid_source_cancel_active(mut state)
+	data_grid_source_clear_page_cache(mut state)
 	state.loading = false
 	state.request_key = ''
 	state.load_error = ''
@@ -86,6 +141,35 @@ fn data_grid_source_force_refetch(grid_id string, mut window Window) {
 	window.update_window()
 }
 
+// data_grid_column_store_cfg serves cfg.column_store through an
+// InMemoryDataSource kept per grid, so edits persist across frames and
+// only fetched pages become GridRows. Passing a different store replaces
+// the source and refetches.
+fn data_grid_column_store_cfg(cfg DataGridCfg, mut window Window) DataGridCfg {
+	mut sources := state_map[string, DataGridColumnSourceState](mut window, ns_dg_column_source,
+		cap_moderate)
+	mut entry := sources.get(cfg.id) or { DataGridColumnSourceState{} }
+	if voidptr(entry.store) != voidptr(cfg.column_store) {
+		had_source := entry.source != unsafe { nil }
+		entry = DataGridColumnSourceState{
+			store:  cfg.column_store
+			source: &InMemoryDataSource{
+				columns:       cfg.column_store
+				default_limit: data_grid_page_limit(cfg)
+				version:       1
+			}
+		}
+		sources.set(cfg.id, entry)
+		if had_source {
+			data_grid_source_force_refetch(cfg.id, mut window)
+		}
+	}
+	return DataGridCfg{
+		...cfg
+		data_source: entry.source
+	}
+}
+
 fn data_grid_has_source(cfg DataGridCfg) bool {
 	return cfg.data_source != none
 }
@@ -119,9 +203,10 @@ fn data_grid_resolve_source_cfg(cfg DataGridCfg, mut window Window) (DataGridCfg
 		rows:       rows
 		page_size:  0
 		page_index: 0
-		loading:    state.loading
-		load_error: state.load_error
-		row_count:  row_count
+		loading:      state.loading
+		load_error:   state.load_error
+		row_count:    row_count
+		rows_version: state.rows_version
 	}
 	return resolved, state, true, caps
 }
@@ -160,10 +245,19 @@ fn data_grid_source_resolve_state(cfg DataGridCfg, caps GridDataCapabilities, mu
 			state.request_key = ''
 		}
 	}
+	data_grid_source_sync_page_cache(cfg, mut state)
+	data_grid_live_sync(cfg, mut state, mut window)
 	request_key := data_grid_source_request_key(cfg, state, kind, query_sig)
-	if request_key != state.request_key {
+	// Only query changes wait for the query to settle; paging does not.
+	debounce := state.has_loaded && query_sig.str() != state.pacer.started_query
+	if request_key != state.request_key
+		&& !data_grid_source_cache_hit(request_key, caps, mut state)
+		&& !data_grid_source_join_prefetch(request_key, mut state)
+		&& grid_request_ready(cfg.request_policy, request_key, debounce, '${cfg.id}:request_pacing', mut
+		state.pacer, mut window) {
 		data_grid_source_start_request(cfg, caps, kind, request_key, mut state, mut window)
 	}
+	data_grid_source_prefetch(cfg, kind, query_sig, mut state, mut window)
 	state.rows_dirty = false
 	dg_src.set(cfg.id, state)
 	return state
@@ -263,9 +357,37 @@ fn data_grid_source_request_key(cfg DataGridCfg, state DataGridSourceState, kind
 fn data_grid_source_start_request(cfg DataGridCfg, caps GridDataCapabilities, kind GridPaginationKind, request_key string, mut state DataGridSourceState, mut window Window) {
 	source := cfg.data_source or { return }
 	data_grid_source_cancel_active(mut state)
+	if !isnil(state.live) {
+		mut live := unsafe { state.live }
+		live.forget_replay()
+	}
 	limit := data_grid_page_limit(cfg)
-	controller := new_grid_abort_controller()
 	next_request_id := state.request_id + 1
+	state.pacer.note_start(state.query_signature.str(), time.ticks())
+	if state.page_cache != unsafe { nil } {
+		state.page_cache.misses++
+	}
+	share_key := grid_request_share_key(cfg.request_policy, request_key)
+	subscriber := GridRequestSubscriber{
+		id:         cfg.id
+		request_id: next_request_id
+	}
+	if joined := grid_shared_request_join(ns_dg_shared_request, share_key, subscriber, mut
+		window)
+	{
+		// An identical request is in flight; its result is delivered here too.
+		state.loading = true
+		state.load_error = ''
+		state.request_id = next_request_id
+		state.request_key = request_key
+		state.active_abort = joined
+		state.request_count++
+		state.deduped_count++
+		state.pagination_kind = kind
+		return
+	}
+	controller := grid_shared_request_lead(ns_dg_shared_request, share_key, subscriber, mut
+		window)
 	page := match kind {
 		.cursor {
 			GridPageRequest(GridCursorPageReq{
@@ -287,6 +409,7 @@ fn data_grid_source_start_request(cfg DataGridCfg, caps GridDataCapabilities, ki
 		page:       page
 		signal:     controller.signal
 		request_id: next_request_id
+		window:     window
 	}
 	state.loading = true
 	state.load_error = ''
@@ -295,41 +418,60 @@ fn data_grid_source_start_request(cfg DataGridCfg, caps GridDataCapabilities, ki
 	state.active_abort = controller
 	state.request_count++
 	state.pagination_kind = kind
-	grid_id := cfg.id
 	window.pin_layout_callback_reclaim() or { panic(err) }
-	window.suspend_layout_callback_tracking(fn [source, req, grid_id, next_request_id, caps, mut window] () {
-		spawn fn [source, req, grid_id, next_request_id, caps] (mut w Window) {
-			if req.signal.is_aborted() {
+	window.suspend_layout_callback_tracking(fn [source, req, subscriber, share_key, caps, mut window] () {
+		window.submit_work(WorkItem{
+			signal:    req.signal
+			on_cancel: fn (mut w Window) {
 				w.data_grid_source_queue_reclaim_pin_release()
-				return
 			}
-			result := source.fetch_data(req) or {
+			run:       fn [source, req, subscriber, share_key, caps] (mut w Window) {
+				result := source.fetch_data(req) or {
+					if req.signal.is_aborted() {
+						w.data_grid_source_queue_reclaim_pin_release()
+						return
+					}
+					err_msg := err.msg()
+					w.queue_command(fn [subscriber, share_key, req, err_msg] (mut w Window) {
+						for sub in grid_shared_request_take(ns_dg_shared_request, share_key,
+							req.signal, subscriber, mut w) {
+							data_grid_source_apply_error(sub.id, sub.request_id, err_msg, mut
+								w)
+						}
+						w.release_layout_callback_reclaim_pin()
+					})
+					return
+				}
 				if req.signal.is_aborted() {
 					w.data_grid_source_queue_reclaim_pin_release()
 					return
 				}
-				err_msg := err.msg()
-				w.queue_command(fn [grid_id, next_request_id, err_msg] (mut w Window) {
-					data_grid_source_apply_error(grid_id, next_request_id, err_msg, mut w)
+				w.queue_command(fn [subscriber, share_key, req, result, caps] (mut w Window) {
+					for sub in grid_shared_request_take(ns_dg_shared_request, share_key,
+						req.signal, subscriber, mut w) {
+						data_grid_source_apply_success(sub.id, sub.request_id, result, caps, mut
+							w)
+					}
 					w.release_layout_callback_reclaim_pin()
 				})
-				return
 			}
-			if req.signal.is_aborted() {
-				w.data_grid_source_queue_reclaim_pin_release()
-				return
-			}
-			w.queue_command(fn [grid_id, next_request_id, result, caps] (mut w Window) {
-				data_grid_source_apply_success(grid_id, next_request_id, result, caps, mut w)
-				w.release_layout_callback_reclaim_pin()
-			})
-		}(mut window)
+		})
 	}) or {
 		window.release_layout_callback_reclaim_pin()
 		panic(err)
 	}
 }
 
+// data_grid_source_rows_version combines a source data version with the
+// request that produced the page. Returns 0 when the source reports no
+// version, so callers fall back to hashing rows.
+fn data_grid_source_rows_version(version u64, request_key string) u64 {
+	if version == 0 {
+		return 0
+	}
+	return data_grid_fnv64_str(data_grid_fnv64_u64(data_grid_fnv64_offset, version), request_key)
+}
+
 fn data_grid_source_drop_if_stale(request_id u64, mut state DataGridSourceState, mut window Window, grid_id string) bool {
 	if request_id != state.request_id {
 		state.stale_drop_count++
@@ -346,10 +488,27 @@ fn data_grid_source_apply_success(grid_id string, request_id u64, result GridDat
 	if data_grid_source_drop_if_stale(request_id, mut state, mut window, grid_id) {
 		return
 	}
+	state.pacer.observe(time.ticks())
+	data_grid_source_store_result(mut state, result, caps)
+	if state.page_cache != unsafe { nil } {
+		state.page_cache.put(state.request_key, result)
+	}
+	data_grid_live_replay(mut state)
+	dg_src.set(grid_id, state)
+	window.update_window()
+}
+
+// data_grid_source_store_result shows result as the current page.
+fn data_grid_source_store_result(mut state DataGridSourceState, result GridDataResult, caps GridDataCapabilities) {
 	state.loading = false
 	state.load_error = ''
 	state.has_loaded = true
-	state.rows_signature = data_grid_rows_signature(result.rows, []string{})
+	state.rows_version = data_grid_source_rows_version(result.version, state.request_key)
+	state.rows_signature = if state.rows_version != 0 {
+		state.rows_version
+	} else {
+		data_grid_rows_signature(result.rows, []string{})
+	}
 	state.rows_dirty = true
 	state.rows = result.rows
 	state.next_cursor = result.next_cursor
@@ -366,8 +525,6 @@ fn data_grid_source_apply_success(grid_id string, request_id u64, result GridDat
 		state.row_count = none
 	}
 	state.active_abort = unsafe { nil }
-	dg_src.set(grid_id, state)
-	window.update_window()
 }
 
 fn data_grid_source_apply_error(grid_id string, request_id u64, err_msg string, mut window Window) {
@@ -444,6 +601,7 @@ fn data_grid_source_prev_page(grid_id string, kind GridPaginationKind, page_limi
 		}
 		state.offset_start = int_max(0, state.offset_start - page_limit)
 	}
+	data_grid_source_note_paging(mut state, -1)
 	state.request_key = ''
 	state.load_error = ''
 	dg_src.set(grid_id, state)
@@ -467,6 +625,7 @@ fn data_grid_source_next_page(grid_id string, kind GridPaginationKind, page_limi
 			state.offset_start = int_min(state.offset_start, int_max(0, total - 1))
 		}
 	}
+	data_grid_source_note_paging(mut state, 1)
 	state.request_key = ''
 	state.load_error = ''
 	dg_src.set(grid_id, state)
@@ -485,6 +644,7 @@ fn data_grid_source_jump_to_row(grid_id string, target_idx int, page_limit int,
 	state.pending_jump_row = target_idx
 	page_start := (target_idx / page_limit) * page_limit
 	if page_start != state.offset_start {
+		data_grid_source_note_paging(mut state, page_start - state.offset_start)
 		state.offset_start = page_start
 		state.request_key = ''
 		state.load_error = ''
@@ -0,0 +1,550 @@
+module gui
+
+// data_source_live.v pushes row changes into data-source grids. A grid
+// used to show a changed row only after refetching its whole page. Now
+// a producer publishes GridRowPatch values to a GridLiveFeed, and every
+// grid with DataGridCfg.live_feed set patches the page it shows:
+// - producers may publish from any thread. Patches wait in a per-grid
+//   inbox, coalesced by row id, so a burst costs one entry per row
+// - the first patch after a drain queues one command, so the main
+//   thread applies each frame's patches as one batch
+// - an upsert sets cells on the row with its id; a delete removes it.
+//   Ids not on the page are ignored (their page shows them when
+//   fetched), except that upserts append to the last page of an
+//   unsorted, unfiltered query
+// - the page keeps the server's order and filter. A patch that may
+//   move a row (it changes a sort or filter column, or adds a row to a
+//   sorted or filtered query) is applied in place and the page is
+//   refetched
+// - patches applied while a fetch is in flight are applied again to
+//   its result, which may predate them
+// - the window relayouts only when a patch touched a row the grid
+//   generated last frame, added or removed rows, or the grid groups or
+//   aggregates (headers summarize rows that are off screen). Other
+//   patches update the page for the next layout without causing one.
+// - a grid that was not generated by the last view is unsubscribed and
+//   subscribes again when it reappears
+import sync
+
+pub enum GridRowPatchKind as u8 {
+	upsert
+	delete
+}
+
+// GridRowPatch changes one row, found by id.
+pub struct GridRowPatch {
+pub:
+	kind  GridRowPatchKind
+	id    string
+	cells map[string]string // upsert: cells to set; others are kept
+}
+
+// GridLiveFeed carries row patches from a producer to the grids that
+// subscribed to it. Create with new_grid_live_feed and pass it to
+// DataGridCfg.live_feed; publish from any thread.
+@[heap]
+pub struct GridLiveFeed {
+mut:
+	mutex     &sync.Mutex = sync.new_mutex()
+	inboxes   []&GridLiveInbox
+	published u64
+}
+
+pub fn new_grid_live_feed() &GridLiveFeed {
+	return &GridLiveFeed{}
+}
+
+// publish sends patches to every subscribed grid.
+pub fn (mut feed GridLiveFeed) publish(patches []GridRowPatch) {
+	if patches.len == 0 {
+		return
+	}
+	feed.mutex.lock()
+	feed.published += u64(patches.len)
+	inboxes := feed.inboxes.clone()
+	feed.mutex.unlock()
+	for inbox in inboxes {
+		mut target := unsafe { inbox }
+		target.push(patches)
+	}
+}
+
+// upsert publishes new cell values for the row with id.
+pub fn (mut feed GridLiveFeed) upsert(id string, cells map[string]string) {
+	feed.publish([GridRowPatch{
+		kind:  .upsert
+		id:    id
+		cells: cells
+	}])
+}
+
+// delete publishes the removal of the row with id.
+pub fn (mut feed GridLiveFeed) delete(id string) {
+	feed.publish([GridRowPatch{
+		kind: .delete
+		id:   id
+	}])
+}
+
+fn (mut feed GridLiveFeed) subscribe(inbox &GridLiveInbox) {
+	feed.mutex.lock()
+	feed.inboxes << inbox
+	feed.mutex.unlock()
+}
+
+fn (mut feed GridLiveFeed) unsubscribe(inbox &GridLiveInbox) {
+	feed.mutex.lock()
+	feed.inboxes = feed.inboxes.filter(voidptr(it) != voidptr(inbox))
+	feed.mutex.unlock()
+}
+
+// GridLiveView is what the grid showed and queried at its last view
+// generation. It is written during view generation, which runs on the
+// layout thread in pipelined mode, and read by the main-thread drain.
+struct GridLiveView {
+	lo         int = -1 // generated data row indices
+	hi         int = -1
+	frozen_ids map[string]bool
+	summarized bool            // group headers or aggregates shown
+	query_cols map[string]bool // sort and filter columns
+	query_any  bool            // quick filter: every column counts
+	ordered    bool            // the query sorts or filters
+}
+
+// GridPatchLog is an insertion-ordered set of patches, merged by row id.
+struct GridPatchLog {
+mut:
+	order   []string
+	pending map[string]GridRowPatch
+}
+
+// add merges patch in; returns false when it merged into a pending one.
+fn (mut plog GridPatchLog) add(patch GridRowPatch) bool {
+	if old := plog.pending[patch.id] {
+		plog.pending[patch.id] = grid_row_patch_merge(old, patch)
+		return false
+	}
+	plog.order << patch.id
+	plog.pending[patch.id] = patch
+	return true
+}
+
+fn (mut plog GridPatchLog) take() []GridRowPatch {
+	patches := plog.order.map(plog.pending[it])
+	plog.order = []string{}
+	plog.pending = map[string]GridRowPatch{}
+	return patches
+}
+
+// GridLiveInbox is one grid's subscription. All fields are guarded by
+// mutex; producers push from any thread.
+@[heap]
+struct GridLiveInbox {
+mut:
+	mutex     &sync.Mutex   = sync.new_mutex()
+	window    &Window       = unsafe { nil }
+	feed      &GridLiveFeed = unsafe { nil }
+	grid_id   string
+	pending   GridPatchLog
+	replay    GridPatchLog // applied while a fetch was in flight
+	view      GridLiveView
+	queued    bool // a drain command is waiting
+	closed    bool
+	seen      bool // the grid was generated since the last sweep
+	received  u64
+	coalesced u64
+	applied   u64
+	relayouts u64
+	refetches u64
+}
+
+// push buffers patches, merging those for ids already pending, and
+// queues a drain unless one is waiting.
+fn (mut inbox GridLiveInbox) push(patches []GridRowPatch) {
+	inbox.mutex.lock()
+	defer {
+		inbox.mutex.unlock()
+	}
+	if inbox.closed {
+		return
+	}
+	for patch in patches {
+		inbox.received++
+		if !inbox.pending.add(patch) {
+			inbox.coalesced++
+		}
+	}
+	if inbox.queued || inbox.pending.order.len == 0 || isnil(inbox.window) {
+		return
+	}
+	inbox.queued = true
+	mut window := inbox.window
+	window.queue_command(fn [inbox] (mut w Window) {
+		data_grid_live_drain(inbox, mut w)
+	})
+}
+
+// take returns and clears the pending patches. A closed inbox has none.
+fn (mut inbox GridLiveInbox) take() []GridRowPatch {
+	inbox.mutex.lock()
+	defer {
+		inbox.mutex.unlock()
+	}
+	inbox.queued = false
+	return inbox.pending.take()
+}
+
+// close stops buffering and drops what is buffered.
+fn (mut inbox GridLiveInbox) close() {
+	inbox.mutex.lock()
+	inbox.closed = true
+	inbox.pending = GridPatchLog{}
+	inbox.replay = GridPatchLog{}
+	inbox.mutex.unlock()
+}
+
+fn (mut inbox GridLiveInbox) is_closed() bool {
+	inbox.mutex.lock()
+	defer {
+		inbox.mutex.unlock()
+	}
+	return inbox.closed
+}
+
+fn (mut inbox GridLiveInbox) snapshot() GridLiveView {
+	inbox.mutex.lock()
+	defer {
+		inbox.mutex.unlock()
+	}
+	return inbox.view
+}
+
+// remember keeps patches to re-apply to the result of the fetch in
+// flight.
+fn (mut inbox GridLiveInbox) remember(patches []GridRowPatch) {
+	inbox.mutex.lock()
+	for patch in patches {
+		inbox.replay.add(patch)
+	}
+	inbox.mutex.unlock()
+}
+
+// forget_replay drops remembered patches when a new fetch starts: its
+// result already includes them.
+fn (mut inbox GridLiveInbox) forget_replay() {
+	inbox.mutex.lock()
+	inbox.replay = GridPatchLog{}
+	inbox.mutex.unlock()
+}
+
+fn (mut inbox GridLiveInbox) take_replay() []GridRowPatch {
+	inbox.mutex.lock()
+	defer {
+		inbox.mutex.unlock()
+	}
+	return inbox.replay.take()
+}
+
+// grid_row_patch_merge combines two patches for one row: later cells
+// win, and a delete replaces anything before it.
+fn grid_row_patch_merge(old GridRowPatch, next GridRowPatch) GridRowPatch {
+	if next.kind == .delete || old.kind == .delete {
+		return next
+	}
+	mut cells := old.cells.clone()
+	for key, value in next.cells {
+		cells[key] = value
+	}
+	return GridRowPatch{
+		kind:  .upsert
+		id:    next.id
+		cells: cells
+	}
+}
+
+// data_grid_live_sync subscribes the grid to cfg.live_feed, moving the
+// subscription when the feed changes, and records the query.
+fn data_grid_live_sync(cfg DataGridCfg, mut state DataGridSourceState, mut window Window) {
+	if !isnil(state.live) {
+		mut live := unsafe { state.live }
+		if voidptr(live.feed) != voidptr(cfg.live_feed) || live.is_closed() {
+			window.live_unsubscribe(live)
+			state.live = unsafe { nil }
+		}
+	}
+	if isnil(cfg.live_feed) {
+		return
+	}
+	if isnil(state.live) {
+		inbox := &GridLiveInbox{
+			window:  window
+			feed:    cfg.live_feed
+			grid_id: cfg.id
+		}
+		mut feed := unsafe { cfg.live_feed }
+		feed.subscribe(inbox)
+		window.live_inboxes << inbox
+		state.live = inbox
+	}
+	mut query_cols := map[string]bool{}
+	for sort in cfg.query.sorts {
+		query_cols[sort.col_id] = true
+	}
+	for filter in cfg.query.filters {
+		query_cols[filter.col_id] = true
+	}
+	query_any := cfg.query.quick_filter.trim_space().len > 0
+	mut inbox := unsafe { state.live }
+	inbox.mutex.lock()
+	inbox.seen = true
+	inbox.view = GridLiveView{
+		...inbox.view
+		query_cols: query_cols
+		query_any:  query_any
+		ordered:    query_cols.len > 0 || query_any
+		summarized: cfg.group_by.len > 0 || cfg.aggregates.len > 0
+	}
+	inbox.mutex.unlock()
+}
+
+fn (mut window Window) live_unsubscribe(inbox &GridLiveInbox) {
+	mut target := unsafe { inbox }
+	target.close()
+	mut feed := target.feed
+	feed.unsubscribe(inbox)
+	window.live_inboxes = window.live_inboxes.filter(voidptr(it) != voidptr(inbox))
+}
+
+// sweep_live_inboxes unsubscribes grids the view just generated did not
+// include: grids that left the view, and inboxes whose grid state was
+// evicted and has since subscribed anew. Runs after view generation.
+fn (mut window Window) sweep_live_inboxes() {
+	for inbox in window.live_inboxes.clone() {
+		mut target := unsafe { inbox }
+		target.mutex.lock()
+		seen := target.seen
+		target.seen = false
+		target.mutex.unlock()
+		if !seen {
+			window.live_unsubscribe(inbox)
+		}
+	}
+}
+
+// close_live_inboxes ends the window's subscriptions so producers stop
+// queueing commands to it.
+fn (mut window Window) close_live_inboxes() {
+	for inbox in window.live_inboxes.clone() {
+		window.live_unsubscribe(inbox)
+	}
+}
+
+// data_grid_live_note_view records which data rows the grid generated
+// from presentation rows first..last.
+fn data_grid_live_note_view(state DataGridSourceState, presentation DataGridPresentation, first int, last int, frozen_ids map[string]bool) {
+	if isnil(state.live) {
+		return
+	}
+	mut lo := -1
+	mut hi := -1
+	for i in int_max(first, 0) .. int_min(last + 1, presentation.rows.len) {
+		idx := presentation.rows[i].data_row_idx
+		if idx < 0 {
+			continue
+		}
+		if lo < 0 || idx < lo {
+			lo = idx
+		}
+		if idx > hi {
+			hi = idx
+		}
+	}
+	mut inbox := unsafe { state.live }
+	inbox.mutex.lock()
+	inbox.view = GridLiveView{
+		...inbox.view
+		lo:         lo
+		hi:         hi
+		frozen_ids: frozen_ids
+	}
+	inbox.mutex.unlock()
+}
+
+// data_grid_live_drain applies an inbox's pending patches to its grid's
+// page. An inbox whose grid state is gone, or has moved on to another
+// inbox, is unsubscribed.
+fn data_grid_live_drain(inbox &GridLiveInbox, mut window Window) {
+	mut target := unsafe { inbox }
+	patches := target.take()
+	if target.is_closed() {
+		return
+	}
+	mut dg_src := state_map[string, DataGridSourceState](mut window, ns_dg_source, cap_moderate)
+	mut state := dg_src.get(target.grid_id) or {
+		window.live_unsubscribe(inbox)
+		return
+	}
+	if voidptr(state.live) != voidptr(inbox) {
+		window.live_unsubscribe(inbox)
+		return
+	}
+	if patches.len == 0 {
+		return
+	}
+	if state.loading {
+		target.remember(patches)
+	}
+	if !state.has_loaded {
+		return
+	}
+	view := target.snapshot()
+	changed, relayout, refetch := data_grid_live_apply(mut state, patches, view, false)
+	if !changed && !refetch {
+		return
+	}
+	if changed {
+		// Cached pages no longer match the source.
+		data_grid_source_clear_page_cache(mut state)
+		data_grid_live_bump(mut state, mut target)
+	}
+	target.mutex.lock()
+	if relayout || refetch {
+		target.relayouts++
+	}
+	if refetch && !state.loading {
+		// The next view generation fetches the page again; an in-flight
+		// fetch already returns the current order.
+		state.request_key = ''
+		target.refetches++
+	}
+	target.mutex.unlock()
+	dg_src.set(target.grid_id, state)
+	if relayout || refetch {
+		window.update_window()
+	}
+}
+
+// data_grid_live_replay re-applies patches received while the fetch
+// that produced state.rows was in flight.
+fn data_grid_live_replay(mut state DataGridSourceState) {
+	if isnil(state.live) {
+		return
+	}
+	mut inbox := unsafe { state.live }
+	patches := inbox.take_replay()
+	if patches.len == 0 {
+		return
+	}
+	changed, _, _ := data_grid_live_apply(mut state, patches, GridLiveView{}, true)
+	if changed {
+		data_grid_live_bump(mut state, mut inbox)
+	}
+}
+
+// data_grid_live_bump marks patched rows as changed. The signature is
+// chained instead of rehashing every row per batch.
+fn data_grid_live_bump(mut state DataGridSourceState, mut inbox GridLiveInbox) {
+	inbox.mutex.lock()
+	applied := inbox.applied
+	inbox.mutex.unlock()
+	if state.rows_version != 0 {
+		state.rows_version = data_grid_fnv64_u64(state.rows_version, applied)
+		state.rows_signature = state.rows_version
+	} else {
+		state.rows_signature = data_grid_fnv64_u64(state.rows_signature, applied)
+	}
+	state.rows_dirty = true
+}
+
+// data_grid_live_apply patches state.rows. It reports whether rows
+// changed, whether a generated row changed, and whether the page must
+// be refetched because a row may have moved. A replay only updates rows
+// already on the page.
+fn data_grid_live_apply(mut state DataGridSourceState, patches []GridRowPatch, view GridLiveView, replay bool) (bool, bool, bool) {
+	mut index := map[string]int{}
+	for i, row in state.rows {
+		index[row.id] = i
+	}
+	// The page may share its array with a cached result.
+	mut rows := state.rows.clone()
+	mut deleted := map[string]bool{}
+	mut applied := u64(0)
+	mut relayout := false
+	mut refetch := false
+	for patch in patches {
+		idx := index[patch.id] or { -1 }
+		if patch.kind == .delete {
+			if idx >= 0 {
+				deleted[patch.id] = true
+			}
+			continue
+		}
+		if idx < 0 {
+			if replay || state.has_more {
+				continue
+			}
+			if view.ordered {
+				// Where the row belongs is the server's call.
+				refetch = true
+				continue
+			}
+			rows << GridRow{
+				id:    patch.id
+				cells: patch.cells.clone()
+			}
+			index[patch.id] = rows.len - 1
+			applied++
+			relayout = true
+			if count := state.row_count {
+				state.row_count = ?int(count + 1)
+			}
+			continue
+		}
+		row := rows[idx]
+		mut cells := row.cells.clone()
+		mut same := true
+		for key, value in patch.cells {
+			if old := cells[key] {
+				if old == value {
+					continue
+				}
+			}
+			cells[key] = value
+			same = false
+			if !replay && (view.query_any || key in view.query_cols) {
+				refetch = true
+			}
+		}
+		if same {
+			continue
+		}
+		rows[idx] = GridRow{
+			...row
+			cells: cells
+		}
+		applied++
+		if view.summarized || (idx >= view.lo && idx <= view.hi) || patch.id in view.frozen_ids {
+			relayout = true
+		}
+	}
+	if deleted.len > 0 {
+		rows = rows.filter(it.id !in deleted)
+		applied += u64(deleted.len)
+		relayout = true
+		if count := state.row_count {
+			state.row_count = ?int(int_max(0, count - deleted.len))
+		}
+	}
+	if applied == 0 {
+		return false, false, refetch
+	}
+	if !isnil(state.live) {
+		mut inbox := unsafe { state.live }
+		inbox.mutex.lock()
+		inbox.applied += applied
+		inbox.mutex.unlock()
+	}
+	state.rows = rows
+	state.received_count = rows.len
+	return true, relayout, refetch
+}
@@ -1,8 +1,13 @@
 module gui
 
+import strings
+import sync
+import time
+
 const grid_orm_default_filter_ops = ['contains', 'equals', 'starts_with', 'ends_with']
 const grid_orm_max_filter_value_len = 500
 const grid_orm_max_filter_count = 100
+const grid_orm_cache_max_entries = 256
 
 @[minify]
 pub struct GridOrmColumnSpec {
@@ -16,7 +21,11 @@ pub:
 	filterable       bool = true
 	sortable         bool = true
 	case_insensitive bool = true
-	allowed_ops      []string
+	// keyset: opt-in; set only when cells hold the raw DB value, so
+	// they are usable as a seek bound. Sorting by a column without it
+	// falls back to offset paging.
+	keyset      bool
+	allowed_ops []string
 }
 
 @[minify]
@@ -26,8 +35,18 @@ pub:
 	sorts        []GridSort
 	filters      []GridFilter
 	limit        int = 100
-	offset       int
+	offset       int // logical position; not skipped when seeking
 	cursor       string
+	// Keyset paging: rows after (or, when seek_backward, before) the
+	// row whose sort values and id are seek. seek_field is the unique
+	// id column ordering ties; build_sql emits both. Backward rows come
+	// back in reverse order; fetch_data restores it.
+	seek          []string
+	seek_field    string
+	seek_backward bool
+	// need_count is false when a cached row count will be used and the
+	// count query can be skipped.
+	need_count bool = true
 }
 
 @[minify]
@@ -73,9 +92,18 @@ pub type GridOrmDeleteManyFn = fn (row_ids []string, signal &GridAbortSignal) ![
 // column validation, query normalization, and abort handling.
 // Construct via new_grid_orm_data_source() to pre-validate
 // columns and cache the column map. Direct construction
-// re-validates columns on each fetch/mutate call.
+// re-validates columns on each fetch/mutate call, and caches
+// neither built SQL nor row counts.
+//
+// keyset_field turns cursor pages into keyset (seek) pages:
+// the next page is the rows after the last row's sort values
+// and id, so deep pages cost the same as the first instead of
+// an O(offset) scan. Numbered pages still use offsets.
 @[heap; minify]
 pub struct GridOrmDataSource {
+	// Built SQL per query shape and recent row counts.
+	// Module-internal; built by new_grid_orm_data_source.
+	cache &GridOrmCache = unsafe { nil }
 pub:
 	columns         []GridOrmColumnSpec
 	column_map      map[string]GridOrmColumnSpec // validated; built by new_grid_orm_data_source
@@ -87,20 +115,28 @@ pub:
 	update_fn       GridOrmUpdateFn     = unsafe { nil }
 	delete_fn       GridOrmDeleteFn     = unsafe { nil }
 	delete_many_fn  GridOrmDeleteManyFn = unsafe { nil }
+	keyset_field    string        // unique row id db field, e.g. 'm.id'; enables keyset cursors
+	row_count_ttl   time.Duration // reuse a row count for the same filters this long
 }
 
 // new_grid_orm_data_source validates columns and builds
 // the cached column_map with pre-normalized filter ops.
 pub fn new_grid_orm_data_source(src GridOrmDataSource) !&GridOrmDataSource {
 	column_map := grid_orm_validate_column_map(src.columns)!
+	keyset_field := src.keyset_field.trim_space()
+	if keyset_field.len > 0 && !grid_orm_valid_db_field(keyset_field) {
+		return error('grid orm: invalid keyset_field: ${keyset_field}')
+	}
 	mut validated_columns := []GridOrmColumnSpec{cap: src.columns.len}
 	for col in src.columns {
 		validated_columns << column_map[col.id.trim_space()]
 	}
 	return &GridOrmDataSource{
 		...src
-		columns:    validated_columns
-		column_map: column_map
+		columns:      validated_columns
+		column_map:   column_map
+		keyset_field: keyset_field
+		cache:        &GridOrmCache{}
 	}
 }
 
@@ -134,17 +170,68 @@ pub fn (source GridOrmDataSource) fetch_data(req GridDataRequest) !GridDataResul
 	column_map := source.resolved_column_map()!
 	query := grid_orm_validate_query_with_map(req.query, column_map)!
 	limit, offset, cursor := grid_orm_resolve_page(req.page, source.default_limit)
-	page := source.fetch_fn(GridOrmQuerySpec{
+	seek_field := source.keyset_seek_field(query.sorts, column_map)
+	mut seek := GridOrmKeysetCursor{}
+	if req.page is GridCursorPageReq && seek_field.len > 0 {
+		if parsed := grid_orm_parse_keyset_cursor(req.page.cursor) {
+			// A cursor from a different sort cannot seek; its
+			// offset is still honored.
+			if parsed.values.len == query.sorts.len + 1 {
+				seek = parsed
+			}
+		}
+	}
+	count_key := grid_query_signature(GridQueryState{
 		quick_filter: query.quick_filter
-		sorts:        query.sorts
 		filters:      query.filters
-		limit:        limit
-		offset:       offset
-		cursor:       cursor
+	})
+	// A mutation during the fetch makes its count stale; the
+	// generation read here tells store_row_count to drop it.
+	count_generation := source.row_count_generation()
+	cached_count := source.cached_row_count(count_key)
+	mut need_count := true
+	if _ := cached_count {
+		need_count = false
+	}
+	page := source.fetch_fn(GridOrmQuerySpec{
+		quick_filter:  query.quick_filter
+		sorts:         query.sorts
+		filters:       query.filters
+		limit:         limit
+		offset:        offset
+		cursor:        cursor
+		seek:          seek.values
+		seek_field:    seek_field
+		seek_backward: seek.backward
+		need_count:    need_count
 	}, req.signal)!
 	grid_abort_check(req.signal)!
+	rows := if seek.backward { page.rows.reverse() } else { page.rows }
+	mut row_count := page.row_count
+	if count := page.row_count {
+		source.store_row_count(count_key, count, count_generation)
+	} else {
+		row_count = cached_count
+	}
 	mut next_cursor := page.next_cursor
 	mut prev_cursor := page.prev_cursor
+	if req.page is GridCursorPageReq && seek_field.len > 0 && rows.len > 0 {
+		// Rows after a backward page exist: it was reached from them.
+		first := grid_orm_keyset_values(rows[0], query.sorts)
+		last := grid_orm_keyset_values(rows.last(), query.sorts)
+		if first.len > 0 && last.len > 0 {
+			next_cursor = if page.has_more || seek.backward {
+				grid_orm_keyset_cursor(offset + rows.len, false, last)
+			} else {
+				''
+			}
+			prev_cursor = if offset > limit {
+				grid_orm_keyset_cursor(offset - limit, true, first)
+			} else {
+				data_grid_source_prev_cursor(offset, limit)
+			}
+		}
+	}
 	if req.page is GridCursorPageReq {
 		if next_cursor.len == 0 && page.has_more {
 			next_cursor = data_grid_source_cursor_from_index(offset + page.rows.len)
@@ -154,19 +241,61 @@ pub fn (source GridOrmDataSource) fetch_data(req GridDataRequest) !GridDataResul
 		}
 	}
 	return GridDataResult{
-		rows:           page.rows
+		rows:           rows
 		next_cursor:    next_cursor
 		prev_cursor:    prev_cursor
-		row_count:      page.row_count
+		row_count:      row_count
 		has_more:       page.has_more
-		received_count: page.rows.len
+		received_count: rows.len
+	}
+}
+
+// keyset_seek_field returns the field ordering ties for sorts,
+// or '' when keyset paging is off or a sorted column is not
+// usable as a seek bound.
+fn (source GridOrmDataSource) keyset_seek_field(sorts []GridSort, column_map map[string]GridOrmColumnSpec) string {
+	if source.keyset_field.len == 0 {
+		return ''
 	}
+	for sort in sorts {
+		col := column_map[sort.col_id] or { return '' }
+		if !col.keyset {
+			return ''
+		}
+	}
+	return source.keyset_field.trim_space()
+}
+
+fn (source GridOrmDataSource) cached_row_count(key u64) ?int {
+	if source.row_count_ttl <= 0 || isnil(source.cache) {
+		return none
+	}
+	mut cache := unsafe { source.cache }
+	return cache.row_count(key, source.row_count_ttl)
+}
+
+// row_count_generation returns the cache's mutation generation,
+// to pass to store_row_count after the fetch.
+fn (source GridOrmDataSource) row_count_generation() u64 {
+	if isnil(source.cache) {
+		return 0
+	}
+	mut cache := unsafe { source.cache }
+	return cache.count_generation()
+}
+
+fn (source GridOrmDataSource) store_row_count(key u64, count int, generation u64) {
+	if source.row_count_ttl <= 0 || isnil(source.cache) {
+		return
+	}
+	mut cache := unsafe { source.cache }
+	cache.put_row_count(key, count, generation)
 }
 
 pub fn (mut source GridOrmDataSource) mutate_data(req GridMutationRequest) !GridMutationResult {
 	grid_abort_check(req.signal)!
 	column_map := source.resolved_column_map()!
-	return match req.kind {
+	result := match req.kind {
 		.create {
 			if source.create_fn == unsafe { nil } {
 				return error('grid orm: create not supported')
@@ -218,6 +347,12 @@ pub fn (mut source GridOrmDataSource) mutate_data(req GridMutationRequest) !Grid
 			}
 		}
 	}
+	// Any committed mutation may change which rows match.
+	if !isnil(source.cache) {
+		mut cache := unsafe { source.cache }
+		cache.clear_row_counts()
+	}
+	return result
 }
 
 pub fn grid_orm_validate_query(query GridQueryState, columns []GridOrmColumnSpec) !GridQueryState {
@@ -396,14 +531,16 @@ pub:
 	limit_sql  string   // "limit ?"
 	offset_sql string   // "offset ?"
 	params     []string // ordered to match ? placeholders
+	shape      u64      // equal for queries differing only in values
 }
 
 // build_sql validates the query spec against the source's
 // columns and builds SQL fragments with parameterized
-// placeholders. Delegates to grid_orm_build_sql.
+// placeholders. Sources built by new_grid_orm_data_source
+// reuse the fragments of earlier queries with the same shape.
 pub fn (source GridOrmDataSource) build_sql(spec GridOrmQuerySpec) !GridOrmSqlBuilder {
 	column_map := source.resolved_column_map()!
-	return grid_orm_build_sql(spec, column_map)
+	return grid_orm_build_sql_cached(spec, column_map, source.cache)
 }
 
 // grid_orm_build_sql builds SQL fragments from a query spec
@@ -411,35 +548,130 @@ pub fn (source GridOrmDataSource) build_sql(spec GridOrmQuerySpec) !GridOrmSqlBu
 // ORDER BY) are included — caller composes the final query.
 // Use this when you have a column map but no GridOrmDataSource.
 pub fn grid_orm_build_sql(spec GridOrmQuerySpec, column_map map[string]GridOrmColumnSpec) !GridOrmSqlBuilder {
+	return grid_orm_build_sql_cached(spec, column_map, unsafe { nil })
+}
+
+// grid_orm_build_sql_cached builds SQL text once per query
+// shape when cache is set; params are built on every call.
+fn grid_orm_build_sql_cached(spec GridOrmQuerySpec, column_map map[string]GridOrmColumnSpec, cache &GridOrmCache) !GridOrmSqlBuilder {
 	query := grid_orm_validate_query_with_map(GridQueryState{
 		quick_filter: spec.quick_filter
 		sorts:        spec.sorts
 		filters:      spec.filters
 	}, column_map)!
-	mut params := []string{}
-	mut where_parts := []string{}
-	qf := grid_orm_build_quick_filter(query.quick_filter, column_map, mut params)
-	if qf.len > 0 {
-		where_parts << qf
+	seek_field := spec.seek_field.trim_space()
+	if seek_field.len > 0 && !grid_orm_valid_db_field(seek_field) {
+		return error('grid orm: invalid seek_field: ${seek_field}')
 	}
-	for filter in query.filters {
-		col := column_map[filter.col_id] or { continue }
-		clause := grid_orm_build_filter_clause(col.db_field, filter.op, filter.value,
-			col.case_insensitive, mut params)
-		where_parts << clause
+	seeking := spec.seek.len > 0
+	if seeking && (seek_field.len == 0 || spec.seek.len != query.sorts.len + 1) {
+		return error('grid orm: seek needs seek_field and one value per sort plus the row id')
 	}
-	order := grid_orm_build_order(query.sorts, column_map)
+	shape := grid_orm_sql_shape(query, seek_field, seeking, spec.seek_backward)
+	mut text := GridOrmSqlText{}
+	mut cached := false
+	if !isnil(cache) {
+		mut c := unsafe { cache }
+		if hit := c.sql_text(shape) {
+			text = hit
+			cached = true
+		}
+	}
+	if !cached {
+		text = grid_orm_sql_text(query, column_map, seek_field, seeking, spec.seek_backward)
+		if !isnil(cache) {
+			mut c := unsafe { cache }
+			c.put_sql_text(shape, text)
+		}
+	}
+	mut params := grid_orm_sql_params(query, column_map, spec.seek)
 	params << spec.limit.str()
-	params << spec.offset.str()
+	// Seeking replaces skipping; offset stays a logical position.
+	params << if seeking { '0' } else { spec.offset.str() }
 	return GridOrmSqlBuilder{
-		where_sql:  where_parts.join(' and ')
-		order_sql:  order
+		where_sql:  text.where_sql
+		order_sql:  text.order_sql
 		limit_sql:  'limit ?'
 		offset_sql: 'offset ?'
 		params:     params
+		shape:      shape
+	}
+}
+
+// GridOrmSqlText is the value-independent part of a built query.
+struct GridOrmSqlText {
+	where_sql string
+	order_sql string
+}
+
+// grid_orm_sql_shape hashes what determines the SQL text: which
+// filters apply, the sorts and the seek, but not their values.
+fn grid_orm_sql_shape(query GridQueryState, seek_field string, seeking bool, backward bool) u64 {
+	mut h := data_grid_fnv64_offset
+	h = data_grid_fnv64_byte(h, if query.quick_filter.trim_space().len > 0 { `q` } else { `-` })
+	for filter in query.filters {
+		h = data_grid_fnv64_byte(h, 0x1e)
+		h = data_grid_fnv64_str(h, filter.col_id)
+		h = data_grid_fnv64_byte(h, 0x1f)
+		h = data_grid_fnv64_str(h, filter.op)
+	}
+	h = data_grid_fnv64_byte(h, `|`)
+	for sort in query.sorts {
+		h = data_grid_fnv64_byte(h, 0x1e)
+		h = data_grid_fnv64_str(h, sort.col_id)
+		h = data_grid_fnv64_byte(h, if sort.dir == .desc { `d` } else { `a` })
+	}
+	h = data_grid_fnv64_byte(h, `|`)
+	h = data_grid_fnv64_str(h, seek_field)
+	h = data_grid_fnv64_byte(h, if seeking { `s` } else { `-` })
+	return data_grid_fnv64_byte(h, if backward { `b` } else { `f` })
+}
+
+// grid_orm_sql_text builds the where and order fragments.
+// Placeholders follow the order of grid_orm_sql_params.
+fn grid_orm_sql_text(query GridQueryState, column_map map[string]GridOrmColumnSpec, seek_field string, seeking bool, backward bool) GridOrmSqlText {
+	mut where_parts := []string{}
+	if query.quick_filter.trim_space().len > 0 {
+		qf := grid_orm_quick_filter_sql(column_map)
+		if qf.len > 0 {
+			where_parts << qf
+		}
+	}
+	for filter in query.filters {
+		col := column_map[filter.col_id] or { continue }
+		where_parts << grid_orm_filter_sql(col.db_field, filter.op, col.case_insensitive)
+	}
+	if seeking {
+		where_parts << grid_orm_seek_sql(query.sorts, column_map, seek_field, backward)
+	}
+	return GridOrmSqlText{
+		where_sql: where_parts.join(' and ')
+		order_sql: grid_orm_build_order(query.sorts, column_map, seek_field, backward)
 	}
 }
 
+// grid_orm_sql_params returns the where placeholder values in
+// the order grid_orm_sql_text emits them.
+fn grid_orm_sql_params(query GridQueryState, column_map map[string]GridOrmColumnSpec, seek []string) []string {
+	mut params := []string{}
+	grid_orm_quick_filter_params(query.quick_filter, column_map, mut params)
+	for filter in query.filters {
+		col := column_map[filter.col_id] or { continue }
+		params << grid_orm_filter_param(filter.op, filter.value, col.case_insensitive)
+	}
+	if seek.len > 0 {
+		if grid_orm_seek_uniform(query.sorts) {
+			params << seek
+		} else {
+			// One term per key: equal on the keys before it.
+			for i in 0 .. seek.len {
+				params << seek[..i + 1]
+			}
+		}
+	}
+	return params
+}
+
 // grid_orm_escape_like escapes SQL LIKE wildcard characters
 // (%, _) in user input so they match literally. Uses
 // backslash as escape char (SQLite/Postgres compatible).
@@ -450,16 +682,9 @@ fn grid_orm_escape_like(s string) string {
 	return s.replace('\\', '\\\\').replace('%', '\\%').replace('_', '\\_')
 }
 
-// grid_orm_build_quick_filter returns a parenthesized OR
-// clause for quick_filter columns, or empty string.
-fn grid_orm_build_quick_filter(needle string, columns map[string]GridOrmColumnSpec, mut params []string) string {
-	trimmed := needle.trim_space()
-	if trimmed.len == 0 {
-		return ''
-	}
-	lower_needle := trimmed.to_lower()
-	escaped_lower := grid_orm_escape_like(lower_needle)
-	escaped_trimmed := grid_orm_escape_like(trimmed)
+// grid_orm_quick_filter_sql returns a parenthesized OR
+// clause over the quick_filter columns, or empty string.
+fn grid_orm_quick_filter_sql(columns map[string]GridOrmColumnSpec) string {
 	mut or_parts := []string{}
 	for _, col in columns {
 		if !col.quick_filter {
@@ -467,10 +692,8 @@ fn grid_orm_build_quick_filter(needle string, columns map[string]GridOrmColumnSp
 		}
 		if col.case_insensitive {
 			or_parts << 'lower(${col.db_field}) like ? escape \'\\\''
-			params << '%${escaped_lower}%'
 		} else {
 			or_parts << '${col.db_field} like ? escape \'\\\''
-			params << '%${escaped_trimmed}%'
 		}
 	}
 	if or_parts.len == 0 {
@@ -479,45 +702,281 @@ fn grid_orm_build_quick_filter(needle string, columns map[string]GridOrmColumnSp
 	return '(${or_parts.join(' or ')})'
 }
 
-// grid_orm_build_filter_clause returns a single WHERE clause
-// and appends the parameterized value.
-fn grid_orm_build_filter_clause(db_field string, op string, value string, case_insensitive bool, mut params []string) string {
-	target_field := if case_insensitive { 'lower(${db_field})' } else { db_field }
-	target_value := if case_insensitive { value.to_lower() } else { value }
-	clause, param := match op {
-		'equals' {
-			'${target_field} = ?', target_value
-		}
-		'starts_with' {
-			'${target_field} like ? escape \'\\\'', '${grid_orm_escape_like(target_value)}%'
-		}
-		'ends_with' {
-			'${target_field} like ? escape \'\\\'', '%${grid_orm_escape_like(target_value)}'
+// grid_orm_quick_filter_params appends one LIKE pattern per
+// quick_filter column, matching grid_orm_quick_filter_sql.
+fn grid_orm_quick_filter_params(needle string, columns map[string]GridOrmColumnSpec, mut params []string) {
+	trimmed := needle.trim_space()
+	if trimmed.len == 0 {
+		return
+	}
+	escaped_lower := grid_orm_escape_like(trimmed.to_lower())
+	escaped_trimmed := grid_orm_escape_like(trimmed)
+	for _, col in columns {
+		if !col.quick_filter {
+			continue
 		}
-		else {
-			'${target_field} like ? escape \'\\\'', '%${grid_orm_escape_like(target_value)}%'
+		if col.case_insensitive {
+			params << '%${escaped_lower}%'
+		} else {
+			params << '%${escaped_trimmed}%'
 		}
 	}
+}
+
+// grid_orm_filter_sql returns a single WHERE clause with one
+// placeholder.
+fn grid_orm_filter_sql(db_field string, op string, case_insensitive bool) string {
+	target_field := if case_insensitive { 'lower(${db_field})' } else { db_field }
+	if op == 'equals' {
+		return '${target_field} = ?'
+	}
+	return '${target_field} like ? escape \'\\\''
+}
 
-	params << param
-	return clause
+// grid_orm_filter_param returns the placeholder value for a
+// filter clause.
+fn grid_orm_filter_param(op string, value string, case_insensitive bool) string {
+	target_value := if case_insensitive { value.to_lower() } else { value }
+	return match op {
+		'equals' { target_value }
+		'starts_with' { '${grid_orm_escape_like(target_value)}%' }
+		'ends_with' { '%${grid_orm_escape_like(target_value)}' }
+		else { '%${grid_orm_escape_like(target_value)}%' }
+	}
 }
 
 // grid_orm_build_order returns comma-separated order terms
-// or empty string.
-fn grid_orm_build_order(sorts []GridSort, column_map map[string]GridOrmColumnSpec) string {
+// or empty string. With a seek_field, ties are ordered by it
+// in the direction of the last sort; backward flips all.
+fn grid_orm_build_order(sorts []GridSort, column_map map[string]GridOrmColumnSpec, seek_field string, backward bool) string {
 	mut parts := []string{}
 	for sort in sorts {
 		col := column_map[sort.col_id] or { continue }
 		if !col.sortable {
 			continue
 		}
-		dir := if sort.dir == .desc { 'desc' } else { 'asc' }
-		parts << '${col.db_field} ${dir}'
+		parts << '${col.db_field} ${grid_orm_sort_dir(sort.dir, backward)}'
+	}
+	if seek_field.len > 0 {
+		parts << '${seek_field} ${grid_orm_sort_dir(grid_orm_tie_dir(sorts), backward)}'
 	}
 	return parts.join(', ')
 }
 
+fn grid_orm_sort_dir(dir GridSortDir, backward bool) string {
+	return if (dir == .desc) != backward { 'desc' } else { 'asc' }
+}
+
+// grid_orm_tie_dir returns the direction of the seek_field
+// tiebreak: that of the last sort, so single-direction sorts
+// stay uniform.
+fn grid_orm_tie_dir(sorts []GridSort) GridSortDir {
+	return if sorts.len > 0 { sorts.last().dir } else { .asc }
+}
+
+// grid_orm_seek_uniform reports whether all sort keys run in
+// one direction, so one row-value comparison can seek.
+fn grid_orm_seek_uniform(sorts []GridSort) bool {
+	return sorts.all(it.dir == grid_orm_tie_dir(sorts))
+}
+
+// grid_orm_seek_sql returns the clause selecting rows past the
+// seek row in the build_order ordering. A uniform ordering
+// uses a row-value comparison, which databases answer with an
+// index range scan; a mixed one expands to one term per key.
+fn grid_orm_seek_sql(sorts []GridSort, column_map map[string]GridOrmColumnSpec, seek_field string, backward bool) string {
+	mut fields := []string{cap: sorts.len + 1}
+	mut dirs := []GridSortDir{cap: sorts.len + 1}
+	for sort in sorts {
+		col := column_map[sort.col_id] or { continue }
+		fields << col.db_field
+		dirs << sort.dir
+	}
+	fields << seek_field
+	dirs << grid_orm_tie_dir(sorts)
+	cmp := fn [backward] (dir GridSortDir) string {
+		return if (dir == .desc) != backward { '<' } else { '>' }
+	}
+	if grid_orm_seek_uniform(sorts) {
+		if fields.len == 1 {
+			return '${fields[0]} ${cmp(dirs[0])} ?'
+		}
+		marks := []string{len: fields.len, init: '?'}
+		return '(${fields.join(', ')}) ${cmp(dirs[0])} (${marks.join(', ')})'
+	}
+	mut terms := []string{cap: fields.len}
+	for i in 0 .. fields.len {
+		mut parts := []string{cap: i + 1}
+		for j in 0 .. i {
+			parts << '${fields[j]} = ?'
+		}
+		parts << '${fields[i]} ${cmp(dirs[i])} ?'
+		terms << '(${parts.join(' and ')})'
+	}
+	return '(${terms.join(' or ')})'
+}
+
+// GridOrmKeysetCursor is a decoded keyset cursor: the sort
+// values and id of the row a page starts after (or, backward,
+// before), plus the page's logical offset for row numbering.
+struct GridOrmKeysetCursor {
+	offset   int
+	backward bool
+	values   []string
+}
+
+// grid_orm_keyset_cursor encodes a keyset cursor as
+// "k:<offset>:<f|b>:" followed by "<len>:<value>" per value.
+fn grid_orm_keyset_cursor(offset int, backward bool, values []string) string {
+	mut sb := strings.new_builder(32)
+	sb.write_string('k:${int_max(0, offset)}:')
+	sb.write_string(if backward { 'b:' } else { 'f:' })
+	for value in values {
+		sb.write_string('${value.len}:')
+		sb.write_string(value)
+	}
+	return sb.str()
+}
+
+// grid_orm_parse_keyset_cursor decodes grid_orm_keyset_cursor
+// output, or returns none for anything else.
+fn grid_orm_parse_keyset_cursor(cursor string) ?GridOrmKeysetCursor {
+	if !cursor.starts_with('k:') {
+		return none
+	}
+	parts := cursor[2..].split_nth(':', 3)
+	if parts.len != 3 || !data_grid_source_is_decimal(parts[0])
+		|| parts[1] !in ['f', 'b'] {
+		return none
+	}
+	rest := parts[2]
+	mut values := []string{}
+	mut i := 0
+	for i < rest.len {
+		mut j := i
+		for j < rest.len && rest[j] != `:` {
+			j++
+		}
+		if j == rest.len || !data_grid_source_is_decimal(rest[i..j]) {
+			return none
+		}
+		start := j + 1
+		end := start + rest[i..j].int()
+		if end > rest.len {
+			return none
+		}
+		values << rest[start..end]
+		i = end
+	}
+	return GridOrmKeysetCursor{
+		offset:   parts[0].int()
+		backward: parts[1] == 'b'
+		values:   values
+	}
+}
+
+// grid_orm_keyset_values returns row's seek values: its cell
+// per sort, then its id. Empty when a sorted cell is missing.
+fn grid_orm_keyset_values(row GridRow, sorts []GridSort) []string {
+	mut values := []string{cap: sorts.len + 1}
+	for sort in sorts {
+		values << row.cells[sort.col_id] or { return []string{} }
+	}
+	values << row.id
+	return values
+}
+
+// GridOrmCache holds a source's built SQL per query shape and
+// its recent row counts. Fetches run on worker threads, so
+// access is locked. Each mutation bumps count_gen; a count
+// taken by a fetch that started before it is discarded.
+@[heap]
+struct GridOrmCache {
+mut:
+	mutex      &sync.Mutex = sync.new_mutex()
+	sql        map[u64]GridOrmSqlText
+	counts     map[u64]GridOrmCachedCount
+	count_gen  u64
+	sql_hits   int
+	count_hits int
+}
+
+struct GridOrmCachedCount {
+	count int
+	at    i64 // time.ticks() when counted
+}
+
+fn (mut cache GridOrmCache) sql_text(shape u64) ?GridOrmSqlText {
+	cache.mutex.lock()
+	defer {
+		cache.mutex.unlock()
+	}
+	text := cache.sql[shape] or { return none }
+	cache.sql_hits++
+	return text
+}
+
+fn (mut cache GridOrmCache) put_sql_text(shape u64, text GridOrmSqlText) {
+	cache.mutex.lock()
+	defer {
+		cache.mutex.unlock()
+	}
+	if cache.sql.len >= grid_orm_cache_max_entries {
+		cache.sql.clear()
+	}
+	cache.sql[shape] = text
+}
+
+fn (mut cache GridOrmCache) row_count(key u64, ttl time.Duration) ?int {
+	cache.mutex.lock()
+	defer {
+		cache.mutex.unlock()
+	}
+	entry := cache.counts[key] or { return none }
+	if time.ticks() - entry.at > ttl.milliseconds() {
+		cache.counts.delete(key)
+		return none
+	}
+	cache.count_hits++
+	return entry.count
+}
+
+fn (mut cache GridOrmCache) count_generation() u64 {
+	cache.mutex.lock()
+	defer {
+		cache.mutex.unlock()
+	}
+	return cache.count_gen
+}
+
+// put_row_count stores count unless a mutation has run since
+// generation was read.
+fn (mut cache GridOrmCache) put_row_count(key u64, count int, generation u64) {
+	cache.mutex.lock()
+	defer {
+		cache.mutex.unlock()
+	}
+	if generation != cache.count_gen {
+		return
+	}
+	if cache.counts.len >= grid_orm_cache_max_entries {
+		cache.counts.clear()
+	}
+	cache.counts[key] = GridOrmCachedCount{
+		count: count
+		at:    time.ticks()
+	}
+}
+
+fn (mut cache GridOrmCache) clear_row_counts() {
+	cache.mutex.lock()
+	defer {
+		cache.mutex.unlock()
+	}
+	cache.counts.clear()
+	cache.count_gen++
+}
+
 // grid_orm_valid_db_field checks that a db_field contains only
 // alphanumeric chars, underscores, and at most one dot (for
 // table-qualified names like "table.column"). Must start with
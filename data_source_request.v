@@ -0,0 +1,214 @@
+module gui
+
+// data_source_request.v paces and shares data-source fetches for data
+// grids, list boxes and comboboxes. A fetch used to start on every
+// request key change, aborting the previous one, so typing a filter
+// against a remote source issued one query per keystroke.
+// - GridRequestPolicy.debounce holds a query change until the query has
+//   been stable that long. Paging and the first load are not delayed.
+// - GridRequestPolicy.throttle spaces request starts.
+// - GridRequestPolicy.adaptive widens the debounce to half the observed
+//   fetch latency, up to max_debounce: slow sources see fewer queries.
+// - GridRequestPolicy.share_key lets views backed by the same source
+//   share identical in-flight requests. The fetch runs once and every
+//   subscriber gets the result; it is aborted only when all of them
+//   have moved on.
+import math
+import time
+
+const ns_dg_shared_request = 'gui.dg.shared_request'
+const ns_list_box_shared_request = 'gui.list_box.shared_request'
+const grid_request_latency_weight = 0.3
+
+// GridRequestPolicy configures how a view paces its data-source fetches.
+// The zero value starts every request at once, as before.
+pub struct GridRequestPolicy {
+pub:
+	debounce     time.Duration // wait for the query to settle this long
+	throttle     time.Duration // minimum time between request starts
+	adaptive     bool          // widen debounce toward observed latency
+	max_debounce time.Duration = time.second // cap for adaptive debounce
+	share_key    string // views with the same key share identical requests
+}
+
+// GridRequestPacer tracks request timing for one view.
+struct GridRequestPacer {
+mut:
+	pending_key   string // request key waiting to start
+	pending_since i64    // time.ticks() when pending_key was first seen
+	last_start    i64    // time.ticks() of the last request start
+	started_query string // query of the last started request
+	latency_ms    f64    // moving average of fetch latency
+	deferred      int    // request keys held back at least once
+}
+
+// debounce_ms returns the effective debounce for policy.
+fn (pacer &GridRequestPacer) debounce_ms(policy GridRequestPolicy) i64 {
+	mut ms := policy.debounce.milliseconds()
+	if policy.adaptive && pacer.latency_ms > 0 {
+		widened := i64(pacer.latency_ms / 2)
+		ms = math.max(ms, math.min(widened, policy.max_debounce.milliseconds()))
+	}
+	return ms
+}
+
+// wait_ms returns how long key must still wait before it may start, 0
+// when it may start now. debounce is false for requests that should
+// not wait for the query to settle.
+fn (mut pacer GridRequestPacer) wait_ms(policy GridRequestPolicy, key string, now i64, debounce bool) i64 {
+	if key != pacer.pending_key {
+		pacer.pending_key = key
+		pacer.pending_since = now
+	}
+	mut wait := i64(0)
+	if debounce {
+		wait = pacer.pending_since + pacer.debounce_ms(policy) - now
+	}
+	throttle := policy.throttle.milliseconds()
+	if throttle > 0 && pacer.last_start > 0 {
+		wait = math.max(wait, pacer.last_start + throttle - now)
+	}
+	if wait > 0 && pacer.pending_since == now {
+		pacer.deferred++
+	}
+	return math.max(wait, 0)
+}
+
+fn (mut pacer GridRequestPacer) note_start(query string, now i64) {
+	pacer.pending_key = ''
+	pacer.last_start = now
+	pacer.started_query = query
+}
+
+// observe records the latency of the request started last.
+fn (mut pacer GridRequestPacer) observe(now i64) {
+	if pacer.last_start <= 0 {
+		return
+	}
+	latency := f64(now - pacer.last_start)
+	pacer.latency_ms = if pacer.latency_ms <= 0 {
+		latency
+	} else {
+		pacer.latency_ms + grid_request_latency_weight * (latency - pacer.latency_ms)
+	}
+}
+
+// grid_request_ready reports whether key may start now. Otherwise it
+// schedules a frame for when it may.
+fn grid_request_ready(policy GridRequestPolicy, key string, debounce bool, wake_id string, mut pacer GridRequestPacer, mut window Window) bool {
+	if policy.debounce <= 0 && policy.throttle <= 0 && !policy.adaptive {
+		return true
+	}
+	wait := pacer.wait_ms(policy, key, time.ticks(), debounce)
+	if wait <= 0 {
+		return true
+	}
+	window.animation_add(mut &Animate{
+		id:       wake_id
+		delay:    time.Duration(wait) * time.millisecond
+		callback: fn (mut an Animate, mut w Window) {
+			w.update_window()
+		}
+	})
+	return false
+}
+
+// GridAbortGroup aborts a shared fetch once every subscriber has
+// aborted its own controller.
+@[heap]
+struct GridAbortGroup {
+mut:
+	signal &GridAbortSignal = unsafe { nil }
+	live   int
+}
+
+fn (mut group GridAbortGroup) release() {
+	group.live--
+	if group.live <= 0 && !isnil(group.signal) {
+		group.signal.set_aborted(true)
+	}
+}
+
+struct GridRequestSubscriber {
+	id         string
+	request_id u64
+}
+
+// GridSharedRequest is an in-flight fetch other views may join.
+struct GridSharedRequest {
+	group       &GridAbortGroup = unsafe { nil }
+	subscribers []GridRequestSubscriber
+}
+
+// grid_request_share_key returns the key identical requests share, or
+// '' when the policy does not share.
+fn grid_request_share_key(policy GridRequestPolicy, request_key string) string {
+	if policy.share_key.len == 0 {
+		return ''
+	}
+	return '${policy.share_key}|${request_key}'
+}
+
+// grid_shared_request_join subscribes to the in-flight request for
+// share_key, returning a controller that releases the subscription.
+fn grid_shared_request_join(ns string, share_key string, sub GridRequestSubscriber, mut window Window) ?&GridAbortController {
+	if share_key.len == 0 {
+		return none
+	}
+	mut sm := state_map[string, GridSharedRequest](mut window, ns, cap_moderate)
+	entry := sm.get(share_key) or { return none }
+	if entry.group.signal.is_aborted() {
+		sm.delete(share_key)
+		return none
+	}
+	mut group := unsafe { entry.group }
+	group.live++
+	mut subscribers := entry.subscribers.clone()
+	subscribers << sub
+	sm.set(share_key, GridSharedRequest{
+		group:       group
+		subscribers: subscribers
+	})
+	return &GridAbortController{
+		signal: group.signal
+		group:  group
+	}
+}
+
+// grid_shared_request_lead returns the controller for a new fetch and,
+// when share_key is set, registers it for others to join.
+fn grid_shared_request_lead(ns string, share_key string, sub GridRequestSubscriber, mut window Window) &GridAbortController {
+	controller := new_grid_abort_controller()
+	if share_key.len == 0 {
+		return controller
+	}
+	group := &GridAbortGroup{
+		signal: controller.signal
+		live:   1
+	}
+	mut sm := state_map[string, GridSharedRequest](mut window, ns, cap_moderate)
+	sm.set(share_key, GridSharedRequest{
+		group:       group
+		subscribers: [sub]
+	})
+	return &GridAbortController{
+		signal: controller.signal
+		group:  group
+	}
+}
+
+// grid_shared_request_take unregisters a finished fetch and returns the
+// subscribers to deliver to: only the leader when the fetch was not
+// shared or its entry is gone.
+fn grid_shared_request_take(ns string, share_key string, signal &GridAbortSignal, leader GridRequestSubscriber, mut window Window) []GridRequestSubscriber {
+	if share_key.len == 0 {
+		return [leader]
+	}
+	mut sm := state_map[string, GridSharedRequest](mut window, ns, cap_moderate)
+	entry := sm.get(share_key) or { return [leader] }
+	if voidptr(entry.group.signal) != voidptr(signal) {
+		return [leader]
+	}
+	sm.delete(share_key)
+	return entry.subscribers
+}
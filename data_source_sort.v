@@ -0,0 +1,284 @@
+module gui
+
+// data_source_sort.v sorts rows for data_grid_source_apply_query. Each
+// sort column is normalized once into a u64 key per row, so the sort
+// itself compares integers only:
+// - number and date keys are order-preserving encodings of the parsed
+//   f64 or unix seconds
+// - text keys rank the cell among the column's distinct values, using
+//   the column's collation (byte order, case-folded or natural)
+// Empty or unparseable cells get key 0 and sort first ascending, as ''
+// does lexicographically. Ties fall back to row order, so sorts are
+// stable. Large inputs are sorted in chunks on several threads, then
+// merged pairwise.
+import math
+import runtime
+import strconv
+import time
+
+// GridSortKind is how a column's cells compare when an in-memory source
+// sorts by it. Set per column with InMemoryDataSource.sort_kinds.
+pub enum GridSortKind as u8 {
+	text      // byte order (default)
+	text_fold // case-insensitive
+	natural   // case-insensitive; digit runs compare as numbers ("a2" < "a10")
+	number    // parsed with the locale's decimal and group separators
+	date      // ISO 8601, or the locale's short date format
+}
+
+// Below this many rows a single-threaded sort is faster than spawning.
+const grid_sort_parallel_min = 65536
+const grid_sort_max_threads = 8
+
+// grid_sort_row_indices returns row indices in sort order.
+fn grid_sort_row_indices(rows []GridRow, sorts []GridSort, kinds map[string]GridSortKind) []int {
+	mut keys := [][]u64{cap: sorts.len}
+	mut desc := []bool{cap: sorts.len}
+	for sort in sorts {
+		keys << grid_sort_keys(rows, sort.col_id, kinds[sort.col_id] or { GridSortKind.text })
+		desc << (sort.dir == .desc)
+	}
+	idxs := []int{len: rows.len, init: index}
+	threads := if rows.len >= grid_sort_parallel_min {
+		int_min(grid_sort_max_threads, runtime.nr_cpus())
+	} else {
+		1
+	}
+	return grid_sort_by_keys(idxs, keys, desc, threads)
+}
+
+// grid_sort_keys normalizes one column into a key per row.
+fn grid_sort_keys(rows []GridRow, col_id string, kind GridSortKind) []u64 {
+	match kind {
+		.number {
+			locale := gui_locale.to_numeric_locale()
+			plain := locale.decimal_sep == `.`
+			return []u64{len: rows.len, init: grid_sort_number_key(rows[index].cells[col_id] or {
+				''
+			}, plain, locale)}
+		}
+		.date {
+			short_date := gui_locale.date.short_date
+			return []u64{len: rows.len, init: grid_sort_date_key(rows[index].cells[col_id] or {
+				''
+			}, short_date)}
+		}
+		else {
+			return grid_sort_text_keys(rows, col_id, kind)
+		}
+	}
+}
+
+fn grid_sort_number_key(value string, plain bool, locale NumericLocaleCfg) u64 {
+	trimmed := value.trim_space()
+	if trimmed.len == 0 {
+		return 0
+	}
+	mut number := math.nan()
+	if plain {
+		number = strconv.atof64(trimmed) or { math.nan() }
+	}
+	if math.is_nan(number) {
+		number = numeric_parse(trimmed, locale) or { return 0 }
+	}
+	return grid_sort_f64_key(number)
+}
+
+// grid_sort_f64_key maps an f64 to a u64 with the same order. NaN maps
+// to 0, the key of empty cells.
+@[inline]
+fn grid_sort_f64_key(value f64) u64 {
+	if math.is_nan(value) {
+		return 0
+	}
+	bits := math.f64_bits(value)
+	if bits >> 63 == 1 {
+		return ~bits
+	}
+	return bits | (u64(1) << 63)
+}
+
+fn grid_sort_date_key(value string, short_date string) u64 {
+	trimmed := value.trim_space()
+	if trimmed.len == 0 {
+		return 0
+	}
+	t := time.parse_iso8601(trimmed) or {
+		time.parse(trimmed) or { time.parse_format(trimmed, short_date) or { return 0 } }
+	}
+	return u64(t.unix()) ^ (u64(1) << 63)
+}
+
+// grid_sort_text_keys ranks each cell among the column's distinct
+// values. Folding and collation run once per distinct value.
+fn grid_sort_text_keys(rows []GridRow, col_id string, kind GridSortKind) []u64 {
+	mut codes := []u32{len: rows.len}
+	mut lookup := map[string]u32{}
+	mut distinct := []string{}
+	for i, row in rows {
+		value := row.cells[col_id] or { '' }
+		codes[i] = lookup[value] or {
+			code := u32(distinct.len)
+			lookup[value] = code
+			distinct << value
+			code
+		}
+	}
+	folded := if kind == .text { distinct } else { distinct.map(it.to_lower()) }
+	natural := kind == .natural
+	mut order := []int{len: distinct.len, init: index}
+	order.sort_with_compare(fn [folded, distinct, natural] (ia &int, ib &int) int {
+		a := *ia
+		b := *ib
+		mut cmp := if natural {
+			grid_natural_compare(folded[a], folded[b])
+		} else {
+			grid_string_compare(folded[a], folded[b])
+		}
+		if cmp == 0 {
+			cmp = grid_string_compare(distinct[a], distinct[b])
+		}
+		return cmp
+	})
+	mut ranks := []u64{len: distinct.len}
+	for rank, code in order {
+		ranks[code] = u64(rank)
+	}
+	return []u64{len: rows.len, init: ranks[codes[index]]}
+}
+
+@[inline]
+fn grid_string_compare(a string, b string) int {
+	return if a < b {
+		-1
+	} else if a > b {
+		1
+	} else {
+		0
+	}
+}
+
+// grid_natural_compare orders strings with embedded numbers by value:
+// "item2" < "item10". Among equal numbers, fewer leading zeros first.
+@[direct_array_access]
+fn grid_natural_compare(a string, b string) int {
+	mut i := 0
+	mut j := 0
+	for i < a.len && j < b.len {
+		if a[i].is_digit() && b[j].is_digit() {
+			mut si := i
+			for si < a.len && a[si] == `0` {
+				si++
+			}
+			mut sj := j
+			for sj < b.len && b[sj] == `0` {
+				sj++
+			}
+			mut ei := si
+			for ei < a.len && a[ei].is_digit() {
+				ei++
+			}
+			mut ej := sj
+			for ej < b.len && b[ej].is_digit() {
+				ej++
+			}
+			if ei - si != ej - sj {
+				return if ei - si < ej - sj { -1 } else { 1 }
+			}
+			for k in 0 .. ei - si {
+				if a[si + k] != b[sj + k] {
+					return if a[si + k] < b[sj + k] { -1 } else { 1 }
+				}
+			}
+			if ei - i != ej - j {
+				return if ei - i < ej - j { -1 } else { 1 }
+			}
+			i = ei
+			j = ej
+			continue
+		}
+		if a[i] != b[j] {
+			return if a[i] < b[j] { -1 } else { 1 }
+		}
+		i++
+		j++
+	}
+	if i == a.len && j == b.len {
+		return 0
+	}
+	return if i == a.len { -1 } else { 1 }
+}
+
+// grid_sort_compare compares rows a and b by their keys, then by row
+// order.
+@[direct_array_access; inline]
+fn grid_sort_compare(keys [][]u64, desc []bool, a int, b int) int {
+	for k in 0 .. keys.len {
+		ka := keys[k][a]
+		kb := keys[k][b]
+		if ka != kb {
+			return if (ka < kb) != desc[k] { -1 } else { 1 }
+		}
+	}
+	return if a < b {
+		-1
+	} else if a > b {
+		1
+	} else {
+		0
+	}
+}
+
+// grid_sort_by_keys sorts idxs on `threads` threads: each sorts a chunk,
+// then sorted chunks merge pairwise, also in parallel.
+fn grid_sort_by_keys(idxs []int, keys [][]u64, desc []bool, threads int) []int {
+	if threads <= 1 || idxs.len < 2 * threads {
+		return grid_sort_part(idxs.clone(), keys, desc)
+	}
+	chunk := (idxs.len + threads - 1) / threads
+	mut sorting := []thread []int{cap: threads}
+	for start := 0; start < idxs.len; start += chunk {
+		sorting << spawn grid_sort_part(idxs[start..int_min(idxs.len, start + chunk)].clone(),
+			keys, desc)
+	}
+	mut parts := sorting.wait()
+	for parts.len > 1 {
+		mut merging := []thread []int{cap: parts.len / 2}
+		for i := 0; i + 1 < parts.len; i += 2 {
+			merging << spawn grid_sort_merge(parts[i], parts[i + 1], keys, desc)
+		}
+		mut next := merging.wait()
+		if parts.len % 2 == 1 {
+			next << parts[parts.len - 1]
+		}
+		parts = next
+	}
+	return parts[0]
+}
+
+fn grid_sort_part(part []int, keys [][]u64, desc []bool) []int {
+	mut sorted := part
+	sorted.sort_with_compare(fn [keys, desc] (a &int, b &int) int {
+		return grid_sort_compare(keys, desc, *a, *b)
+	})
+	return sorted
+}
+
+@[direct_array_access]
+fn grid_sort_merge(a []int, b []int, keys [][]u64, desc []bool) []int {
+	mut out := []int{cap: a.len + b.len}
+	mut i := 0
+	mut j := 0
+	for i < a.len && j < b.len {
+		if grid_sort_compare(keys, desc, b[j], a[i]) < 0 {
+			out << b[j]
+			j++
+		} else {
+			out << a[i]
+			i++
+		}
+	}
+	out << a[i..]
+	out << b[j..]
+	return out
+}
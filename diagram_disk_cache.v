@@ -0,0 +1,280 @@
+module gui
+
+// diagram_disk_cache.v persists rendered mermaid and math PNGs across
+// launches so documents open without refetching every diagram, and
+// keep rendering offline once seen. Files are content-addressed: the
+// name hashes the render kind, endpoint, source and every parameter
+// that changes the output. Reads refresh the file mtime; writes trim
+// the directory to max_bytes by deleting least recently used files.
+// Only bodies that decode as PNG are written, and a cached file that
+// fails to decode is deleted, so an error or captive-portal page
+// served with HTTP 200 never sticks in the cache.
+// Reads and fetches run on diagram fetch threads, decodes on the worker
+// pool (see start_diagram_fetch). Safe to use from both: files are
+// written under a temporary name and renamed into place.
+import hash.fnv1a
+import net.http
+import os
+import rand
+import stbi
+import time
+
+const diagram_disk_cache_default_bytes = i64(64 * 1024 * 1024)
+const diagram_disk_cache_ext = '.png'
+const max_diagram_response_bytes = 10 * 1024 * 1024
+
+pub const markdown_default_mermaid_endpoint = 'https://kroki.io/mermaid/png'
+pub const markdown_default_math_endpoint = 'https://latex.codecogs.com/png.image'
+
+// DiagramDiskCache locates the on-disk diagram cache. Fetch workers
+// receive a copy, so it holds only plain values.
+struct DiagramDiskCache {
+	dir       string // empty: <user cache dir>/gui/diagrams
+	max_bytes i64 = diagram_disk_cache_default_bytes // <= 0 disables the cache
+}
+
+// set_diagram_disk_cache configures the persistent cache for rendered
+// mermaid and math images. An empty dir keeps the default location
+// (<user cache dir>/gui/diagrams); max_bytes <= 0 disables the cache.
+pub fn (mut window Window) set_diagram_disk_cache(dir string, max_bytes i64) {
+	window.diagram_disk = DiagramDiskCache{
+		dir:       dir
+		max_bytes: max_bytes
+	}
+}
+
+// diagram_disk_key hashes everything that determines a rendered image.
+fn diagram_disk_key(parts []string) string {
+	joined := parts.join('\x1f')
+	return '${fnv1a.sum64_string(joined).hex()}_${joined.len:x}'
+}
+
+fn (c DiagramDiskCache) cache_dir() string {
+	if c.dir.len > 0 {
+		return c.dir
+	}
+	return os.join_path(os.cache_dir(), 'gui', 'diagrams')
+}
+
+fn (c DiagramDiskCache) path(key string) string {
+	return os.join_path(c.cache_dir(), key + diagram_disk_cache_ext)
+}
+
+// read returns cached bytes for key and marks the file recently used.
+fn (c DiagramDiskCache) read(key string) ?[]u8 {
+	if c.max_bytes <= 0 {
+		return none
+	}
+	path := c.path(key)
+	bytes := os.read_bytes(path) or { return none }
+	if bytes.len == 0 {
+		return none
+	}
+	now := int(time.now().unix())
+	os.utime(path, now, now) or {}
+	return bytes
+}
+
+// write stores bytes under key, then trims the cache to its budget.
+// Failures are ignored; the cache is an optimization only.
+fn (c DiagramDiskCache) write(key string, bytes []u8) {
+	if c.max_bytes <= 0 || i64(bytes.len) > c.max_bytes {
+		return
+	}
+	dir := c.cache_dir()
+	os.mkdir_all(dir) or { return }
+	path := c.path(key)
+	tmp_path := '${path}.${rand.u32():x}.tmp'
+	os.write_file_array(tmp_path, bytes) or { return }
+	os.mv(tmp_path, path) or {
+		os.rm(tmp_path) or {}
+		return
+	}
+	c.trim()
+}
+
+// remove deletes the file for key.
+fn (c DiagramDiskCache) remove(key string) {
+	os.rm(c.path(key)) or {}
+}
+
+struct DiagramDiskFile {
+	path  string
+	size  i64
+	mtime i64
+}
+
+// trim deletes least recently used files until the cache fits.
+fn (c DiagramDiskCache) trim() {
+	dir := c.cache_dir()
+	names := os.ls(dir) or { return }
+	mut files := []DiagramDiskFile{cap: names.len}
+	mut total := i64(0)
+	for name in names {
+		if !name.ends_with(diagram_disk_cache_ext) {
+			continue
+		}
+		path := os.join_path(dir, name)
+		size := i64(os.file_size(path))
+		files << DiagramDiskFile{
+			path:  path
+			size:  size
+			mtime: os.file_last_mod_unix(path)
+		}
+		total += size
+	}
+	if total <= c.max_bytes {
+		return
+	}
+	files.sort(a.mtime < b.mtime)
+	for f in files {
+		if total <= c.max_bytes {
+			break
+		}
+		os.rm(f.path) or { continue }
+		total -= f.size
+	}
+}
+
+// DiagramPngBody holds PNG bytes read on a fetch thread until the
+// worker pool decodes them.
+struct DiagramPngBody {
+	bytes  []u8
+	cached bool // read from the disk cache rather than fetched
+}
+
+// diagram_fetch_png_body returns the PNG bytes for a diagram: from the
+// disk cache when present, else from fetch. A cached file without the
+// PNG signature is deleted and refetched. Errors carry the message
+// shown in place of the diagram. Blocks on the network.
+fn diagram_fetch_png_body(disk DiagramDiskCache, key string, fetch fn () !http.Response) !DiagramPngBody {
+	if cached := disk.read(key) {
+		if diagram_has_png_signature(cached) {
+			return DiagramPngBody{
+				bytes:  cached
+				cached: true
+			}
+		}
+		disk.remove(key)
+	}
+	result := fetch()!
+	if result.status_code != 200 {
+		body_preview := if result.body.len > 200 {
+			result.body[..200] + '...'
+		} else {
+			result.body
+		}
+		return error('HTTP ${result.status_code}: ${body_preview}')
+	}
+	if result.body.len > max_diagram_response_bytes {
+		return error('Response too large (>${result.body.len / 1024 / 1024}MB)')
+	}
+	png_bytes := result.body.bytes()
+	if !diagram_has_png_signature(png_bytes) {
+		return error('Failed to decode PNG: response is not a PNG image')
+	}
+	return DiagramPngBody{
+		bytes: png_bytes
+	}
+}
+
+// diagram_png_decode decodes a body from diagram_fetch_png_body.
+// Fetched bodies are written to the disk cache once they decode; a
+// cached file that does not decode is deleted. The caller frees the
+// image.
+fn diagram_png_decode(disk DiagramDiskCache, key string, body DiagramPngBody) !stbi.Image {
+	img := diagram_decode_png(body.bytes) or {
+		if body.cached {
+			disk.remove(key)
+		}
+		return err
+	}
+	if !body.cached {
+		disk.write(key, body.bytes)
+	}
+	return img
+}
+
+const diagram_png_signature = [u8(0x89), `P`, `N`, `G`, `\r`, `\n`, 0x1a, `\n`]
+
+// diagram_has_png_signature reports whether bytes start like a PNG.
+fn diagram_has_png_signature(bytes []u8) bool {
+	return bytes.len >= diagram_png_signature.len
+		&& bytes[..diagram_png_signature.len] == diagram_png_signature
+}
+
+// diagram_decode_png decodes bytes that carry the PNG signature.
+fn diagram_decode_png(bytes []u8) !stbi.Image {
+	if !diagram_has_png_signature(bytes) {
+		return error('Failed to decode PNG: response is not a PNG image')
+	}
+	return stbi.load_from_memory(bytes.data, bytes.len) or {
+		return error('Failed to decode PNG: ${err.msg()}')
+	}
+}
+
+// queue_diagram_error marks a diagram as failed on the main thread.
+fn queue_diagram_error(mut window Window, hash i64, request_id u64, err_msg string) {
+	window.queue_command(fn [hash, request_id, err_msg] (mut w Window) {
+		if !diagram_cache_should_apply_result(&w.view_state.diagram_cache, hash, request_id) {
+			return
+		}
+		w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
+			state:      .error
+			error:      err_msg
+			request_id: request_id
+		})
+		w.update_window()
+	})
+}
+
+// DiagramFetch is one mermaid or math render. fetch runs on a diagram
+// fetch thread; finish runs on the worker pool, owns the decoded image
+// and posts it to the main thread.
+struct DiagramFetch {
+	disk       DiagramDiskCache
+	key        string
+	hash       i64
+	request_id u64
+	fetch      fn () !http.Response              @[required]
+	finish     fn (img stbi.Image, mut w Window) @[required]
+}
+
+// start_diagram_fetch reads or fetches the PNG on the window's
+// diagram_fetches queue, at most max_concurrent_diagram_fetches threads,
+// so a slow endpoint never holds a pool worker for its timeout. Only
+// the decode and finish run on the pool. A cached file that fails to
+// decode is fetched again. Safe to call from the layout thread.
+fn start_diagram_fetch(mut window Window, job DiagramFetch) {
+	if window.on_layout_thread() {
+		window.queue_command(fn [job] (mut w Window) {
+			start_diagram_fetch(mut w, job)
+		})
+		return
+	}
+	fetch_queue_push(window.diagram_fetches, fn [job] (mut w Window) {
+		body := diagram_fetch_png_body(job.disk, job.key, job.fetch) or {
+			queue_diagram_error(mut w, job.hash, job.request_id, err.msg())
+			return
+		}
+		// submit_work is called from the main thread.
+		w.queue_command(fn [job, body] (mut w Window) {
+			w.submit_work(WorkItem{
+				priority: .background
+				run:      fn [job, body] (mut w Window) {
+					img := diagram_png_decode(job.disk, job.key, body) or {
+						if body.cached {
+							w.queue_command(fn [job] (mut w Window) {
+								start_diagram_fetch(mut w, job)
+							})
+						} else {
+							queue_diagram_error(mut w, job.hash, job.request_id, err.msg())
+						}
+						return
+					}
+					job.finish(img, mut w)
+				}
+			})
+		})
+	}, mut window)
+}
@@ -249,6 +249,28 @@ fn drag_reorder_apply_tree_drop(drag_key string, on_reorder fn (string, string,
 	return true
 }
 
+// drag_reorder_on_scroll returns the drop hook for a reorderable list.
+// Non-reorderable lists get none, which keeps plain scrolling on the
+// scroll fast path (layout_scroll.v).
+fn drag_reorder_on_scroll(drag_key string, reorderable bool, on_reorder fn (string, string, mut Window)) fn (&Layout, mut Window) {
+	if !reorderable {
+		return unsafe { nil }
+	}
+	return fn [drag_key, on_reorder] (_ &Layout, mut w Window) {
+		drag_reorder_apply_drop(drag_key, on_reorder, mut w)
+	}
+}
+
+// drag_reorder_tree_on_scroll is drag_reorder_on_scroll for trees.
+fn drag_reorder_tree_on_scroll(drag_key string, reorderable bool, on_reorder fn (string, string, string, mut Window)) fn (&Layout, mut Window) {
+	if !reorderable {
+		return unsafe { nil }
+	}
+	return fn [drag_key, on_reorder] (_ &Layout, mut w Window) {
+		drag_reorder_apply_tree_drop(drag_key, on_reorder, mut w)
+	}
+}
+
 // drag_reorder_make_lock builds a MouseLockCfg that implements the
 // full drag lifecycle: threshold detection, tracking with FLIP
 // animation, and drop/cancel.
@@ -0,0 +1,66 @@
+module gui
+
+// event_coalesce.v batches high-rate pointer input between frames.
+// Mice and touchpads can deliver several mouse_move and mouse_scroll
+// events per frame; dispatching each one walks the layout tree and
+// requests a refresh. Instead, event_fn parks them here and frame_fn
+// dispatches each run of same-type events as one:
+// - consecutive moves merge into the latest, with deltas summed
+// - consecutive scrolls sum their deltas and keep the latest position
+// - a move after a scroll (or the reverse) starts a new event, so the
+//   interleaving is kept
+// Any other event (buttons, keys, focus, resize) first flushes the
+// pending input, so ordering relative to those events is preserved and
+// they are never merged.
+import gg
+import sokol.sapp
+
+// InputCoalescer holds pointer events waiting for the next frame, in
+// arrival order. Main thread only.
+struct InputCoalescer {
+mut:
+	pending []gg.Event
+	merged  u64 // events folded into a pending one
+}
+
+// is_coalescable reports whether an event may be merged with others of
+// the same type.
+@[inline]
+fn is_coalescable(typ sapp.EventType) bool {
+	return typ == .mouse_move || typ == .mouse_scroll
+}
+
+// add folds ev into the last pending event when it has the same type,
+// or appends it.
+fn (mut c InputCoalescer) add(ev &gg.Event) {
+	if c.pending.len == 0 || c.pending.last().typ != ev.typ {
+		c.pending << *ev
+		return
+	}
+	last := c.pending.last()
+	mut merged := *ev
+	merged.mouse_dx += last.mouse_dx
+	merged.mouse_dy += last.mouse_dy
+	merged.scroll_x += last.scroll_x
+	merged.scroll_y += last.scroll_y
+	c.pending[c.pending.len - 1] = merged
+	c.merged++
+}
+
+// take returns the pending events and empties the buffer.
+fn (mut c InputCoalescer) take() []gg.Event {
+	if c.pending.len == 0 {
+		return []
+	}
+	events := c.pending.clone()
+	array_clear(mut c.pending)
+	return events
+}
+
+// flush_coalesced_input dispatches pending pointer events. Called at
+// the start of each frame and before any non-coalescable event.
+fn (mut window Window) flush_coalesced_input() {
+	for ev in window.input.take() {
+		window.dispatch_event(&ev)
+	}
+}
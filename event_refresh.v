@@ -0,0 +1,134 @@
+module gui
+
+// event_refresh.v decides how much work an event costs the next frame.
+// Every event used to end in update_window(), so moving the pointer
+// across a large grid regenerated the view and reran layout on every
+// mouse_move. Now handlers may declare what they changed with
+// set_event_refresh, and undeclared mouse moves rerun layout only when
+// something visible depends on the new position:
+// - a mouse_move handler handled the event, or the mouse is locked
+// - the set of hover-sensitive shapes under the pointer changed
+//   (hover styling is applied during layout by on_hover/amend_layout)
+// - a tooltip was showing (any event hides it)
+// A changed RTF tooltip rebuilds renderers only; a changed cursor just
+// redraws. All other events still rerun layout unless declared.
+import sokol.sapp
+
+// EventRefresh is the refresh an event needs once its handlers ran.
+// Declarations only strengthen: the strongest one wins.
+pub enum EventRefresh as u8 {
+	auto        // let the window decide (default)
+	none        // nothing visible changed
+	render_only // rebuild renderers from the current layout
+	scroll      // translate scrolled containers in place (see layout_scroll.v)
+	layout      // regenerate the view and rerun layout
+}
+
+// set_event_refresh declares the refresh the current event needs. Call
+// from event handlers, e.g. `.none` from a mouse-move handler that only
+// records a position. update_window() still forces a layout refresh.
+pub fn (mut window Window) set_event_refresh(kind EventRefresh) {
+	if kind > window.event_refresh {
+		window.event_refresh = kind
+	}
+}
+
+fn on_event_default(_ &Event, mut _ Window) {}
+
+// MouseMoveSnapshot is the state a mouse move can change without a
+// handler, taken before dispatch.
+struct MouseMoveSnapshot {
+	cursor       sapp.MouseCursor
+	rtf_tooltip  string
+	menu_key_nav bool
+}
+
+fn mouse_move_snapshot(w &Window) MouseMoveSnapshot {
+	return MouseMoveSnapshot{
+		cursor:       w.view_state.mouse_cursor
+		rtf_tooltip:  w.view_state.rtf_tooltip_text
+		menu_key_nav: w.view_state.menu_key_nav
+	}
+}
+
+// mouse_move_refresh picks the refresh for an undeclared mouse move.
+fn (mut w Window) mouse_move_refresh(e &Event, before MouseMoveSnapshot) EventRefresh {
+	if e.is_handled || w.mouse_is_locked() || voidptr(w.on_event) != voidptr(on_event_default) {
+		return .layout
+	}
+	if before.menu_key_nav {
+		return .layout
+	}
+	signature := layout_hover_signature(&w.layout, w.ui.mouse_pos_x, w.ui.mouse_pos_y)
+	if signature != w.hover_signature {
+		w.hover_signature = signature
+		return .layout
+	}
+	if w.view_state.rtf_tooltip_text != before.rtf_tooltip {
+		return .render_only
+	}
+	return .none
+}
+
+// apply_event_refresh requests the refresh an event needs.
+fn (mut w Window) apply_event_refresh(kind EventRefresh, cursor_changed bool) {
+	match kind {
+		.render_only {
+			w.request_render_only()
+		}
+		.scroll {
+			w.request_scroll_refresh()
+		}
+		.none {
+			if cursor_changed {
+				w.ui.refresh_ui() // cursor is applied at the end of frame_fn
+			}
+		}
+		else {
+			w.update_window()
+		}
+	}
+}
+
+// reset_hover_signature records the hover targets of a freshly built
+// layout, so the next mouse move compares against it. Caller holds the
+// window lock.
+fn (mut w Window) reset_hover_signature() {
+	w.hover_signature = layout_hover_signature(&w.layout, w.ui.mouse_pos_x, w.ui.mouse_pos_y)
+}
+
+// layout_hover_signature hashes the hover-sensitive shapes under the
+// point: on_hover shapes that contain it, and amend_layout shapes that
+// contain it or whose parent does, since amend_layout may style itself
+// on hover over its parent (e.g. the markdown code-block copy button).
+// Shape addresses are stable for the lifetime of a layout, and a
+// rebuild resets the signature.
+fn layout_hover_signature(layout &Layout, x f32, y f32) u64 {
+	return layout_hover_signature_walk(layout, x, y, u64(14695981039346656037))
+}
+
+fn layout_hover_signature_walk(layout &Layout, x f32, y f32, seed u64) u64 {
+	mut hash := seed
+	for i in 0 .. layout.children.len {
+		hash = layout_hover_signature_walk(&layout.children[i], x, y, hash)
+	}
+	shape := layout.shape
+	if shape != unsafe { nil } && shape.has_events() && !shape.disabled
+		&& layout_hover_sensitive(layout, x, y) {
+		hash = (hash ^ u64(voidptr(shape))) * 1099511628211
+	}
+	return hash
+}
+
+fn layout_hover_sensitive(layout &Layout, x f32, y f32) bool {
+	events := layout.shape.events
+	if events.on_hover != unsafe { nil } && layout.shape.point_in_shape(x, y) {
+		return true
+	}
+	if events.amend_layout == unsafe { nil } {
+		return false
+	}
+	return layout.shape.point_in_shape(x, y)
+		|| (layout.parent != unsafe { nil } && layout.parent.shape != unsafe { nil }
+		&& layout.parent.shape.point_in_shape(x, y))
+}
@@ -2,6 +2,7 @@
 import db.sqlite
 import gui
 import sync
+import time
 
 @[table: 'members']
 struct MemberRow {
@@ -38,8 +39,8 @@ pub mut:
 struct SqliteGridOrmFetcher {
 mut:
 	db      sqlite.DB
-	mutex   &sync.Mutex = sync.new_mutex()
-	columns map[string]gui.GridOrmColumnSpec
+	mutex  &sync.Mutex          = sync.new_mutex()
+	source &gui.GridOrmDataSource = unsafe { nil }
 }
 
 fn main() {
@@ -53,11 +54,13 @@ fn main() {
 			app.columns = orm_demo_grid_columns()
 			mut fetcher := orm_demo_new_fetcher() or { panic(err) }
 			app.fetcher = fetcher
-			app.source = &gui.GridOrmDataSource{
+			source := gui.new_grid_orm_data_source(gui.GridOrmDataSource{
 				columns:         orm_demo_source_columns()
 				default_limit:   180
 				supports_offset: true
 				row_count_known: true
+				keyset_field:    'm.id'
+				row_count_ttl:   5 * time.second
 				fetch_fn:        fn [mut fetcher] (spec gui.GridOrmQuerySpec, signal &gui.GridAbortSignal) !gui.GridOrmPage {
 					return fetcher.fetch(spec, signal)
 				}
@@ -70,7 +73,9 @@ fn main() {
 				delete_many_fn:  fn [mut fetcher] (row_ids []string, signal &gui.GridAbortSignal) ![]string {
 					return fetcher.delete_rows(row_ids, signal)
 				}
-			}
+			}) or { panic(err) }
+			fetcher.source = source
+			app.source = source
 			w.update_view(orm_demo_view)
 		}
 	)
@@ -222,6 +227,7 @@ fn orm_demo_source_columns() []gui.GridOrmColumnSpec {
 			filterable:       true
 			sortable:         true
 			case_insensitive: true
+			keyset:           true
 		},
 		gui.GridOrmColumnSpec{
 			id:               'team'
@@ -230,6 +236,7 @@ fn orm_demo_source_columns() []gui.GridOrmColumnSpec {
 			filterable:       true
 			sortable:         true
 			case_insensitive: true
+			keyset:           true
 		},
 		gui.GridOrmColumnSpec{
 			id:               'email'
@@ -238,6 +245,7 @@ fn orm_demo_source_columns() []gui.GridOrmColumnSpec {
 			filterable:       true
 			sortable:         true
 			case_insensitive: true
+			keyset:           true
 		},
 		gui.GridOrmColumnSpec{
 			id:               'status'
@@ -246,6 +254,7 @@ fn orm_demo_source_columns() []gui.GridOrmColumnSpec {
 			filterable:       true
 			sortable:         true
 			case_insensitive: true
+			keyset:           true
 		},
 		gui.GridOrmColumnSpec{
 			id:               'active'
@@ -254,7 +263,7 @@ fn orm_demo_source_columns() []gui.GridOrmColumnSpec {
 			filterable:       true
 			sortable:         true
 			case_insensitive: false
-			allowed_ops:      ['equals']
+			allowed_ops:      ['equals'] // no keyset: cells show true/false, the db stores 1/0
 		},
 		gui.GridOrmColumnSpec{
 			id:               'score'
@@ -263,6 +272,7 @@ fn orm_demo_source_columns() []gui.GridOrmColumnSpec {
 			filterable:       true
 			sortable:         true
 			case_insensitive: false
+			keyset:           true
 			allowed_ops:      ['equals']
 		},
 		gui.GridOrmColumnSpec{
@@ -272,6 +282,7 @@ fn orm_demo_source_columns() []gui.GridOrmColumnSpec {
 			filterable:       true
 			sortable:         true
 			case_insensitive: true
+			keyset:           true
 		},
 	]
 }
@@ -280,17 +291,8 @@ fn orm_demo_new_fetcher() !&SqliteGridOrmFetcher {
 	mut db := sqlite.connect(':memory:')!
 	orm_demo_seed(mut db, 9000)!
 	return &SqliteGridOrmFetcher{
-		db:      db
-		columns: orm_demo_column_map(orm_demo_source_columns())
-	}
-}
-
-fn orm_demo_column_map(columns []gui.GridOrmColumnSpec) map[string]gui.GridOrmColumnSpec {
-	mut out := map[string]gui.GridOrmColumnSpec{}
-	for col in columns {
-		out[col.id] = col
+		db: db
 	}
-	return out
 }
 
 fn orm_demo_seed(mut db sqlite.DB, count int) ! {
@@ -342,24 +344,29 @@ fn (mut fetcher SqliteGridOrmFetcher) fetch(spec gui.GridOrmQuerySpec, signal &g
 	defer {
 		fetcher.mutex.unlock()
 	}
-	b := gui.grid_orm_build_sql(spec, fetcher.columns)!
+	// build_sql reuses the SQL text of queries with the same shape.
+	b := fetcher.source.build_sql(spec)!
 	base_from := ' from members m join teams t on t.id = m.team_id'
 	where_sql := if b.where_sql.len > 0 { ' where ${b.where_sql}' } else { '' }
 	order_sql := if b.order_sql.len > 0 { b.order_sql } else { 'm.id asc' }
 	rows_sql := 'select m.id, m.name, t.name, m.email, m.status, m.active, m.score, m.start_date${base_from}${where_sql} order by ${order_sql} ${b.limit_sql} ${b.offset_sql}'
 	sql_rows := fetcher.db.exec_param_many(rows_sql, b.params)!
-	// Count query uses params without limit/offset (last 2).
-	count_params := if b.params.len >= 2 {
-		b.params[..b.params.len - 2]
-	} else {
-		[]string{}
-	}
-	count_sql := 'select count(*)${base_from}${where_sql}'
-	count_rows := fetcher.db.exec_param_many(count_sql, count_params)!
-	total := if count_rows.len > 0 && count_rows[0].vals.len > 0 {
-		count_rows[0].vals[0].int()
-	} else {
-		0
+	mut total := ?int(none)
+	if spec.need_count {
+		// Count the filtered rows, without the keyset seek.
+		count_b := fetcher.source.build_sql(gui.GridOrmQuerySpec{
+			quick_filter: spec.quick_filter
+			filters:      spec.filters
+		})!
+		count_where := if count_b.where_sql.len > 0 { ' where ${count_b.where_sql}' } else { '' }
+		count_sql := 'select count(*)${base_from}${count_where}'
+		// Count query uses params without limit/offset (last 2).
+		count_rows := fetcher.db.exec_param_many(count_sql, count_b.params[..count_b.params.len - 2])!
+		total = if count_rows.len > 0 && count_rows[0].vals.len > 0 {
+			count_rows[0].vals[0].int()
+		} else {
+			0
+		}
 	}
 	mut rows := []gui.GridRow{cap: sql_rows.len}
 	for row in sql_rows {
@@ -383,7 +390,8 @@ fn (mut fetcher SqliteGridOrmFetcher) fetch(spec gui.GridOrmQuerySpec, signal &g
 		}
 	}
 	next_offset := spec.offset + rows.len
-	has_more := next_offset < total
+	// Without a count (a cached one is used), a full page has more.
+	has_more := if count := total { next_offset < count } else { rows.len == spec.limit }
 	prev_offset := if spec.offset > spec.limit {
 		spec.offset - spec.limit
 	} else {
@@ -393,7 +401,7 @@ fn (mut fetcher SqliteGridOrmFetcher) fetch(spec gui.GridOrmQuerySpec, signal &g
 		rows:        rows
 		next_cursor: if has_more { 'i:${next_offset}' } else { '' }
 		prev_cursor: if spec.offset > 0 { 'i:${prev_offset}' } else { '' }
-		row_count:   ?int(total)
+		row_count:   total
 		has_more:    has_more
 	}
 }
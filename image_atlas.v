@@ -0,0 +1,306 @@
+module gui
+
+// image_atlas.v packs small images (avatars, flags, icons, thumbnails)
+// into shared streaming textures. Consecutive atlas DrawImage renderers
+// on the same page draw with one texture bind (see draw_atlas_image_batch
+// and draw_rounded_image_batch). Pages use a shelf packer; when every
+// page is full, the least recently drawn shelf that no presented
+// renderer references is evicted and reused. Renderers can outlive the
+// frame that built them (pipelined windows redraw the front buffer and
+// overlay-only updates keep the rest), so every shelf drawn since the
+// last full build_renderers is pinned. CPU pixels are uploaded at most
+// once per frame per page, right before drawing.
+import gg
+
+const image_atlas_page_size = 1024
+const image_atlas_max_pages = 2
+const image_atlas_max_dim = 128 // larger images bypass the atlas
+const image_atlas_padding = 1 // transparent gutter between packed images
+const image_atlas_shelf_align = 8 // shelf heights round up so similar sizes share shelves
+
+// ImageAtlasEntry locates a packed image. u0..v1 are texture
+// coordinates inset by half a texel so linear filtering never samples
+// the neighbouring gutter.
+struct ImageAtlasEntry {
+	page  int
+	shelf int
+	x     int
+	y     int
+	w     int
+	h     int
+	u0    f32
+	v0    f32
+	u1    f32
+	v1    f32
+}
+
+// ImageAtlasShelf is one horizontal strip of a page. Images are
+// appended left to right; the shelf is evicted as a unit.
+struct ImageAtlasShelf {
+mut:
+	y         int
+	height    int
+	cursor    int
+	last_used u64
+	keys      []int
+}
+
+// ImageAtlasPage owns the CPU copy of one atlas texture.
+struct ImageAtlasPage {
+mut:
+	image_idx     int = -1 // gg image cache index, created lazily
+	pixels        []u8
+	shelves       []ImageAtlasShelf
+	next_y        int
+	dirty         bool
+	upload_frame  i64 = -1
+	upload_missed bool // dirty pixels waited for next frame's upload slot
+}
+
+// ImageAtlas maps gg image cache ids to packed entries. Callers remove
+// an id whenever its source image leaves the gg cache.
+struct ImageAtlas {
+mut:
+	pages     []ImageAtlasPage
+	entries   map[int]ImageAtlasEntry
+	presented u64 // frame the presented renderer list was built in
+	disabled  bool
+	evictions int
+}
+
+// begin_renderers marks the start of a full renderer build in frame.
+// The previous list is discarded, so only shelves drawn from here on
+// stay pinned.
+fn (mut atlas ImageAtlas) begin_renderers(frame u64) {
+	atlas.presented = frame
+}
+
+// image_atlas_accepts reports whether img is small enough and has CPU
+// RGBA pixels that can be copied into a page.
+@[inline]
+fn image_atlas_accepts(img &gg.Image) bool {
+	return img != unsafe { nil } && img.data != unsafe { nil } && img.nr_channels == 4
+		&& img.width > 0 && img.height > 0 && img.width <= image_atlas_max_dim
+		&& img.height <= image_atlas_max_dim
+}
+
+// lookup returns the atlas entry for key, packing img on first use.
+// Returns none when img does not qualify or no shelf can be freed
+// without disturbing images the presented renderers draw.
+fn (mut atlas ImageAtlas) lookup(key int, img &gg.Image, frame u64) ?ImageAtlasEntry {
+	if atlas.disabled {
+		return none
+	}
+	if entry := atlas.entries[key] {
+		atlas.pages[entry.page].shelves[entry.shelf].last_used = frame
+		return entry
+	}
+	if !image_atlas_accepts(img) {
+		return none
+	}
+	entry := atlas.insert(key, img.width, img.height, frame)?
+	atlas.copy_pixels(entry, img.data)
+	return entry
+}
+
+// insert reserves space for a w x h image and records the entry.
+// Pixels are not copied; see copy_pixels.
+fn (mut atlas ImageAtlas) insert(key int, w int, h int, frame u64) ?ImageAtlasEntry {
+	if w <= 0 || h <= 0 || w > image_atlas_max_dim || h > image_atlas_max_dim {
+		return none
+	}
+	need_w := w + image_atlas_padding
+	need_h := h + image_atlas_padding
+	page_idx, shelf_idx := atlas.allocate(need_w, need_h, frame)?
+	mut shelf := &atlas.pages[page_idx].shelves[shelf_idx]
+	x := shelf.cursor
+	y := shelf.y
+	shelf.cursor += need_w
+	shelf.last_used = frame
+	shelf.keys << key
+	size := f32(image_atlas_page_size)
+	entry := ImageAtlasEntry{
+		page:  page_idx
+		shelf: shelf_idx
+		x:     x
+		y:     y
+		w:     w
+		h:     h
+		u0:    (f32(x) + 0.5) / size
+		v0:    (f32(y) + 0.5) / size
+		u1:    (f32(x + w) - 0.5) / size
+		v1:    (f32(y + h) - 0.5) / size
+	}
+	atlas.entries[key] = entry
+	return entry
+}
+
+// allocate finds a shelf with room for need_w x need_h. Order:
+// best-fitting existing shelf, new shelf on an existing page, new
+// page, then eviction of the least recently used unpinned shelf.
+fn (mut atlas ImageAtlas) allocate(need_w int, need_h int, frame u64) ?(int, int) {
+	mut best_page := -1
+	mut best_shelf := -1
+	mut best_height := image_atlas_page_size + 1
+	for p, page in atlas.pages {
+		for s, shelf in page.shelves {
+			if shelf.height >= need_h && shelf.height < best_height
+				&& image_atlas_page_size - shelf.cursor >= need_w {
+				best_page = p
+				best_shelf = s
+				best_height = shelf.height
+			}
+		}
+	}
+	if best_page >= 0 {
+		return best_page, best_shelf
+	}
+	shelf_h := image_atlas_align(need_h)
+	for p, page in atlas.pages {
+		if image_atlas_page_size - page.next_y >= shelf_h {
+			return p, atlas.add_shelf(p, shelf_h)
+		}
+	}
+	if atlas.pages.len < image_atlas_max_pages {
+		atlas.pages << ImageAtlasPage{}
+		return atlas.pages.len - 1, atlas.add_shelf(atlas.pages.len - 1, shelf_h)
+	}
+	mut victim_page := -1
+	mut victim_shelf := -1
+	mut oldest := u64(0)
+	for p, page in atlas.pages {
+		for s, shelf in page.shelves {
+			if shelf.height < need_h || shelf.last_used >= atlas.presented
+				|| shelf.last_used == frame {
+				continue
+			}
+			if victim_page < 0 || shelf.last_used < oldest {
+				victim_page = p
+				victim_shelf = s
+				oldest = shelf.last_used
+			}
+		}
+	}
+	if victim_page < 0 {
+		return none
+	}
+	atlas.evict_shelf(victim_page, victim_shelf)
+	return victim_page, victim_shelf
+}
+
+fn (mut atlas ImageAtlas) add_shelf(page_idx int, height int) int {
+	mut page := &atlas.pages[page_idx]
+	page.shelves << ImageAtlasShelf{
+		y:      page.next_y
+		height: height
+	}
+	page.next_y += height
+	return page.shelves.len - 1
+}
+
+// evict_shelf drops every entry on a shelf and clears its pixels so
+// stale texels never show through the gutter of new neighbours.
+fn (mut atlas ImageAtlas) evict_shelf(page_idx int, shelf_idx int) {
+	mut page := &atlas.pages[page_idx]
+	mut shelf := &page.shelves[shelf_idx]
+	for key in shelf.keys {
+		// Skip keys that were removed and later re-packed elsewhere.
+		if entry := atlas.entries[key] {
+			if entry.page == page_idx && entry.shelf == shelf_idx {
+				atlas.entries.delete(key)
+			}
+		}
+	}
+	array_clear(mut shelf.keys)
+	if page.pixels.len > 0 && shelf.cursor > 0 {
+		stride := image_atlas_page_size * 4
+		for row in shelf.y .. shelf.y + shelf.height {
+			start := row * stride
+			unsafe { vmemset(&page.pixels[start], 0, shelf.cursor * 4) }
+		}
+		page.dirty = true
+	}
+	shelf.cursor = 0
+	atlas.evictions++
+}
+
+// copy_pixels writes RGBA rows from data into the entry's page slot.
+fn (mut atlas ImageAtlas) copy_pixels(entry ImageAtlasEntry, data voidptr) {
+	mut page := &atlas.pages[entry.page]
+	if page.pixels.len == 0 {
+		page.pixels = []u8{len: image_atlas_page_size * image_atlas_page_size * 4}
+	}
+	stride := image_atlas_page_size * 4
+	row_bytes := entry.w * 4
+	src := unsafe { &u8(data) }
+	for row in 0 .. entry.h {
+		dst_start := (entry.y + row) * stride + entry.x * 4
+		unsafe { vmemcpy(&page.pixels[dst_start], src + row * row_bytes, row_bytes) }
+	}
+	page.dirty = true
+}
+
+// remove drops the entry for key. The slot is reclaimed when its shelf
+// is evicted.
+fn (mut atlas ImageAtlas) remove(key int) {
+	atlas.entries.delete(key)
+}
+
+// page_image returns the GPU texture for a page, creating it on first
+// use. Must run on the main thread with a valid gfx context.
+fn (mut atlas ImageAtlas) page_image(page_idx int, mut ctx gg.Context) &gg.Image {
+	mut page := &atlas.pages[page_idx]
+	if page.image_idx < 0 {
+		page.image_idx = ctx.new_streaming_image(image_atlas_page_size, image_atlas_page_size,
+			4, gg.StreamingImageConfig{})
+	}
+	return ctx.get_cached_image_by_idx(page.image_idx)
+}
+
+// upload pushes dirty page pixels to the GPU. sokol allows one update
+// per streaming image per frame; a second dirtying in the same frame
+// is deferred and reported so the caller can request another frame.
+fn (mut atlas ImageAtlas) upload(mut ctx gg.Context) bool {
+	frame := i64(ctx.frame)
+	mut pending := false
+	for mut page in atlas.pages {
+		if !page.dirty || page.image_idx < 0 {
+			continue
+		}
+		if page.upload_frame == frame {
+			page.upload_missed = true
+			pending = true
+			continue
+		}
+		ctx.update_pixel_data(page.image_idx, page.pixels.data)
+		page.dirty = false
+		page.upload_missed = false
+		page.upload_frame = frame
+	}
+	return pending
+}
+
+// clear forgets every entry and page. It returns the page textures,
+// which the caller frees once no presented renderer draws them.
+fn (mut atlas ImageAtlas) clear() []int {
+	mut textures := []int{cap: atlas.pages.len}
+	for page in atlas.pages {
+		if page.image_idx >= 0 {
+			textures << page.image_idx
+		}
+	}
+	atlas.pages.clear()
+	atlas.entries.clear()
+	return textures
+}
+
+// len returns the number of packed images.
+fn (atlas &ImageAtlas) len() int {
+	return atlas.entries.len
+}
+
+@[inline]
+fn image_atlas_align(h int) int {
+	aligned := (h + image_atlas_shelf_align - 1) / image_atlas_shelf_align * image_atlas_shelf_align
+	return int_min(aligned, image_atlas_page_size)
+}
@@ -0,0 +1,382 @@
+module gui
+
+// image_decode.v moves image decoding off the main thread. A cache miss
+// in load_image_sized_async enqueues a job and returns `pending`; the
+// caller keeps the layout size (known from image_source_size, which
+// only sniffs the file header) and draws a placeholder. When the header
+// is not recognized, the decode reports the size and triggers a
+// relayout. Jobs run at
+// background priority on the window worker pool (worker_pool.v), which
+// decodes and downsamples to the requested mip level.
+// The main thread uploads finished pixels at the start of the next
+// frame, bounded by image_upload_budget_bytes, so a burst of new images
+// spreads its GPU uploads across frames instead of hitching one.
+// A failed image is retried when its file changes, or after a backoff
+// that doubles with each failure up to image_retry_max_ms.
+import log
+import math
+import os
+import stbi
+import sync
+import time
+
+const image_upload_budget_bytes = i64(8 * 1024 * 1024) // per frame; one image always fits
+const image_placeholder_size = 100 // layout size while the real size is unknown
+const image_retry_base_ms = i64(1000)
+const image_retry_max_ms = i64(60 * 1000)
+
+// ImageLookup is the result of load_image_sized_async. When pending is
+// true, img is nil and the texture arrives in a later frame.
+struct ImageLookup {
+	img     &Image = unsafe { nil }
+	pending bool
+}
+
+struct ImageDecodeJob {
+	key       string
+	real_path string
+	level     int
+}
+
+struct ImageDecodeResult {
+	key       string
+	real_path string
+	img       stbi.Image
+	src_w     int // source size before downsampling
+	src_h     int
+	err_msg   string
+}
+
+// ImageDecodeFailure remembers why an image failed and when to try it
+// again.
+struct ImageDecodeFailure {
+	err_msg  string
+	mtime    i64 // source file mtime when it failed
+	retry_at i64 // time.ticks() after which it is retried
+	attempts int
+}
+
+// ImageDecoder collects decode results. `results` is filled by pool
+// workers and drained by the main thread. `pending`, `failed` and
+// `closed` are written on the main thread only.
+@[heap]
+struct ImageDecoder {
+mut:
+	results_mutex &sync.Mutex = sync.new_mutex()
+	results       []ImageDecodeResult
+	pending       map[string]bool
+	failed        map[string]ImageDecodeFailure
+	closed        bool
+	uploads       u64
+	upload_bytes  u64
+}
+
+// load_image_sized_async is the non-blocking form of load_image_sized.
+// Returns the cached image when ready; otherwise queues a background
+// decode and returns a pending lookup. Decode failures are reported as
+// errors on later calls for the same image until it is retried.
+pub fn (mut window Window) load_image_sized_async(file_name string, width f32, height f32) !ImageLookup {
+	if is_memory_image_key(file_name) {
+		return ImageLookup{
+			img: window.load_memory_image(file_name)!
+		}
+	}
+	validate_image_path(file_name)!
+	real_path := os.real_path(file_name)
+	src_w, src_h := window.image_source_size(file_name)!
+	scale := if window.ui.scale > 0 { window.ui.scale } else { f32(1) }
+	// Until the decode reports the real size, src_w x src_h is only a
+	// placeholder: decode the full image rather than a wrong mip.
+	level := if real_path in window.view_state.image_dims {
+		image_mip_level(src_w, src_h, int(math.ceil(f64(width * scale))),
+			int(math.ceil(f64(height * scale))))
+	} else {
+		0
+	}
+	key := if level == 0 { real_path } else { image_mip_key(real_path, level) }
+	mut ctx := window.context()
+	if id := window.view_state.image_map.get(key) {
+		window.view_state.image_map.touch(key)
+		return ImageLookup{
+			img: ctx.get_cached_image_by_idx(id)
+		}
+	}
+	mut decoder := window.ensure_image_decoder()
+	if decoder.closed {
+		return error('window closed: ${file_name}')
+	}
+	if failure := decoder.failed[key] {
+		if time.ticks() < failure.retry_at && os.file_last_mod_unix(real_path) == failure.mtime {
+			return error(failure.err_msg)
+		}
+	}
+	if key !in decoder.pending {
+		job := ImageDecodeJob{
+			key:       key
+			real_path: real_path
+			level:     level
+		}
+		window.submit_work(WorkItem{
+			priority: .background
+			run:      fn [job, mut decoder] (mut w Window) {
+				image_decode_deliver(mut decoder, image_decode_job(job), mut w)
+			}
+		})
+		decoder.pending[key] = true
+	}
+	return ImageLookup{
+		pending: true
+	}
+}
+
+// image_source_size returns the pixel size of an image file without
+// decoding it: from the dims cache, else by sniffing the file header.
+// A missing or unreadable file is an error. For an existing file in a
+// format the sniffer does not know it returns a placeholder size; the
+// background decode records the real size and relayouts.
+pub fn (mut window Window) image_source_size(file_name string) !(int, int) {
+	if is_memory_image_key(file_name) {
+		dims := window.view_state.image_dims[file_name] or {
+			return error('image not in cache: ${file_name}')
+		}
+		return dims[0], dims[1]
+	}
+	validate_image_path(file_name)!
+	real_path := os.real_path(file_name)
+	if dims := window.view_state.image_dims[real_path] {
+		return dims[0], dims[1]
+	}
+	w, h := image_file_header_size(real_path) or {
+		if !os.is_file(real_path) || !os.is_readable(real_path) {
+			return error('image file not found: ${file_name}')
+		}
+		return image_placeholder_size, image_placeholder_size
+	}
+	window.view_state.image_dims[real_path] = [w, h]!
+	return w, h
+}
+
+// ensure_image_decoder returns the window's decoder, creating it on
+// first use.
+fn (mut window Window) ensure_image_decoder() &ImageDecoder {
+	if window.image_decoder == unsafe { nil } {
+		window.image_decoder = &ImageDecoder{}
+	}
+	return window.image_decoder
+}
+
+// image_decode_deliver hands a finished decode to the main thread.
+// Runs on a worker; results arriving after close are freed. The
+// wake-up goes through the command queue, which is safe from any
+// thread; the frame it starts uploads the result.
+fn image_decode_deliver(mut decoder ImageDecoder, result ImageDecodeResult, mut w Window) {
+	decoder.results_mutex.lock()
+	if decoder.closed {
+		decoder.results_mutex.unlock()
+		if result.err_msg.len == 0 {
+			result.img.free()
+		}
+		return
+	}
+	decoder.results << result
+	decoder.results_mutex.unlock()
+	w.queue_command_keyed('image_decode', fn (mut _ Window) {})
+}
+
+fn image_decode_job(job ImageDecodeJob) ImageDecodeResult {
+	src := stbi.load(job.real_path) or {
+		return ImageDecodeResult{
+			key:       job.key
+			real_path: job.real_path
+			err_msg:   'decode failed: ${job.real_path}: ${err.msg()}'
+		}
+	}
+	if job.level == 0 {
+		return ImageDecodeResult{
+			key:       job.key
+			real_path: job.real_path
+			img:       src
+			src_w:     src.width
+			src_h:     src.height
+		}
+	}
+	mip_w, mip_h := image_mip_size(src.width, src.height, job.level)
+	mip := stbi.resize_uint8(&src, mip_w, mip_h) or {
+		src.free()
+		return ImageDecodeResult{
+			key:       job.key
+			real_path: job.real_path
+			err_msg:   'resize failed: ${job.real_path}: ${err.msg()}'
+		}
+	}
+	src.free()
+	return ImageDecodeResult{
+		key:       job.key
+		real_path: job.real_path
+		img:       mip
+		src_w:     src.width
+		src_h:     src.height
+	}
+}
+
+// upload_decoded_images turns finished decodes into textures. Runs on
+// the main thread at frame start. Returns true when at least one image
+// was uploaded, so the caller can refresh renderers.
+fn (mut window Window) upload_decoded_images() bool {
+	if window.image_decoder == unsafe { nil } {
+		return false
+	}
+	mut decoder := window.image_decoder
+	decoder.results_mutex.lock()
+	if decoder.results.len == 0 {
+		decoder.results_mutex.unlock()
+		return false
+	}
+	mut budget := image_upload_budget_bytes
+	mut take := 0
+	for take < decoder.results.len {
+		r := decoder.results[take]
+		bytes := if r.err_msg.len > 0 { i64(0) } else { image_byte_size(r.img.width, r.img.height) }
+		if take > 0 && bytes > budget {
+			break
+		}
+		budget -= bytes
+		take++
+	}
+	ready := decoder.results[..take].clone()
+	decoder.results = decoder.results[take..].clone()
+	remaining := decoder.results.len
+	decoder.results_mutex.unlock()
+
+	mut uploaded := false
+	for r in ready {
+		decoder.pending.delete(r.key)
+		if r.err_msg.len > 0 {
+			log.error(r.err_msg)
+			decoder.record_failure(r.key, r.real_path, r.err_msg)
+			continue
+		}
+		if r.real_path !in window.view_state.image_dims {
+			// Laid out at the placeholder size; relayout at the real one.
+			window.view_state.image_dims[r.real_path] = [r.src_w, r.src_h]!
+			window.update_window()
+		}
+		if _ := window.cache_rgba_image(r.key, r.img.width, r.img.height, r.img.data) {
+			decoder.failed.delete(r.key)
+			decoder.uploads++
+			decoder.upload_bytes += u64(image_byte_size(r.img.width, r.img.height))
+			uploaded = true
+		} else {
+			log.error('${@FILE_LINE} > ${err.msg()}')
+			decoder.record_failure(r.key, r.real_path, err.msg())
+		}
+		r.img.free()
+	}
+	if remaining > 0 {
+		// Over this frame's budget: continue next frame.
+		window.ui.refresh_ui()
+	}
+	return uploaded
+}
+
+// record_failure marks key as failed. Each consecutive failure doubles
+// the wait before the next attempt; a change to the file retries at
+// once. Main thread only.
+fn (mut decoder ImageDecoder) record_failure(key string, real_path string, err_msg string) {
+	attempts := (decoder.failed[key] or { ImageDecodeFailure{} }).attempts + 1
+	backoff := math.min(image_retry_base_ms << math.min(attempts - 1, 16), image_retry_max_ms)
+	decoder.failed[key] = ImageDecodeFailure{
+		err_msg:  err_msg
+		mtime:    os.file_last_mod_unix(real_path)
+		retry_at: time.ticks() + backoff
+		attempts: attempts
+	}
+}
+
+// close_image_decoder frees undelivered pixels; decodes still running
+// free their own. Images still pending are never uploaded: later
+// lookups return an error instead of a pending result, since the
+// window is going away.
+fn (mut window Window) close_image_decoder() {
+	if window.image_decoder == unsafe { nil } {
+		return
+	}
+	mut decoder := window.image_decoder
+	decoder.results_mutex.lock()
+	decoder.closed = true
+	for r in decoder.results {
+		if r.err_msg.len == 0 {
+			r.img.free()
+		}
+	}
+	decoder.results.clear()
+	decoder.results_mutex.unlock()
+	decoder.pending.clear()
+}
+
+// image_file_header_size reads just enough of a file to find its pixel
+// size. See image_header_size for supported formats.
+fn image_file_header_size(path string) ?(int, int) {
+	mut f := os.open(path) or { return none }
+	defer {
+		f.close()
+	}
+	mut buf := []u8{len: 64 * 1024}
+	n := f.read(mut buf) or { return none }
+	return image_header_size(buf[..n])
+}
+
+// image_header_size parses PNG, GIF, BMP and JPEG headers for width and
+// height. JPEG scans markers up to the first SOF segment, so large EXIF
+// blocks beyond the sniffed bytes return none.
+fn image_header_size(b []u8) ?(int, int) {
+	if b.len >= 24 && b[0] == 0x89 && b[1] == `P` && b[2] == `N` && b[3] == `G` {
+		return int(be_u32(b, 16)), int(be_u32(b, 20))
+	}
+	if b.len >= 10 && b[0] == `G` && b[1] == `I` && b[2] == `F` {
+		return int(u32(b[6]) | u32(b[7]) << 8), int(u32(b[8]) | u32(b[9]) << 8)
+	}
+	if b.len >= 26 && b[0] == `B` && b[1] == `M` {
+		w := i32(le_u32(b, 18))
+		h := i32(le_u32(b, 22))
+		return int(if w < 0 { -w } else { w }), int(if h < 0 { -h } else { h })
+	}
+	if b.len >= 4 && b[0] == 0xff && b[1] == 0xd8 {
+		mut i := 2
+		for i + 9 < b.len {
+			if b[i] != 0xff {
+				i++
+				continue
+			}
+			marker := b[i + 1]
+			if marker == 0xff {
+				i++
+				continue
+			}
+			if marker == 0xd8 || marker == 0x01 || (marker >= 0xd0 && marker <= 0xd7) {
+				i += 2
+				continue
+			}
+			seg_len := int(u32(b[i + 2]) << 8 | u32(b[i + 3]))
+			is_sof := marker >= 0xc0 && marker <= 0xcf && marker != 0xc4 && marker != 0xc8
+				&& marker != 0xcc
+			if is_sof {
+				h := int(u32(b[i + 5]) << 8 | u32(b[i + 6]))
+				w := int(u32(b[i + 7]) << 8 | u32(b[i + 8]))
+				return w, h
+			}
+			i += 2 + seg_len
+		}
+	}
+	return none
+}
+
+@[inline]
+fn be_u32(b []u8, at int) u32 {
+	return u32(b[at]) << 24 | u32(b[at + 1]) << 16 | u32(b[at + 2]) << 8 | u32(b[at + 3])
+}
+
+@[inline]
+fn le_u32(b []u8, at int) u32 {
+	return u32(b[at]) | u32(b[at + 1]) << 8 | u32(b[at + 2]) << 16 | u32(b[at + 3]) << 24
+}
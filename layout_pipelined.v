@@ -0,0 +1,181 @@
+module gui
+
+// layout_pipelined.v implements the opt-in pipelined frame
+// (WindowCfg.pipelined_layout). A dedicated layout thread runs the view
+// generator and layout into a back buffer while the main thread keeps
+// drawing the front buffer: window.layout and window.renderers as last
+// presented. When the back buffer is ready, the next frame swaps it in
+// and rebuilds renderers from it, then draws. A 12 ms layout therefore
+// overlaps the draw instead of adding to it.
+//
+// Locking:
+// - `gate` is held by the layout thread for the whole build, and by the
+//   main thread while it mutates state: commands, events, image
+//   uploads, the swap and renderer building. The main thread only
+//   try_locks it; if a build is running it draws the front buffer
+//   unchanged and events wait in `deferred_events` for the next frame.
+//   Events therefore always hit-test the presented layout.
+// - Drawing takes no state lock. It reads only main-thread data plus
+//   the vglyph text system, which is serialized by text_mutex
+//   (text_sync.v).
+// - Renderer building stays on the main thread: it updates the image
+//   atlas and texture caches the draw pass reads. View code that needs
+//   the GPU or those caches checks on_layout_thread and defers the work
+//   to the main thread with queue_command.
+import gg
+import sokol.sapp
+import sync
+
+// LayoutPipeline is the back buffer and handshake state for the layout
+// thread. back, ready and builds are guarded by gate; deferred_events
+// and skipped_frames are main-thread only.
+@[heap]
+struct LayoutPipeline {
+mut:
+	gate            &sync.Mutex = sync.new_mutex()
+	wake            chan bool   = chan bool{cap: 1}
+	back            Layout
+	ready           bool // back holds a finished layout
+	building        bool // the layout thread is generating views
+	deferred_events []gg.Event
+	builds          u64
+	skipped_frames  u64 // frames drawn while a build held the gate
+}
+
+// layout_pipeline_request wakes the layout thread. Non-blocking; a
+// pending wake already covers the request.
+fn (mut pipeline LayoutPipeline) request() {
+	select {
+		pipeline.wake <- true {}
+		else {}
+	}
+}
+
+// layout_pipeline_loop builds layouts on its own thread until the wake
+// channel is closed.
+fn (mut window Window) layout_pipeline_loop() {
+	mut pipeline := window.pipeline
+	for {
+		_ := <-pipeline.wake or { break }
+		pipeline.gate.lock()
+		pipeline.building = true
+		window.lock()
+		window.scroll_fast_path_reset()
+		window.layout_callback_frame(fn [mut window] () {
+			mut view := window.view_generator(window)
+			mut p := window.pipeline
+			layout_clear(mut p.back)
+			p.back = window.compose_layout(mut view)
+			view_clear(mut view)
+			window.sweep_live_inboxes()
+		}) or { panic(err) }
+		window.unlock()
+		pipeline.building = false
+		pipeline.ready = true
+		pipeline.builds++
+		pipeline.gate.unlock()
+		window.ui.refresh_ui()
+	}
+}
+
+// on_layout_thread reports whether the caller runs on the layout thread,
+// where sokol and the texture caches must not be touched.
+fn (window &Window) on_layout_thread() bool {
+	return window.pipeline != unsafe { nil } && window.pipeline.building
+}
+
+// frame_pipelined is frame_fn for pipelined windows.
+fn (mut window Window) frame_pipelined() {
+	mut pipeline := window.pipeline
+	if pipeline.gate.try_lock() {
+		window.replay_deferred_events()
+		window.flush_commands()
+		if window.upload_decoded_images() {
+			window.mark_render_only_refresh()
+		}
+		if pipeline.ready {
+			window.present_back_layout()
+			window.refresh_render_only = false
+			window.refresh_overlay = false
+		} else if window.refresh_render_only {
+			window.update_render_only()
+			window.refresh_render_only = false
+			window.refresh_overlay = false
+		} else if window.refresh_overlay {
+			window.update_overlay()
+			window.refresh_overlay = false
+		}
+		if window.refresh_layout {
+			window.refresh_layout = false
+			pipeline.request()
+		}
+		process_svg_filters(mut window)
+		pipeline.gate.unlock()
+	} else {
+		pipeline.skipped_frames++
+	}
+
+	window.ui.begin()
+	renderers_draw(mut window)
+	renderers_draw_overlay(mut window)
+	window.ui.end()
+	sapp.set_mouse_cursor(window.view_state.mouse_cursor)
+}
+
+// present_back_layout swaps the finished back layout in and builds its
+// renderers. Caller holds the gate.
+fn (mut window Window) present_back_layout() {
+	mut pipeline := window.pipeline
+	window.lock()
+	window.refresh_inspector_cache()
+	layout_clear(mut window.layout)
+	window.layout = pipeline.back
+	pipeline.back = Layout{}
+	pipeline.ready = false
+	window.reclaim_old_layout_callbacks()
+	window.reset_hover_signature()
+	window.build_renderers(window.color_background(), window.window_rect())
+	window.unlock()
+	window.sync_a11y()
+	window.stats.update_max_renderers(usize(window.renderers.len))
+}
+
+// pipelined_event runs an event now if no build holds the gate, else
+// defers it to the next frame. Deferred events run first to keep order.
+fn (mut window Window) pipelined_event(ev &gg.Event) {
+	mut pipeline := window.pipeline
+	if !pipeline.gate.try_lock() {
+		pipeline.deferred_events << *ev
+		return
+	}
+	window.replay_deferred_events()
+	event_dispatch(ev, mut window)
+	pipeline.gate.unlock()
+}
+
+// replay_deferred_events dispatches events held back during a build.
+// Caller holds the gate.
+fn (mut window Window) replay_deferred_events() {
+	mut pipeline := window.pipeline
+	if pipeline.deferred_events.len == 0 {
+		return
+	}
+	events := pipeline.deferred_events.clone()
+	pipeline.deferred_events.clear()
+	for ev in events {
+		event_dispatch(&ev, mut window)
+	}
+}
+
+// close_layout_pipeline stops the layout thread and waits for a build
+// in progress to finish.
+fn (mut window Window) close_layout_pipeline() {
+	if window.pipeline == unsafe { nil } {
+		return
+	}
+	mut pipeline := window.pipeline
+	pipeline.wake.close()
+	pipeline.gate.lock()
+	layout_clear(mut pipeline.back)
+	pipeline.gate.unlock()
+}
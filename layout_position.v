@@ -56,8 +56,13 @@ fn layout_positions(mut layout Layout, offset_x f32, offset_y f32, mut w Window)
 	if layout.shape.id_scroll > 0 {
 		mut sx := state_map[u32, f32](mut w, ns_scroll_x, cap_scroll)
 		mut sy := state_map[u32, f32](mut w, ns_scroll_y, cap_scroll)
-		x += sx.get(layout.shape.id_scroll) or { f32(0) }
-		y += sy.get(layout.shape.id_scroll) or { f32(0) }
+		offset := ScrollOffset{
+			x: sx.get(layout.shape.id_scroll) or { f32(0) }
+			y: sy.get(layout.shape.id_scroll) or { f32(0) }
+		}
+		x += offset.x
+		y += offset.y
+		w.scroll_applied[layout.shape.id_scroll] = offset
 	}
 
 	// Resolve start/end based on text direction
@@ -0,0 +1,211 @@
+module gui
+
+// layout_scroll.v is the scroll fast path. Scrolling a container only
+// moves its content, so scroll handlers declare EventRefresh.scroll and
+// the presented layout is translated in place instead of regenerating
+// the view: the container's children shift by the change in offset,
+// its scrollbars are re-amended, child clips are recomputed, and
+// renderers are rebuilt. The full layout still runs when the scroll
+// changes what was generated:
+// - a virtualized view's visible range would change (see ScrollDep)
+// - a view read the offset while generating (e.g. data grid headers)
+// - a floating layer is attached inside the container
+// - a layout or hero transition is running, or layout is pipelined
+// Hover styling under the pointer catches up on the next mouse move.
+
+// ScrollOffset is a container's scroll offset, as stored in
+// ns_scroll_x/ns_scroll_y.
+struct ScrollOffset {
+	x f32
+	y f32
+}
+
+// ScrollDepKind names how a generated view depends on a scroll offset.
+enum ScrollDepKind as u8 {
+	offset_x  // any horizontal change
+	offset_y  // any vertical change
+	list_core // list_core_visible_range
+	data_grid // data_grid_visible_range_for_scroll
+	tree      // tree_visible_range_for_scroll
+	table     // table_visible_range_for_scroll
+}
+
+// ScrollDep records that view generation used a scroll offset. Range
+// kinds keep the inputs of their visible-range function so the fast
+// path can tell whether a new offset would produce the same rows.
+struct ScrollDep {
+	id_scroll  u32
+	kind       ScrollDepKind
+	offset     f32 // offset_x/offset_y kinds
+	first      int
+	last       int
+	row_count  int
+	row_height f32
+	viewport   f32
+	static_top f32
+	buffer     int
+}
+
+// holds reports whether the generated view is still valid at offset.
+fn (dep ScrollDep) holds(offset ScrollOffset) bool {
+	match dep.kind {
+		.offset_x {
+			return offset.x == dep.offset
+		}
+		.offset_y {
+			return offset.y == dep.offset
+		}
+		.list_core {
+			first, last := list_core_visible_range(dep.row_count, dep.row_height, dep.viewport,
+				offset.y)
+			return first == dep.first && last == dep.last
+		}
+		.data_grid {
+			first, last := data_grid_visible_range_for_scroll(-offset.y, dep.viewport,
+				dep.row_height, dep.row_count, dep.static_top, dep.buffer)
+			return first == dep.first && last == dep.last
+		}
+		.tree {
+			first, last := tree_visible_range_for_scroll(dep.viewport, dep.row_height,
+				dep.row_count, -offset.y)
+			return first == dep.first && last == dep.last
+		}
+		.table {
+			first, last := table_visible_range_for_scroll(dep.viewport, dep.row_height,
+				dep.row_count, -offset.y)
+			return first == dep.first && last == dep.last
+		}
+	}
+}
+
+// scroll_dep records a scroll dependency of the view being generated.
+fn (mut window Window) scroll_dep(dep ScrollDep) {
+	if dep.id_scroll > 0 {
+		window.scroll_deps << dep
+	}
+}
+
+// scroll_fast_path_reset forgets the previous layout's offsets and
+// dependencies. Called before view generation.
+fn (mut window Window) scroll_fast_path_reset() {
+	array_clear(mut window.scroll_deps)
+	window.scroll_applied.clear()
+}
+
+// scroll_offset reads a container's current offset from state.
+fn (window &Window) scroll_offset(id_scroll u32) ScrollOffset {
+	return ScrollOffset{
+		x: state_read_or[u32, f32](window, ns_scroll_x, id_scroll, f32(0))
+		y: state_read_or[u32, f32](window, ns_scroll_y, id_scroll, f32(0))
+	}
+}
+
+// request_scroll_refresh translates the presented layout to the
+// current scroll offsets, or falls back to a full layout.
+fn (mut window Window) request_scroll_refresh() {
+	if window.refresh_layout || !window.scroll_fast_path() {
+		window.update_window()
+		return
+	}
+	window.request_render_only()
+}
+
+// scroll_fast_path translates every scrolled container of the
+// presented layout. Returns false, leaving the layout untouched, when
+// layout must rerun instead.
+fn (mut window Window) scroll_fast_path() bool {
+	if window.pipeline != unsafe { nil } || window.layout.children.len == 0 {
+		return false
+	}
+	if _ := window.get_layout_transition() {
+		return false
+	}
+	if _ := window.get_hero_transition() {
+		return false
+	}
+	window.lock()
+	defer {
+		window.unlock()
+	}
+	if !window.scroll_fast_path_check(&window.layout) {
+		return false
+	}
+	window.scroll_fast_path_apply(mut window.layout)
+	return true
+}
+
+fn (window &Window) scroll_fast_path_check(layout &Layout) bool {
+	id_scroll := layout.shape.id_scroll
+	if id_scroll > 0 {
+		applied := window.scroll_applied[id_scroll] or { return false }
+		offset := window.scroll_offset(id_scroll)
+		if offset != applied {
+			for dep in window.scroll_deps {
+				if dep.id_scroll == id_scroll && !dep.holds(offset) {
+					return false
+				}
+			}
+			// Floating layers are positioned from their parent.
+			for i in 1 .. window.layout.children.len {
+				if layout_contains_node(layout, window.layout.children[i].parent) {
+					return false
+				}
+			}
+		}
+	}
+	for i in 0 .. layout.children.len {
+		if !window.scroll_fast_path_check(&layout.children[i]) {
+			return false
+		}
+	}
+	return true
+}
+
+fn (mut window Window) scroll_fast_path_apply(mut layout Layout) {
+	id_scroll := layout.shape.id_scroll
+	if id_scroll > 0 {
+		offset := window.scroll_offset(id_scroll)
+		applied := window.scroll_applied[id_scroll] or { offset }
+		dx := offset.x - applied.x
+		dy := offset.y - applied.y
+		if dx != 0 || dy != 0 {
+			window.scroll_applied[id_scroll] = offset
+			for mut child in layout.children {
+				if child.shape.scrollbar_orientation == .none {
+					input_shift_layout_tree(mut child, dx, dy)
+				} else {
+					layout_amend(mut child, mut window)
+				}
+				layout_set_shape_clips(mut child, layout.shape.shape_clip)
+			}
+		}
+	}
+	for mut child in layout.children {
+		window.scroll_fast_path_apply(mut child)
+	}
+}
+
+// layout_contains_node reports whether node is layout or one of its
+// descendants. Compares addresses only; node is never dereferenced.
+fn layout_contains_node(layout &Layout, node &Layout) bool {
+	if voidptr(layout) == voidptr(node) {
+		return true
+	}
+	for i in 0 .. layout.children.len {
+		if layout_contains_node(&layout.children[i], node) {
+			return true
+		}
+	}
+	return false
+}
+
+// declare_scroll_refresh is called by scroll handlers after setting a
+// container's offset. A container's on_scroll hook may change more
+// than the offset, so it keeps the full layout.
+fn (mut w Window) declare_scroll_refresh(layout &Layout) {
+	if layout.shape.has_events() && layout.shape.events.on_scroll != unsafe { nil } {
+		w.set_event_refresh(.layout)
+		return
+	}
+	w.set_event_refresh(.scroll)
+}
@@ -1,7 +1,6 @@
 module gui
 
 import net.http
-import os
 import stbi
 
 // math_cache_hash computes a cache key for a math expression ID.
@@ -9,14 +8,16 @@ fn math_cache_hash(math_id string) i64 {
 	return i64((u64(math_id.hash()) << 32) | u64(math_id.len))
 }
 
-// fetch_math_async fetches a LaTeX math image from codecogs in
-// a background thread. Uses PNG format. Updates diagram_cache
-// with result and triggers window refresh.
+// fetch_math_async fetches a LaTeX math image from a codecogs
+// compatible endpoint through start_diagram_fetch. Uses PNG format. The
+// disk cache is checked first. Updates diagram_cache with result and
+// triggers window refresh.
 //
-// PRIVACY NOTE: LaTeX source is sent to external third-party
-// API (latex.codecogs.com) for rendering. This may leak
-// document content to the service provider.
-// Use MarkdownCfg.disable_external_apis to disable this.
+// PRIVACY NOTE: With the default endpoint, LaTeX source is sent to
+// external third-party API (latex.codecogs.com) for rendering. This
+// may leak document content to the service provider. Point
+// MarkdownCfg.math_endpoint at a local renderer, or use
+// MarkdownCfg.disable_external_apis to disable this.
 //
 // sanitize_latex strips dangerous TeX commands that could
 // enable shell escape or file access on the remote renderer.
@@ -144,157 +145,49 @@ fn fetch_math_http(url string) !http.Response {
 	return req.do()!
 }
 
-fn fetch_math_async(mut window Window, latex string, hash i64, request_id u64, dpi int, fg_color Color) {
-	window.suspend_layout_callback_tracking(fn [mut window, latex, hash, request_id, dpi, fg_color] () {
-		spawn fn [mut window, latex, hash, request_id, dpi, fg_color] () {
-			if latex.len > max_latex_source_len {
-				window.queue_command(fn [hash, request_id] (mut w Window) {
-					if !diagram_cache_should_apply_result(&w.view_state.diagram_cache, hash,
-						request_id) {
-						return
-					}
-					w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
-						state:      .error
-						error:      'LaTeX source too large'
-						request_id: request_id
-					})
-					w.update_window()
-				})
-				return
-			}
-			safe_latex := sanitize_latex(latex)
+fn fetch_math_async(mut window Window, latex string, hash i64, request_id u64, dpi int, fg_color Color, endpoint string) {
+	disk := window.diagram_disk
+	window.suspend_layout_callback_tracking(fn [mut window, latex, hash, request_id, dpi, fg_color, endpoint, disk] () {
+		if latex.len > max_latex_source_len {
+			queue_diagram_error(mut window, hash, request_id, 'LaTeX source too large')
+			return
+		}
+		safe_latex := sanitize_latex(latex)
 
-			// Build codecogs URL with DPI and optional color prefix.
-			// Use named color to avoid bracket syntax that breaks
-			// when percent-encoded.
-			dpi_str := '${dpi}'
-			lum := 0.299 * f64(fg_color.r) + 0.587 * f64(fg_color.g) + 0.114 * f64(fg_color.b)
-			color_cmd := if lum > 128.0 { '\\color{white}' } else { '' }
-			prefix := '\\dpi{${dpi_str}}${color_cmd}'
-			// Replace spaces with {} (empty group) — acts as
-			// command terminator without visible output. V's
-			// http library re-encodes %20 as + which codecogs
-			// renders as literal plus signs.
-			encoded := (prefix + safe_latex).replace(' ', '{}').replace('#', '%23').replace('&',
-				'%26')
-			url := 'https://latex.codecogs.com/png.image?${encoded}'
-			result := fetch_math_http(url) or {
-				err_msg := err.msg()
-				window.queue_command(fn [hash, request_id, err_msg] (mut w Window) {
-					if !diagram_cache_should_apply_result(&w.view_state.diagram_cache, hash,
-						request_id) {
-						return
-					}
-					w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
-						state:      .error
-						error:      err_msg
-						request_id: request_id
-					})
-					w.update_window()
-				})
-				return
+		// Build codecogs URL with DPI and optional color prefix.
+		// Use named color to avoid bracket syntax that breaks
+		// when percent-encoded.
+		dpi_str := '${dpi}'
+		lum := 0.299 * f64(fg_color.r) + 0.587 * f64(fg_color.g) + 0.114 * f64(fg_color.b)
+		color_cmd := if lum > 128.0 { '\\color{white}' } else { '' }
+		prefix := '\\dpi{${dpi_str}}${color_cmd}'
+		// Replace spaces with {} (empty group) — acts as
+		// command terminator without visible output. V's
+		// http library re-encodes %20 as + which codecogs
+		// renders as literal plus signs.
+		encoded := (prefix + safe_latex).replace(' ', '{}').replace('#', '%23').replace('&', '%26')
+		url := '${endpoint}?${encoded}'
+		start_diagram_fetch(mut window, DiagramFetch{
+			disk:       disk
+			key:        diagram_disk_key(['math', url])
+			hash:       hash
+			request_id: request_id
+			fetch:      fn [url] () !http.Response {
+				return fetch_math_http(url)
 			}
-			if result.status_code == 200 {
-				// Reject oversized responses (>10MB)
-				if result.body.len > 10 * 1024 * 1024 {
-					body_len := result.body.len
-					window.queue_command(fn [hash, request_id, body_len] (mut w Window) {
-						if !diagram_cache_should_apply_result(&w.view_state.diagram_cache, hash,
-							request_id) {
-							return
-						}
-						w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
-							state:      .error
-							error:      'Response too large (>${body_len / 1024 / 1024}MB)'
-							request_id: request_id
-						})
-						w.update_window()
-					})
-					return
-				}
-				png_bytes := result.body.bytes()
-				img := stbi.load_from_memory(png_bytes.data, png_bytes.len) or {
-					err_msg := err.msg()
-					window.queue_command(fn [hash, request_id, err_msg] (mut w Window) {
-						if !diagram_cache_should_apply_result(&w.view_state.diagram_cache, hash,
-							request_id) {
-							return
-						}
-						w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
-							state:      .error
-							error:      'Failed to decode PNG: ${err_msg}'
-							request_id: request_id
-						})
-						w.update_window()
-					})
-					return
-				}
-
+			finish:     fn [hash, request_id, dpi] (img stbi.Image, mut window Window) {
 				// No transparent fill — keep PNG alpha for blending
-				// with any background color
-
-				tmp_path := write_stbi_temp('math', hash, img) or {
-					img.free()
-					err_msg := err.msg()
-					window.queue_command(fn [hash, request_id, err_msg] (mut w Window) {
-						if !diagram_cache_should_apply_result(&w.view_state.diagram_cache, hash,
-							request_id) {
-							return
-						}
-						w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
-							state:      .error
-							error:      'Failed to write temp file: ${err_msg}'
-							request_id: request_id
-						})
-						w.update_window()
-					})
-					return
-				}
-				img_w := f32(img.width)
-				img_h := f32(img.height)
+				// with any background color.
+				// No markdown_cache clear needed on apply: parsed blocks
+				// don't change; RTF reads math dims from diagram_cache
+				// at render time, and update_window triggers a view
+				// rebuild picking up new dimensions via
+				// to_vglyph_rich_text_with_math.
 				img_dpi := f32(dpi)
-				img.free()
-				window.queue_command(fn [hash, request_id, tmp_path, img_w, img_h, img_dpi] (mut w Window) {
-					if !diagram_cache_should_apply_result(&w.view_state.diagram_cache, hash,
-						request_id) {
-						os.rm(tmp_path) or {}
-						return
-					}
-					w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
-						state:      .ready
-						png_path:   tmp_path
-						width:      img_w
-						height:     img_h
-						dpi:        img_dpi
-						request_id: request_id
-					})
-					// No markdown_cache clear needed: parsed blocks
-					// don't change; RTF reads math dims from
-					// diagram_cache at render time. update_window
-					// triggers view rebuild picking up new
-					// dimensions via to_vglyph_rich_text_with_math.
-					w.update_window()
-				})
-			} else {
-				body_preview := if result.body.len > 200 {
-					result.body[..200] + '...'
-				} else {
-					result.body
-				}
-				status_code := result.status_code
-				window.queue_command(fn [hash, request_id, status_code, body_preview] (mut w Window) {
-					if !diagram_cache_should_apply_result(&w.view_state.diagram_cache, hash,
-						request_id) {
-						return
-					}
-					w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
-						state:      .error
-						error:      'HTTP ${status_code}: ${body_preview}'
-						request_id: request_id
-					})
-					w.update_window()
+				window.queue_command(fn [hash, request_id, img, img_dpi] (mut w Window) {
+					apply_diagram_image(mut w, 'math', hash, request_id, img, img_dpi)
 				})
 			}
-		}()
+		})
 	}) or { panic(err) }
 }
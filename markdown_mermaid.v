@@ -1,8 +1,6 @@
 module gui
 
 import net.http
-import os
-import rand
 import stbi
 import time
 
@@ -19,7 +17,7 @@ enum DiagramState {
 // DiagramCacheEntry stores cached diagram data with its state.
 struct DiagramCacheEntry {
 	state      DiagramState
-	png_path   string // temp file path for PNG
+	image_key  string // in-memory image key (see register_image_pixels)
 	error      string
 	width      f32
 	height     f32
@@ -27,14 +25,55 @@ struct DiagramCacheEntry {
 	request_id u64
 }
 
-// write_stbi_temp writes an stbi image to a temp PNG file.
-// Returns the file path or an error string.
-fn write_stbi_temp(prefix string, hash i64, img stbi.Image) !string {
-	rand_suffix := rand.intn(1000000) or { 0 }
-	tmp_path := os.join_path(os.temp_dir(), '${prefix}_${hash}_${rand_suffix}.png')
-	stbi.stbi_write_png(tmp_path, img.width, img.height, img.nr_channels, img.data,
-		img.width * img.nr_channels)!
-	return tmp_path
+// diagram_image_name names the in-memory image for one diagram result.
+// request_id keeps a refetched diagram from colliding with a texture
+// that is still cached under the previous result.
+fn diagram_image_name(kind string, hash i64, request_id u64) string {
+	return '${kind}/${hash}/${request_id}'
+}
+
+// apply_diagram_image registers decoded diagram pixels as a cached
+// image and marks the cache entry ready. Runs on the main thread; frees
+// img in every case.
+fn apply_diagram_image(mut w Window, kind string, hash i64, request_id u64, img stbi.Image, dpi f32) {
+	defer {
+		img.free()
+	}
+	if !diagram_cache_should_apply_result(&w.view_state.diagram_cache, hash, request_id) {
+		return
+	}
+	key := w.register_image_pixels(diagram_image_name(kind, hash, request_id), img.width,
+		img.height, img.data) or {
+		w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
+			state:      .error
+			error:      'Failed to create texture: ${err.msg()}'
+			request_id: request_id
+		})
+		w.update_window()
+		return
+	}
+	w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
+		state:      .ready
+		image_key:  key
+		width:      f32(img.width)
+		height:     f32(img.height)
+		dpi:        dpi
+		request_id: request_id
+	})
+	w.release_diagram_images()
+	w.update_window()
+}
+
+// release_diagram_images drops in-memory images of diagram entries
+// that were replaced or evicted from the diagram cache. Runs from a
+// command, while the presented renderers may still draw the old
+// image, so the textures go through the deferred release list and are
+// destroyed by the next renderer build.
+fn (mut window Window) release_diagram_images() {
+	for key in window.view_state.diagram_cache.released {
+		window.remove_memory_image(key)
+	}
+	array_clear(mut window.view_state.diagram_cache.released)
 }
 
 // fill_transparent_with_bg replaces transparent pixels with the
@@ -66,7 +105,7 @@ fn diagram_cache_should_apply_result(cache &BoundedDiagramCache, hash i64, reque
 	return entry.state == .loading && entry.request_id == request_id
 }
 
-fn mermaid_http_fetch(source string) !http.Response {
+fn mermaid_http_fetch(endpoint string, source string) !http.Response {
 	// Kroki POST /mermaid/png: JSON body with
 	// 'diagram_source'. Escape per RFC 8259.
 	mut escaped := source.replace('\\', '\\\\')
@@ -87,7 +126,7 @@ fn mermaid_http_fetch(source string) !http.Response {
 	json_data := '{"diagram_source": "${buf.bytestr()}"}'
 	mut req := http.prepare(
 		method: .post
-		url:    'https://kroki.io/mermaid/png'
+		url:    endpoint
 		data:   json_data
 		header: http.new_custom_header_from_map({
 			'Content-Type': 'application/json'
@@ -98,186 +137,70 @@ fn mermaid_http_fetch(source string) !http.Response {
 	return req.do()!
 }
 
-// fetch_mermaid_async fetches a mermaid diagram from Kroki API in background thread.
-// Uses PNG format since SVG from Kroki uses foreignObject/CSS which our parser doesn't support.
-// Updates diagram_cache with result and triggers window refresh.
+// fetch_mermaid_async fetches a mermaid diagram from a Kroki endpoint
+// through start_diagram_fetch. Uses PNG format since SVG from Kroki uses
+// foreignObject/CSS which our parser doesn't support. The disk cache is
+// checked first. Updates diagram_cache with result and triggers window
+// refresh.
 //
-// PRIVACY NOTE: Mermaid source is sent to external third-party
-// API (kroki.io) for rendering. This may leak document content
-// to the service provider.
-// Use MarkdownCfg.disable_external_apis to disable this.
-fn fetch_mermaid_async(mut window Window, source string, hash i64, request_id u64, max_width int, bg_r u8, bg_g u8, bg_b u8) {
-	window.suspend_layout_callback_tracking(fn [mut window, source, hash, request_id, max_width, bg_r, bg_g, bg_b] () {
-		spawn fn [mut window, source, hash, request_id, max_width, bg_r, bg_g, bg_b] () {
-			if source.len > max_mermaid_source_len {
-				window.queue_command(fn [hash, request_id] (mut w Window) {
-					if !diagram_cache_should_apply_result(&w.view_state.diagram_cache, hash,
-						request_id) {
-						return
-					}
-					w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
-						state:      .error
-						error:      'Mermaid source too large'
-						request_id: request_id
-					})
-					w.update_window()
-				})
-				return
-			}
-
-			result := mermaid_http_fetch(source) or {
-				err_msg := err.msg()
-				window.queue_command(fn [hash, request_id, err_msg] (mut w Window) {
-					if !diagram_cache_should_apply_result(&w.view_state.diagram_cache, hash,
-						request_id) {
-						return
-					}
-					w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
-						state:      .error
-						error:      err_msg
-						request_id: request_id
-					})
-					w.update_window()
-				})
-				return
+// PRIVACY NOTE: With the default endpoint, mermaid source is sent to
+// an external third-party API (kroki.io) for rendering. This may leak
+// document content to the service provider. Point
+// MarkdownCfg.mermaid_endpoint at a self-hosted Kroki instance, or use
+// MarkdownCfg.disable_external_apis to disable this.
+fn fetch_mermaid_async(mut window Window, source string, hash i64, request_id u64, max_width int, bg_r u8, bg_g u8, bg_b u8, endpoint string) {
+	disk := window.diagram_disk
+	window.suspend_layout_callback_tracking(fn [mut window, source, hash, request_id, max_width, bg_r, bg_g, bg_b, endpoint, disk] () {
+		if source.len > max_mermaid_source_len {
+			queue_diagram_error(mut window, hash, request_id, 'Mermaid source too large')
+			return
+		}
+		key := diagram_disk_key(['mermaid', endpoint, source, '${max_width}',
+			'${bg_r},${bg_g},${bg_b}'])
+		start_diagram_fetch(mut window, DiagramFetch{
+			disk:       disk
+			key:        key
+			hash:       hash
+			request_id: request_id
+			fetch:      fn [endpoint, source] () !http.Response {
+				return mermaid_http_fetch(endpoint, source)
 			}
-			if result.status_code == 200 {
-				// Reject oversized responses (>10MB)
-				if result.body.len > 10 * 1024 * 1024 {
-					body_len := result.body.len
-					window.queue_command(fn [hash, request_id, body_len] (mut w Window) {
-						if !diagram_cache_should_apply_result(&w.view_state.diagram_cache, hash,
-							request_id) {
-							return
-						}
-						w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
-							state:      .error
-							error:      'Response too large (>${body_len / 1024 / 1024}MB)'
-							request_id: request_id
-						})
-						w.update_window()
-					})
-					return
-				}
-				// Load PNG from memory and resize if needed
-				png_bytes := result.body.bytes()
-				img := stbi.load_from_memory(png_bytes.data, png_bytes.len) or {
-					err_msg := err.msg()
-					window.queue_command(fn [hash, request_id, err_msg] (mut w Window) {
-						if !diagram_cache_should_apply_result(&w.view_state.diagram_cache, hash,
-							request_id) {
-							return
-						}
-						w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
-							state:      .error
-							error:      'Failed to decode PNG: ${err_msg}'
-							request_id: request_id
-						})
-						w.update_window()
-					})
-					return
-				}
-
+			finish:     fn [hash, request_id, max_width, bg_r, bg_g, bg_b] (img stbi.Image, mut window Window) {
 				// Scale down if wider than max_width
 				mut final_img := img
-				resized := img.width > max_width
-				if resized {
+				if img.width > max_width {
 					scale := f64(max_width) / f64(img.width)
 					new_h := int(f64(img.height) * scale)
 					final_img = stbi.resize_uint8(&img, max_width, new_h) or {
 						img.free()
-						err_msg := err.msg()
-						window.queue_command(fn [hash, request_id, err_msg] (mut w Window) {
-							if !diagram_cache_should_apply_result(&w.view_state.diagram_cache,
-								hash, request_id) {
-								return
-							}
-							w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
-								state:      .error
-								error:      'Failed to resize: ${err_msg}'
-								request_id: request_id
-							})
-							w.update_window()
-						})
+						queue_diagram_error(mut window, hash, request_id, 'Failed to resize: ${err.msg()}')
 						return
 					}
+					img.free()
 				}
 
 				// Fill transparent pixels with background color
 				fill_transparent_with_bg(final_img.data, final_img.width, final_img.height,
 					final_img.nr_channels, bg_r, bg_g, bg_b)
 
-				tmp_path := write_stbi_temp('mermaid', hash, final_img) or {
-					img.free()
-					if resized {
-						final_img.free()
-					}
-					err_msg := err.msg()
-					window.queue_command(fn [hash, request_id, err_msg] (mut w Window) {
-						if !diagram_cache_should_apply_result(&w.view_state.diagram_cache, hash,
-							request_id) {
-							return
-						}
-						w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
-							state:      .error
-							error:      'Failed to write temp file: ${err_msg}'
-							request_id: request_id
-						})
-						w.update_window()
-					})
-					return
-				}
-				// Free stbi memory after writing PNG
-				img.free()
-				if resized {
-					final_img.free()
-				}
-				final_w := f32(final_img.width)
-				final_h := f32(final_img.height)
-				window.queue_command(fn [hash, request_id, tmp_path, final_w, final_h] (mut w Window) {
-					if !diagram_cache_should_apply_result(&w.view_state.diagram_cache, hash,
-						request_id) {
-						os.rm(tmp_path) or {}
-						return
-					}
-					w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
-						state:      .ready
-						png_path:   tmp_path
-						width:      final_w
-						height:     final_h
-						request_id: request_id
-					})
-					w.update_window()
-				})
-			} else {
-				body_preview := if result.body.len > 200 {
-					result.body[..200] + '...'
-				} else {
-					result.body
-				}
-				status_code := result.status_code
-				window.queue_command(fn [hash, request_id, status_code, body_preview] (mut w Window) {
-					if !diagram_cache_should_apply_result(&w.view_state.diagram_cache, hash,
-						request_id) {
-						return
-					}
-					w.view_state.diagram_cache.set(hash, DiagramCacheEntry{
-						state:      .error
-						error:      'HTTP ${status_code}: ${body_preview}'
-						request_id: request_id
-					})
-					w.update_window()
+				// Pixels go straight to a texture on the main thread;
+				// apply_diagram_image frees them.
+				window.queue_command(fn [hash, request_id, final_img] (mut w Window) {
+					apply_diagram_image(mut w, 'mermaid', hash, request_id, final_img, 0)
 				})
 			}
-		}()
+		})
 	}) or { panic(err) }
 }
 
-// BoundedDiagramCache is a FIFO cache for diagram entries.
+// BoundedDiagramCache is a FIFO cache for diagram entries. Image keys
+// of replaced or evicted entries collect in `released` until the window
+// frees them (see release_diagram_images).
 struct BoundedDiagramCache {
 mut:
 	data     map[i64]DiagramCacheEntry
 	order    []i64
+	released []string
 	max_size int = 50
 }
 
@@ -292,17 +215,16 @@ fn (mut m BoundedDiagramCache) set(key i64, value DiagramCacheEntry) {
 		return
 	}
 	if existing := m.data[key] {
-		if existing.png_path.len > 0 && existing.png_path != value.png_path {
-			os.rm(existing.png_path) or {}
+		if existing.image_key.len > 0 && existing.image_key != value.image_key {
+			m.released << existing.image_key
 		}
 	}
 	if key !in m.data {
 		if m.data.len >= m.max_size && m.order.len > 0 {
 			oldest := m.order[0]
-			// Clean up temp file before evicting
 			if oldest_entry := m.data[oldest] {
-				if oldest_entry.png_path.len > 0 {
-					os.rm(oldest_entry.png_path) or {}
+				if oldest_entry.image_key.len > 0 {
+					m.released << oldest_entry.image_key
 				}
 			}
 			m.data.delete(oldest)
@@ -313,6 +235,18 @@ fn (mut m BoundedDiagramCache) set(key i64, value DiagramCacheEntry) {
 	m.data[key] = value
 }
 
+// delete removes an entry without releasing its image.
+fn (mut m BoundedDiagramCache) delete(key i64) {
+	if key !in m.data {
+		return
+	}
+	m.data.delete(key)
+	idx := m.order.index(key)
+	if idx >= 0 {
+		m.order.delete(idx)
+	}
+}
+
 // loading_count returns number of entries in loading state.
 fn (m &BoundedDiagramCache) loading_count() int {
 	mut n := 0
@@ -329,11 +263,11 @@ fn (m &BoundedDiagramCache) len() int {
 	return m.data.len
 }
 
-// clear removes all entries and deletes temp files.
+// clear removes all entries and releases their images.
 fn (mut m BoundedDiagramCache) clear() {
 	for _, entry in m.data {
-		if entry.png_path.len > 0 {
-			os.rm(entry.png_path) or {}
+		if entry.image_key.len > 0 {
+			m.released << entry.image_key
 		}
 	}
 	m.data.clear()
@@ -3,17 +3,20 @@ module gui
 import nativebridge
 
 fn native_notification_impl(mut w Window, cfg NativeNotificationCfg) {
-	// Spawn background thread — send_notification blocks
+	// Run on the worker pool — send_notification blocks
 	// (semaphores, Sleep, D-Bus) and must not stall the
 	// render thread.
-	spawn fn [cfg] (mut w Window) {
-		bridge_result := nativebridge.send_notification(nativebridge.BridgeNotificationCfg{
-			title: cfg.title
-			body:  cfg.body
-		})
-		result := native_notification_result_from_bridge(bridge_result)
-		native_dispatch_notification_done(mut w, cfg.on_done, result)
-	}(mut w)
+	w.submit_work(WorkItem{
+		priority: .background
+		run:      fn [cfg] (mut w Window) {
+			bridge_result := nativebridge.send_notification(nativebridge.BridgeNotificationCfg{
+				title: cfg.title
+				body:  cfg.body
+			})
+			result := native_notification_result_from_bridge(bridge_result)
+			native_dispatch_notification_done(mut w, cfg.on_done, result)
+		}
+	})
 }
 
 fn native_notification_result_from_bridge(br nativebridge.BridgeNotificationResult) NativeNotificationResult {
@@ -265,6 +265,7 @@ fn pdf_render_document_raster(mut window Window, source_width f32, source_height
 	// reference).
 	saved_size := window.window_size
 	saved_renderers := window.renderers
+	saved_anchors := window.overlay_anchors
 	print_height := int(math.ceil(source_height))
 	mut print_view := View(ContainerView{})
 	mut print_layout := Layout{}
@@ -278,12 +279,14 @@ fn pdf_render_document_raster(mut window Window, source_width f32, source_height
 		clip_rect := window.window_rect()
 		bg := window.color_background()
 		window.renderers = []Renderer{}
+		window.overlay_anchors = []OverlayAnchor{}
 		render_layout(mut print_layout, bg, clip_rect, mut window)
 	}
 	defer {
 		if window.window_size.height != saved_size.height {
 			unsafe { window.renderers.free() }
 			window.renderers = saved_renderers
+			window.overlay_anchors = saved_anchors
 			window.window_size = saved_size
 			layout_clear(mut print_layout)
 			view_clear(mut print_view)
@@ -105,7 +105,11 @@ fn draw_quad_uv(x f32, y f32, w f32, h f32, z f32, u0 f32, v0 f32, u1 f32, v1 f3
 fn renderers_draw(mut window Window) {
 	renderers := window.renderers
 	window.frame_triangle_vertices = 0 // reset the sokol-gl triangle budget for this draw pass
+	if window.view_state.image_atlas.upload(mut window.ui) {
+		window.ui.refresh_ui() // a page changed twice this frame; draw again with fresh pixels
+	}
 	mut active_clip := window.window_rect()
+	window.draw_clip = active_clip
 
 	mut i := 0
 	for i < renderers.len {
@@ -137,6 +141,25 @@ fn renderers_draw(mut window Window) {
 				break
 			}
 			draw_rounded_image_batch(renderers, start, i, active_clip, mut window)
+		} else if renderer is DrawImage && renderer.atlas {
+			// Batch consecutive atlas images that share a page texture.
+			page_id := renderer.img.id
+			start := i
+			i++
+			for i < renderers.len {
+				candidate := renderers[i]
+				if !guard_renderer_or_skip(candidate, mut window) {
+					i++
+					continue
+				}
+				if candidate is DrawImage && candidate.atlas && candidate.clip_radius <= 0
+					&& candidate.img.id == page_id {
+					i++
+					continue
+				}
+				break
+			}
+			draw_atlas_image_batch(renderers, start, i, mut window)
 		} else if renderer is DrawSvg {
 			// Batch consecutive DrawSvg with same color, position, scale
 			// Handle stencil clip groups
@@ -181,7 +204,9 @@ fn renderers_draw(mut window Window) {
 			i++
 		}
 	}
+	window.text_mutex.lock()
 	window.text_system.commit()
+	window.text_mutex.unlock()
 }
 
 // draw_svg_batch draws consecutive flat-color DrawSvg renderers in one SGL batch.
@@ -239,7 +264,11 @@ fn draw_rounded_image_batch(renderers []Renderer, start int, end int, active_cli
 				continue
 			}
 			if renderer is DrawImage {
-				ctx.draw_image(renderer.x, renderer.y, renderer.w, renderer.h, renderer.img)
+				if renderer.atlas {
+					draw_atlas_image_batch(renderers, idx, idx + 1, mut window)
+				} else {
+					ctx.draw_image(renderer.x, renderer.y, renderer.w, renderer.h, renderer.img)
+				}
 			}
 		}
 		return
@@ -247,6 +276,8 @@ fn draw_rounded_image_batch(renderers []Renderer, start int, end int, active_cli
 
 	scale := ctx.scale
 	effective_clip := quantized_scissor_clip(active_clip, scale)
+	has_atlas_pipeline := init_image_clip_atlas_pipeline(mut window)
+	mut atlas_active := false
 	sgl.load_pipeline(window.pip.image_clip)
 	sgl.enable_texture()
 	sgl.c4b(255, 255, 255, 255)
@@ -260,14 +291,114 @@ fn draw_rounded_image_batch(renderers []Renderer, start int, end int, active_cli
 			x0, y0, w0, h0, r := rounded_image_scaled_params(clip.x, clip.y, clip.w, clip.h,
 				renderer.clip_radius, scale)
 			z := pack_shader_params(r, 0)
+			use_atlas := renderer.atlas && has_atlas_pipeline
+			if use_atlas != atlas_active {
+				pipeline := if use_atlas { window.pip.image_clip_atlas } else { window.pip.image_clip }
+				sgl.load_pipeline(pipeline)
+				atlas_active = use_atlas
+			}
 			sgl.texture(renderer.img.simg, renderer.img.ssmp)
-			draw_quad_uv(x0, y0, w0, h0, z, clip.u0, clip.v0, clip.u1, clip.v1)
+			if use_atlas {
+				draw_atlas_quad_sdf(x0, y0, w0, h0, z, clip, renderer)
+			} else if renderer.atlas {
+				// No atlas pipeline: draw the sub-image unrounded.
+				sgl.load_pipeline(window.ui.pipeline.alpha)
+				draw_quad_uv(x0, y0, w0, h0, 0, atlas_uv(renderer.u0, renderer.u1, clip.u0),
+					atlas_uv(renderer.v0, renderer.v1, clip.v0), atlas_uv(renderer.u0,
+					renderer.u1, clip.u1), atlas_uv(renderer.v0, renderer.v1, clip.v1))
+				sgl.load_pipeline(window.pip.image_clip)
+			} else {
+				draw_quad_uv(x0, y0, w0, h0, z, clip.u0, clip.v0, clip.u1, clip.v1)
+			}
 		}
 	}
 	sgl.disable_texture()
 	sgl.load_default_pipeline()
 }
 
+// atlas_uv maps an SDF coordinate (-1..1 across the image) to the
+// atlas texture coordinate between lo and hi.
+@[inline]
+fn atlas_uv(lo f32, hi f32, sdf f32) f32 {
+	return lo + (sdf + 1) * 0.5 * (hi - lo)
+}
+
+// atlas_sdf_channel encodes an SDF coordinate (-1..1) as a color
+// channel for fs_image_clip_atlas, which decodes it with rg * 2 - 1.
+@[inline]
+fn atlas_sdf_channel(sdf f32) u8 {
+	return u8(f32_clamp((sdf + 1) * 0.5, 0, 1) * 255 + 0.5)
+}
+
+// draw_atlas_quad_sdf emits one rounded atlas quad. Texture coordinates
+// address the atlas sub-rect; the SDF coordinate rides in color.rg.
+fn draw_atlas_quad_sdf(x f32, y f32, w f32, h f32, z f32, clip RoundedImageClip, img DrawImage) {
+	tu0 := atlas_uv(img.u0, img.u1, clip.u0)
+	tv0 := atlas_uv(img.v0, img.v1, clip.v0)
+	tu1 := atlas_uv(img.u0, img.u1, clip.u1)
+	tv1 := atlas_uv(img.v0, img.v1, clip.v1)
+	r0 := atlas_sdf_channel(clip.u0)
+	g0 := atlas_sdf_channel(clip.v0)
+	r1 := atlas_sdf_channel(clip.u1)
+	g1 := atlas_sdf_channel(clip.v1)
+	sgl.begin_quads()
+	sgl.c4b(r0, g0, 0, 255)
+	sgl.t2f(tu0, tv0)
+	sgl.v3f(x, y, z)
+	sgl.c4b(r1, g0, 0, 255)
+	sgl.t2f(tu1, tv0)
+	sgl.v3f(x + w, y, z)
+	sgl.c4b(r1, g1, 0, 255)
+	sgl.t2f(tu1, tv1)
+	sgl.v3f(x + w, y + h, z)
+	sgl.c4b(r0, g1, 0, 255)
+	sgl.t2f(tu0, tv1)
+	sgl.v3f(x, y + h, z)
+	sgl.end()
+}
+
+// draw_atlas_image_batch draws consecutive unrounded atlas images that
+// share one page texture as a single textured quad batch.
+fn draw_atlas_image_batch(renderers []Renderer, start int, end int, mut window Window) {
+	if start < 0 || end <= start || end > renderers.len {
+		return
+	}
+	first := renderers[start]
+	if first !is DrawImage {
+		return
+	}
+	page := first.img
+	scale := window.ui.scale
+	sgl.load_pipeline(window.ui.pipeline.alpha)
+	sgl.enable_texture()
+	sgl.texture(page.simg, page.ssmp)
+	sgl.begin_quads()
+	sgl.c4b(255, 255, 255, 255)
+	for idx in start .. end {
+		renderer := renderers[idx]
+		if !guard_renderer_or_skip(renderer, mut window) {
+			continue
+		}
+		if renderer is DrawImage {
+			x0 := renderer.x * scale
+			y0 := renderer.y * scale
+			x1 := (renderer.x + renderer.w) * scale
+			y1 := (renderer.y + renderer.h) * scale
+			sgl.t2f(renderer.u0, renderer.v0)
+			sgl.v3f(x0, y0, 0)
+			sgl.t2f(renderer.u1, renderer.v0)
+			sgl.v3f(x1, y0, 0)
+			sgl.t2f(renderer.u1, renderer.v1)
+			sgl.v3f(x1, y1, 0)
+			sgl.t2f(renderer.u0, renderer.v1)
+			sgl.v3f(x0, y1, 0)
+		}
+	}
+	sgl.end()
+	sgl.disable_texture()
+	sgl.load_default_pipeline()
+}
+
 // draw_clipped_svg_group renders a stencil-clipped SVG group.
 // Collects all DrawSvg renderers sharing the same clip_group,
 // draws mask geometry to stencil, then draws content with
@@ -435,6 +566,7 @@ fn renderer_draw(renderer Renderer, mut window Window) {
 				renderer.radius, renderer.thickness, renderer.color, mut window)
 		}
 		DrawText {
+			window.text_mutex.lock()
 			window.text_system.draw_text(renderer.x, renderer.y, renderer.text, renderer.cfg) or {
 				// Log error with context for debugging
 				log.error('Text render failed at (${renderer.x}, ${renderer.y}): ${err.msg()}')
@@ -442,16 +574,20 @@ fn renderer_draw(renderer Renderer, mut window Window) {
 				// Fallback: draw small magenta indicator
 				draw_error_placeholder(renderer.x, renderer.y, 10, 10, mut window)
 			}
+			window.text_mutex.unlock()
 		}
 		DrawLayout {
+			window.text_mutex.lock()
 			if renderer.gradient != unsafe { nil } {
 				window.text_system.draw_layout_with_gradient(renderer.layout, renderer.x,
 					renderer.y, renderer.gradient)
 			} else {
 				window.text_system.draw_layout(renderer.layout, renderer.x, renderer.y)
 			}
+			window.text_mutex.unlock()
 		}
 		DrawLayoutTransformed {
+			window.text_mutex.lock()
 			if renderer.gradient != unsafe { nil } {
 				window.text_system.draw_layout_transformed_with_gradient(renderer.layout,
 					renderer.x, renderer.y, renderer.transform, renderer.gradient)
@@ -459,13 +595,17 @@ fn renderer_draw(renderer Renderer, mut window Window) {
 				window.text_system.draw_layout_transformed(renderer.layout, renderer.x, renderer.y,
 					renderer.transform)
 			}
+			window.text_mutex.unlock()
 		}
 		DrawLayoutPlaced {
+			window.text_mutex.lock()
 			window.text_system.draw_layout_placed(renderer.layout, renderer.placements)
+			window.text_mutex.unlock()
 		}
 		DrawClip {
 			sgl.scissor_rectf(ctx.scale * renderer.x, ctx.scale * renderer.y,
 				ctx.scale * renderer.width, ctx.scale * renderer.height, true)
+			window.draw_clip = renderer
 		}
 		DrawCircle {
 			if renderer.fill {
@@ -475,7 +615,16 @@ fn renderer_draw(renderer Renderer, mut window Window) {
 			}
 		}
 		DrawImage {
-			if renderer.clip_radius > 0 {
+			if renderer.atlas {
+				// Atlas pages must not be drawn whole; route through the
+				// batch paths under the current clip.
+				single := [Renderer(renderer)]
+				if renderer.clip_radius > 0 {
+					draw_rounded_image_batch(single, 0, 1, window.draw_clip, mut window)
+				} else {
+					draw_atlas_image_batch(single, 0, 1, mut window)
+				}
+			} else if renderer.clip_radius > 0 {
 				draw_image_rounded(renderer.x, renderer.y, renderer.w, renderer.h,
 					renderer.clip_radius, renderer.img, mut window)
 			} else {
@@ -376,17 +376,53 @@ fn render_image(mut shape Shape, clip DrawClip, mut window Window) {
 		shape.disabled = true
 		return
 	}
-	loaded_image := window.load_image(shape.resource) or {
+	lookup := window.load_image_sized_async(shape.resource, shape.width, shape.height) or {
 		log.error('${@FILE_LINE} > ${err.msg()}')
 		emit_error_placeholder(shape.x, shape.y, shape.width, shape.height, mut window)
 		return
 	}
+	if lookup.pending {
+		// Decoding in the background; the layout already reserves the size.
+		emit_renderer(DrawRect{
+			x:      shape.x
+			y:      shape.y
+			w:      shape.width
+			h:      shape.height
+			color:  gui_theme.color_interior.to_gx_color()
+			radius: window.clip_radius
+			style:  .fill
+		}, mut window)
+		return
+	}
+	emit_image_renderer(lookup.img, shape.x, shape.y, shape.width, shape.height, mut
+		window)
+}
+
+// emit_image_renderer emits a DrawImage, routing small images through
+// the texture atlas so runs of them share one texture bind.
+fn emit_image_renderer(img &gg.Image, x f32, y f32, w f32, h f32, mut window Window) {
+	if entry := window.view_state.image_atlas.lookup(img.id, img, window.ui.frame) {
+		emit_renderer(DrawImage{
+			x:           x
+			y:           y
+			w:           w
+			h:           h
+			img:         window.view_state.image_atlas.page_image(entry.page, mut window.ui)
+			clip_radius: window.clip_radius
+			atlas:       true
+			u0:          entry.u0
+			v0:          entry.v0
+			u1:          entry.u1
+			v1:          entry.v1
+		}, mut window)
+		return
+	}
 	emit_renderer(DrawImage{
-		x:           shape.x
-		y:           shape.y
-		w:           shape.width
-		h:           shape.height
-		img:         loaded_image
+		x:           x
+		y:           y
+		w:           w
+		h:           h
+		img:         img
 		clip_radius: window.clip_radius
 	}, mut window)
 }
@@ -446,16 +482,14 @@ fn render_rtf(mut shape Shape, clip DrawClip, mut window Window) {
 				}
 				ihash := math_cache_hash(item.object_id)
 				if entry := window.view_state.diagram_cache.get(ihash) {
-					if entry.state == .ready && entry.png_path.len > 0 {
-						img := window.load_image(entry.png_path) or { continue }
-						emit_renderer(DrawImage{
-							x:           shape.x + f32(item.x)
-							y:           shape.y + f32(item.y) - f32(item.ascent)
-							w:           f32(item.width)
-							h:           f32(item.ascent + item.descent)
-							img:         img
-							clip_radius: window.clip_radius
-						}, mut window)
+					if entry.state == .ready && entry.image_key.len > 0 {
+						img_w := f32(item.width)
+						img_h := f32(item.ascent + item.descent)
+						img := window.load_image_sized(entry.image_key, img_w, img_h) or {
+							continue
+						}
+						emit_image_renderer(img, shape.x + f32(item.x), shape.y + f32(item.y) - f32(item.ascent),
+							img_w, img_h, mut window)
 					}
 				}
 			}
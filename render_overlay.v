@@ -0,0 +1,139 @@
+module gui
+
+// render_overlay.v keeps the text caret and IME composition underlines
+// out of the main renderer list. render_text records an anchor (the
+// focused text shape and its clip) instead of emitting caret rects;
+// build_overlay_renderers turns anchors into a small second list that
+// renderers_draw_overlay draws after the main list. A cursor blink
+// only rebuilds the overlay, so its cost does not grow with the UI.
+// Anchors point into window.layout and are reset on every renderer
+// rebuild, so they never outlive the layout they were taken from.
+// Each anchor remembers its root layer; caret and underline rects that
+// a later floating layer (menu, popup, dialog, tooltip) was drawn over
+// are dropped, so the overlay never shows through it.
+
+// OverlayAnchor is a focused text shape whose caret is drawn in the
+// overlay, with the clip active where the shape was rendered.
+struct OverlayAnchor {
+	shape &Shape = unsafe { nil }
+	clip  DrawClip
+	layer int // index in window.layer_rects
+}
+
+// add_overlay_anchor records a focused text shape for the overlay.
+@[inline]
+fn (mut window Window) add_overlay_anchor(shape &Shape, clip DrawClip) {
+	if window.is_focus(shape.id_focus) {
+		window.overlay_anchors << OverlayAnchor{
+			shape: shape
+			clip:  clip
+			layer: window.render_layer
+		}
+	}
+}
+
+// build_overlay_renderers regenerates overlay renderers from anchors.
+// render_cursor emits through emit_renderer, so the main list is
+// swapped out while it runs.
+fn (mut window Window) build_overlay_renderers() {
+	main_renderers := window.renderers
+	window.renderers = window.overlay_renderers
+	array_clear(mut window.renderers)
+	for anchor in window.overlay_anchors {
+		start := window.renderers.len
+		window.renderers << anchor.clip
+		render_cursor(anchor.shape, anchor.clip, mut window)
+		window.drop_covered_overlay(start + 1, anchor.layer)
+		if window.renderers.len == start + 1 {
+			window.renderers.delete_last() // caret hidden: drop the clip
+		}
+	}
+	window.overlay_renderers = window.renderers
+	window.renderers = main_renderers
+}
+
+// drop_covered_overlay removes the overlay rects from index `from` on
+// that overlap a root layer drawn after `layer`.
+fn (mut window Window) drop_covered_overlay(from int, layer int) {
+	if layer + 1 >= window.layer_rects.len {
+		return
+	}
+	mut kept := from
+	for i in from .. window.renderers.len {
+		renderer := window.renderers[i]
+		if renderer is DrawRect && window.overlay_covered(renderer, layer) {
+			continue
+		}
+		window.renderers[kept] = renderer
+		kept++
+	}
+	window.renderers.trim(kept)
+}
+
+fn (window &Window) overlay_covered(r DrawRect, layer int) bool {
+	rect := DrawClip{
+		x:      r.x
+		y:      r.y
+		width:  r.w
+		height: r.h
+	}
+	for cover in window.layer_rects[layer + 1..] {
+		if rects_overlap(rect, cover) {
+			return true
+		}
+	}
+	return false
+}
+
+// render_layers renders the root layout: the main layer, then each
+// floating layer in draw order, noting which layer is being rendered
+// and its bounds for the overlay.
+fn (mut window Window) render_layers(background_color Color, clip DrawClip) {
+	mut root := &window.layout
+	render_shape(mut root.shape, background_color, clip, mut window)
+	color := if root.shape.color != color_transparent { root.shape.color } else { background_color }
+	array_clear(mut window.layer_rects)
+	for i, mut layer in root.children {
+		window.render_layer = i
+		window.layer_rects << DrawClip{
+			x:      layer.shape.x
+			y:      layer.shape.y
+			width:  layer.shape.width
+			height: layer.shape.height
+		}
+		render_layout(mut layer, color, clip, mut window)
+	}
+	window.render_layer = 0
+}
+
+// update_overlay rebuilds only the overlay. Used by the cursor blink.
+fn (mut window Window) update_overlay() {
+	window.lock()
+	window.build_overlay_renderers()
+	window.unlock()
+}
+
+fn (mut window Window) request_overlay_only() {
+	window.mark_overlay_refresh()
+	window.ui.refresh_ui()
+}
+
+fn (mut window Window) mark_overlay_refresh() {
+	if !window.refresh_layout && !window.refresh_render_only {
+		window.refresh_overlay = true
+	}
+}
+
+// renderers_draw_overlay draws the overlay list after the main list,
+// then restores the window clip.
+fn renderers_draw_overlay(mut window Window) {
+	if window.overlay_renderers.len == 0 {
+		return
+	}
+	for renderer in window.overlay_renderers {
+		if guard_renderer_or_skip(renderer, mut window) {
+			renderer_draw(renderer, mut window)
+		}
+	}
+	renderer_draw(window.window_rect(), mut window)
+}
@@ -3,7 +3,8 @@ module gui
 // render_text.v handles text shape rendering. It manages the vglyph layout
 // cache (keyed by a hash of text, style, and size), password masking,
 // placeholder text, cursor rendering (render_cursor reads input_cursor_on
-// live — never captured in a closure), and text-transform affine matrices.
+// live — never captured in a closure; it runs from the caret overlay, see
+// render_overlay.v), and text-transform affine matrices.
 // clone_layout_for_draw deep-clones vglyph layouts for renderer lifetime.
 import gg
 import log
@@ -195,7 +196,7 @@ fn render_text_try_transformed(mut shape Shape, style_state RenderTextStyleState
 				&& shape.tc.cached_transform_key == cache_key {
 				layout_to_draw = shape.tc.cached_transform_layout
 			} else {
-				mut transformed_layout := window.text_system.layout_text(text_to_layout, cfg) or {
+				mut transformed_layout := window.text_layout(text_to_layout, cfg) or {
 					log.error('Transformed text layout failed at (${shape.x}, ${shape.y}): ${err.msg()}')
 					return true
 				}
@@ -289,7 +290,7 @@ fn render_text_layout_lines(mut shape Shape, clip DrawClip, style_state RenderTe
 }
 
 // render_text renders text including multiline text using vglyph layout.
-// If cursor coordinates are present, it draws the input cursor.
+// If the shape has focus, its cursor is drawn by the caret overlay.
 // The highlighting of selected text happens here also.
 fn render_text(mut shape Shape, clip DrawClip, mut window Window) {
 	dr := gg.Rect{
@@ -324,7 +325,7 @@ fn render_text(mut shape Shape, clip DrawClip, mut window Window) {
 		render_text_layout_lines(mut shape, clip, style_state, selection_state, mut window)
 	}
 
-	render_cursor(shape, clip, mut window)
+	window.add_overlay_anchor(&shape, clip)
 }
 
 fn draw_text_selection(mut window Window, params DrawTextSelectionParams) {
@@ -438,8 +439,8 @@ fn draw_text_selection(mut window Window, params DrawTextSelectionParams) {
 
 // render_cursor figures out where the darn cursor goes using vglyph.
 // input_cursor_on is read live here — never captured in a closure — so the
-// blink animation (render-only path) toggles it and triggers a re-render
-// without rebuilding the layout tree.
+// blink animation toggles it and rebuilds only the overlay list (see
+// build_overlay_renderers), not the main renderers or layout tree.
 fn render_cursor(shape &Shape, _ DrawClip, mut window Window) {
 	if window.is_focus(shape.id_focus) && shape.shape_type == .text
 		&& window.view_state.input_cursor_on {
@@ -25,6 +25,11 @@ struct DrawImage {
 	w           f32
 	h           f32
 	clip_radius f32 // >0 enables SDF rounded clipping
+	atlas       bool // img is an atlas page; u0..v1 locate the sub-image
+	u0          f32
+	v0          f32
+	u1          f32
+	v1          f32
 }
 
 struct DrawLine {
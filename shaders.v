@@ -52,18 +52,20 @@ mut:
 // Each pipeline is considered initialized when its `.id != 0`.
 struct Pipelines {
 mut:
-	rounded_rect               sgl.Pipeline
-	shadow                     sgl.Pipeline
-	blur                       sgl.Pipeline
-	gradient                   sgl.Pipeline
-	image_clip                 sgl.Pipeline
-	image_clip_init_failed     bool
-	image_clip_fallback_warned bool
-	stencil_write              sgl.Pipeline
-	stencil_test               sgl.Pipeline
-	stencil_clear              sgl.Pipeline
-	custom                     map[u64]sgl.Pipeline
-	gradient_stop_warned       bool
+	rounded_rect                 sgl.Pipeline
+	shadow                       sgl.Pipeline
+	blur                         sgl.Pipeline
+	gradient                     sgl.Pipeline
+	image_clip                   sgl.Pipeline
+	image_clip_init_failed       bool
+	image_clip_fallback_warned   bool
+	image_clip_atlas             sgl.Pipeline
+	image_clip_atlas_init_failed bool
+	stencil_write                sgl.Pipeline
+	stencil_test                 sgl.Pipeline
+	stencil_clear                sgl.Pipeline
+	custom                       map[u64]sgl.Pipeline
+	gradient_stop_warned         bool
 }
 
 const packed_param_stride = 4096
@@ -1767,7 +1769,39 @@ fn init_image_clip_pipeline(mut window Window) bool {
 	if window.pip.image_clip_init_failed {
 		return false
 	}
+	window.pip.image_clip = make_image_clip_pipeline(fs_image_clip_glsl, fs_image_clip_metal,
+		c'image_clip_pip')
+	if window.pip.image_clip.id == 0 {
+		window.pip.image_clip_init_failed = true
+		return false
+	}
+	window.pip.image_clip_init_failed = false
+	window.pip.image_clip_fallback_warned = false
+	return true
+}
+
+// init_image_clip_atlas_pipeline initializes the rounded-clip variant
+// used for atlas images. The SDF coordinate comes from vertex color
+// because texture coordinates address the atlas sub-rect.
+fn init_image_clip_atlas_pipeline(mut window Window) bool {
+	if window.pip.image_clip_atlas.id != 0 {
+		return true
+	}
+	if window.pip.image_clip_atlas_init_failed {
+		return false
+	}
+	window.pip.image_clip_atlas = make_image_clip_pipeline(fs_image_clip_atlas_glsl,
+		fs_image_clip_atlas_metal, c'image_clip_atlas_pip')
+	if window.pip.image_clip_atlas.id == 0 {
+		window.pip.image_clip_atlas_init_failed = true
+		return false
+	}
+	return true
+}
 
+// make_image_clip_pipeline builds a textured SDF pipeline with the
+// given fragment shader. Returns a pipeline with id 0 on failure.
+fn make_image_clip_pipeline(fs_glsl_src string, fs_metal_src string, label &char) sgl.Pipeline {
 	mut attrs := [16]gfx.VertexAttrDesc{}
 	attrs[0] = gfx.VertexAttrDesc{
 		format:       .float3
@@ -1869,7 +1903,7 @@ fn init_image_clip_pipeline(mut window Window) bool {
 			uniform_blocks: ub
 		}
 		shader_desc.fs = gfx.ShaderStageDesc{
-			source:              fs_image_clip_metal.str
+			source:              fs_metal_src.str
 			entry:               c'fs_main'
 			images:              shader_images
 			samplers:            shader_samplers
@@ -1881,7 +1915,7 @@ fn init_image_clip_pipeline(mut window Window) bool {
 			uniform_blocks: ub
 		}
 		shader_desc.fs = gfx.ShaderStageDesc{
-			source:              fs_image_clip_glsl.str
+			source:              fs_glsl_src.str
 			images:              shader_images
 			samplers:            shader_samplers
 			image_sampler_pairs: shader_image_sampler_pairs
@@ -1889,7 +1923,7 @@ fn init_image_clip_pipeline(mut window Window) bool {
 	}
 
 	desc := gfx.PipelineDesc{
-		label:  c'image_clip_pip'
+		label:  label
 		colors: colors
 		layout: gfx.VertexLayoutState{
 			attrs:   attrs
@@ -1898,14 +1932,7 @@ fn init_image_clip_pipeline(mut window Window) bool {
 		shader: gfx.make_shader(&shader_desc)
 	}
 
-	window.pip.image_clip = sgl.make_pipeline(&desc)
-	if window.pip.image_clip.id == 0 {
-		window.pip.image_clip_init_failed = true
-		return false
-	}
-	window.pip.image_clip_init_failed = false
-	window.pip.image_clip_fallback_warned = false
-	return true
+	return sgl.make_pipeline(&desc)
 }
 
 @[inline]
@@ -473,6 +473,37 @@ const fs_image_clip_glsl = '
     }
 '
 
+// Atlas variant of fs_image_clip_glsl: uv addresses the atlas sub-rect,
+// so the -1..1 SDF coordinate is carried in color.rg (0..1 per corner).
+const fs_image_clip_atlas_glsl = '
+    #version 330
+    uniform sampler2D tex;
+    in vec2 uv;
+    in vec4 color;
+    in float params;
+
+    out vec4 frag_color;
+
+    void main() {
+        float radius = floor(params / 4096.0) / 4.0;
+
+        vec2 sdf_uv = color.rg * 2.0 - 1.0;
+        vec2 uv_to_px = 1.0 / (vec2(fwidth(sdf_uv.x), fwidth(sdf_uv.y)) + 1e-6);
+        vec2 half_size = uv_to_px;
+        vec2 pos = sdf_uv * half_size;
+
+        vec2 q = abs(pos) - half_size + vec2(radius);
+        float d = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+
+        float grad_len = length(vec2(dFdx(d), dFdy(d)));
+        d = d / max(grad_len, 0.001);
+        float alpha = 1.0 - smoothstep(-0.59, 0.59, d);
+
+        vec4 tex_color = texture(tex, uv);
+        frag_color = vec4(tex_color.rgb, tex_color.a * alpha);
+    }
+'
+
 const fs_filter_texture_glsl = '
     #version 330
     uniform sampler2D tex_smp;
@@ -551,6 +551,39 @@ fragment float4 fs_main(VertexOut in [[stage_in]], texture2d<float> tex [[textur
 }
 '
 
+// Atlas variant of fs_image_clip_metal: uv addresses the atlas sub-rect,
+// so the -1..1 SDF coordinate is carried in color.rg (0..1 per corner).
+const fs_image_clip_atlas_metal = '
+#include <metal_stdlib>
+using namespace metal;
+
+struct VertexOut {
+    float4 position [[position]];
+    float2 uv;
+    float4 color;
+    float params;
+};
+
+fragment float4 fs_main(VertexOut in [[stage_in]], texture2d<float> tex [[texture(0)]], sampler smp [[sampler(0)]]) {
+    float radius = floor(in.params / 4096.0) / 4.0;
+
+    float2 sdf_uv = in.color.rg * 2.0 - 1.0;
+    float2 width_inv = float2(fwidth(sdf_uv.x), fwidth(sdf_uv.y));
+    float2 half_size = 1.0 / (width_inv + 1e-6);
+    float2 pos = sdf_uv * half_size;
+
+    float2 q = abs(pos) - half_size + float2(radius);
+    float d = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+
+    float grad_len = length(float2(dfdx(d), dfdy(d)));
+    d = d / max(grad_len, 0.001);
+    float alpha = 1.0 - smoothstep(-0.59, 0.59, d);
+
+    float4 tex_color = tex.sample(smp, in.uv);
+    return float4(tex_color.rgb, tex_color.a * alpha);
+}
+'
+
 // Simple texture sampling shader for compositing blurred result.
 const fs_filter_texture_metal = '
 #include <metal_stdlib>
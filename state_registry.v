@@ -159,6 +159,8 @@ const ns_dg_crud = 'gui.dg.crud'
 const ns_dg_jump = 'gui.dg.jump'
 const ns_dg_pending_jump = 'gui.dg.pending_jump'
 const ns_dg_source = 'gui.dg.source'
+const ns_dg_column_source = 'gui.dg.column_source'
+const ns_dg_aggregate = 'gui.dg.aggregate'
 const ns_sidebar = 'gui.sidebar'
 const ns_combobox = 'gui.combobox'
 const ns_combobox_highlight = 'gui.combobox.highlight'
@@ -24,12 +24,13 @@ const stat_sub_div = '----------------------------------'
 
 struct Stats {
 mut:
-	container_views usize
-	text_views      usize
-	image_views     usize
-	rtf_views       usize
-	layouts         usize
-	max_renderers   usize
+	container_views   usize
+	text_views        usize
+	image_views       usize
+	rtf_views         usize
+	layouts           usize
+	max_renderers     usize
+	textures_released usize // image cache textures handed back to gg
 }
 
 @[if !prod]
@@ -76,6 +77,13 @@ fn (mut stats Stats) increment_layouts() {
 	}
 }
 
+@[if !prod]
+fn (mut stats Stats) add_textures_released(count int) {
+	$if !prod {
+		stats.textures_released += usize(count)
+	}
+}
+
 // Methods for Stats struct
 
 fn (window &Window) stats() string {
@@ -153,6 +161,8 @@ fn (vs ViewState) view_state_stats() string {
 	tx << 'View State'
 	tx << stat_sub_div
 	tx << 'image_map length         ${cm(usize(vs.image_map.len())):8}'
+	tx << 'image_atlas entries      ${cm(usize(vs.image_atlas.len())):8}'
+	tx << 'image_atlas evictions    ${cm(usize(vs.image_atlas.evictions)):8}'
 	tx << 'svg_cache length         ${cm(usize(vs.svg_cache.len())):8}'
 	tx << 'markdown_cache length    ${cm(usize(vs.markdown_cache.len())):8}'
 	tx << 'tree_state length        ${cm(usize(vs.tree_state.len())):8}'
@@ -179,6 +189,22 @@ fn (window &Window) context_stats() string {
 	tx << 'window size  ${win_size:20}'
 	tx << 'screen size  ${scr_size:20}'
 	tx << 'scale        ${window.ui.scale:20}'
+	tx << 'images       ${cm(usize(window.view_state.image_map.len())):20}'
+	tx << 'image cpu    ${cmkb(usize(window.view_state.image_map.cpu_bytes)):17} KB'
+	tx << 'image gpu    ${cmkb(usize(window.view_state.image_map.gpu_bytes)):17} KB'
+	tx << 'image hits   ${cm(usize(window.view_state.image_map.hits)):20}'
+	tx << 'image misses ${cm(usize(window.view_state.image_map.misses)):20}'
+	tx << 'image evicts ${cm(usize(window.view_state.image_map.evictions)):20}'
+	tx << 'image frees  ${cm(window.stats.textures_released):20}'
+	qs := window.command_queue_stats()
+	tx << 'cmd queued   ${cm(usize(qs.depth)):20}'
+	tx << 'cmd max batch${cm(usize(qs.max_depth)):20}'
+	tx << 'cmd coalesced${cm(usize(qs.coalesced)):20}'
+	tx << 'cmd latency  ${cm(usize(qs.max_latency_ns / 1000)):17} us'
+	if window.image_decoder != unsafe { nil } {
+		tx << 'image queued ${cm(usize(window.image_decoder.pending.len)):20}'
+		tx << 'image uploads${cm(usize(window.image_decoder.uploads)):20}'
+	}
 	return tx.join('\n')
 }
 
@@ -116,12 +116,12 @@ fn cached_svg_text_draws(texts []svg.SvgText, scale f32, gradients map[string]sv
 		tw := if window.text_system == unsafe { nil } {
 			f32(0)
 		} else {
-			window.text_system.text_width(t.text, cfg) or { 0 }
+			window.text_measure_width(t.text, cfg) or { 0 }
 		}
 		fh := if window.text_system == unsafe { nil } {
 			t.font_size * scale
 		} else {
-			window.text_system.font_height(cfg) or { t.font_size * scale }
+			window.text_font_height(cfg) or { t.font_size * scale }
 		}
 		ascent := fh * 0.8
 		mut x := t.x * scale
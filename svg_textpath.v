@@ -43,7 +43,7 @@ fn render_svg_text_path(tp svg.SvgTextPath, defs_paths map[string]string, shape_
 		}
 	}
 	cfg := text_style.to_vglyph_cfg()
-	layout := window.text_system.layout_text(tp.text, cfg) or { return }
+	layout := window.text_layout(tp.text, cfg) or { return }
 	glyph_infos := layout.glyph_positions()
 	if glyph_infos.len == 0 {
 		return
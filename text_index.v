@@ -0,0 +1,423 @@
+module gui
+
+// text_index.v is an optional trigram index for in-memory text search.
+// A linear scan per keystroke, however fast, grows with the data. A
+// GridTextIndex maps every three-byte sequence of the lowered text to
+// the rows that contain it, so a needle of three or more bytes only
+// verifies rows that hold all of its trigrams.
+// - Attach one to InMemoryDataSource.text_index or
+//   InMemoryListBoxDataSource.text_index.
+// - The index is built on the window's worker pool, at background
+//   priority, the first time it is needed, and rebuilt when the rows or
+//   options array is replaced or InMemoryDataSource.version changes.
+//   Until it is ready, searches scan linearly as before. Outside a
+//   window (fetch_data called directly) it is built on the caller.
+// - InMemoryDataSource.mutate_data updates it in place. Creates and
+//   updates re-index only the rows involved; deletes tombstone rows.
+// - An index over some columns narrows the quick filter to those
+//   columns. Over all columns, results match a linear scan, since
+//   every candidate is still verified.
+// With InMemoryDataSource.version zero, the index cannot see a row
+// edited in place; replace the rows array or set and bump version.
+import sync
+import time
+
+const text_index_gram_len = 3
+
+// GridTextIndex is a trigram index over rows or list box options.
+@[heap]
+pub struct GridTextIndex {
+pub:
+	columns []string // grid columns to index and search; empty means all
+mut:
+	mutex      &sync.Mutex = sync.new_mutex()
+	postings   map[u32][]int // trigram -> docs, ascending
+	doc_pos    []int         // doc -> row position, -1 once deleted
+	doc_ids    map[string]int // row id -> doc; grids only
+	stable_ids bool           // every row had an explicit id at build
+	live       int
+	data       voidptr // array the index describes
+	version    u64     // InMemoryDataSource.version the index describes
+	len        int
+	window     &Window = unsafe { nil } // worker pool for builds
+	ready      bool
+	building   bool
+	build_time time.Duration
+	queries    u64
+	query_time time.Duration
+	candidates u64
+	updates    u64
+}
+
+// GridTextIndexStats reports index size and timings.
+pub struct GridTextIndexStats {
+pub:
+	ready          bool
+	docs           int
+	trigrams       int
+	postings       int
+	build_time     time.Duration
+	queries        u64
+	avg_query_time time.Duration
+	avg_candidates u64
+	updates        u64 // mutations applied in place
+}
+
+// new_grid_text_index creates an index over the given grid columns, or
+// over every cell when columns is empty. With columns, the quick filter
+// only matches text in those columns. List boxes index each option's
+// id, name and value; columns is ignored.
+pub fn new_grid_text_index(columns []string) &GridTextIndex {
+	return &GridTextIndex{
+		columns: columns.clone()
+	}
+}
+
+// is_ready reports whether a build has finished and no rebuild is
+// running.
+pub fn (mut index GridTextIndex) is_ready() bool {
+	index.mutex.lock()
+	defer {
+		index.mutex.unlock()
+	}
+	return index.ready && !index.building
+}
+
+// stats returns a snapshot of the index size and timings.
+pub fn (mut index GridTextIndex) stats() GridTextIndexStats {
+	index.mutex.lock()
+	defer {
+		index.mutex.unlock()
+	}
+	mut total := 0
+	for _, docs in index.postings {
+		total += docs.len
+	}
+	return GridTextIndexStats{
+		ready:          index.ready
+		docs:           index.live
+		trigrams:       index.postings.len
+		postings:       total
+		build_time:     index.build_time
+		queries:        index.queries
+		avg_query_time: if index.queries > 0 {
+			index.query_time / i64(index.queries)
+		} else {
+			time.Duration(0)
+		}
+		avg_candidates: if index.queries > 0 { index.candidates / index.queries } else { 0 }
+		updates:        index.updates
+	}
+}
+
+// text_index_grams returns the distinct trigrams of texts, ASCII
+// lowered to match grid_contains_lower, in ascending order. Trigrams
+// never span two texts.
+@[direct_array_access]
+fn text_index_grams(texts []string) []u32 {
+	mut grams := []u32{}
+	for text in texts {
+		for i := 0; i + text_index_gram_len <= text.len; i++ {
+			a := u32(grid_lower_byte(text[i]))
+			b := u32(grid_lower_byte(text[i + 1]))
+			c := u32(grid_lower_byte(text[i + 2]))
+			grams << (a << 16) | (b << 8) | c
+		}
+	}
+	if grams.len < 2 {
+		return grams
+	}
+	grams.sort()
+	mut n := 1
+	for i in 1 .. grams.len {
+		if grams[i] != grams[n - 1] {
+			grams[n] = grams[i]
+			n++
+		}
+	}
+	grams.trim(n)
+	return grams
+}
+
+// text_index_row_texts returns the searchable cells of a grid row.
+fn text_index_row_texts(row GridRow, columns []string) []string {
+	if columns.len == 0 {
+		return row.cells.values()
+	}
+	return columns.map(row.cells[it] or { '' })
+}
+
+// use_window sets the window whose worker pool runs index builds.
+fn (mut index GridTextIndex) use_window(window &Window) {
+	if window == unsafe { nil } {
+		return
+	}
+	index.mutex.lock()
+	index.window = window
+	index.mutex.unlock()
+}
+
+// current reports whether the index is ready for this array at this
+// version. When it is not, a build is queued at background priority
+// (if none is running) and the caller should scan linearly. Without a
+// window the build runs here and current reports true.
+fn (mut index GridTextIndex) current(data voidptr, len int, version u64, text_of fn (int) []string, id_of fn (int) string) bool {
+	index.mutex.lock()
+	if index.ready && index.data == data && index.len == len && index.version == version {
+		index.mutex.unlock()
+		return true
+	}
+	if index.building {
+		index.mutex.unlock()
+		return false
+	}
+	index.building = true
+	window := index.window
+	index.mutex.unlock()
+	if window == unsafe { nil } {
+		index.build(data, len, version, text_of, id_of)
+		return true
+	}
+	mut w := unsafe { window }
+	w.submit_work(WorkItem{
+		priority:  .background
+		run:       fn [mut index, data, len, version, text_of, id_of] (mut w Window) {
+			index.build(data, len, version, text_of, id_of)
+		}
+		on_cancel: fn [mut index] (mut w Window) {
+			index.mutex.lock()
+			index.building = false
+			index.mutex.unlock()
+		}
+	})
+	return false
+}
+
+// rows_current is current for grid rows at data version version.
+fn (mut index GridTextIndex) rows_current(rows []GridRow, version u64) bool {
+	columns := index.columns
+	return index.current(rows.data, rows.len, version, fn [rows, columns] (i int) []string {
+		return text_index_row_texts(rows[i], columns)
+	}, fn [rows] (i int) string {
+		return rows[i].id
+	})
+}
+
+// options_current is current for list box options.
+fn (mut index GridTextIndex) options_current(options []ListBoxOption) bool {
+	return index.current(options.data, options.len, 0, fn [options] (i int) []string {
+		return [options[i].id, options[i].name, options[i].value]
+	}, unsafe { nil })
+}
+
+// build indexes len documents without holding the lock, then swaps the
+// result in.
+fn (mut index GridTextIndex) build(data voidptr, len int, version u64, text_of fn (int) []string, id_of fn (int) string) {
+	sw := time.new_stopwatch()
+	mut postings := map[u32][]int{}
+	mut doc_ids := map[string]int{}
+	mut stable_ids := id_of != unsafe { nil }
+	for doc in 0 .. len {
+		for gram in text_index_grams(text_of(doc)) {
+			postings[gram] << doc
+		}
+		if stable_ids {
+			id := id_of(doc)
+			if id.len == 0 || id in doc_ids {
+				stable_ids = false
+			} else {
+				doc_ids[id] = doc
+			}
+		}
+	}
+	index.mutex.lock()
+	index.postings = postings
+	index.doc_pos = []int{cap: len}
+	for doc in 0 .. len {
+		index.doc_pos << doc
+	}
+	index.doc_ids = if stable_ids { doc_ids } else { map[string]int{} }
+	index.stable_ids = stable_ids
+	index.live = len
+	index.data = data
+	index.len = len
+	index.version = version
+	index.ready = true
+	index.building = false
+	index.build_time = sw.elapsed()
+	index.mutex.unlock()
+}
+
+// candidates returns the row positions, ascending, whose text holds
+// every trigram of needle. needle must be lowered and at least
+// text_index_gram_len bytes. Returns none unless the index describes
+// the array at data with len entries at version: the check shares the
+// lock with the lookup, so a concurrent mutation cannot move the index
+// to another array in between.
+fn (mut index GridTextIndex) candidates(needle string, data voidptr, len int, version u64) ?[]int {
+	sw := time.new_stopwatch()
+	index.mutex.lock()
+	defer {
+		index.mutex.unlock()
+	}
+	if !index.ready || index.data != data || index.len != len || index.version != version {
+		return none
+	}
+	mut lists := [][]int{}
+	for gram in text_index_grams([needle]) {
+		list := index.postings[gram] or {
+			index.queries++
+			return []int{}
+		}
+		lists << list
+	}
+	lists.sort(a.len < b.len)
+	mut docs := lists[0]
+	for i in 1 .. lists.len {
+		if docs.len == 0 {
+			break
+		}
+		docs = text_index_intersect(docs, lists[i])
+	}
+	mut positions := []int{cap: docs.len}
+	for doc in docs {
+		pos := index.doc_pos[doc]
+		if pos >= 0 {
+			positions << pos
+		}
+	}
+	index.queries++
+	index.candidates += u64(positions.len)
+	index.query_time += sw.elapsed()
+	return positions
+}
+
+// apply_rows_mutation updates the index after InMemoryDataSource
+// replaced old_rows at old_version with new_rows at new_version. An
+// index that did not describe old_rows, or whose rows lack stable ids,
+// is left to rebuild.
+fn (mut index GridTextIndex) apply_rows_mutation(old_rows []GridRow, old_version u64, new_rows []GridRow, new_version u64, kind GridMutationKind, result GridMutationResult) {
+	index.mutex.lock()
+	defer {
+		index.mutex.unlock()
+	}
+	if !index.ready || index.building || index.data != old_rows.data
+		|| index.len != old_rows.len || index.version != old_version || !index.stable_ids {
+		return
+	}
+	match kind {
+		.create {
+			for row in result.created {
+				if row.id.len == 0 || row.id in index.doc_ids {
+					index.ready = false
+					return
+				}
+				doc := index.doc_pos.len
+				index.doc_pos << index.live // appended after every live row
+				index.doc_ids[row.id] = doc
+				index.live++
+				for gram in text_index_grams(text_index_row_texts(row, index.columns)) {
+					index.postings[gram] << doc
+				}
+			}
+		}
+		.update {
+			for row in result.updated {
+				doc := index.doc_ids[row.id] or {
+					index.ready = false
+					return
+				}
+				old := old_rows[index.doc_pos[doc]]
+				for gram in text_index_grams(text_index_row_texts(old, index.columns)) {
+					mut list := index.postings[gram] or { continue }
+					text_index_remove(mut list, doc)
+					index.postings[gram] = list
+				}
+				for gram in text_index_grams(text_index_row_texts(row, index.columns)) {
+					mut list := index.postings[gram] or { []int{} }
+					text_index_insert(mut list, doc)
+					index.postings[gram] = list
+				}
+			}
+		}
+		.delete {
+			for id in result.deleted_ids {
+				doc := index.doc_ids[id] or {
+					index.ready = false
+					return
+				}
+				index.doc_pos[doc] = -1
+				index.doc_ids.delete(id)
+				index.live--
+			}
+			// Deletes keep row order, so live docs renumber in order.
+			mut pos := 0
+			for doc in 0 .. index.doc_pos.len {
+				if index.doc_pos[doc] >= 0 {
+					index.doc_pos[doc] = pos
+					pos++
+				}
+			}
+		}
+	}
+	if index.live != new_rows.len {
+		index.ready = false
+		return
+	}
+	index.data = new_rows.data
+	index.len = new_rows.len
+	index.version = new_version
+	index.updates++
+}
+
+// text_index_intersect intersects two ascending lists.
+@[direct_array_access]
+fn text_index_intersect(a []int, b []int) []int {
+	mut out := []int{cap: int_min(a.len, b.len)}
+	mut i := 0
+	mut j := 0
+	for i < a.len && j < b.len {
+		if a[i] < b[j] {
+			i++
+		} else if a[i] > b[j] {
+			j++
+		} else {
+			out << a[i]
+			i++
+			j++
+		}
+	}
+	return out
+}
+
+// text_index_lower_bound returns the first position in list not less
+// than value.
+@[direct_array_access]
+fn text_index_lower_bound(list []int, value int) int {
+	mut lo := 0
+	mut hi := list.len
+	for lo < hi {
+		mid := (lo + hi) / 2
+		if list[mid] < value {
+			lo = mid + 1
+		} else {
+			hi = mid
+		}
+	}
+	return lo
+}
+
+fn text_index_insert(mut list []int, doc int) {
+	at := text_index_lower_bound(list, doc)
+	if at < list.len && list[at] == doc {
+		return
+	}
+	list.insert(at, doc)
+}
+
+fn text_index_remove(mut list []int, doc int) {
+	at := text_index_lower_bound(list, doc)
+	if at < list.len && list[at] == doc {
+		list.delete(at)
+	}
+}
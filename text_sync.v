@@ -0,0 +1,49 @@
+module gui
+
+// text_sync.v serializes access to the vglyph TextSystem. vglyph is not
+// thread-safe, and with WindowCfg.pipelined_layout the layout thread
+// shapes text while the main thread draws glyphs (see
+// layout_pipelined.v). Layout-side measurement goes through these
+// wrappers; the draw side locks text_mutex around each text renderer.
+// In the default serial mode the lock is never contended.
+import vglyph
+
+fn (mut window Window) text_layout(text string, cfg vglyph.TextConfig) !vglyph.Layout {
+	window.text_mutex.lock()
+	defer {
+		window.text_mutex.unlock()
+	}
+	return window.text_system.layout_text(text, cfg)
+}
+
+fn (mut window Window) text_layout_rich(rt vglyph.RichText, cfg vglyph.TextConfig) !vglyph.Layout {
+	window.text_mutex.lock()
+	defer {
+		window.text_mutex.unlock()
+	}
+	return window.text_system.layout_rich_text(rt, cfg)
+}
+
+fn (mut window Window) text_measure_width(text string, cfg vglyph.TextConfig) !f32 {
+	window.text_mutex.lock()
+	defer {
+		window.text_mutex.unlock()
+	}
+	return window.text_system.text_width(text, cfg)
+}
+
+fn (mut window Window) text_font_height(cfg vglyph.TextConfig) !f32 {
+	window.text_mutex.lock()
+	defer {
+		window.text_mutex.unlock()
+	}
+	return window.text_system.font_height(cfg)
+}
+
+fn (mut window Window) text_font_metrics(cfg vglyph.TextConfig) !vglyph.TextMetrics {
+	window.text_mutex.lock()
+	defer {
+		window.text_mutex.unlock()
+	}
+	return window.text_system.font_metrics(cfg)
+}
@@ -14,6 +14,7 @@ pub:
 	options             []string           // static mode
 	data_source         ?ListBoxDataSource // async mode
 	source_key          string
+	request_policy      GridRequestPolicy // async mode: debounce, throttle, sharing
 	on_select           fn (string, mut Event, mut Window) @[required]
 	text_style          TextStyle = gui_theme.combobox_style.text_style
 	placeholder_style   TextStyle = gui_theme.combobox_style.placeholder_style
@@ -61,6 +62,15 @@ pub fn (mut window Window) combobox(cfg ComboboxCfg) View {
 		f32(0)
 	}
 	first, last := list_core_visible_range(filtered.len, row_h, list_h, scroll_y)
+	window.scroll_dep(ScrollDep{
+		id_scroll:  cfg.id_scroll
+		kind:       .list_core
+		first:      first
+		last:       last
+		row_count:  filtered.len
+		row_height: row_h
+		viewport:   list_h
+	})
 
 	// Build dropdown content.
 	on_select := cfg.on_select
@@ -266,10 +276,11 @@ fn combobox_resolve_items(cfg ComboboxCfg, query string, mut window Window) ([]L
 	if cfg.data_source != none {
 		// Async path: reuse listbox source machinery.
 		lb_cfg := ListBoxCfg{
-			id:          cfg.id
-			data_source: cfg.data_source
-			source_key:  cfg.source_key
-			query:       query
+			id:             cfg.id
+			data_source:    cfg.data_source
+			source_key:     cfg.source_key
+			request_policy: cfg.request_policy
+			query:          query
 		}
 		resolved, _ := list_box_resolve_source_cfg(lb_cfg, mut window)
 		mut items := []ListCoreItem{cap: resolved.data.len}
@@ -68,6 +68,15 @@ pub fn (mut window Window) command_palette(cfg CommandPaletteCfg) View {
 		f32(0)
 	}
 	first, last := list_core_visible_range(filtered.len, row_h, cfg.max_height, scroll_y)
+	window.scroll_dep(ScrollDep{
+		id_scroll:  cfg.id_scroll
+		kind:       .list_core
+		first:      first
+		last:       last
+		row_count:  filtered.len
+		row_height: row_h
+		viewport:   cfg.max_height
+	})
 
 	on_action := cfg.on_action
 	palette_id := cfg.id
@@ -461,6 +461,7 @@ fn make_mouse_move_tooltip(tooltip &TooltipCfg, on_mouse_move fn (&Layout, mut E
 					height: layout.shape.height
 				}
 				e.is_handled = true
+				w.set_event_refresh(.none) // the tooltip animation refreshes
 			}
 		}
 	}
@@ -506,8 +507,8 @@ fn (cv &ContainerView) add_group_box_title(mut w Window, mut children []Layout)
 	}
 
 	cfg := text_style.to_vglyph_cfg()
-	title_text_width := w.text_system.text_width(cv.title, cfg) or { 0 }
-	metrics := w.text_system.font_metrics(cfg) or { vglyph.TextMetrics{} }
+	title_text_width := w.text_measure_width(cv.title, cfg) or { 0 }
+	metrics := w.text_font_metrics(cfg) or { vglyph.TextMetrics{} }
 
 	offset := metrics.ascender - metrics.descender
 	title_pad := f32(5)
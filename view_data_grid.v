@@ -192,10 +192,16 @@ pub:
 	group_by                  []string
 	aggregates                []GridAggregateCfg
 	rows                      []GridRow
+	rows_version              u64 // bump when rows change; 0 hashes rows instead
 	data_source               ?DataGridDataSource
+	column_store              &GridColumnStore = unsafe { nil } // served via InMemoryDataSource
 	pagination_kind           GridPaginationKind = .cursor
 	cursor                    string
 	page_limit                int = 100
+	page_cache_bytes          int     // source mode: LRU page cache budget; 0 disables
+	prefetch_pages            int = 2 // source mode: max pages prefetched when cached
+	request_policy            GridRequestPolicy // source mode: debounce, throttle, sharing
+	live_feed                 &GridLiveFeed = unsafe { nil } // source mode: pushed row patches
 	row_count                 ?int
 	loading                   bool
 	load_error                string
@@ -315,6 +321,9 @@ fn data_grid_indicator_button(label string, text_style TextStyle, hover_color Co
 // layout metrics → pagination → frozen rows →
 // virtualization → view assembly.
 pub fn (mut window Window) data_grid(cfg DataGridCfg) View {
+	if cfg.column_store != unsafe { nil } && cfg.data_source == none {
+		return window.data_grid(data_grid_column_store_cfg(cfg, mut window))
+	}
 	// Resolve data source (if any) and apply pending
 	// jump/selection from a previous page change.
 	resolved_cfg0, source_state0, has_source, source_caps := data_grid_resolve_source_cfg(cfg, mut
@@ -434,6 +443,25 @@ pub fn (mut window Window) data_grid(cfg DataGridCfg) View {
 	} else {
 		0, last_row_idx
 	}
+	if virtualize {
+		window.scroll_dep(ScrollDep{
+			id_scroll:  scroll_id
+			kind:       .data_grid
+			first:      first_visible
+			last:       last_visible
+			row_count:  presentation.rows.len
+			row_height: row_height
+			viewport:   grid_height
+			static_top: static_top
+			buffer:     data_grid_virtual_buffer_rows
+		})
+	}
+	// Frozen header cells are offset by scroll_x while generating.
+	window.scroll_dep(ScrollDep{
+		id_scroll: scroll_id
+		kind:      .offset_x
+		offset:    scroll_x
+	})
 
 	// Assemble scroll body rows: optional column chooser,
 	// non-frozen header, filter row, then source status
@@ -491,6 +519,8 @@ pub fn (mut window Window) data_grid(cfg DataGridCfg) View {
 			entry.data_row_idx, columns, column_widths, row_height, focus_id, editing_row_id,
 			row_delete_enabled, mut window)
 	}
+	data_grid_live_note_view(source_state, presentation, first_visible, last_visible,
+		frozen_top_ids)
 
 	if virtualize && last_visible < last_row_idx {
 		remaining := last_row_idx - last_visible
@@ -618,8 +648,13 @@ fn data_grid_cached_presentation(cfg DataGridCfg, columns []GridColumnCfg, row_i
 	} else {
 		map[string]int{}
 	}
+	aggregates := if group_cols.len > 0 {
+		data_grid_synced_aggregate_index(cfg, mut window)
+	} else {
+		DataGridAggregateIndex{}
+	}
 	presentation := data_grid_presentation_rows_with_group_ranges(cfg, columns, visible_indices,
-		group_cols, group_ranges)
+		group_cols, group_ranges, aggregates)
 	dg_pc.set(cfg.id, DataGridPresentationCache{
 		signature:       signature
 		rows:            presentation.rows
@@ -632,14 +667,10 @@ fn data_grid_cached_presentation(cfg DataGridCfg, columns []GridColumnCfg, row_i
 
 fn data_grid_presentation_signature(cfg DataGridCfg, columns []GridColumnCfg, row_indices []int, group_cols []string, value_cols []string) u64 {
 	mut hash := data_grid_fnv64_offset
-	visible_indices := data_grid_visible_row_indices(cfg.rows.len, row_indices)
 	group_titles := data_grid_group_titles(columns)
 	hash = data_grid_fnv64_str(hash, cfg.id)
 	hash = data_grid_fnv64_byte(hash, 0x1e)
-	for idx in row_indices {
-		hash = data_grid_fnv64_u64(hash, u64(idx))
-		hash = data_grid_fnv64_byte(hash, 0x1f)
-	}
+	hash = data_grid_fnv64_indices(hash, row_indices)
 	hash = data_grid_fnv64_byte(hash, 0x1e)
 	for col_id in group_cols {
 		hash = data_grid_fnv64_str(hash, col_id)
@@ -659,6 +690,21 @@ fn data_grid_presentation_signature(cfg DataGridCfg, columns []GridColumnCfg, ro
 
 	detail_enabled := cfg.on_detail_row_view != unsafe { nil }
 	hash = data_grid_fnv64_byte(hash, if detail_enabled { `1` } else { `0` })
+	if cfg.rows_version != 0 {
+		// The version stands in for row ids and values.
+		hash = data_grid_fnv64_u64(hash, cfg.rows_version)
+		hash = data_grid_fnv64_u64(hash, u64(cfg.rows.len))
+		if detail_enabled {
+			for row_id, expanded in cfg.detail_expanded_row_ids {
+				if expanded {
+					hash = data_grid_fnv64_byte(hash, 0x1f)
+					hash = data_grid_fnv64_str(hash, row_id)
+				}
+			}
+		}
+		return hash
+	}
+	visible_indices := data_grid_visible_row_indices(cfg.rows.len, row_indices)
 	for row_idx in visible_indices {
 		data_row := cfg.rows[row_idx]
 		row_id := data_grid_row_id(data_row, row_idx)
@@ -682,6 +728,35 @@ fn data_grid_presentation_signature(cfg DataGridCfg, columns []GridColumnCfg, ro
 	return hash
 }
 
+// data_grid_fnv64_indices hashes a row index list. A contiguous
+// ascending run, the common case, hashes as its bounds.
+fn data_grid_fnv64_indices(h u64, indices []int) u64 {
+	mut hash := data_grid_fnv64_u64(h, u64(indices.len))
+	if indices.len == 0 {
+		return hash
+	}
+	first := indices[0]
+	last := indices[indices.len - 1]
+	if last - first == indices.len - 1 {
+		mut contiguous := true
+		for i, idx in indices {
+			if idx != first + i {
+				contiguous = false
+				break
+			}
+		}
+		if contiguous {
+			hash = data_grid_fnv64_u64(hash, u64(first))
+			return data_grid_fnv64_byte(hash, 0x1d)
+		}
+	}
+	for idx in indices {
+		hash = data_grid_fnv64_u64(hash, u64(idx))
+		hash = data_grid_fnv64_byte(hash, 0x1f)
+	}
+	return hash
+}
+
 fn data_grid_presentation_value_cols(group_cols []string, aggregates []GridAggregateCfg) []string {
 	mut cols := []string{cap: group_cols.len + aggregates.len}
 	mut seen := map[string]bool{}
@@ -718,10 +793,10 @@ fn data_grid_presentation_rows(cfg DataGridCfg, columns []GridColumnCfg, row_ind
 		map[string]int{}
 	}
 	return data_grid_presentation_rows_with_group_ranges(cfg, columns, visible_indices, group_cols,
-		group_ranges)
+		group_ranges, DataGridAggregateIndex{})
 }
 
-fn data_grid_presentation_rows_with_group_ranges(cfg DataGridCfg, columns []GridColumnCfg, visible_indices []int, group_cols []string, group_ranges map[string]int) DataGridPresentation {
+fn data_grid_presentation_rows_with_group_ranges(cfg DataGridCfg, columns []GridColumnCfg, visible_indices []int, group_cols []string, group_ranges map[string]int, aggregates DataGridAggregateIndex) DataGridPresentation {
 	mut rows := []DataGridDisplayRow{cap: cfg.rows.len + 8}
 	mut data_to_display := map[int]int{}
 	if group_cols.len == 0 || visible_indices.len == 0 {
@@ -782,7 +857,8 @@ fn data_grid_presentation_rows_with_group_ranges(cfg DataGridCfg, columns []Grid
 					group_col_title: group_titles[col_id] or { col_id }
 					group_depth:     depth
 					group_count:     count
-					aggregate_text:  data_grid_group_aggregate_text(cfg, row_idx, range_end)
+					aggregate_text:  data_grid_group_aggregate_text(cfg, aggregates, row_idx,
+						range_end)
 				}
 			}
 		}
@@ -905,13 +981,19 @@ fn data_grid_group_ranges(rows []GridRow, indices []int, group_cols []string) ma
 	return ranges
 }
 
-fn data_grid_group_aggregate_text(cfg DataGridCfg, start_idx int, end_idx int) string {
+// aggregates answers parsed-column aggregates when it covers cfg.rows;
+// anything else is computed by scanning the range.
+fn data_grid_group_aggregate_text(cfg DataGridCfg, aggregates DataGridAggregateIndex, start_idx int, end_idx int) string {
 	if cfg.aggregates.len == 0 || start_idx < 0 || end_idx < start_idx || end_idx >= cfg.rows.len {
 		return ''
 	}
 	mut parts := []string{cap: cfg.aggregates.len}
 	for agg in cfg.aggregates {
-		value := data_grid_aggregate_value(cfg.rows, start_idx, end_idx, agg) or { continue }
+		value := if aggregates.covers(agg) {
+			aggregates.aggregate_value(start_idx, end_idx, agg) or { continue }
+		} else {
+			data_grid_aggregate_value(cfg.rows, start_idx, end_idx, agg) or { continue }
+		}
 		parts << '${data_grid_aggregate_label(agg)}: ${value}'
 	}
 	return parts.join('  ')
@@ -1080,7 +1162,7 @@ fn data_grid_row_height(cfg DataGridCfg, mut window Window) f32 {
 	if cfg.row_height > 0 {
 		return cfg.row_height
 	}
-	font_h := window.text_system.font_height(cfg.text_style.to_vglyph_cfg()) or {
+	font_h := window.text_font_height(cfg.text_style.to_vglyph_cfg()) or {
 		cfg.text_style.size
 	}
 	return font_h + cfg.padding_cell.height() + cfg.size_border
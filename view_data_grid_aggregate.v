@@ -0,0 +1,301 @@
+// Data grid: incrementally maintained group aggregates.
+module gui
+
+import math
+
+// Group headers used to re-parse every cell of their group for each
+// aggregate whenever the presentation cache missed. Per grid, a
+// DataGridAggregateIndex now keeps each aggregated column parsed into
+// segment trees of sums, counts, minimums and maximums:
+// - a group aggregate is an O(log n) range query instead of a scan
+// - a nonzero cfg.rows_version that matches the last sync skips the
+//   sync; only unversioned rows are compared cell by cell
+// - when the rows change but keep their length (edits, live updates),
+//   only cells whose text changed are re-parsed, each an O(log n)
+//   update that touches just the tree nodes above it
+// - inserts and deletes are matched by row id: rows before and after
+//   the change keep their parsed leaves, only the rows in between are
+//   parsed, and the nodes above are recomputed without parsing
+// - rows that share no leading or trailing ids (a new filter or sort)
+//   rebuild the trees
+// Only non-count aggregates use the index; count is the range size.
+
+// DataGridAggregateColumn is one aggregated column. Trees are stored
+// bottom-up: leaves at size .. size + len, node i covers 2i and 2i+1.
+struct DataGridAggregateColumn {
+mut:
+	col_id string
+	raw    []string // cell text per row, to detect changes
+	size   int      // leaf count, a power of two
+	sums   []f64
+	counts []u32 // parsed values per node
+	mins   []f64
+	maxs   []f64
+}
+
+// DataGridAggregateIndex stores per-grid aggregate trees.
+struct DataGridAggregateIndex {
+mut:
+	len          int
+	rows_version u64      // cfg.rows_version at the last sync; 0 when unversioned
+	ids          []string // row id per row, to match inserts and deletes
+	columns      []DataGridAggregateColumn
+	rebuilds     u64 // full rebuilds
+	splices      u64 // length changes that kept the rows around them
+	reparsed     u64 // cells re-parsed in place
+}
+
+// data_grid_aggregate_col_ids returns the distinct columns the
+// aggregates parse, sorted.
+fn data_grid_aggregate_col_ids(aggregates []GridAggregateCfg) []string {
+	mut cols := []string{}
+	for agg in aggregates {
+		if agg.op == .count || agg.col_id.len == 0 || agg.col_id in cols {
+			continue
+		}
+		cols << agg.col_id
+	}
+	cols.sort()
+	return cols
+}
+
+// sync brings the index up to date with rows. rows_version is
+// cfg.rows_version; 0 means the rows must be compared.
+fn (mut index DataGridAggregateIndex) sync(rows []GridRow, col_ids []string, rows_version u64) {
+	if index.columns.len != col_ids.len || index.columns.map(it.col_id) != col_ids {
+		index.rebuild(rows, col_ids, rows_version)
+		return
+	}
+	if rows_version != 0 && rows_version == index.rows_version && rows.len == index.len {
+		return
+	}
+	if index.len == rows.len {
+		index.rows_version = rows_version
+		for i, row in rows {
+			index.ids[i] = row.id
+		}
+		for mut column in index.columns {
+			for i, row in rows {
+				raw := row.cells[column.col_id] or { '' }
+				if raw != column.raw[i] {
+					column.set(i, raw)
+					index.reparsed++
+				}
+			}
+		}
+		return
+	}
+	// Rows were inserted or deleted: keep the ids shared at both ends.
+	shared := math.min(index.len, rows.len)
+	mut prefix := 0
+	for prefix < shared && rows[prefix].id == index.ids[prefix] {
+		prefix++
+	}
+	mut suffix := 0
+	for suffix < shared - prefix
+		&& rows[rows.len - 1 - suffix].id == index.ids[index.len - 1 - suffix] {
+		suffix++
+	}
+	if prefix + suffix == 0 {
+		index.rebuild(rows, col_ids, rows_version)
+		return
+	}
+	for i, column in index.columns {
+		next, reparsed := column.splice(rows, index.len, prefix, suffix)
+		index.columns[i] = next
+		index.reparsed += reparsed
+	}
+	index.len = rows.len
+	index.rows_version = rows_version
+	index.ids = rows.map(it.id)
+	index.splices++
+}
+
+fn (mut index DataGridAggregateIndex) rebuild(rows []GridRow, col_ids []string, rows_version u64) {
+	index.len = rows.len
+	index.rows_version = rows_version
+	index.ids = rows.map(it.id)
+	index.columns = col_ids.map(data_grid_aggregate_column(rows, it))
+	index.rebuilds++
+}
+
+fn data_grid_aggregate_empty_column(col_id string, len int) DataGridAggregateColumn {
+	mut size := 1
+	for size < len {
+		size *= 2
+	}
+	return DataGridAggregateColumn{
+		col_id: col_id
+		raw:    []string{cap: len}
+		size:   size
+		sums:   []f64{len: 2 * size}
+		counts: []u32{len: 2 * size}
+		mins:   []f64{len: 2 * size, init: math.inf(1)}
+		maxs:   []f64{len: 2 * size, init: math.inf(-1)}
+	}
+}
+
+fn data_grid_aggregate_column(rows []GridRow, col_id string) DataGridAggregateColumn {
+	mut column := data_grid_aggregate_empty_column(col_id, rows.len)
+	size := column.size
+	for i, row in rows {
+		raw := row.cells[col_id] or { '' }
+		column.raw << raw
+		column.set_leaf(i, raw)
+	}
+	for node := size - 1; node >= 1; node-- {
+		column.pull(node)
+	}
+	return column
+}
+
+// splice builds the column for rows from this one, which was built
+// for old_len rows sharing the first prefix and last suffix rows.
+// Shared rows whose text is unchanged copy their leaf; the rest are
+// parsed. Returns the new column and the number of cells parsed.
+@[direct_array_access]
+fn (column &DataGridAggregateColumn) splice(rows []GridRow, old_len int, prefix int, suffix int) (DataGridAggregateColumn, u64) {
+	mut next := data_grid_aggregate_empty_column(column.col_id, rows.len)
+	mut parsed := u64(0)
+	for i, row in rows {
+		raw := row.cells[column.col_id] or { '' }
+		next.raw << raw
+		old := if i < prefix {
+			i
+		} else if i >= rows.len - suffix {
+			i - rows.len + old_len
+		} else {
+			-1
+		}
+		if old >= 0 && column.raw[old] == raw {
+			from := column.size + old
+			to := next.size + i
+			next.sums[to] = column.sums[from]
+			next.counts[to] = column.counts[from]
+			next.mins[to] = column.mins[from]
+			next.maxs[to] = column.maxs[from]
+		} else {
+			next.set_leaf(i, raw)
+			parsed++
+		}
+	}
+	for node := next.size - 1; node >= 1; node-- {
+		next.pull(node)
+	}
+	return next, parsed
+}
+
+// set_leaf stores the parsed value of row i without updating parents.
+fn (mut column DataGridAggregateColumn) set_leaf(i int, raw string) {
+	leaf := column.size + i
+	if value := data_grid_parse_number(raw) {
+		column.sums[leaf] = value
+		column.counts[leaf] = 1
+		column.mins[leaf] = value
+		column.maxs[leaf] = value
+	} else {
+		column.sums[leaf] = 0
+		column.counts[leaf] = 0
+		column.mins[leaf] = math.inf(1)
+		column.maxs[leaf] = math.inf(-1)
+	}
+}
+
+// pull recomputes node from its children. Nodes are recomputed, not
+// adjusted by deltas, so repeated edits do not accumulate error.
+@[direct_array_access]
+fn (mut column DataGridAggregateColumn) pull(node int) {
+	l := 2 * node
+	r := l + 1
+	column.sums[node] = column.sums[l] + column.sums[r]
+	column.counts[node] = column.counts[l] + column.counts[r]
+	column.mins[node] = math.min(column.mins[l], column.mins[r])
+	column.maxs[node] = math.max(column.maxs[l], column.maxs[r])
+}
+
+// set re-parses row i and updates the nodes above it.
+fn (mut column DataGridAggregateColumn) set(i int, raw string) {
+	column.raw[i] = raw
+	column.set_leaf(i, raw)
+	mut node := (column.size + i) / 2
+	for node >= 1 {
+		column.pull(node)
+		node /= 2
+	}
+}
+
+// value aggregates rows start_idx..end_idx inclusive, or none when no
+// cell in the range is numeric. Matches data_grid_aggregate_value.
+@[direct_array_access]
+fn (column &DataGridAggregateColumn) value(start_idx int, end_idx int, op GridAggregateOp) ?f64 {
+	mut sum := f64(0)
+	mut count := u32(0)
+	mut lo := math.inf(1)
+	mut hi := math.inf(-1)
+	mut l := column.size + start_idx
+	mut r := column.size + end_idx + 1
+	for l < r {
+		if l & 1 == 1 {
+			sum += column.sums[l]
+			count += column.counts[l]
+			lo = math.min(lo, column.mins[l])
+			hi = math.max(hi, column.maxs[l])
+			l++
+		}
+		if r & 1 == 1 {
+			r--
+			sum += column.sums[r]
+			count += column.counts[r]
+			lo = math.min(lo, column.mins[r])
+			hi = math.max(hi, column.maxs[r])
+		}
+		l /= 2
+		r /= 2
+	}
+	if count == 0 {
+		return none
+	}
+	return match op {
+		.sum { sum }
+		.avg { sum / f64(count) }
+		.min { lo }
+		.max { hi }
+		.count { f64(count) }
+	}
+}
+
+// covers reports whether aggregate_value can answer agg.
+fn (index &DataGridAggregateIndex) covers(agg GridAggregateCfg) bool {
+	return agg.op != .count && index.columns.any(it.col_id == agg.col_id)
+}
+
+// aggregate_value is data_grid_aggregate_value answered from the
+// index. The caller checked covers(agg).
+fn (index &DataGridAggregateIndex) aggregate_value(start_idx int, end_idx int, agg GridAggregateCfg) ?string {
+	if start_idx < 0 || end_idx >= index.len {
+		return none
+	}
+	for column in index.columns {
+		if column.col_id == agg.col_id {
+			value := column.value(start_idx, end_idx, agg.op) or { return none }
+			return data_grid_format_number(value)
+		}
+	}
+	return none
+}
+
+// data_grid_synced_aggregate_index returns the grid's aggregate index,
+// synced with cfg.rows, or an empty index when no aggregate parses
+// cells.
+fn data_grid_synced_aggregate_index(cfg DataGridCfg, mut window Window) DataGridAggregateIndex {
+	col_ids := data_grid_aggregate_col_ids(cfg.aggregates)
+	if col_ids.len == 0 {
+		return DataGridAggregateIndex{}
+	}
+	mut dg_agg := state_map[string, DataGridAggregateIndex](mut window, ns_dg_aggregate,
+		cap_moderate)
+	mut index := dg_agg.get(cfg.id) or { DataGridAggregateIndex{} }
+	index.sync(cfg.rows, col_ids, cfg.rows_version)
+	dg_agg.set(cfg.id, index)
+	return index
+}
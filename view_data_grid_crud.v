@@ -76,8 +76,9 @@ fn data_grid_rows_id_signature(rows []GridRow) u64 {
 
 // CRUD uses a working copy of rows. When no unsaved changes
 // exist and the source signature changes, the working copy
-// resets to match the new source data. Signature is an
-// FNV-1a hash of all row ids + cell values.
+// resets to match the new source data. Signature is the
+// rows version when one is supplied, else an FNV-1a hash of
+// all row ids + cell values.
 fn data_grid_crud_resolve_cfg(cfg DataGridCfg, mut window Window) (DataGridCfg, DataGridCrudState) {
 	mut state := state_map[string, DataGridCrudState](mut window, ns_dg_crud, cap_moderate).get(cfg.id) or {
 		DataGridCrudState{}
@@ -87,11 +88,17 @@ fn data_grid_crud_resolve_cfg(cfg DataGridCfg, mut window Window) (DataGridCfg,
 	// recompute when row count and row-id signature are
 	// unchanged.
 	mut signature := u64(0)
+	state.rows_versioned = cfg.rows_version != 0
 	if src_state := state_map[string, DataGridSourceState](mut window, ns_dg_source, cap_moderate).get(cfg.id) {
 		signature = src_state.rows_signature
 		state.local_rows_signature_valid = false
 		state.local_rows_len = -1
 		state.local_rows_id_signature = 0
+	} else if state.rows_versioned {
+		signature = data_grid_fnv64_u64(data_grid_fnv64_offset, cfg.rows_version)
+		state.local_rows_signature_valid = false
+		state.local_rows_len = -1
+		state.local_rows_id_signature = 0
 	} else {
 		local_len := cfg.rows.len
 		local_id_signature := data_grid_rows_id_signature(cfg.rows)
@@ -122,11 +129,14 @@ fn data_grid_crud_resolve_cfg(cfg DataGridCfg, mut window Window) (DataGridCfg,
 	if state.save_error.len > 0 {
 		load_error = state.save_error
 	}
+	// Staged edits are not covered by the version; hash them.
+	rows_version := if data_grid_crud_has_unsaved(state) { u64(0) } else { cfg.rows_version }
 	return DataGridCfg{
 		...cfg
-		rows:       state.working_rows.clone()
-		load_error: load_error
-		loading:    cfg.loading || state.saving
+		rows:         state.working_rows.clone()
+		rows_version: rows_version
+		load_error:   load_error
+		loading:      cfg.loading || state.saving
 	}, state
 }
 
@@ -588,17 +598,19 @@ fn data_grid_crud_save(ctx DataGridCrudSaveContext, mut e Event, mut w Window) {
 		focus_id := ctx.focus_id
 		w.pin_layout_callback_reclaim() or { panic(err) }
 		w.suspend_layout_callback_tracking(fn [mut source, grid_id, query, create_rows, update_rows, update_edits, delete_ids, snapshot_rows, on_crud_error, on_rows_change, selection, on_selection_change, focus_id, mut w] () {
-			spawn fn [mut source, grid_id, query, create_rows, update_rows, update_edits, delete_ids, snapshot_rows, on_crud_error, on_rows_change, selection, on_selection_change, focus_id] (mut w Window) {
-				result := data_grid_crud_exec_mutations(mut source, grid_id, query, create_rows,
-					update_rows, update_edits, delete_ids)
-				w.queue_command(fn [grid_id, result, snapshot_rows, on_crud_error, on_rows_change, selection, on_selection_change, focus_id] (mut w Window) {
-					defer {
-						w.release_layout_callback_reclaim_pin()
-					}
-					data_grid_crud_apply_save_result(grid_id, result, snapshot_rows, on_crud_error,
-						on_rows_change, selection, on_selection_change, focus_id, mut w)
-				})
-			}(mut w)
+			w.submit_work(WorkItem{
+				run: fn [mut source, grid_id, query, create_rows, update_rows, update_edits, delete_ids, snapshot_rows, on_crud_error, on_rows_change, selection, on_selection_change, focus_id] (mut w Window) {
+					result := data_grid_crud_exec_mutations(mut source, grid_id, query, create_rows,
+						update_rows, update_edits, delete_ids)
+					w.queue_command(fn [grid_id, result, snapshot_rows, on_crud_error, on_rows_change, selection, on_selection_change, focus_id] (mut w Window) {
+						defer {
+							w.release_layout_callback_reclaim_pin()
+						}
+						data_grid_crud_apply_save_result(grid_id, result, snapshot_rows, on_crud_error,
+							on_rows_change, selection, on_selection_change, focus_id, mut w)
+					})
+				}
+			})
 		}) or {
 			w.release_layout_callback_reclaim_pin()
 			panic(err)
@@ -612,7 +624,7 @@ fn data_grid_crud_save(ctx DataGridCrudSaveContext, mut e Event, mut w Window) {
 }
 
 // Executes create/update/delete mutations sequentially on a
-// spawned thread. Returns a result struct for main-thread
+// worker pool thread. Returns a result struct for main-thread
 // application via queue_command.
 fn data_grid_crud_exec_mutations(mut source DataGridDataSource, grid_id string, query GridQueryState, create_rows []GridRow, update_rows []GridRow, update_edits []GridCellEdit, delete_ids []string) DataGridCrudMutationResult {
 	mut row_count := ?int(none)
@@ -716,7 +728,12 @@ fn data_grid_crud_finish_save(grid_id string, _ map[string]string, row_count ?in
 	state.deleted_row_ids = map[string]bool{}
 	state.saving = false
 	state.save_error = ''
-	state.source_signature = data_grid_rows_signature(state.committed_rows, []string{})
+	// Versioned rows resync from cfg.rows on the next frame.
+	state.source_signature = if state.rows_versioned {
+		u64(0)
+	} else {
+		data_grid_rows_signature(state.committed_rows, []string{})
+	}
 	mut dg_crud := state_map[string, DataGridCrudState](mut w, ns_dg_crud, cap_moderate)
 	dg_crud.set(grid_id, state)
 	data_grid_clear_editing_row(grid_id, mut w)
@@ -752,7 +769,12 @@ fn data_grid_crud_restore_on_error(grid_id string, phase string, on_crud_error f
 	state.deleted_row_ids = map[string]bool{}
 	state.saving = false
 	state.save_error = if phase.len > 0 { '${phase}: ${err_msg}' } else { err_msg }
-	state.source_signature = data_grid_rows_signature(state.committed_rows, []string{})
+	// Versioned rows resync from cfg.rows on the next frame.
+	state.source_signature = if state.rows_versioned {
+		u64(0)
+	} else {
+		data_grid_rows_signature(state.committed_rows, []string{})
+	}
 	mut dg_crud := state_map[string, DataGridCrudState](mut w, ns_dg_crud, cap_moderate)
 	dg_crud.set(grid_id, state)
 	data_grid_clear_editing_row(grid_id, mut w)
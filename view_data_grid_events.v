@@ -576,6 +576,10 @@ fn make_data_grid_on_mouse_move(grid_id string) fn (&Layout, mut Event, mut Wind
 		mouse_y := layout.shape.y + e.mouse_y
 		col_id := data_grid_header_col_under_cursor(layout, grid_id, mouse_x, mouse_y)
 		mut dg_hh := state_map[string, string](mut w, ns_dg_header_hover, cap_moderate)
+		prev_col_id := dg_hh.get(grid_id) or { '' }
+		if prev_col_id != col_id {
+			w.set_event_refresh(.layout)
+		}
 		if col_id.len == 0 {
 			dg_hh.delete(grid_id)
 			return
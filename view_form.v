@@ -607,35 +607,41 @@ fn (mut w Window) form_on_field_event_for_form(form_id string, cfg FormFieldAdap
 		field_id := cfg.field_id
 		w.pin_layout_callback_reclaim() or { panic(err) }
 		w.suspend_layout_callback_tracking(fn [validators, field_snapshot, snapshot, signal, form_id, field_id, request_id, mut w] () {
-			spawn fn [validators, field_snapshot, snapshot, signal, form_id, field_id, request_id] (mut win Window) {
-				mut issues := []FormIssue{}
-				for validator in validators {
+			w.submit_work(WorkItem{
+				signal:    signal
+				on_cancel: fn (mut win Window) {
+					win.form_queue_async_validation_pin_release()
+				}
+				run:       fn [validators, field_snapshot, snapshot, signal, form_id, field_id, request_id] (mut win Window) {
+					mut issues := []FormIssue{}
+					for validator in validators {
+						if signal.is_aborted() {
+							win.form_queue_async_validation_pin_release()
+							return
+						}
+						result := validator(field_snapshot, snapshot, signal) or {
+							log.error('form async validator failed for form_id=${form_id} field_id=${field_id}: ${err.msg()}')
+							issues << FormIssue{
+								code: 'async_error'
+								msg:  form_async_issue_msg
+								kind: .error
+							}
+							continue
+						}
+						if result.len > 0 {
+							issues << result
+						}
+					}
 					if signal.is_aborted() {
 						win.form_queue_async_validation_pin_release()
 						return
 					}
-					result := validator(field_snapshot, snapshot, signal) or {
-						log.error('form async validator failed for form_id=${form_id} field_id=${field_id}: ${err.msg()}')
-						issues << FormIssue{
-							code: 'async_error'
-							msg:  form_async_issue_msg
-							kind: .error
-						}
-						continue
-					}
-					if result.len > 0 {
-						issues << result
-					}
-				}
-				if signal.is_aborted() {
-					win.form_queue_async_validation_pin_release()
-					return
+					win.queue_command(fn [form_id, field_id, request_id, issues] (mut win Window) {
+						win.form_apply_async_result(form_id, field_id, request_id, issues)
+						win.release_layout_callback_reclaim_pin()
+					})
 				}
-				win.queue_command(fn [form_id, field_id, request_id, issues] (mut win Window) {
-					win.form_apply_async_result(form_id, field_id, request_id, issues)
-					win.release_layout_callback_reclaim_pin()
-				})
-			}(mut w)
+			})
 		}) or {
 			w.release_layout_callback_reclaim_pin()
 			panic(err)
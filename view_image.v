@@ -58,16 +58,17 @@ fn (mut iv ImageView) generate_layout(mut window Window) Layout {
 			mut downloads := state_map[string, i64](mut window, ns_active_downloads, cap_moderate)
 			if !downloads.contains(iv.src) {
 				downloads.set(iv.src, time.now().unix())
-				// Resolve optional auth header at dispatch time (main thread)
-				auth_header := if f := window.view_state.image_auth_header_fn {
-					f(iv.src)
+				image_url := iv.src
+				if window.on_layout_thread() {
+					// Keep the auth callback on the main thread.
+					window.queue_command(fn [image_url, base_path] (mut w Window) {
+						dispatch_image_download(image_url, base_path, mut w)
+					})
 				} else {
-					''
+					window.suspend_layout_callback_tracking(fn [image_url, base_path, mut window] () {
+						dispatch_image_download(image_url, base_path, mut window)
+					}) or { panic(err) }
 				}
-				image_url := iv.src
-				window.suspend_layout_callback_tracking(fn [image_url, base_path, auth_header, mut window] () {
-					spawn download_image(image_url, base_path, auth_header, mut window)
-				}) or { panic(err) }
 			}
 			mut layout := Layout{
 				shape: &Shape{
@@ -83,20 +84,26 @@ fn (mut iv ImageView) generate_layout(mut window Window) Layout {
 		}
 	}
 
-	loaded_image := window.load_image(image_path) or {
-		log.error('${@FILE_LINE} > ${err.msg()}')
-		mut error_text := text(
-			text:       '[missing: ${iv.src}]'
-			text_style: TextStyle{
-				...gui_theme.text_style
-				color: magenta
-			}
-		)
-		return error_text.generate_layout(mut window)
+	// Only the size is needed here; pixels decode in the background when
+	// the image is first rendered (see render_image).
+	src_w, src_h := if iv.width > 0 && iv.height > 0 {
+		0, 0
+	} else {
+		window.image_source_size(image_path) or {
+			log.error('${@FILE_LINE} > ${err.msg()}')
+			mut error_text := text(
+				text:       '[missing: ${iv.src}]'
+				text_style: TextStyle{
+					...gui_theme.text_style
+					color: magenta
+				}
+			)
+			return error_text.generate_layout(mut window)
+		}
 	}
 
-	width := if iv.width > 0 { iv.width } else { loaded_image.width }
-	height := if iv.height > 0 { iv.height } else { loaded_image.height }
+	width := if iv.width > 0 { iv.width } else { f32(src_w) }
+	height := if iv.height > 0 { iv.height } else { f32(src_h) }
 
 	mut events := unsafe { &EventHandlers(nil) }
 	if iv.on_click != unsafe { nil } || iv.on_hover != unsafe { nil } {
@@ -126,6 +133,20 @@ fn (mut iv ImageView) generate_layout(mut window Window) Layout {
 	return layout
 }
 
+const image_download_timeout = 30 * time.second // per request read or write; images can be large
+const image_download_max_running = 4 // fetch threads at once; the rest wait in order
+
+// dispatch_image_download resolves the optional auth header and starts
+// the download. Runs on the main thread.
+fn dispatch_image_download(url string, base_path string, mut w Window) {
+	auth_header := if f := w.view_state.image_auth_header_fn {
+		f(url)
+	} else {
+		''
+	}
+	download_image(url, base_path, auth_header, mut w)
+}
+
 struct ImageFetchResult {
 	err_msg string
 	is_err  bool
@@ -135,129 +156,112 @@ struct ImageFetchResult {
 // base_path has no extension; extension is determined from
 // Content-Type header. Validates size (<50MB) and type (image/*).
 // auth_header, when non-empty, is sent as the Authorization header.
+// Downloads wait on the network, so they run on the window's
+// image_downloads fetch queue rather than the worker pool, at most
+// image_download_max_running at once. Runs on the main thread.
 fn download_image(url string, base_path string, auth_header string, mut w Window) {
-	spawn fn [url, base_path, auth_header, mut w] () {
-		ch := chan ImageFetchResult{}
-
-		spawn fn [url, base_path, auth_header, ch] () {
-			max_size := i64(50 * 1024 * 1024)
-
-			// Use a request with optional auth so restricted images (e.g.
-			// Zulip /user_uploads/) are accessible.
-			mut head_req := http.Request{
-				method: .head
-				url:    url
-			}
-			if auth_header.len > 0 {
-				head_req.add_header(.authorization, auth_header)
-			}
-			head := head_req.do() or {
-				ch <- ImageFetchResult{
-					err_msg: 'Failed to fetch image headers for ${url}: ${err}'
-					is_err:  true
-				}
-				return
-			}
-
-			// Validate content length
-			content_length := head.header.get(.content_length) or { '0' }.i64()
-			if content_length > max_size {
-				ch <- ImageFetchResult{
-					err_msg: 'Image too large (${content_length} bytes > ${max_size} bytes): ${url}'
-					is_err:  true
-				}
-				return
-			}
-
-			// Validate content type — some servers omit Content-Type on HEAD;
-			// allow an empty type and rely on the GET response below.
-			ct_head := head.header.get(.content_type) or { '' }
-			if ct_head.len > 0 && !ct_head.starts_with('image/') {
-				ch <- ImageFetchResult{
-					err_msg: 'Invalid content type for image (expected image/*): ${url}'
-					is_err:  true
-				}
-				return
-			}
-
-			// Download file using a GET request with optional auth
-			mut get_req := http.Request{
-				method: .get
-				url:    url
-			}
-			if auth_header.len > 0 {
-				get_req.add_header(.authorization, auth_header)
-			}
-			resp := get_req.do() or {
-				ch <- ImageFetchResult{
-					err_msg: 'Failed to download image ${url}: ${err}'
-					is_err:  true
-				}
-				return
-			}
-			if resp.status_code != 200 {
-				ch <- ImageFetchResult{
-					err_msg: 'Image download returned HTTP ${resp.status_code}: ${url}'
-					is_err:  true
-				}
-				return
+	fetch_queue_push(w.image_downloads, fn [url, base_path, auth_header] (mut w Window) {
+		fetch_res := download_image_fetch(url, base_path, auth_header)
+		if fetch_res.is_err {
+			log.error(fetch_res.err_msg)
+		}
+		ok := !fetch_res.is_err
+		w.queue_command(fn [url, ok] (mut w Window) {
+			// Remove from active downloads
+			mut dl := state_map[string, i64](mut w, ns_active_downloads, cap_moderate)
+			dl.delete(url)
+			if ok {
+				w.update_window()
 			}
+		})
+	}, mut w)
+}
 
-			// Determine extension from Content-Type (prefer GET response)
-			ct := resp.header.get(.content_type) or { ct_head }
-			if ct.len > 0 && !ct.starts_with('image/') {
-				ch <- ImageFetchResult{
-					err_msg: 'Invalid content type for image (expected image/*): ${url}'
-					is_err:  true
-				}
-				return
-			}
+// download_image_fetch performs the blocking HEAD and GET requests and
+// writes the file. Each read and write is bounded by
+// image_download_timeout.
+fn download_image_fetch(url string, base_path string, auth_header string) ImageFetchResult {
+	max_size := i64(50 * 1024 * 1024)
 
-			path := base_path + content_type_to_ext(if ct.len > 0 { ct } else { 'image/png' })
-			os.write_file(path, resp.body) or {
-				ch <- ImageFetchResult{
-					err_msg: 'Failed to write cached image ${path}: ${err}'
-					is_err:  true
-				}
-				return
-			}
+	// Use a request with optional auth so restricted images (e.g.
+	// Zulip /user_uploads/) are accessible.
+	mut head_req := http.Request{
+		method:        .head
+		url:           url
+		read_timeout:  i64(image_download_timeout)
+		write_timeout: i64(image_download_timeout)
+	}
+	if auth_header.len > 0 {
+		head_req.add_header(.authorization, auth_header)
+	}
+	head := head_req.do() or {
+		return ImageFetchResult{
+			err_msg: 'Failed to fetch image headers for ${url}: ${err}'
+			is_err:  true
+		}
+	}
 
-			ch <- ImageFetchResult{
-				is_err: false
-			}
-		}()
+	// Validate content length
+	content_length := head.header.get(.content_length) or { '0' }.i64()
+	if content_length > max_size {
+		return ImageFetchResult{
+			err_msg: 'Image too large (${content_length} bytes > ${max_size} bytes): ${url}'
+			is_err:  true
+		}
+	}
 
-		// Wait for result with 30s timeout (images can be large)
-		mut fetch_res := ImageFetchResult{
+	// Validate content type — some servers omit Content-Type on HEAD;
+	// allow an empty type and rely on the GET response below.
+	ct_head := head.header.get(.content_type) or { '' }
+	if ct_head.len > 0 && !ct_head.starts_with('image/') {
+		return ImageFetchResult{
+			err_msg: 'Invalid content type for image (expected image/*): ${url}'
 			is_err:  true
-			err_msg: 'Image download timed out: ${url}'
 		}
+	}
 
-		select {
-			res := <-ch {
-				fetch_res = res
-			}
-			30 * time.second {
-				// use default timeout value
-			}
+	// Download file using a GET request with optional auth
+	mut get_req := http.Request{
+		method:        .get
+		url:           url
+		read_timeout:  i64(image_download_timeout)
+		write_timeout: i64(image_download_timeout)
+	}
+	if auth_header.len > 0 {
+		get_req.add_header(.authorization, auth_header)
+	}
+	resp := get_req.do() or {
+		return ImageFetchResult{
+			err_msg: 'Failed to download image ${url}: ${err}'
+			is_err:  true
+		}
+	}
+	if resp.status_code != 200 {
+		return ImageFetchResult{
+			err_msg: 'Image download returned HTTP ${resp.status_code}: ${url}'
+			is_err:  true
 		}
+	}
 
-		if fetch_res.is_err {
-			log.error(fetch_res.err_msg)
-			w.queue_command(fn [url] (mut w Window) {
-				mut dl := state_map[string, i64](mut w, ns_active_downloads, cap_moderate)
-				dl.delete(url)
-			})
-			return
+	// Determine extension from Content-Type (prefer GET response)
+	ct := resp.header.get(.content_type) or { ct_head }
+	if ct.len > 0 && !ct.starts_with('image/') {
+		return ImageFetchResult{
+			err_msg: 'Invalid content type for image (expected image/*): ${url}'
+			is_err:  true
 		}
+	}
 
-		// Remove from active downloads (thread-safe)
-		w.queue_command(fn [url] (mut w Window) {
-			mut dl := state_map[string, i64](mut w, ns_active_downloads, cap_moderate)
-			dl.delete(url)
-			w.update_window()
-		})
-	}()
+	path := base_path + content_type_to_ext(if ct.len > 0 { ct } else { 'image/png' })
+	os.write_file(path, resp.body) or {
+		return ImageFetchResult{
+			err_msg: 'Failed to write cached image ${path}: ${err}'
+			is_err:  true
+		}
+	}
+	return ImageFetchResult{
+		is_err: false
+	}
 }
 
 // content_type_to_ext maps Content-Type to file extension.
@@ -1,11 +1,18 @@
 module gui
 
 import gg
+import math
 import os
+import stbi
 
 type Image = gg.Image
 
 const valid_image_extensions = ['.png', '.jpg', '.jpeg', '.gif', '.bmp', '.webp']
+const image_cache_default_cpu_bytes = i64(128 * 1024 * 1024)
+const image_cache_default_gpu_bytes = i64(256 * 1024 * 1024)
+const image_max_mip_levels = 8
+const image_mip_key_sep = '#mip'
+const image_memory_prefix = 'mem:' // keys of images registered from pixel buffers
 
 fn validate_image_extension(file_name string) ! {
 	ext := os.file_ext(file_name).to_lower()
@@ -14,14 +21,21 @@ fn validate_image_extension(file_name string) ! {
 	}
 }
 
+fn validate_image_path(file_name string) ! {
+	if file_name.contains('..') {
+		return error('invalid image path: contains ..')
+	}
+	validate_image_extension(file_name)!
+}
+
 // load_image loads an image from disk with path validation.
 // Images are cached so calling this multiple times is performant.
 // see `remove_image_from_cache()` and `remove_image_from_cache_by_file_name`
 pub fn (mut window Window) load_image(file_name string) !&Image {
-	if file_name.contains('..') {
-		return error('invalid image path: contains ..')
+	if is_memory_image_key(file_name) {
+		return window.load_memory_image(file_name)
 	}
-	validate_image_extension(file_name)!
+	validate_image_path(file_name)!
 	return window.load_image_no_validate(file_name)
 }
 
@@ -30,18 +44,209 @@ pub fn (mut window Window) load_image(file_name string) !&Image {
 pub fn (mut window Window) load_image_no_validate(file_name string) !&Image {
 	real_path := os.real_path(file_name)
 	mut ctx := window.context()
-	return ctx.get_cached_image_by_idx(window.view_state.image_map.get(real_path) or {
-		cached_image := ctx.create_image(file_name)! // ctx.create_image caches images
-		window.view_state.image_map.set(real_path, cached_image.id, mut ctx)
-		return &cached_image
-	})
+	if id := window.view_state.image_map.get(real_path) {
+		window.view_state.image_map.touch(real_path)
+		return ctx.get_cached_image_by_idx(id)
+	}
+	cached_image := ctx.create_image(file_name)! // ctx.create_image caches images
+	window.view_state.image_dims[real_path] = [cached_image.width, cached_image.height]!
+	cpu_bytes := if cached_image.data != unsafe { nil } {
+		image_byte_size(cached_image.width, cached_image.height)
+	} else {
+		i64(0)
+	}
+	window.view_state.image_map.set_sized(real_path, cached_image.id, cpu_bytes,
+		image_byte_size(cached_image.width, cached_image.height))
+	window.release_evicted_images()
+	return &cached_image
+}
+
+// load_image_sized loads an image for display at width x height logical
+// units. Large sources are decoded once, downsampled to the smallest mip
+// level that still covers the displayed size in physical pixels, and
+// only that level is kept. Each level is cached separately, so one file
+// shown as a thumbnail and full-size keeps two textures.
+pub fn (mut window Window) load_image_sized(file_name string, width f32, height f32) !&Image {
+	if is_memory_image_key(file_name) {
+		return window.load_memory_image(file_name)
+	}
+	validate_image_path(file_name)!
+	return window.load_image_sized_no_validate(file_name, width, height)
+}
+
+// load_image_sized_no_validate is load_image_sized without path validation.
+pub fn (mut window Window) load_image_sized_no_validate(file_name string, width f32, height f32) !&Image {
+	real_path := os.real_path(file_name)
+	scale := if window.ui.scale > 0 { window.ui.scale } else { f32(1) }
+	target_w := int(math.ceil(f64(width * scale)))
+	target_h := int(math.ceil(f64(height * scale)))
+	if target_w <= 0 || target_h <= 0 {
+		return window.load_image_no_validate(file_name)
+	}
+	mut ctx := window.context()
+	if dims := window.view_state.image_dims[real_path] {
+		level := image_mip_level(dims[0], dims[1], target_w, target_h)
+		if level == 0 {
+			return window.load_image_no_validate(file_name)
+		}
+		key := image_mip_key(real_path, level)
+		if id := window.view_state.image_map.get(key) {
+			window.view_state.image_map.touch(key)
+			return ctx.get_cached_image_by_idx(id)
+		}
+	} else if id := window.view_state.image_map.get(real_path) {
+		window.view_state.image_map.touch(real_path)
+		return ctx.get_cached_image_by_idx(id)
+	}
+	src := stbi.load(real_path)!
+	defer {
+		src.free()
+	}
+	window.view_state.image_dims[real_path] = [src.width, src.height]!
+	level := image_mip_level(src.width, src.height, target_w, target_h)
+	if level == 0 {
+		return window.cache_rgba_image(real_path, src.width, src.height, src.data)
+	}
+	mip_w, mip_h := image_mip_size(src.width, src.height, level)
+	mip := stbi.resize_uint8(&src, mip_w, mip_h)!
+	defer {
+		mip.free()
+	}
+	return window.cache_rgba_image(image_mip_key(real_path, level), mip.width, mip.height,
+		mip.data)
+}
+
+// cache_rgba_image uploads width x height RGBA pixels as a cached
+// texture under key. The caller keeps ownership of data; a CPU copy is
+// retained only for images small enough for the texture atlas.
+fn (mut window Window) cache_rgba_image(key string, width int, height int, data voidptr) !&Image {
+	if width <= 0 || height <= 0 || data == unsafe { nil } {
+		return error('invalid image buffer for ${key}')
+	}
+	byte_len := image_byte_size(width, height)
+	keep_cpu := width <= image_atlas_max_dim && height <= image_atlas_max_dim
+	mut img := gg.Image{
+		width:       width
+		height:      height
+		nr_channels: 4
+		ok:          true
+		data:        data
+		ext:         'png'
+		path:        key
+	}
+	img.init_sokol_image()
+	// init_sokol_image uploads immediately; data is not needed after it
+	// returns unless the atlas may copy from it later.
+	if keep_cpu {
+		pixels := unsafe { malloc(int(byte_len)) }
+		unsafe { vmemcpy(pixels, data, int(byte_len)) }
+		img.data = pixels
+	} else {
+		img.data = unsafe { nil }
+	}
+	mut ctx := window.context()
+	id := ctx.cache_image(img)
+	window.view_state.image_map.set_sized(key, id, if keep_cpu { byte_len } else { i64(0) },
+		byte_len)
+	window.release_evicted_images()
+	return ctx.get_cached_image_by_idx(id)
 }
 
-// remove_image_from_cache removes the given image from cache.
+// register_image_pixels caches width x height RGBA pixels that were
+// decoded in memory and returns a key usable as an image `src` or with
+// load_image. The image shares the byte budget and LRU eviction of
+// file images; once evicted the key no longer loads, so the caller must
+// be able to regenerate the pixels. The caller keeps ownership of data.
+pub fn (mut window Window) register_image_pixels(name string, width int, height int, data voidptr) !string {
+	key := image_memory_prefix + name
+	window.cache_rgba_image(key, width, height, data)!
+	window.view_state.image_dims[key] = [width, height]!
+	return key
+}
+
+@[inline]
+fn is_memory_image_key(file_name string) bool {
+	return file_name.starts_with(image_memory_prefix)
+}
+
+// load_memory_image returns an image added with register_image_pixels.
+fn (mut window Window) load_memory_image(key string) !&Image {
+	mut ctx := window.context()
+	if id := window.view_state.image_map.get(key) {
+		window.view_state.image_map.touch(key)
+		return ctx.get_cached_image_by_idx(id)
+	}
+	return error('image not in cache: ${key}')
+}
+
+// remove_memory_image releases an image added with register_image_pixels.
+// The texture is destroyed by the next renderer build, since the
+// presented renderers may still draw it.
+fn (mut window Window) remove_memory_image(key string) {
+	window.view_state.image_dims.delete(key)
+	image_idx := window.view_state.image_map.get(key) or { return }
+	window.view_state.image_map.delete(key)
+	window.view_state.image_atlas.remove(image_idx)
+	window.view_state.image_map.release << image_idx
+}
+
+// set_image_cache_budget limits decoded image memory. cpu_bytes bounds
+// pixel copies kept in RAM, gpu_bytes bounds texture memory. Least
+// recently used images are released when either budget is exceeded.
+// Values <= 0 keep the current limit.
+pub fn (mut window Window) set_image_cache_budget(cpu_bytes i64, gpu_bytes i64) {
+	if cpu_bytes > 0 {
+		window.view_state.image_map.max_cpu_bytes = cpu_bytes
+	}
+	if gpu_bytes > 0 {
+		window.view_state.image_map.max_gpu_bytes = gpu_bytes
+	}
+	window.view_state.image_map.enforce_budget('')
+	window.release_evicted_images()
+}
+
+// release_evicted_images drops atlas slots that referenced images the
+// cache just evicted, and diagrams whose in-memory image was evicted
+// so the next view rebuild fetches them again. The textures themselves
+// are destroyed later, by release_evicted_textures.
+fn (mut window Window) release_evicted_images() {
+	if window.view_state.image_map.evicted.len == 0 {
+		return
+	}
+	for id in window.view_state.image_map.evicted {
+		window.view_state.image_atlas.remove(id)
+	}
+	array_clear(mut window.view_state.image_map.evicted)
+	for hash in window.view_state.diagram_cache.order.clone() {
+		entry := window.view_state.diagram_cache.get(hash) or { continue }
+		if entry.image_key.len > 0 && !window.view_state.image_map.contains(entry.image_key) {
+			window.view_state.image_dims.delete(entry.image_key)
+			window.view_state.diagram_cache.delete(hash)
+		}
+	}
+}
+
+// release_evicted_textures destroys textures the cache evicted, and
+// textures removed or cleared, before the renderer build that is
+// starting. Eviction can happen while
+// renderers are built, after an earlier renderer of the same list
+// already drew the texture, and a presented list is redrawn until the
+// next build replaces it. Called at the start of build_renderers, once
+// the list that may reference them is discarded.
+fn (mut window Window) release_evicted_textures() {
+	if window.view_state.image_map.release.len == 0 {
+		return
+	}
+	mut ctx := window.context()
+	window.stats.add_textures_released(window.view_state.image_map.release_textures(mut ctx))
+}
+
+// remove_image_from_cache removes the given image from cache. The
+// texture is destroyed by the next renderer build.
 // Does nothing if not in cache.
 pub fn (mut window Window) remove_image_from_cache(image &Image) {
-	mut ctx := window.context()
-	ctx.remove_cached_image_by_idx(image.id)
+	window.view_state.image_map.release << image.id
+	window.view_state.image_atlas.remove(image.id)
 	for key in window.view_state.image_map.keys() {
 		if value := window.view_state.image_map.get(key) {
 			if value == image.id {
@@ -52,49 +257,172 @@ pub fn (mut window Window) remove_image_from_cache(image &Image) {
 	}
 }
 
-// remove_image_from_cache_by_file_name removes a previously cached image.
-// Does nothing if not in cache.
+// remove_image_from_cache_by_file_name removes a previously cached image
+// and all of its mip levels. Textures are destroyed by the next renderer
+// build. Does nothing if not in cache.
 pub fn (mut window Window) remove_image_from_cache_by_file_name(file_name string) {
+	if is_memory_image_key(file_name) {
+		window.remove_memory_image(file_name)
+		return
+	}
 	real_path := os.real_path(file_name)
-	image_idx := window.view_state.image_map.get(real_path) or { return }
-	window.view_state.image_map.delete(real_path)
-	mut ctx := window.context()
-	ctx.remove_cached_image_by_idx(image_idx)
+	mip_prefix := real_path + image_mip_key_sep
+	window.view_state.image_dims.delete(real_path)
+	for key in window.view_state.image_map.keys() {
+		if key != real_path && !key.starts_with(mip_prefix) {
+			continue
+		}
+		image_idx := window.view_state.image_map.get(key) or { continue }
+		window.view_state.image_map.delete(key)
+		window.view_state.image_atlas.remove(image_idx)
+		window.view_state.image_map.release << image_idx
+	}
+}
+
+// image_mip_level returns the highest mip level (smallest image) whose
+// size still covers target_w x target_h. Level n halves each axis n
+// times; level 0 is the source. Never upscales.
+fn image_mip_level(src_w int, src_h int, target_w int, target_h int) int {
+	if target_w <= 0 || target_h <= 0 {
+		return 0
+	}
+	mut level := 0
+	mut w := src_w
+	mut h := src_h
+	for level < image_max_mip_levels {
+		next_w := w / 2
+		next_h := h / 2
+		if next_w < target_w || next_h < target_h || next_w < 1 || next_h < 1 {
+			break
+		}
+		w = next_w
+		h = next_h
+		level++
+	}
+	return level
+}
+
+// image_mip_size returns the pixel size of a mip level.
+fn image_mip_size(src_w int, src_h int, level int) (int, int) {
+	return int_max(1, src_w >> level), int_max(1, src_h >> level)
+}
+
+@[inline]
+fn image_mip_key(real_path string, level int) string {
+	return '${real_path}${image_mip_key_sep}${level}'
 }
 
-// BoundedImageMap stores image paths -> cache IDs with eviction cleanup.
-// On eviction, removes cached image from graphics context.
+@[inline]
+fn image_byte_size(width int, height int) i64 {
+	return i64(width) * i64(height) * 4
+}
+
+// ImageCacheEntry is one cached texture and the memory it holds.
+struct ImageCacheEntry {
+	id        int
+	cpu_bytes i64
+	gpu_bytes i64
+mut:
+	last_used u64
+}
+
+// BoundedImageMap stores image keys -> gg cache IDs. Entries are evicted
+// least recently used first when the entry count, CPU byte or GPU byte
+// budget is exceeded. Eviction records the id in `evicted` so dependent
+// caches can drop it, and in `release` until renderers that may still
+// draw the texture are gone (see release_evicted_textures).
 struct BoundedImageMap {
 mut:
-	data     map[string]int
-	order    []string
-	max_size int = 100
+	data          map[string]ImageCacheEntry
+	order         []string
+	tick          u64
+	cpu_bytes     i64
+	gpu_bytes     i64
+	max_size      int = 100
+	max_cpu_bytes i64 = image_cache_default_cpu_bytes
+	max_gpu_bytes i64 = image_cache_default_gpu_bytes
+	hits          u64
+	misses        u64
+	evictions     u64
+	evicted       []int
+	release       []int // evicted textures not yet destroyed
+}
+
+// set adds or updates an image cache entry without byte accounting.
+fn (mut m BoundedImageMap) set(key string, value int) {
+	m.set_sized(key, value, 0, 0)
 }
 
-// set adds or updates image cache entry. Evicts oldest with cleanup if at capacity.
-fn (mut m BoundedImageMap) set(key string, value int, mut ctx gg.Context) {
+// set_sized adds or updates an image cache entry with its CPU and GPU
+// footprint, then evicts least recently used entries over budget.
+fn (mut m BoundedImageMap) set_sized(key string, value int, cpu_bytes i64, gpu_bytes i64) {
 	if m.max_size < 1 {
 		return
 	}
-	if key in m.data {
-		m.data[key] = value
-		return
+	m.misses++
+	m.tick++
+	if old := m.data[key] {
+		m.cpu_bytes -= old.cpu_bytes
+		m.gpu_bytes -= old.gpu_bytes
+	} else {
+		m.order << key
+	}
+	m.data[key] = ImageCacheEntry{
+		id:        value
+		cpu_bytes: cpu_bytes
+		gpu_bytes: gpu_bytes
+		last_used: m.tick
 	}
-	if m.data.len >= m.max_size && m.order.len > 0 {
-		oldest_key := m.order[0]
-		if oldest_id := m.data[oldest_key] {
-			ctx.remove_cached_image_by_idx(oldest_id)
+	m.cpu_bytes += cpu_bytes
+	m.gpu_bytes += gpu_bytes
+	m.enforce_budget(key)
+}
+
+// enforce_budget evicts least recently used entries, never `keep`,
+// until count and byte budgets hold.
+fn (mut m BoundedImageMap) enforce_budget(keep string) {
+	for m.over_budget() {
+		mut victim := ''
+		mut oldest := u64(0)
+		for key in m.order {
+			if key == keep {
+				continue
+			}
+			entry := m.data[key] or { continue }
+			if victim.len == 0 || entry.last_used < oldest {
+				victim = key
+				oldest = entry.last_used
+			}
+		}
+		if victim.len == 0 {
+			return
 		}
-		m.data.delete(oldest_key)
-		m.order.delete(0)
+		entry := m.data[victim] or { return }
+		m.evicted << entry.id
+		m.release << entry.id
+		m.evictions++
+		m.delete(victim)
 	}
-	m.order << key
-	m.data[key] = value
+}
+
+fn (m &BoundedImageMap) over_budget() bool {
+	return m.data.len > m.max_size || m.cpu_bytes > m.max_cpu_bytes
+		|| m.gpu_bytes > m.max_gpu_bytes
+}
+
+// touch marks key as most recently used and counts a cache hit.
+fn (mut m BoundedImageMap) touch(key string) {
+	mut entry := m.data[key] or { return }
+	m.tick++
+	m.hits++
+	entry.last_used = m.tick
+	m.data[key] = entry
 }
 
 // get returns cache ID for image path, or none if not found.
 fn (m &BoundedImageMap) get(key string) ?int {
-	return m.data[key] or { return none }
+	entry := m.data[key] or { return none }
+	return entry.id
 }
 
 // contains returns true if image path is cached.
@@ -104,9 +432,9 @@ fn (m &BoundedImageMap) contains(key string) bool {
 
 // delete removes image from cache tracking (does not remove from graphics context).
 fn (mut m BoundedImageMap) delete(key string) {
-	if key !in m.data {
-		return
-	}
+	entry := m.data[key] or { return }
+	m.cpu_bytes -= entry.cpu_bytes
+	m.gpu_bytes -= entry.gpu_bytes
 	m.data.delete(key)
 	for i, item in m.order {
 		if item == key {
@@ -126,11 +454,29 @@ fn (m &BoundedImageMap) len() int {
 	return m.data.len
 }
 
-// clear removes all entries with graphics context cleanup.
-fn (mut m BoundedImageMap) clear(mut ctx gg.Context) {
-	for _, id in m.data {
-		ctx.remove_cached_image_by_idx(id)
+// release_textures destroys the textures of evicted entries and
+// returns how many it released. A window without a gg context
+// (headless, tests) has no textures to destroy.
+fn (mut m BoundedImageMap) release_textures(mut ctx gg.Context) int {
+	count := m.release.len
+	if !isnil(ctx) {
+		for id in m.release {
+			ctx.remove_cached_image_by_idx(id)
+		}
+	}
+	array_clear(mut m.release)
+	return count
+}
+
+// clear removes all entries and queues their textures in release, for
+// the next renderer build to destroy.
+fn (mut m BoundedImageMap) clear() {
+	for _, entry in m.data {
+		m.release << entry.id
 	}
 	m.data.clear()
 	array_clear(mut m.order)
+	array_clear(mut m.evicted)
+	m.cpu_bytes = 0
+	m.gpu_bytes = 0
 }
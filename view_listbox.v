@@ -1,6 +1,7 @@
 module gui
 
 import strings
+import time
 
 // ListBoxCfg configures a [list_box](#list_box) view.
 // `selected_ids` is a list of selected item ids.
@@ -21,6 +22,7 @@ pub:
 	data             []ListBoxOption
 	data_source      ?ListBoxDataSource
 	source_key       string
+	request_policy   GridRequestPolicy // data_source: debounce, throttle, sharing
 	query            string
 	loading          bool
 	load_error       string
@@ -60,6 +62,8 @@ pub:
 	query       string
 	signal      &GridAbortSignal = unsafe { nil }
 	request_id  u64
+mut:
+	window &Window = unsafe { nil } // set by list boxes; runs text index builds
 }
 
 @[minify]
@@ -78,11 +82,16 @@ pub mut:
 	data []ListBoxOption
 pub:
 	latency_ms int
+	text_index &GridTextIndex = unsafe { nil } // optional trigram index for queries
 }
 
 pub fn (source InMemoryListBoxDataSource) fetch_data(req ListBoxDataRequest) !ListBoxDataResult {
 	data_grid_source_sleep_with_abort(req.signal, source.latency_ms)!
-	filtered := list_box_source_apply_query(source.data, req.query)
+	if source.text_index != unsafe { nil } {
+		mut index := unsafe { source.text_index }
+		index.use_window(req.window)
+	}
+	filtered := list_box_source_apply_query_indexed(source.data, req.query, source.text_index)
 	grid_abort_check(req.signal)!
 	return ListBoxDataResult{
 		data: filtered
@@ -97,6 +106,9 @@ pub:
 	cancelled_count  int
 	stale_drop_count int
 	received_count   int
+	deduped_count    int // requests served by another view's identical fetch
+	deferred_count   int // request keys held back by debounce or throttle
+	latency_ms       f64 // moving average of fetch latency
 }
 
 // list_box builds a list box without viewport virtualization.
@@ -282,9 +294,7 @@ fn list_box_from_range(first_visible int, last_visible int, cfg ListBoxCfg, virt
 		a11y:         list_a11y
 		id_focus:     cfg.id_focus
 		id_scroll:    cfg.id_scroll
-		on_scroll:    fn [list_box_id, on_reorder] (_ &Layout, mut w Window) {
-			drag_reorder_apply_drop(list_box_id, on_reorder, mut w)
-		}
+		on_scroll:    drag_reorder_on_scroll(list_box_id, reorderable, on_reorder)
 		on_keydown:   fn [list_box_id, item_ids, is_multiple, on_select, selected_ids, reorderable, on_reorder] (_ &Layout, mut e Event, mut w Window) {
 			list_box_on_keydown(list_box_id, item_ids, is_multiple, on_select, selected_ids,
 				reorderable, on_reorder, mut e, mut w)
@@ -463,13 +473,23 @@ fn list_box_font_height(style TextStyle, mut window Window) f32 {
 		return style.size
 	}
 	vg_cfg := style.to_vglyph_cfg()
-	return window.text_system.font_height(vg_cfg) or { style.size }
+	return window.text_font_height(vg_cfg) or { style.size }
 }
 
 fn list_box_visible_range(list_height f32, row_height f32, cfg ListBoxCfg, mut window Window) (int, int) {
 	mut sy := state_map[u32, f32](mut window, ns_scroll_y, cap_scroll)
 	scroll_y := sy.get(cfg.id_scroll) or { f32(0) }
-	return list_core_visible_range(cfg.data.len, row_height, list_height, scroll_y)
+	first, last := list_core_visible_range(cfg.data.len, row_height, list_height, scroll_y)
+	window.scroll_dep(ScrollDep{
+		id_scroll:  cfg.id_scroll
+		kind:       .list_core
+		first:      first
+		last:       last
+		row_count:  cfg.data.len
+		row_height: row_height
+		viewport:   list_height
+	})
+	return first, last
 }
 
 pub fn (window &Window) list_box_source_stats(list_box_id string) ListBoxSourceStats {
@@ -484,6 +504,9 @@ pub fn (window &Window) list_box_source_stats(list_box_id string) ListBoxSourceS
 			cancelled_count:  state.cancelled_count
 			stale_drop_count: state.stale_drop_count
 			received_count:   state.received_count
+			deduped_count:    state.deduped_count
+			deferred_count:   state.pacer.deferred
+			latency_ms:       state.pacer.latency_ms
 		}
 	}
 	return ListBoxSourceStats{}
@@ -559,7 +582,10 @@ fn list_box_source_resolve_state(cfg ListBoxCfg, mut window Window) ListBoxSourc
 	mut sm := state_map[string, ListBoxSourceState](mut window, ns_list_box_source, cap_moderate)
 	mut state := sm.get(cfg.id) or { ListBoxSourceState{} }
 	request_key := list_box_source_request_key(cfg)
-	if request_key != state.request_key {
+	debounce := state.has_loaded && cfg.query != state.pacer.started_query
+	if request_key != state.request_key
+		&& grid_request_ready(cfg.request_policy, request_key, debounce, '${cfg.id}:request_pacing', mut
+		state.pacer, mut window) {
 		list_box_source_start_request(cfg, request_key, mut state, mut window)
 	}
 	state.data_dirty = false
@@ -584,13 +610,34 @@ fn list_box_source_start_request(cfg ListBoxCfg, request_key string, mut state L
 		active.abort()
 		state.cancelled_count++
 	}
-	controller := new_grid_abort_controller()
 	next_request_id := state.request_id + 1
+	state.pacer.note_start(cfg.query, time.ticks())
+	share_key := grid_request_share_key(cfg.request_policy, 'q:${cfg.query}|s:${cfg.source_key}')
+	subscriber := GridRequestSubscriber{
+		id:         cfg.id
+		request_id: next_request_id
+	}
+	if joined := grid_shared_request_join(ns_list_box_shared_request, share_key, subscriber, mut
+		window)
+	{
+		// An identical request is in flight; its result is delivered here too.
+		state.loading = true
+		state.load_error = ''
+		state.request_id = next_request_id
+		state.request_key = request_key
+		state.active_abort = joined
+		state.request_count++
+		state.deduped_count++
+		return
+	}
+	controller := grid_shared_request_lead(ns_list_box_shared_request, share_key, subscriber, mut
+		window)
 	req := ListBoxDataRequest{
 		list_box_id: cfg.id
 		query:       cfg.query
 		signal:      controller.signal
 		request_id:  next_request_id
+		window:      window
 	}
 	state.loading = true
 	state.load_error = ''
@@ -598,35 +645,44 @@ fn list_box_source_start_request(cfg ListBoxCfg, request_key string, mut state L
 	state.request_key = request_key
 	state.active_abort = controller
 	state.request_count++
-	list_box_id := cfg.id
 	window.pin_layout_callback_reclaim() or { panic(err) }
-	window.suspend_layout_callback_tracking(fn [source, req, list_box_id, next_request_id, mut window] () {
-		spawn fn [source, req, list_box_id, next_request_id] (mut w Window) {
-			if req.signal.is_aborted() {
+	window.suspend_layout_callback_tracking(fn [source, req, subscriber, share_key, mut window] () {
+		window.submit_work(WorkItem{
+			signal:    req.signal
+			on_cancel: fn (mut w Window) {
 				w.list_box_source_queue_reclaim_pin_release()
-				return
 			}
-			result := source.fetch_data(req) or {
+			run:       fn [source, req, subscriber, share_key] (mut w Window) {
+				result := source.fetch_data(req) or {
+					if req.signal.is_aborted() {
+						w.list_box_source_queue_reclaim_pin_release()
+						return
+					}
+					err_msg := err.msg()
+					w.queue_command(fn [subscriber, share_key, req, err_msg] (mut w Window) {
+						for sub in grid_shared_request_take(ns_list_box_shared_request,
+							share_key, req.signal, subscriber, mut w) {
+							list_box_source_apply_error(sub.id, sub.request_id, err_msg, mut
+								w)
+						}
+						w.release_layout_callback_reclaim_pin()
+					})
+					return
+				}
 				if req.signal.is_aborted() {
 					w.list_box_source_queue_reclaim_pin_release()
 					return
 				}
-				err_msg := err.msg()
-				w.queue_command(fn [list_box_id, next_request_id, err_msg] (mut w Window) {
-					list_box_source_apply_error(list_box_id, next_request_id, err_msg, mut w)
+				w.queue_command(fn [subscriber, share_key, req, result] (mut w Window) {
+					for sub in grid_shared_request_take(ns_list_box_shared_request,
+						share_key, req.signal, subscriber, mut w) {
+						list_box_source_apply_success(sub.id, sub.request_id, result, mut
+							w)
+					}
 					w.release_layout_callback_reclaim_pin()
 				})
-				return
 			}
-			if req.signal.is_aborted() {
-				w.list_box_source_queue_reclaim_pin_release()
-				return
-			}
-			w.queue_command(fn [list_box_id, next_request_id, result] (mut w Window) {
-				list_box_source_apply_success(list_box_id, next_request_id, result, mut w)
-				w.release_layout_callback_reclaim_pin()
-			})
-		}(mut window)
+		})
 	}) or {
 		window.release_layout_callback_reclaim_pin()
 		panic(err)
@@ -641,6 +697,7 @@ fn list_box_source_apply_success(list_box_id string, request_id u64, result List
 		sm.set(list_box_id, state)
 		return
 	}
+	state.pacer.observe(time.ticks())
 	state.loading = false
 	state.load_error = ''
 	state.has_loaded = true
@@ -675,6 +732,29 @@ fn list_box_source_apply_query(options []ListBoxOption, query string) []ListBoxO
 	return options.filter(list_box_source_option_matches_query(it, needle))
 }
 
+// list_box_source_apply_query_indexed is list_box_source_apply_query,
+// verifying only the options a current text index returns.
+fn list_box_source_apply_query_indexed(options []ListBoxOption, query string, text_index &GridTextIndex) []ListBoxOption {
+	needle := query.trim_space().to_lower()
+	if text_index == unsafe { nil } || needle.len < text_index_gram_len {
+		return list_box_source_apply_query(options, query)
+	}
+	mut idx := unsafe { text_index }
+	if !idx.options_current(options) {
+		return list_box_source_apply_query(options, query)
+	}
+	hits := idx.candidates(needle, options.data, options.len, 0) or {
+		return list_box_source_apply_query(options, query)
+	}
+	mut filtered := []ListBoxOption{}
+	for i in hits {
+		if list_box_source_option_matches_query(options[i], needle) {
+			filtered << options[i]
+		}
+	}
+	return filtered
+}
+
 fn list_box_source_option_matches_query(option ListBoxOption, needle string) bool {
 	return grid_contains_lower(option.id, needle) || grid_contains_lower(option.name, needle)
 		|| grid_contains_lower(option.value, needle)
@@ -59,7 +59,10 @@ pub:
 // MarkdownCfg configures a Markdown View.
 // NOTE: Rendering math (LaTeX) and mermaid diagrams sends the source
 // content to external third-party APIs (codecogs.com and kroki.io).
-// Set disable_external_apis to true to prevent these network requests.
+// Set disable_external_apis to true to prevent these network requests,
+// or point mermaid_endpoint/math_endpoint at a local render service.
+// Rendered images are kept in a disk cache across launches (see
+// Window.set_diagram_disk_cache).
 @[minify]
 pub struct MarkdownCfg {
 pub:
@@ -78,7 +81,9 @@ pub:
 	size_border           f32
 	radius                f32
 	padding               Padding
-	mermaid_width         int = 500
+	mermaid_width         int    = 500
+	mermaid_endpoint      string = markdown_default_mermaid_endpoint // Kroki-compatible POST endpoint
+	math_endpoint         string = markdown_default_math_endpoint    // codecogs-compatible GET endpoint
 	disable_external_apis bool // If true, math/mermaid are rendered as plain code blocks
 }
 
@@ -185,7 +190,7 @@ fn render_md_math(block MarkdownBlock, cfg MarkdownCfg, window &Window) View {
 					sizing:      fill_fit
 					h_align:     .center
 					content:     [
-						image(src: entry.png_path),
+						image(src: entry.image_key),
 					]
 				)
 			}
@@ -217,7 +222,7 @@ fn render_md_math(block MarkdownBlock, cfg MarkdownCfg, window &Window) View {
 			request_id: request_id
 		})
 		fetch_math_async(mut w, block.math_latex, diagram_hash, request_id,
-			cfg.style.math_dpi_display, cfg.style.text.color)
+			cfg.style.math_dpi_display, cfg.style.text.color, cfg.math_endpoint)
 	}
 	return column(
 		color:       cfg.style.code_block_bg
@@ -278,7 +283,7 @@ fn render_md_mermaid(block MarkdownBlock, cfg MarkdownCfg, window &Window) View
 					size_border: 0
 					sizing:      fill_fit
 					content:     [
-						image(src: entry.png_path),
+						image(src: entry.image_key),
 					]
 				)
 			}
@@ -310,7 +315,7 @@ fn render_md_mermaid(block MarkdownBlock, cfg MarkdownCfg, window &Window) View
 			request_id: request_id
 		})
 		fetch_mermaid_async(mut w, source, diagram_hash, request_id, cfg.mermaid_width,
-			cfg.style.mermaid_bg.r, cfg.style.mermaid_bg.g, cfg.style.mermaid_bg.b)
+			cfg.style.mermaid_bg.r, cfg.style.mermaid_bg.g, cfg.style.mermaid_bg.b, cfg.mermaid_endpoint)
 	}
 	return loading_view
 }
@@ -490,7 +495,7 @@ pub fn (window &Window) markdown(cfg MarkdownCfg) View {
 							request_id: request_id
 						})
 						fetch_math_async(mut w, run.math_latex, mhash, request_id,
-							cfg.style.math_dpi_inline, cfg.style.text.color)
+							cfg.style.math_dpi_inline, cfg.style.text.color, cfg.math_endpoint)
 					}
 				}
 			}
@@ -61,7 +61,7 @@ fn (mut rtf RtfView) generate_layout(mut window Window) Layout {
 	}
 
 	// Layout rich text using vglyph
-	layout := window.text_system.layout_rich_text(vg_rich_text, cfg) or { vglyph.Layout{} }
+	layout := window.text_layout_rich(vg_rich_text, cfg) or { vglyph.Layout{} }
 
 	shape := &Shape{
 		shape_type: .rtf
@@ -228,6 +228,7 @@ fn rtf_mouse_move(layout &Layout, mut e Event, mut w Window) {
 			if found_run.tooltip != '' {
 				abs_rect := rtf_abs_run_rect(run, layout.shape, forward_transform)
 				w.set_rtf_tooltip(found_run.tooltip, abs_rect)
+				w.set_event_refresh(.render_only)
 				e.is_handled = true
 				return
 			}
@@ -235,6 +236,7 @@ fn rtf_mouse_move(layout &Layout, mut e Event, mut w Window) {
 			// Links have underline style
 			if run.has_underline {
 				w.set_mouse_cursor_pointing_hand()
+				w.set_event_refresh(.none)
 				e.is_handled = true
 				return
 			}
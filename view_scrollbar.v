@@ -150,6 +150,7 @@ fn scrollbar_mouse_move(orientation ScrollbarOrientation, id_scroll u32, layout
 					if ly.shape.has_events() && ly.shape.events.on_scroll != unsafe { nil } {
 						ly.shape.events.on_scroll(ly, mut w)
 					}
+					w.declare_scroll_refresh(ly)
 				}
 			}
 			else {
@@ -161,6 +162,7 @@ fn scrollbar_mouse_move(orientation ScrollbarOrientation, id_scroll u32, layout
 					if ly.shape.has_events() && ly.shape.events.on_scroll != unsafe { nil } {
 						ly.shape.events.on_scroll(ly, mut w)
 					}
+					w.declare_scroll_refresh(ly)
 				}
 			}
 		}
@@ -383,6 +385,7 @@ fn offset_from_mouse_x(layout &Layout, mouse_x f32, id_scroll u32, mut w Window)
 		if sb.shape.has_events() && sb.shape.events.on_scroll != unsafe { nil } {
 			sb.shape.events.on_scroll(sb, mut w)
 		}
+		w.declare_scroll_refresh(sb)
 	}
 }
 
@@ -410,6 +413,7 @@ fn offset_from_mouse_y(layout &Layout, mouse_y f32, id_scroll u32, mut w Window)
 		if sb.shape.has_events() && sb.shape.events.on_scroll != unsafe { nil } {
 			sb.shape.events.on_scroll(sb, mut w)
 		}
+		w.declare_scroll_refresh(sb)
 	}
 }
 
@@ -434,6 +438,7 @@ fn scroll_horizontal(layout &Layout, delta f32, mut w Window) bool {
 		if layout.shape.has_events() && layout.shape.events.on_scroll != unsafe { nil } {
 			layout.shape.events.on_scroll(layout, mut w)
 		}
+		w.declare_scroll_refresh(layout)
 		return true
 	}
 	return false
@@ -460,6 +465,7 @@ fn scroll_vertical(layout &Layout, delta f32, mut w Window) bool {
 		if layout.shape.has_events() && layout.shape.events.on_scroll != unsafe { nil } {
 			layout.shape.events.on_scroll(layout, mut w)
 		}
+		w.declare_scroll_refresh(layout)
 		return true
 	}
 	return false
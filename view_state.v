@@ -33,6 +33,8 @@ mut:
 	image_map                   BoundedImageMap = BoundedImageMap{
 		max_size: 100
 	}
+	image_atlas                 ImageAtlas
+	image_dims                  map[string][2]int // source pixel size per real path
 	svg_cache                   BoundedSvgCache = BoundedSvgCache{
 		max_size: 100
 	}
@@ -116,6 +118,7 @@ mut:
 	local_rows_len             int = -1
 	local_rows_id_signature    u64
 	local_rows_signature_valid bool
+	rows_versioned             bool // source_signature derives from a rows version
 	committed_rows             []GridRow
 	working_rows               []GridRow
 	dirty_row_ids              map[string]bool
@@ -154,6 +157,22 @@ mut:
 	caps_cached      bool
 	rows_dirty       bool = true
 	rows_signature   u64
+	rows_version     u64 // non-zero when rows_signature comes from GridDataResult.version
+	page_cache       &DataGridPageCache = unsafe { nil }
+	nav_dir          int = 1  // last paging direction, for prefetch
+	nav_ticks        i64      // time.ticks() of the last paging
+	nav_gap_ms       i64 = -1 // between the last two pagings
+	pacer            GridRequestPacer
+	deduped_count    int
+	live             &GridLiveInbox = unsafe { nil } // DataGridCfg.live_feed subscription
+}
+
+// DataGridColumnSourceState keeps the InMemoryDataSource that serves a
+// grid's DataGridCfg.column_store. `store` is the store the app passed;
+// the source's own store is replaced by each mutation.
+struct DataGridColumnSourceState {
+	store  &GridColumnStore    = unsafe { nil }
+	source &InMemoryDataSource = unsafe { nil }
 }
 
 // ListBoxSourceState stores async data-source runtime state per list-box id.
@@ -171,6 +190,8 @@ mut:
 	received_count   int // cumulative across all requests
 	active_abort     &GridAbortController = unsafe { nil }
 	data_dirty       bool                 = true
+	pacer            GridRequestPacer
+	deduped_count    int
 }
 
 // TableColCache stores cached column widths and hash for invalidation
@@ -192,12 +213,16 @@ pub:
 
 // clear_view_state resets all GUI state for this window.
 // Call when window destroyed or needs full GUI state reinitialization.
+// Image textures and atlas pages are only queued for release: the
+// presented renderers (redrawn until the next build, and until a
+// pipelined back layout is presented) may still draw them.
 fn (mut w Window) clear_view_state() {
 	w.release_mouse_lock_pin()
 	mouse_lock_dispatch_depth := w.view_state.mouse_lock_dispatch_depth
 	mouse_lock_release_pending := w.view_state.mouse_lock_release_pending
-	mut ctx := w.context()
-	w.view_state.image_map.clear(mut ctx)
+	w.view_state.image_map.clear()
+	w.view_state.image_map.release << w.view_state.image_atlas.clear()
+	release := w.view_state.image_map.release
 	w.view_state.diagram_cache.clear()
 	w.view_state.svg_cache.clear()
 	w.view_state.markdown_cache.clear()
@@ -206,6 +231,7 @@ fn (mut w Window) clear_view_state() {
 		mouse_lock_dispatch_depth:  mouse_lock_dispatch_depth
 		mouse_lock_release_pending: mouse_lock_release_pending
 	}
+	w.view_state.image_map.release = release
 }
 
 fn (mut w Window) clear_input_selections() {
@@ -478,7 +478,7 @@ fn table_compute_column_widths(cfg &TableCfg, mut window Window) []f32 {
 // table_estimate_row_height estimates row height for virtualization
 fn table_estimate_row_height(cfg &TableCfg, mut window Window) f32 {
 	vg_cfg := cfg.text_style.to_vglyph_cfg()
-	font_h := window.text_system.font_height(vg_cfg) or { 0 }
+	font_h := window.text_font_height(vg_cfg) or { 0 }
 	border := match cfg.border_style {
 		.all { cfg.size_border }
 		else { f32(0) }
@@ -491,10 +491,27 @@ fn table_estimate_row_height(cfg &TableCfg, mut window Window) f32 {
 fn table_visible_range(table_height f32, row_height f32, cfg &TableCfg, mut window Window) (int, int) {
 	mut sy := state_map[u32, f32](mut window, ns_scroll_y, cap_scroll)
 	scroll_y := -(sy.get(cfg.id_scroll) or { f32(0) }) // scroll_y is negative
+	first_visible, last_visible := table_visible_range_for_scroll(table_height, row_height,
+		cfg.data.len, scroll_y)
+	window.scroll_dep(ScrollDep{
+		id_scroll:  cfg.id_scroll
+		kind:       .table
+		first:      first_visible
+		last:       last_visible
+		row_count:  cfg.data.len
+		row_height: row_height
+		viewport:   table_height
+	})
+	return first_visible, last_visible
+}
+
+// table_visible_range_for_scroll is the arithmetic behind
+// table_visible_range; scroll_y is positive.
+fn table_visible_range_for_scroll(table_height f32, row_height f32, row_count int, scroll_y f32) (int, int) {
 	first := int(scroll_y / row_height)
 	visible_rows := int(table_height / row_height) + 1
 	buffer := 2
 	first_visible := int_max(0, first - buffer)
-	last_visible := int_min(cfg.data.len - 1, first + visible_rows + buffer)
+	last_visible := int_min(row_count - 1, first + visible_rows + buffer)
 	return first_visible, last_visible
 }
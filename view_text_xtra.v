@@ -20,7 +20,7 @@ pub fn text_width(text string, text_style TextStyle, mut window Window) f32 {
 	}
 	mut cfg := text_style.to_vglyph_cfg()
 	cfg.no_hit_testing = true
-	return window.text_system.text_width(text, cfg) or { 0 }
+	return window.text_measure_width(text, cfg) or { 0 }
 }
 
 // rich_text_width calculates the width of RichText accounting for all font styles.
@@ -31,7 +31,7 @@ fn rich_text_width(rt RichText, mut window Window) f32 {
 			width: -1.0
 		}
 	}
-	layout := window.text_system.layout_rich_text(rt.to_vglyph_rich_text(), cfg) or { return 0 }
+	layout := window.text_layout_rich(rt.to_vglyph_rich_text(), cfg) or { return 0 }
 	return layout.width
 }
 
@@ -237,7 +237,7 @@ fn text_height(shape &Shape, mut window Window) f32 {
 			return 0
 		}
 		cfg := shape.tc.text_style.to_vglyph_cfg()
-		return window.text_system.font_height(cfg) or { 0 }
+		return window.text_font_height(cfg) or { 0 }
 	}
 	if shape.has_text_layout() {
 		return shape.tc.vglyph_layout.height
@@ -258,7 +258,7 @@ fn line_height(shape &Shape, mut window Window) f32 {
 		return 0
 	}
 	cfg := shape.tc.text_style.to_vglyph_cfg()
-	height := window.text_system.font_height(cfg) or { 0 }
+	height := window.text_font_height(cfg) or { 0 }
 	return height + shape.tc.text_style.line_spacing
 }
 
@@ -298,7 +298,7 @@ fn text_wrap(mut shape Shape, mut window Window) {
 		if window.text_system == unsafe { nil } {
 			return
 		}
-		layout := window.text_system.layout_text(shape.tc.text, cfg) or { vglyph.Layout{} }
+		layout := window.text_layout(shape.tc.text, cfg) or { vglyph.Layout{} }
 		shape.tc.vglyph_layout = &layout
 		shape.tc.last_constraint_width = width
 		shape.tc.last_text_hash = text_hash
@@ -341,7 +341,7 @@ fn text_wrap(mut shape Shape, mut window Window) {
 							indent: -shape.tc.hanging_indent
 						}
 					}
-					layout := window.text_system.layout_rich_text(vg_rt, cfg) or { vglyph.Layout{} }
+					layout := window.text_layout_rich(vg_rt, cfg) or { vglyph.Layout{} }
 					shape.tc.vglyph_layout = &layout
 					shape.tc.last_constraint_width = width
 					shape.width = layout.width + shape.padding.width()
@@ -230,9 +230,7 @@ pub fn (mut window Window) tree(cfg TreeCfg) View {
 		spacing:          cfg.spacing
 		height:           cfg.height
 		max_height:       cfg.max_height
-		on_scroll:        fn [cfg_id, on_reorder] (_ &Layout, mut w Window) {
-			drag_reorder_apply_tree_drop(cfg_id, on_reorder, mut w)
-		}
+		on_scroll:        drag_reorder_tree_on_scroll(cfg_id, can_reorder, on_reorder)
 		on_keydown:       fn [cfg_id, on_select, on_lazy_load, visible_ids, can_reorder, on_reorder, sibling_ids_by_parent, sibling_index_of, parent_of] (_ &Layout, mut e Event, mut w Window) {
 			tree_on_keydown(cfg_id, on_select, on_lazy_load, visible_ids, can_reorder, on_reorder,
 				sibling_ids_by_parent, sibling_index_of, parent_of, mut e, mut w)
@@ -321,7 +319,7 @@ fn tree_font_height(style TextStyle, mut window Window) f32 {
 		return style.size
 	}
 	vg_cfg := style.to_vglyph_cfg()
-	return window.text_system.font_height(vg_cfg) or { style.size }
+	return window.text_font_height(vg_cfg) or { style.size }
 }
 
 // tree_visible_range computes the first and last visible flat-row
@@ -331,9 +329,29 @@ fn tree_visible_range(tree_height f32, row_height f32, total_rows int, id_scroll
 	if total_rows == 0 || row_height <= 0 || tree_height <= 0 {
 		return 0, -1
 	}
-	max_idx := total_rows - 1
 	mut sy := state_map[u32, f32](mut window, ns_scroll_y, cap_scroll)
 	scroll_y := -(sy.get(id_scroll) or { f32(0) })
+	first_visible, last_visible := tree_visible_range_for_scroll(tree_height, row_height,
+		total_rows, scroll_y)
+	window.scroll_dep(ScrollDep{
+		id_scroll:  id_scroll
+		kind:       .tree
+		first:      first_visible
+		last:       last_visible
+		row_count:  total_rows
+		row_height: row_height
+		viewport:   tree_height
+	})
+	return first_visible, last_visible
+}
+
+// tree_visible_range_for_scroll is the arithmetic behind
+// tree_visible_range; scroll_y is positive.
+fn tree_visible_range_for_scroll(tree_height f32, row_height f32, total_rows int, scroll_y f32) (int, int) {
+	if total_rows == 0 || row_height <= 0 || tree_height <= 0 {
+		return 0, -1
+	}
+	max_idx := total_rows - 1
 	first := int_clamp(int(scroll_y / row_height), 0, max_idx)
 	visible_rows := int(tree_height / row_height) + 1
 	mut first_visible := int_max(0, first - tree_virtual_buffer_rows)
@@ -19,17 +19,18 @@ pub type WindowCommand = fn (mut Window)
 
 pub struct Window {
 mut:
-	commands_mutex           &sync.Mutex                 = sync.new_mutex() // Mutex for command queue
+	commands                 &CommandQueue               = new_command_queue(command_queue_capacity) // Lock-free queue of main-thread commands
 	focused                  bool                        = true // Window focus state
 	mutex                    &sync.Mutex                 = sync.new_mutex() // Mutex for thread-safety
-	on_event                 fn (e &Event, mut w Window) = fn (_ &Event, mut _ Window) {}           // Global event handler
+	on_event                 fn (e &Event, mut w Window) = on_event_default  // Global event handler
 	state                    voidptr                     = unsafe { nil }    // User state passed to the window
 	text_system              &vglyph.TextSystem          = unsafe { nil }    // Text rendering system
 	ui                       &gg.Context                 = &gg.Context{} // Main sokol/gg graphics context
 	view_generator           fn (&Window) View           = empty_view        // Function to generate the UI view
 	a11y                     A11y                          // Accessibility backend state (lazily initialized)
 	animations               map[string]Animation          // Active animations (keyed by id)
-	commands                 []WindowCommand               // Atomic command queue for UI state updates
+	animation_wake           chan bool = chan bool{cap: 1} // unparks animation_loop (see animation_add)
+	animation_batch          AnimationBatch // struct-of-arrays store for tweens, springs, keyframes
 	debug_layout             bool                          // enable layout performance stats
 	inspector_enabled        bool                          // dev-only inspector overlay (F12)
 	inspector_tree_cache     []TreeNodeCfg                 // previous-frame tree for inspector
@@ -37,6 +38,13 @@ mut:
 	dialog_cfg               DialogCfg                     // Configuration for the active dialog (if any)
 	filter_state             SvgFilterState                // Offscreen state for SVG filters
 	ime                      IME                    // Input Method Editor state (lazily initialized)
+	image_decoder            &ImageDecoder   = unsafe { nil }   // background image decode state (lazily initialized)
+	workers                  &WorkerPool     = unsafe { nil }   // shared background worker pool (lazily started)
+	pipeline                 &LayoutPipeline = unsafe { nil }   // layout thread state; nil unless pipelined_layout
+	text_mutex               &sync.Mutex     = sync.new_mutex() // serializes vglyph use (see text_sync.v)
+	diagram_disk             DiagramDiskCache // persistent mermaid/math image cache settings
+	image_downloads          &FetchQueue = &FetchQueue{max_running: image_download_max_running} // remote image fetch threads
+	diagram_fetches          &FetchQueue = &FetchQueue{max_running: max_concurrent_diagram_fetches} // mermaid/math fetch threads
 	init_error               string                 // error during initialization (e.g. text system fail)
 	layout                   Layout                 // The current calculated layout tree
 	layout_callback_lifetime LayoutCallbackLifetime // Owns callbacks created while rebuilding layout epochs
@@ -44,12 +52,24 @@ mut:
 	pip                      Pipelines              // GPU rendering pipelines (lazily initialized)
 	refresh_layout           bool                   // Trigger full view/layout/renderer rebuild next frame
 	refresh_render_only      bool                   // Trigger renderer-only rebuild from existing layout
+	refresh_overlay          bool                   // Trigger caret overlay rebuild only
+	event_refresh            EventRefresh           // refresh declared by handlers of the current event
+	hover_signature          u64                    // hover targets under the pointer (see event_refresh.v)
+	input                    InputCoalescer         // pointer events waiting for the next frame
+	scroll_applied           map[u32]ScrollOffset   // scroll offsets the presented layout was positioned with
+	scroll_deps              []ScrollDep            // scroll offsets the presented view was generated from
+	live_inboxes             []&GridLiveInbox       // data grid live-feed subscriptions (see data_source_live.v)
 	render_guard_warned      map[string]bool        // Renderer kinds warned by render guard (prod only)
 	frame_triangle_vertices  int                    // Running sokol-gl triangle-vertex count for the current draw pass (reset in renderers_draw)
 	renderers                []Renderer             // Flat list of drawing instructions for the current frame
+	overlay_renderers        []Renderer             // Caret/IME renderers drawn after renderers
+	overlay_anchors          []OverlayAnchor        // Focused text shapes feeding overlay_renderers
+	layer_rects              []DrawClip             // bounds of each root layer (main, then floating), render-time only
+	render_layer             int                    // root layer being rendered, render-time only
 	scratch                  ScratchPools           // Bounded scratch arrays reused in hot paths
 	stats                    Stats                  // Rendering statistics
 	clip_radius              f32                    // rounded clip radius, render-time only
+	draw_clip                DrawClip               // scissor of the last DrawClip drawn, render-time only
 	toasts                   []ToastNotification    // active toast queue
 	toast_counter            u64                    // monotonic toast id
 	view_state               ViewState              // Manages state for widgets (scroll, selection, etc.)
@@ -102,10 +122,11 @@ pub:
 	on_init             fn (mut Window) = fn (mut w Window) {
 		w.update_view(empty_view)
 	} // called once after GPU init; set the initial view here via w.update_view()
-	on_event            fn (e &Event, mut w Window) = fn (_ &Event, mut _ Window) {} // global event hook; fires for all events
+	on_event            fn (e &Event, mut w Window) = on_event_default // global event hook; fires for all events
 	log_level           log.Level                   = default_log_level()
 	debug_layout        bool // print layout timing stats to stdout each frame
 	sample_count        int = 1 // MSAA sample count (1 = off; 4 antialiases draw_canvas lines/polygons)
+	pipelined_layout    bool // run view generation and layout on a background thread (see layout_pipelined.v)
 }
 
 fn default_log_level() log.Level {
@@ -128,6 +149,9 @@ pub fn window(cfg &WindowCfg) &Window {
 			app_id: cfg.app_id
 		}
 	}
+	if cfg.pipelined_layout {
+		app_window.pipeline = &LayoutPipeline{}
+	}
 	on_init := cfg.on_init
 	cursor_blink := cfg.cursor_blink
 	app_window.ui = gg.new_context(
@@ -167,6 +191,9 @@ pub fn window(cfg &WindowCfg) &Window {
 			}
 
 			spawn w.animation_loop()
+			if w.pipeline != unsafe { nil } {
+				spawn w.layout_pipeline_loop()
+			}
 			if cursor_blink {
 				w.blinky_cursor_animation()
 			}
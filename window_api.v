@@ -217,33 +217,34 @@ pub fn (mut window Window) unlock() {
 	window.mutex.unlock()
 }
 
-// queue_command adds a command to the window's atomic command queue.
+// queue_command adds a command to the window's lock-free command queue.
 // The command will be executed on the main thread during the next frame
 // update. This is the preferred way to update UI state from other threads.
 pub fn (mut window Window) queue_command(cb WindowCommand) {
-	window.commands_mutex.lock()
-	window.commands << cb
-	window.commands_mutex.unlock()
+	window.commands.push(cb, '')
 	window.ui.refresh_ui()
 }
 
+// queue_command_keyed is queue_command with a coalescing key. If several
+// commands with the same key are waiting when the frame starts, only the
+// most recently queued one runs. Use it for updates that replace the
+// previous one, e.g. progress or the latest result for a data source.
+pub fn (mut window Window) queue_command_keyed(key string, cb WindowCommand) {
+	window.commands.push(cb, key)
+	window.ui.refresh_ui()
+}
+
+// command_queue_stats reports command queue depth, coalescing and
+// latency counters.
+pub fn (window &Window) command_queue_stats() CommandQueueStats {
+	mut commands := unsafe { window.commands }
+	return commands.stats()
+}
+
 // flush_commands executes all pending commands in the command queue.
 // Internal use only; called by the main loop.
 fn (mut window Window) flush_commands() {
-	window.commands_mutex.lock()
-	if window.commands.len == 0 {
-		window.commands_mutex.unlock()
-		return
-	}
-	// Swap instead of clone+clear: avoids heap allocation and
-	// prevents GC false retention from stale pointers.
-	to_run := window.commands
-	window.commands = []WindowCommand{}
-	window.commands_mutex.unlock()
-
-	for cb in to_run {
-		cb(mut window)
-	}
+	window.commands.flush(mut window)
 }
 
 // run starts the UI and handles events
@@ -563,6 +564,7 @@ pub fn (mut window Window) set_theme(theme Theme) {
 	titlebar_dark(theme.titlebar_dark)
 	window.view_state.markdown_cache.clear()
 	window.view_state.diagram_cache.clear()
+	window.release_diagram_images()
 	window.set_color_background(theme.color_background)
 }
 
@@ -2,17 +2,41 @@ module gui
 
 // AI-DOC: window_event.v
 // - Scope: Window event intake and dispatch from gg callback.
-// - Entry point: event_fn().
+// - Entry point: event_fn(). Moves and scrolls are coalesced per frame.
 // - Focus gate: reject most events while unfocused; allow right-click and
 //   focus/scroll flow.
 // - Modal behavior: route events to dialog layer when dialog visible.
-// - Post-condition: tooltip id cleared and update_window() requested.
+// - Post-condition: tooltip id cleared and the refresh the event needs
+//   requested; mouse moves that change nothing skip layout (see
+//   event_refresh.v).
 import gg
 import log
 
 // event_fn handles user events, mostly delegating to child views.
+// Pointer moves and scrolls are coalesced and dispatched once per frame
+// (see event_coalesce.v).
 fn event_fn(ev &gg.Event, mut w Window) {
+	if is_coalescable(ev.typ) {
+		w.input.add(ev)
+		w.ui.refresh_ui()
+		return
+	}
+	w.flush_coalesced_input()
+	w.dispatch_event(ev)
+}
+
+// dispatch_event routes an event to the pipelined or serial path.
+fn (mut w Window) dispatch_event(ev &gg.Event) {
+	if w.pipeline != unsafe { nil } {
+		w.pipelined_event(ev)
+		return
+	}
+	event_dispatch(ev, mut w)
+}
+
+fn event_dispatch(ev &gg.Event, mut w Window) {
 	mut e := from_gg_event(ev)
+	w.event_refresh = .auto
 	if !w.focused && e.typ == .mouse_down && e.mouse_button == MouseButton.right {
 		// allow right clicks without focus.
 		// motivation: browsers allow this action.
@@ -56,6 +80,7 @@ fn event_fn(ev &gg.Event, mut w Window) {
 		w.layout
 	}
 
+	move_before := if e.typ == .mouse_move { mouse_move_snapshot(w) } else { MouseMoveSnapshot{} }
 	match e.typ {
 		.char {
 			char_handler(layout, mut e, mut w)
@@ -140,6 +165,13 @@ fn event_fn(ev &gg.Event, mut w Window) {
 	if e.is_handled {
 		log.debug('event_fn: ${e.typ} handled: ${e}')
 	}
+	mut refresh := w.event_refresh
+	if refresh == .auto {
+		refresh = if e.typ == .mouse_move { w.mouse_move_refresh(e, move_before) } else { .layout }
+	}
+	if w.view_state.tooltip.id != '' {
+		refresh = .layout // hides the tooltip
+	}
 	w.view_state.tooltip.id = ''
-	w.update_window()
+	w.apply_event_refresh(refresh, w.view_state.mouse_cursor != move_before.cursor)
 }
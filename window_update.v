@@ -4,9 +4,12 @@ module gui
 // - Scope: Window frame/update/render pipeline.
 // - Entry points: frame_fn() from gg, update_view(), update_window().
 // - Refresh flags: layout refresh overrides render-only refresh.
-// - Order: init subsystems -> flush commands -> update/layout/renderers ->
-//   run SVG offscreen filter passes -> draw swapchain pass.
+// - Order: init subsystems -> coalesced input -> flush commands ->
+//   upload decoded images -> update/layout/renderers (or caret overlay
+//   only) -> run SVG offscreen filter passes -> draw swapchain pass.
 // - Locking: layout/renderer rebuild runs under window lock.
+// - Pipelined mode (WindowCfg.pipelined_layout): layout runs on a
+//   background thread; see layout_pipelined.v.
 import log
 import sokol.sapp
 
@@ -15,16 +18,29 @@ import sokol.sapp
 fn frame_fn(mut window Window) {
 	window.init_ime()
 	window.init_a11y()
+	window.flush_coalesced_input()
+	if window.pipeline != unsafe { nil } {
+		window.frame_pipelined()
+		return
+	}
 	window.flush_commands()
+	if window.upload_decoded_images() {
+		window.mark_render_only_refresh()
+	}
 
 	if window.refresh_layout {
 		window.update()
 		window.sync_a11y()
 		window.refresh_layout = false
 		window.refresh_render_only = false
+		window.refresh_overlay = false
 	} else if window.refresh_render_only {
 		window.update_render_only()
 		window.refresh_render_only = false
+		window.refresh_overlay = false
+	} else if window.refresh_overlay {
+		window.update_overlay()
+		window.refresh_overlay = false
 	}
 
 	// Process SVG filters in offscreen passes BEFORE the
@@ -34,6 +50,7 @@ fn frame_fn(mut window Window) {
 	window.lock()
 	window.ui.begin()
 	renderers_draw(mut window)
+	renderers_draw_overlay(mut window)
 	window.ui.end()
 	window.unlock()
 	sapp.set_mouse_cursor(window.view_state.mouse_cursor)
@@ -64,11 +81,13 @@ fn (mut window Window) request_render_only() {
 fn (mut window Window) mark_layout_refresh() {
 	window.refresh_layout = true
 	window.refresh_render_only = false
+	window.refresh_overlay = false
 }
 
 fn (mut window Window) mark_render_only_refresh() {
 	if !window.refresh_layout {
 		window.refresh_render_only = true
+		window.refresh_overlay = false
 	}
 }
 
@@ -80,21 +99,17 @@ fn (mut window Window) update() {
 	clip_rect := window.window_rect()
 	background_color := window.color_background()
 
-	$if !prod {
-		if window.inspector_enabled {
-			window.inspector_props_cache = map[string]InspectorNodeProps{}
-			selected := inspector_selected_path(window)
-			window.inspector_tree_cache = inspector_build_tree_nodes(&window.layout, selected, mut
-				window.inspector_props_cache)
-		}
-	}
+	window.refresh_inspector_cache()
+	window.scroll_fast_path_reset()
 	window.layout_callback_frame(fn [mut window] () {
 		mut view := window.view_generator(window)
 		layout_clear(mut window.layout)
 		window.layout = window.compose_layout(mut view)
 		view_clear(mut view)
+		window.sweep_live_inboxes()
 	}) or { panic(err) }
 	window.reclaim_old_layout_callbacks()
+	window.reset_hover_signature()
 	window.build_renderers(background_color, clip_rect)
 	window.unlock()
 	//--------------------------------------------
@@ -102,12 +117,26 @@ fn (mut window Window) update() {
 	window.stats.update_max_renderers(usize(window.renderers.len))
 }
 
+// refresh_inspector_cache snapshots the outgoing layout for the
+// inspector before it is replaced.
+fn (mut window Window) refresh_inspector_cache() {
+	$if !prod {
+		if window.inspector_enabled {
+			window.inspector_props_cache = map[string]InspectorNodeProps{}
+			selected := inspector_selected_path(window)
+			window.inspector_tree_cache = inspector_build_tree_nodes(&window.layout, selected, mut
+				window.inspector_props_cache)
+		}
+	}
+}
+
 fn (mut window Window) update_render_only() {
 	log.debug('update_render_only')
 	//--------------------------------------------
 	window.lock()
 	clip_rect := window.window_rect()
 	background_color := window.color_background()
+	window.reapply_transitions()
 	window.build_renderers(background_color, clip_rect)
 	window.unlock()
 	//--------------------------------------------
@@ -121,9 +150,13 @@ fn (mut window Window) build_renderers(background_color Color, clip_rect DrawCli
 	mut filter_renderers := window.scratch.take_filter_renderers(0)
 	window.scratch.put_filter_renderers(mut filter_renderers)
 	window.scratch.begin_svg_transform_batches()
+	window.view_state.image_atlas.begin_renderers(window.ui.frame)
+	window.release_evicted_textures()
 	array_clear(mut window.renderers)
-	render_layout(mut window.layout, background_color, clip_rect, mut window)
+	array_clear(mut window.overlay_anchors)
+	window.render_layers(background_color, clip_rect)
 	window.scratch.trim_svg_transform_batches()
+	window.build_overlay_renderers()
 	$if !prod {
 		if window.inspector_enabled {
 			inspector_inject_wireframe(mut window)
@@ -0,0 +1,286 @@
+module gui
+
+// worker_pool.v runs background work for a window on a fixed set of
+// threads, so bursts of requests (a fast typist on a grid filter, a
+// page of remote images) queue up instead of creating one OS thread
+// each. Work is picked highest priority first, FIFO within a priority.
+// Priorities do not preempt running work, so one worker is kept for
+// interactive items: slow prefetches and background decodes never
+// occupy every thread while the user waits on a fetch.
+// A work item may carry a GridAbortSignal: if it is aborted before a
+// worker picks the item up, run is skipped and on_cancel runs instead,
+// so superseded requests cost nothing. Workers hand results back to
+// the main thread through queue_command, as before.
+// Blocking network fetches do not belong on the pool: a slow server
+// would hold a worker for the whole request timeout. They go through a
+// FetchQueue instead, which runs each on its own thread, a capped
+// number at once.
+import runtime
+import sync
+
+const worker_pool_max_threads = 4
+const worker_pool_interactive_reserve = 1 // workers only interactive items may use
+
+// WorkPriority orders queued work. Interactive work (data the user is
+// waiting for) runs before prefetches, which run before background
+// decodes and notifications.
+pub enum WorkPriority as u8 {
+	interactive
+	prefetch
+	background
+}
+
+// WorkItem is one unit of background work. run and on_cancel execute
+// on a worker thread; use queue_command to touch window state.
+pub struct WorkItem {
+pub:
+	priority  WorkPriority     = .interactive
+	signal    &GridAbortSignal = unsafe { nil }
+	run       fn (mut Window) @[required]
+	on_cancel fn (mut Window) = unsafe { nil } // instead of run when aborted before start or dropped by close
+}
+
+// WorkerPoolStats counts pool activity.
+pub struct WorkerPoolStats {
+pub:
+	threads   int
+	queued    int
+	running   int
+	submitted u64
+	cancelled u64 // skipped because their signal was aborted
+}
+
+@[heap]
+struct WorkerPool {
+mut:
+	mutex     &sync.Mutex     = sync.new_mutex()
+	ready     &sync.Semaphore = sync.new_semaphore()
+	queues    [][]WorkItem // indexed by WorkPriority
+	threads   int
+	running   int
+	low       int // running items below interactive priority
+	closed    bool
+	window    &Window = unsafe { nil }
+	submitted u64
+	cancelled u64
+}
+
+// worker_pool_thread_count sizes the pool to the machine, capped so
+// background work never starves the render thread.
+fn worker_pool_thread_count() int {
+	return int_max(2, int_min(worker_pool_max_threads, runtime.nr_cpus() - 1))
+}
+
+// submit_work queues item on the window's worker pool, starting the
+// pool on first use. Call from the main thread.
+pub fn (mut window Window) submit_work(item WorkItem) {
+	if window.workers == unsafe { nil } {
+		window.workers = new_worker_pool(mut window, worker_pool_thread_count())
+	}
+	window.workers.submit(item)
+}
+
+// worker_pool_stats reports pool activity; zero before first use.
+pub fn (window &Window) worker_pool_stats() WorkerPoolStats {
+	if window.workers == unsafe { nil } {
+		return WorkerPoolStats{}
+	}
+	mut pool := unsafe { window.workers }
+	return pool.stats()
+}
+
+fn new_worker_pool(mut window Window, threads int) &WorkerPool {
+	mut pool := &WorkerPool{
+		queues:  [][]WorkItem{len: 3}
+		threads: threads
+		window:  window
+	}
+	for _ in 0 .. threads {
+		spawn worker_pool_run(mut pool)
+	}
+	return pool
+}
+
+fn (mut pool WorkerPool) submit(item WorkItem) {
+	pool.mutex.lock()
+	if pool.closed {
+		pool.mutex.unlock()
+		if item.on_cancel != unsafe { nil } {
+			mut w := pool.window
+			item.on_cancel(mut w)
+		}
+		return
+	}
+	pool.queues[int(item.priority)] << item
+	pool.submitted++
+	pool.mutex.unlock()
+	pool.ready.post()
+}
+
+// take pops the next item by priority. Items below interactive
+// priority are left queued while they already occupy every worker but
+// the reserved ones. Caller holds the mutex.
+fn (mut pool WorkerPool) take() ?WorkItem {
+	for p, mut queue in pool.queues {
+		if queue.len == 0 {
+			continue
+		}
+		if p != int(WorkPriority.interactive)
+			&& pool.low >= pool.threads - worker_pool_interactive_reserve {
+			return none
+		}
+		item := queue[0]
+		queue.delete(0)
+		return item
+	}
+	return none
+}
+
+// low_queued reports whether items below interactive priority wait.
+// Caller holds the mutex.
+fn (pool &WorkerPool) low_queued() bool {
+	for p, queue in pool.queues {
+		if p != int(WorkPriority.interactive) && queue.len > 0 {
+			return true
+		}
+	}
+	return false
+}
+
+fn worker_pool_run(mut pool WorkerPool) {
+	for {
+		pool.ready.wait()
+		pool.mutex.lock()
+		if pool.closed {
+			pool.mutex.unlock()
+			return
+		}
+		item := pool.take() or {
+			// Nothing runnable. A low-priority item held back here is
+			// picked up when a running one finishes.
+			pool.mutex.unlock()
+			continue
+		}
+		aborted := item.signal.is_aborted()
+		low := item.priority != .interactive
+		if aborted {
+			pool.cancelled++
+		} else {
+			pool.running++
+			if low {
+				pool.low++
+			}
+		}
+		pool.mutex.unlock()
+
+		mut w := pool.window
+		if aborted {
+			if item.on_cancel != unsafe { nil } {
+				item.on_cancel(mut w)
+			}
+			continue
+		}
+		item.run(mut w)
+		pool.mutex.lock()
+		pool.running--
+		wake := low && pool.low_queued()
+		if low {
+			pool.low--
+		}
+		pool.mutex.unlock()
+		if wake {
+			pool.ready.post()
+		}
+	}
+}
+
+// close stops the workers. Queued items are dropped and their
+// on_cancel runs on the calling thread, so the resources they hold
+// (e.g. layout callback pins) are released; running items finish on
+// their own.
+fn (mut pool WorkerPool) close() {
+	pool.mutex.lock()
+	if pool.closed {
+		pool.mutex.unlock()
+		return
+	}
+	pool.closed = true
+	mut dropped := []WorkItem{}
+	for mut queue in pool.queues {
+		dropped << queue
+		queue.clear()
+	}
+	pool.cancelled += u64(dropped.len)
+	pool.mutex.unlock()
+	for _ in 0 .. pool.threads {
+		pool.ready.post()
+	}
+	mut w := pool.window
+	for item in dropped {
+		if item.on_cancel != unsafe { nil } {
+			item.on_cancel(mut w)
+		}
+	}
+}
+
+fn (mut pool WorkerPool) stats() WorkerPoolStats {
+	pool.mutex.lock()
+	defer {
+		pool.mutex.unlock()
+	}
+	mut queued := 0
+	for queue in pool.queues {
+		queued += queue.len
+	}
+	return WorkerPoolStats{
+		threads:   pool.threads
+		queued:    queued
+		running:   pool.running
+		submitted: pool.submitted
+		cancelled: pool.cancelled
+	}
+}
+
+// FetchJob runs on a fetch thread; use queue_command to touch window
+// state.
+type FetchJob = fn (mut Window)
+
+// FetchQueue caps the threads running blocking fetches; jobs past the
+// cap wait in order. Queues hang off the Window rather than ViewState,
+// so clear_view_state neither drops queued jobs nor unbalances the
+// running count. Main thread only.
+@[heap]
+struct FetchQueue {
+	max_running int
+mut:
+	running int
+	queued  []FetchJob
+}
+
+// fetch_queue_push queues job and starts it if a slot is free.
+fn fetch_queue_push(q &FetchQueue, job FetchJob, mut w Window) {
+	mut queue := unsafe { q }
+	queue.queued << job
+	fetch_queue_start_next(q, mut w)
+}
+
+fn fetch_queue_start_next(q &FetchQueue, mut w Window) {
+	mut queue := unsafe { q }
+	for queue.running < queue.max_running && queue.queued.len > 0 {
+		job := queue.queued[0]
+		queue.queued.delete(0)
+		queue.running++
+		spawn fetch_queue_run(q, job, mut w)
+	}
+}
+
+// fetch_queue_run runs job, then frees its slot on the main thread
+// after any commands the job queued.
+fn fetch_queue_run(q &FetchQueue, job FetchJob, mut w Window) {
+	job(mut w)
+	w.queue_command(fn [q] (mut w Window) {
+		mut queue := unsafe { q }
+		queue.running--
+		fetch_queue_start_next(q, mut w)
+	})
+}